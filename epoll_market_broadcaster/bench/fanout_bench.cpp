@@ -0,0 +1,392 @@
+// 廣播 fan-out 壓測：同一個 process 內啟動 server 與多個 client 連線，
+// 比較不同 backend 與 reactor 數量下的送達速度、每則廣播的 syscall 數，
+// 以及從 enqueue_broadcast 到 client 收到為止的延遲
+//
+// 用法: fanout_bench [clients] [messages] [max_reactors] [reader_threads]
+//                    [rate] [symbols]
+// rate 為每秒發布的訊息數，0 表示不限速 (量測吞吐量)；
+// 量測延遲時應該給一個 server 跟得上的 rate，否則量到的是排隊時間
+//
+// symbols 為 0 時每則 64 bytes 的原始訊息送給所有 client；
+// 大於 0 時發布二進位 quote，輪流分配到各 symbol，第 i 個 client 以
+// 二進位格式只訂閱第 i % symbols 個 symbol
+
+#include "async_logger.h"
+#include "broadcast_server.h"
+#include "protocol.h"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <netinet/in.h>
+#include <stdexcept>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+constexpr size_t RAW_MESSAGE_SIZE = 64;
+constexpr size_t MAX_MESSAGE_SIZE = 64;
+constexpr uint16_t BASE_PORT = 19100;
+// 延遲以 1us 為一格，超過上限的都算在最後一格
+constexpr size_t LATENCY_BUCKETS = 100000;
+
+using Clock = std::chrono::steady_clock;
+
+uint64_t now_ns() {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          Clock::now().time_since_epoch())
+          .count());
+}
+
+// 發布格式：原始訊息的時間戳在開頭，quote 的在 send_time_ns
+struct MessageLayout {
+  size_t size;
+  size_t timestamp_offset;
+};
+
+int connect_client(uint16_t port) {
+  int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) {
+    throw std::runtime_error("socket() failed");
+  }
+
+  int rcvbuf = 256 * 1024;
+  ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  ::inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+  if (::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+    ::close(fd);
+    throw std::runtime_error("connect() failed: " +
+                             std::string(strerror(errno)));
+  }
+  return fd;
+}
+
+struct ReaderState {
+  std::atomic<uint64_t> bytes{0};
+  std::vector<uint64_t> latency_us = std::vector<uint64_t>(LATENCY_BUCKETS);
+};
+
+// 每個 reader 線程以自己的 epoll 讀取一部分 client；
+// 訊息固定長度，skip 為每個 client 開頭要略過的 bytes (協商回覆)
+void reader_loop(const std::vector<int> &fds, MessageLayout layout,
+                 size_t skip, ReaderState &state,
+                 const std::atomic<bool> &running) {
+  const size_t msg_size = layout.size;
+  struct Partial {
+    char data[MAX_MESSAGE_SIZE];
+    size_t len = 0;
+    size_t skip = 0;
+  };
+  std::vector<Partial> partial(fds.size());
+  for (auto &p : partial) {
+    p.skip = skip;
+  }
+
+  int ep = ::epoll_create1(0);
+  for (size_t i = 0; i < fds.size(); ++i) {
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.u32 = static_cast<uint32_t>(i);
+    ::epoll_ctl(ep, EPOLL_CTL_ADD, fds[i], &ev);
+  }
+
+  auto record = [&state, layout](const char *msg, uint64_t now) {
+    uint64_t sent;
+    std::memcpy(&sent, msg + layout.timestamp_offset, sizeof(sent));
+    const uint64_t us = now > sent ? (now - sent) / 1000 : 0;
+    ++state.latency_us[std::min<uint64_t>(us, LATENCY_BUCKETS - 1)];
+  };
+
+  std::vector<char> buf(256 * 1024);
+  epoll_event events[64];
+  while (running.load(std::memory_order_relaxed)) {
+    int n = ::epoll_wait(ep, events, 64, 10);
+    for (int i = 0; i < n; ++i) {
+      const uint32_t idx = events[i].data.u32;
+      ssize_t r = ::recv(fds[idx], buf.data(), buf.size(), MSG_DONTWAIT);
+      if (r <= 0) {
+        continue;
+      }
+      const uint64_t now = now_ns();
+      Partial &p = partial[idx];
+      size_t off = std::min(p.skip, static_cast<size_t>(r));
+      p.skip -= off;
+      state.bytes.fetch_add(static_cast<uint64_t>(r) - off,
+                            std::memory_order_relaxed);
+
+      // TCP 是 byte stream，跨 recv 的訊息先拼回完整的一則
+      if (p.len > 0) {
+        const size_t take =
+            std::min(msg_size - p.len, static_cast<size_t>(r) - off);
+        std::memcpy(p.data + p.len, buf.data() + off, take);
+        p.len += take;
+        off += take;
+        if (p.len == msg_size) {
+          record(p.data, now);
+          p.len = 0;
+        }
+      }
+      for (; off + msg_size <= static_cast<size_t>(r); off += msg_size) {
+        record(buf.data() + off, now);
+      }
+      if (off < static_cast<size_t>(r)) {
+        p.len = static_cast<size_t>(r) - off;
+        std::memcpy(p.data, buf.data() + off, p.len);
+      }
+    }
+  }
+  ::close(ep);
+}
+
+struct Result {
+  uint64_t delivered = 0;
+  uint64_t expected = 0;
+  double seconds = 0.0;
+  double syscalls_per_broadcast = 0.0;
+  double p50_us = 0.0;
+  double p99_us = 0.0;
+};
+
+double percentile(const std::vector<uint64_t> &hist, double q) {
+  uint64_t total = 0;
+  for (uint64_t c : hist) {
+    total += c;
+  }
+  if (total == 0) {
+    return 0.0;
+  }
+
+  const auto rank = static_cast<uint64_t>(q * static_cast<double>(total - 1));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < hist.size(); ++i) {
+    seen += hist[i];
+    if (seen > rank) {
+      return static_cast<double>(i);
+    }
+  }
+  return static_cast<double>(hist.size() - 1);
+}
+
+Result run_once(emb::ServerConfig config, size_t clients, size_t messages,
+                size_t reader_threads, uint64_t rate, size_t symbols) {
+  namespace protocol = emb::protocol;
+
+  config.outbound_capacity = 4 * 1024 * 1024;
+  config.outbound_messages = 65536;
+  config.max_connections = std::max<size_t>(clients, 1024);
+  for (size_t i = 0; i < symbols; ++i) {
+    config.symbols.push_back("S" + std::to_string(i));
+  }
+
+  const MessageLayout layout =
+      symbols > 0 ? MessageLayout{sizeof(protocol::QuoteFrame),
+                                  offsetof(protocol::QuoteFrame, send_time_ns)}
+                  : MessageLayout{RAW_MESSAGE_SIZE, 0};
+  const size_t skip = symbols > 0 ? std::strlen(protocol::BINARY_ACK) : 0;
+
+  auto server = emb::make_server(config);
+  std::thread server_thread([&server] { server->run(); });
+
+  std::vector<int> fds;
+  std::vector<size_t> subscribers(std::max<size_t>(symbols, 1));
+  for (size_t i = 0; i < clients; ++i) {
+    fds.push_back(connect_client(config.port));
+    if (symbols > 0) {
+      const std::string request = std::string(protocol::BINARY_REQUEST) +
+                                  "\n" + protocol::SUBSCRIBE + " " +
+                                  config.symbols[i % symbols] + "\n";
+      ::send(fds.back(), request.data(), request.size(), 0);
+    }
+    ++subscribers[symbols > 0 ? i % symbols : 0];
+  }
+  while (server->stats().connections < clients) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  if (symbols > 0) {
+    // 等 server 處理完訂閱指令
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  }
+
+  std::atomic<bool> reading{true};
+  std::vector<ReaderState> states(reader_threads);
+  std::vector<std::vector<int>> slices(reader_threads);
+  for (size_t i = 0; i < fds.size(); ++i) {
+    slices[i % reader_threads].push_back(fds[i]);
+  }
+  std::vector<std::thread> readers;
+  for (size_t i = 0; i < reader_threads; ++i) {
+    readers.emplace_back(reader_loop, std::cref(slices[i]), layout, skip,
+                         std::ref(states[i]), std::cref(reading));
+  }
+
+  auto total_bytes = [&states] {
+    uint64_t total = 0;
+    for (auto &s : states) {
+      total += s.bytes.load(std::memory_order_relaxed);
+    }
+    return total;
+  };
+
+  Result result;
+  for (size_t i = 0; i < messages; ++i) {
+    result.expected += subscribers[symbols > 0 ? i % symbols : 0];
+  }
+  const uint64_t expected_bytes = result.expected * layout.size;
+  const emb::ServerStats before = server->stats();
+
+  const auto start = Clock::now();
+  const uint64_t interval_ns = rate > 0 ? 1000000000ull / rate : 0;
+  uint64_t next_send = now_ns();
+  for (size_t i = 0; i < messages; ++i) {
+    if (interval_ns > 0) {
+      while (now_ns() < next_send) {
+      }
+      next_send += interval_ns;
+    }
+
+    emb::PayloadRef payload;
+    while (!(payload = server->acquire_payload())) {
+      std::this_thread::yield(); // pool 用完，等 client 消化
+    }
+    char *data = payload->mutable_data();
+    const uint64_t ts = now_ns();
+    if (symbols > 0) {
+      const auto quote = protocol::make_quote(
+          static_cast<uint32_t>(i % symbols), i, ts,
+          protocol::to_fixed(100.0 + static_cast<double>(i % 100)), 100);
+      payload->set_size(protocol::encode(quote, data));
+      payload->set_format(emb::PayloadFormat::Binary);
+    } else {
+      std::memset(data, 'a' + static_cast<int>(i % 26), RAW_MESSAGE_SIZE);
+      std::memcpy(data, &ts, sizeof(ts));
+      payload->set_size(RAW_MESSAGE_SIZE);
+    }
+
+    while (!server->enqueue_broadcast(payload)) {
+      std::this_thread::yield();
+    }
+  }
+
+  // 等全部送達，或是 500ms 內沒有任何進展 (有訊息被丟棄)
+  uint64_t last = 0;
+  auto last_progress = Clock::now();
+  auto end = last_progress;
+  while (true) {
+    uint64_t now_bytes = total_bytes();
+    if (now_bytes != last) {
+      last = now_bytes;
+      end = last_progress = Clock::now();
+    }
+    if (now_bytes >= expected_bytes ||
+        Clock::now() - last_progress > std::chrono::milliseconds(500)) {
+      break;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+  }
+
+  const emb::ServerStats after = server->stats();
+  const uint64_t broadcasts = after.broadcasts - before.broadcasts;
+
+  reading.store(false, std::memory_order_relaxed);
+  for (auto &t : readers) {
+    t.join();
+  }
+
+  std::vector<uint64_t> hist(LATENCY_BUCKETS);
+  for (auto &s : states) {
+    for (size_t i = 0; i < LATENCY_BUCKETS; ++i) {
+      hist[i] += s.latency_us[i];
+    }
+  }
+
+  result.delivered = last / layout.size;
+  result.seconds = std::chrono::duration<double>(end - start).count();
+  result.syscalls_per_broadcast =
+      broadcasts > 0 ? static_cast<double>(after.syscalls - before.syscalls) /
+                           static_cast<double>(broadcasts)
+                     : 0.0;
+  result.p50_us = percentile(hist, 0.50);
+  result.p99_us = percentile(hist, 0.99);
+
+  for (int fd : fds) {
+    ::close(fd);
+  }
+  server->stop();
+  server_thread.join();
+  return result;
+}
+
+void print_row(const char *backend, size_t reactors, const Result &r) {
+  std::printf("%-9s %8zu %12llu %9llu %9.3f %12.0f %10.2f %8.0f %8.0f\n",
+              backend, reactors, static_cast<unsigned long long>(r.delivered),
+              static_cast<unsigned long long>(r.expected - r.delivered),
+              r.seconds, r.delivered / r.seconds, r.syscalls_per_broadcast,
+              r.p50_us, r.p99_us);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  emb::log::set_level(emb::log::Level::Warn);
+
+  size_t clients = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 64;
+  size_t messages = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100000;
+  size_t max_reactors = argc > 3 ? std::strtoul(argv[3], nullptr, 10)
+                                 : std::thread::hardware_concurrency();
+  size_t reader_threads = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : 4;
+  uint64_t rate = argc > 5 ? std::strtoull(argv[5], nullptr, 10) : 0;
+  size_t symbols = argc > 6 ? std::strtoul(argv[6], nullptr, 10) : 0;
+  if (max_reactors == 0) {
+    max_reactors = 1;
+  }
+  if (reader_threads == 0) {
+    reader_threads = 1;
+  }
+
+  std::printf("clients=%zu messages=%zu message_size=%zu reader_threads=%zu "
+              "rate=%llu symbols=%zu\n",
+              clients, messages,
+              symbols > 0 ? sizeof(emb::protocol::QuoteFrame)
+                          : RAW_MESSAGE_SIZE,
+              reader_threads, static_cast<unsigned long long>(rate), symbols);
+  std::printf("%-9s %8s %12s %9s %9s %12s %10s %8s %8s\n", "backend",
+              "reactors", "delivered", "dropped", "seconds", "msgs/sec",
+              "sys/bcast", "p50(us)", "p99(us)");
+
+  uint16_t port = BASE_PORT;
+  for (size_t reactors = 1; reactors <= max_reactors; reactors *= 2) {
+    emb::ServerConfig config;
+    config.port = port++;
+    config.num_reactors = reactors;
+    print_row("epoll", reactors,
+              run_once(config, clients, messages, reader_threads, rate,
+                       symbols));
+  }
+
+  for (bool zc : {false, true}) {
+    emb::ServerConfig config;
+    config.port = port++;
+    config.backend = emb::Backend::IoUring;
+    config.uring_fixed_files = zc;
+    config.uring_registered_buffers = zc;
+    print_row(zc ? "uring-zc" : "uring", 1,
+              run_once(config, clients, messages, reader_threads, rate,
+                       symbols));
+  }
+  return 0;
+}
@@ -0,0 +1,161 @@
+// 連上 broadcaster 並印出收到的行情
+//
+// 用法: test_client [host] [port] [text|binary] [count] [symbols]
+// binary 模式會先送出 "PROTO BINARY"，收到 "OK BINARY" 之後以 frame 解碼，
+// 並依 frame 中的發布時間計算延遲 (server 與 client 需在同一台機器上)；
+// count 為 0 時持續讀取直到 server 關閉連線；symbols 例如 "AAPL,GOOG"，
+// 只訂閱這些 symbol (預設全部)
+
+#include "protocol.h"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+namespace protocol = emb::protocol;
+
+uint64_t realtime_ns() {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count());
+}
+
+struct Printer {
+  uint64_t received = 0;
+  std::vector<uint64_t> latency_ns;
+
+  void on_quote(const protocol::QuoteFrame &q) {
+    const uint64_t now = realtime_ns();
+    latency_ns.push_back(now > q.send_time_ns ? now - q.send_time_ns : 0);
+    std::printf("Q seq=%" PRIu64 " symbol=%u price=%.4f volume=%u\n", q.seq,
+                q.symbol_id, protocol::from_fixed(q.price), q.volume);
+    ++received;
+  }
+
+  void on_trade(const protocol::TradeFrame &t) {
+    std::printf("T seq=%" PRIu64 " symbol=%u price=%.4f qty=%u side=%c\n",
+                t.seq, t.symbol_id, protocol::from_fixed(t.price), t.quantity,
+                static_cast<char>(t.side));
+    ++received;
+  }
+
+  void on_snapshot_end(const protocol::SnapshotEndFrame &e) {
+    std::printf("E resume_seq=%" PRIu64 "\n", e.resume_seq);
+  }
+};
+
+void print_latency(std::vector<uint64_t> &samples) {
+  if (samples.empty()) {
+    return;
+  }
+  std::sort(samples.begin(), samples.end());
+  auto at = [&samples](double q) {
+    return samples[static_cast<size_t>(q * (samples.size() - 1))] / 1000.0;
+  };
+  std::printf("latency(us): p50=%.1f p99=%.1f max=%.1f (n=%zu)\n", at(0.50),
+              at(0.99), at(1.0), samples.size());
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  const char *host = argc > 1 ? argv[1] : "127.0.0.1";
+  const auto port = static_cast<uint16_t>(argc > 2 ? std::atoi(argv[2]) : 8080);
+  const bool binary = argc > 3 && std::string(argv[3]) == "binary";
+  const uint64_t count = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 0;
+  const std::string symbols = argc > 5 ? argv[5] : "";
+
+  int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) {
+    std::perror("socket");
+    return 1;
+  }
+
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  if (::inet_pton(AF_INET, host, &addr.sin_addr) != 1) {
+    std::fprintf(stderr, "invalid address: %s\n", host);
+    return 1;
+  }
+  if (::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+    std::perror("connect");
+    return 1;
+  }
+
+  std::string request;
+  if (binary) {
+    request += std::string(protocol::BINARY_REQUEST) + "\n";
+  }
+  if (!symbols.empty()) {
+    request += std::string(protocol::SUBSCRIBE) + " " + symbols + "\n";
+  }
+  if (!request.empty()) {
+    if (::send(fd, request.data(), request.size(), 0) !=
+        static_cast<ssize_t>(request.size())) {
+      std::perror("send");
+      return 1;
+    }
+  }
+
+  // 收到協商回覆之前資料仍是文字，逐行處理；之後的 bytes 交給 decode
+  bool decoding = false;
+  std::string pending;
+  Printer printer;
+  uint64_t lines = 0;
+  char buf[64 * 1024];
+
+  while (count == 0 || printer.received + lines < count) {
+    ssize_t n = ::recv(fd, buf, sizeof(buf), 0);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      break;
+    }
+    pending.append(buf, static_cast<size_t>(n));
+
+    while (!decoding) {
+      const size_t pos = pending.find('\n');
+      if (pos == std::string::npos) {
+        break;
+      }
+      const std::string line = pending.substr(0, pos + 1);
+      pending.erase(0, pos + 1);
+      if (binary && line == protocol::BINARY_ACK) {
+        decoding = true;
+      } else {
+        std::fwrite(line.data(), 1, line.size(), stdout);
+        ++lines;
+      }
+    }
+
+    if (decoding) {
+      const size_t used =
+          protocol::decode(pending.data(), pending.size(), printer);
+      if (used == protocol::DECODE_ERROR) {
+        std::fprintf(stderr, "malformed frame, closing\n");
+        break;
+      }
+      pending.erase(0, used);
+    }
+  }
+
+  ::close(fd);
+  print_latency(printer.latency_ns);
+  return 0;
+}
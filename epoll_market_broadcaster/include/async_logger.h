@@ -0,0 +1,248 @@
+#pragma once
+
+#include <fmt/core.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+namespace emb::log {
+
+// 非同步二進位 logger
+//
+// 呼叫端 (event loop) 只把格式字串的指標、格式化函式與原始參數複製進自己
+// 線程的 SPSC ring，格式化與寫檔都在背景線程做，背景線程可以綁到管理核心。
+// ring 滿時丟棄並計數，永遠不阻塞呼叫端。start() 之前或 stop() 之後，
+// 訊息直接在呼叫端同步格式化並寫到 stderr。
+//
+// 格式字串必須是字串常值 (只保存指標)；參數必須是 trivially copyable 或字串，
+// 字串會被複製 (過長時截斷)。用法與 spdlog 相同：
+//   EMB_LOG_INFO("fd={} closed, remaining={}", fd, count);
+
+enum class Level : uint8_t { Debug, Info, Warn, Error, Off };
+
+struct LoggerConfig {
+  std::string path;               // 空字串代表 stdout
+  int cpu = -1;                   // 背景線程綁定的 CPU，-1 不綁定
+  Level level = Level::Info;
+  int idle_sleep_us = 1000;       // 沒有訊息時背景線程的睡眠時間
+};
+
+// 啟動背景線程；開檔失敗丟出 std::runtime_error
+void start(const LoggerConfig &config);
+// 寫出所有 ring 中剩下的訊息並停止背景線程
+void stop();
+
+void set_level(Level level);
+// 因 ring 滿而丟棄的訊息總數
+uint64_t dropped();
+
+namespace detail {
+
+inline std::atomic<Level> g_level{Level::Info};
+
+// 參數編碼：trivially copyable 直接 memcpy，字串為 uint16 長度 + 內容
+template <typename T> struct Codec {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "log arguments must be trivially copyable or strings");
+  using Decoded = T;
+  static constexpr size_t FIXED_SIZE = sizeof(T);
+  static constexpr bool IS_STRING = false;
+
+  static std::string_view view(const T &) { return {}; }
+  static uint8_t *encode(uint8_t *p, const T &value, size_t) {
+    std::memcpy(p, &value, sizeof(T));
+    return p + sizeof(T);
+  }
+  static T decode(const uint8_t *&p) {
+    T value;
+    std::memcpy(&value, p, sizeof(T));
+    p += sizeof(T);
+    return value;
+  }
+};
+
+struct StringCodec {
+  using Decoded = std::string_view;
+  static constexpr size_t FIXED_SIZE = sizeof(uint16_t);
+  static constexpr bool IS_STRING = true;
+
+  // max_len 為這個字串還能使用的空間
+  static uint8_t *encode(uint8_t *p, std::string_view s, size_t max_len) {
+    const auto len = static_cast<uint16_t>(std::min(s.size(), max_len));
+    std::memcpy(p, &len, sizeof(len));
+    std::memcpy(p + sizeof(len), s.data(), len);
+    return p + sizeof(len) + len;
+  }
+  static std::string_view decode(const uint8_t *&p) {
+    uint16_t len;
+    std::memcpy(&len, p, sizeof(len));
+    std::string_view s(reinterpret_cast<const char *>(p + sizeof(len)), len);
+    p += sizeof(len) + len;
+    return s;
+  }
+};
+
+template <> struct Codec<const char *> : StringCodec {
+  static std::string_view view(const char *s) {
+    return s == nullptr ? std::string_view("(null)") : std::string_view(s);
+  }
+};
+template <> struct Codec<char *> : Codec<const char *> {};
+template <> struct Codec<std::string_view> : StringCodec {
+  static std::string_view view(std::string_view s) { return s; }
+};
+template <> struct Codec<std::string> : StringCodec {
+  static std::string_view view(const std::string &s) { return s; }
+};
+
+using FormatFn = void (*)(fmt::memory_buffer &out, std::string_view format,
+                          const uint8_t *payload);
+
+// 一筆訊息佔一個 cache line 的整數倍，呼叫端直接寫進 ring 的 slot
+struct alignas(64) Record {
+  static constexpr size_t PAYLOAD_SIZE = 216;
+
+  const char *format;
+  uint32_t format_len;
+  Level level;
+  FormatFn format_fn;
+  int64_t time_ns; // CLOCK_REALTIME
+  uint8_t payload[PAYLOAD_SIZE];
+};
+static_assert(sizeof(Record) == 256);
+
+template <typename... Args>
+void format_record(fmt::memory_buffer &out, std::string_view format,
+                   [[maybe_unused]] const uint8_t *payload) {
+  // brace-init 保證由左到右解碼
+  std::tuple<typename Codec<Args>::Decoded...> args{
+      Codec<Args>::decode(payload)...};
+  std::apply(
+      [&](const auto &...decoded) {
+        fmt::format_to(std::back_inserter(out), fmt::runtime(format),
+                       decoded...);
+      },
+      args);
+}
+
+// 每個寫 log 的線程一個 SPSC ring：寫入端為該線程，讀取端為背景線程
+struct Ring {
+  static constexpr size_t CAPACITY = 1024;
+
+  std::array<Record, CAPACITY> slots;
+  alignas(64) std::atomic<uint64_t> head{0}; // 背景線程已讀到的位置
+  alignas(64) std::atomic<uint64_t> tail{0}; // 已發布的位置
+  uint64_t cached_head = 0;                  // 寫入端看到的 head
+  std::atomic<uint64_t> dropped{0};          // 只有寫入端修改
+};
+
+inline std::atomic<bool> g_running{false};
+inline thread_local Ring *tls_ring = nullptr;
+
+// 第一次寫 log 時配置並登記 ring (每個線程只發生一次)
+Ring *register_thread();
+void write_sync(Level level, std::string_view format, FormatFn format_fn,
+                const uint8_t *payload);
+int64_t now_ns();
+
+// ring 滿時計數並回傳 nullptr
+inline Record *claim(Ring &ring) {
+  const uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+  if (tail - ring.cached_head >= Ring::CAPACITY) {
+    ring.cached_head = ring.head.load(std::memory_order_acquire);
+    if (tail - ring.cached_head >= Ring::CAPACITY) {
+      ring.dropped.store(ring.dropped.load(std::memory_order_relaxed) + 1,
+                         std::memory_order_relaxed);
+      return nullptr;
+    }
+  }
+  return &ring.slots[tail & (Ring::CAPACITY - 1)];
+}
+
+inline void commit(Ring &ring) {
+  ring.tail.store(ring.tail.load(std::memory_order_relaxed) + 1,
+                  std::memory_order_release);
+}
+
+template <typename... Args>
+void log(Level level, fmt::format_string<Args...> format,
+         const Args &...args) {
+  // 固定大小的部分在編譯期就確定放得下，剩下的空間分給字串
+  constexpr size_t fixed =
+      (size_t{0} + ... + Codec<std::decay_t<Args>>::FIXED_SIZE);
+  static_assert(fixed <= Record::PAYLOAD_SIZE, "too many log arguments");
+
+  const fmt::string_view format_sv = format;
+  const std::string_view fmt_view(format_sv.data(), format_sv.size());
+  const FormatFn fn = &format_record<std::decay_t<Args>...>;
+
+  const bool async = g_running.load(std::memory_order_acquire);
+  Ring *ring = nullptr;
+  Record *record = nullptr;
+  uint8_t stack_payload[Record::PAYLOAD_SIZE];
+  if (async) {
+    ring = tls_ring != nullptr ? tls_ring : register_thread();
+    record = claim(*ring);
+    if (record == nullptr) {
+      return;
+    }
+  }
+
+  [[maybe_unused]] size_t budget = Record::PAYLOAD_SIZE - fixed;
+  [[maybe_unused]] uint8_t *p = async ? record->payload : stack_payload;
+  (
+      [&] {
+        using C = Codec<std::decay_t<Args>>;
+        if constexpr (C::IS_STRING) {
+          const std::string_view s = C::view(args);
+          const size_t used = std::min(s.size(), budget);
+          budget -= used;
+          p = C::encode(p, s, used);
+        } else {
+          p = C::encode(p, args, 0);
+        }
+      }(),
+      ...);
+
+  if (!async) {
+    // 沒有參數時 payload 不會被讀取，也不會被寫入
+    write_sync(level, fmt_view, fn,
+               sizeof...(Args) == 0 ? nullptr : stack_payload);
+    return;
+  }
+  record->format = fmt_view.data();
+  record->format_len = static_cast<uint32_t>(fmt_view.size());
+  record->level = level;
+  record->format_fn = fn;
+  record->time_ns = now_ns();
+  commit(*ring);
+}
+
+} // namespace detail
+
+inline bool enabled(Level level) {
+  return level >= detail::g_level.load(std::memory_order_relaxed);
+}
+
+} // namespace emb::log
+
+#define EMB_LOG(level, ...)                                                    \
+  do {                                                                         \
+    if (::emb::log::enabled(level)) {                                          \
+      ::emb::log::detail::log(level, __VA_ARGS__);                             \
+    }                                                                          \
+  } while (0)
+
+#define EMB_LOG_DEBUG(...) EMB_LOG(::emb::log::Level::Debug, __VA_ARGS__)
+#define EMB_LOG_INFO(...) EMB_LOG(::emb::log::Level::Info, __VA_ARGS__)
+#define EMB_LOG_WARN(...) EMB_LOG(::emb::log::Level::Warn, __VA_ARGS__)
+#define EMB_LOG_ERROR(...) EMB_LOG(::emb::log::Level::Error, __VA_ARGS__)
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "connect.h"
+#include "payload_pool.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace emb {
+
+// 啟動時選擇的 I/O backend
+enum class Backend {
+  Epoll,   // EpollServer：每個 reactor 一個 epoll 事件循環
+  IoUring, // UringServer：單一 io_uring 事件循環
+};
+
+struct ServerConfig {
+  uint16_t port = 8888;
+  Backend backend = Backend::Epoll;
+  // 每個連線 outbound ring 的容量 (bytes 與訊息數)
+  size_t outbound_capacity = Connection::DEFAULT_OUTBOUND_CAPACITY;
+  size_t outbound_messages = Connection::DEFAULT_OUTBOUND_MESSAGES;
+  // 單則廣播訊息的大小上限
+  size_t max_payload_size = PayloadPool::DEFAULT_SLOT_SIZE;
+  // payload pool 的 buffer 數，0 表示由 payload_pool_capacity() 計算
+  size_t payload_pool_size = 0;
+  SlowConsumerPolicy slow_consumer_policy = SlowConsumerPolicy::DropOldest;
+  // symbols[id] 為 symbol 代號，把二進位 frame 轉成文字給文字連線時使用
+  std::vector<std::string> symbols;
+  // 新連線預設為最新值模式 (client 也可以送 "MODE CONFLATED" 個別開啟)，
+  // 只有 epoll backend 支援
+  bool conflate_by_default = false;
+  // 每個 reactor 保留最近幾則 frame 給 REPLAY 使用 (每則 64 bytes)
+  size_t retransmit_capacity = 65536;
+
+  // reactor 數量，大於 1 時每個 reactor 以 SO_REUSEPORT 各自 listen
+  size_t num_reactors = 1;
+  // reactor_cpus[i] 為第 i 個 reactor 綁定的 CPU，未指定的不綁定
+  std::vector<int> reactor_cpus;
+  // 不在 epoll_wait 中睡眠，以 CPU 換取喚醒延遲
+  bool busy_poll = false;
+  // 單次 sendmsg 的資料量達到這個 bytes 數時使用 MSG_ZEROCOPY，0 表示關閉
+  size_t zerocopy_threshold = 0;
+
+  // io_uring backend
+  unsigned uring_entries = 4096;
+  size_t max_connections = 4096;
+  // 把 client socket 註冊為 fixed file，省去每個 SQE 的 fd 查找
+  bool uring_fixed_files = false;
+  // 把 payload pool 註冊為 fixed buffer，以 SEND_ZC 零複製送出
+  bool uring_registered_buffers = false;
+};
+
+struct ServerStats {
+  size_t connections = 0;
+  uint64_t broadcasts = 0; // 已分派的廣播訊息數
+  uint64_t syscalls = 0;   // 事件循環發出的 I/O 相關 syscall 數
+};
+
+// 各 backend 共同的對外介面
+class BroadcastServer {
+public:
+  virtual ~BroadcastServer() = default;
+
+  // 執行事件循環直到 stop()
+  virtual void run() = 0;
+  virtual void stop() = 0;
+
+  // 以下皆可由多個生產者線程同時呼叫
+
+  // 複製一次到 pool 中的 payload，之後所有客戶端共用
+  virtual bool enqueue_broadcast(const std::string &data) = 0;
+
+  // 從 pool 取得 payload 直接序列化，再以 enqueue_broadcast(PayloadRef) 發布，
+  // 連一次複製都省下；pool 用完時回傳空的 PayloadRef
+  virtual PayloadRef acquire_payload() = 0;
+  virtual bool enqueue_broadcast(PayloadRef payload) = 0;
+
+  virtual ServerStats stats() const = 0;
+};
+
+// payload pool 的 buffer 數：有設定 payload_pool_size 時直接使用，否則為
+// 每個事件循環 2 * outbound_messages (落後的連線持有的二進位 payload 與該循環
+// 轉出的文字 payload；DropOldest 留下的是最新的幾則，各連線持有的大多重疊)
+// 再加上 inbox、回補與生產者手上的餘裕。只訂閱部分 symbol 的落後連線持有的
+// payload 彼此不重疊，這種連線很多時要以 payload_pool_size 調大
+size_t payload_pool_capacity(const ServerConfig &config, size_t event_loops);
+
+// 依 config.backend 建立對應的 server
+std::unique_ptr<BroadcastServer> make_server(const ServerConfig &config);
+
+} // namespace emb
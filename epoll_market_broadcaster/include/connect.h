@@ -1,13 +1,48 @@
 #pragma once
 
+#include "io_counters.h"
+#include "outbound_ring.h"
+#include "payload_pool.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <optional>
 #include <string>
+#include <vector>
 
 namespace emb {
 
+// client 跟不上時 (outbound ring 滿了) 的處理方式
+enum class SlowConsumerPolicy {
+  DropOldest, // 丟棄最舊的未送訊息
+  Disconnect, // 直接斷線
+  Conflate,   // 丟棄所有未送訊息，只保留最新的一則
+};
+
+// 連線協商後的資料格式，見 protocol.h
+enum class WireFormat {
+  Text,   // SEQ|SYMBOL|PRICE|VOLUME\n (預設)
+  Binary, // 固定長度的 frame
+};
+
+enum class SendResult {
+  Ok,       // 已送出或已放入 outbound ring
+  Dropped,  // 依 policy 丟棄了部分訊息
+  Overflow, // policy 為 Disconnect 且 ring 已滿，呼叫端應關閉連線
+  Error,    // socket 錯誤，呼叫端應關閉連線
+};
+
 class Connection {
 public:
-  explicit Connection(int fd);
+  static constexpr size_t DEFAULT_OUTBOUND_CAPACITY = 256 * 1024;
+  static constexpr size_t DEFAULT_OUTBOUND_MESSAGES = 4096;
+
+  // counters 不為 nullptr 時，每次 recv/send 都會記到 counters->syscalls
+  explicit Connection(int fd,
+                      size_t outbound_capacity = DEFAULT_OUTBOUND_CAPACITY,
+                      size_t outbound_messages = DEFAULT_OUTBOUND_MESSAGES,
+                      IoCounters *counters = nullptr);
   ~Connection();
 
   Connection(const Connection &) = delete;
@@ -24,12 +59,85 @@ public:
   // 從緩衝區取得一條完整的消息
   std::optional<std::string> get_message();
 
-  // 發送數據
-  bool send_data(const std::string &data);
+  // 發送一則完整的訊息，不會阻塞：
+  // 沒有待送資料時直接 send()，送不完時把 payload 參考放入 outbound ring
+  SendResult send_data(const PayloadRef &payload, SlowConsumerPolicy policy);
+
+  // 一次放入多則訊息，再以一個 sendmsg 送出 (每則一段 iovec)；
+  // 正在等 EPOLLOUT 時只放入 ring，不做注定 EAGAIN 的 syscall
+  SendResult send_batch(const PayloadRef *payloads, size_t count,
+                        SlowConsumerPolicy policy);
+
+  // socket 可寫時呼叫，盡量送出 outbound ring 中的資料，錯誤時回傳 false
+  bool flush();
+
+  // 開啟 SO_ZEROCOPY：單次 sendmsg 的資料量達到 threshold 時改用
+  // MSG_ZEROCOPY，payload 參考會保留到 kernel 回報完成為止；
+  // kernel 不支援時回傳 false
+  bool enable_zerocopy(size_t threshold);
+
+  // EPOLLERR 時呼叫：讀取 error queue 中的 MSG_ZEROCOPY 完成通知並釋放 payload，
+  // 遇到真正的 socket 錯誤時回傳 false
+  bool reap_zerocopy();
+  bool zerocopy_enabled() const { return zerocopy_threshold_ > 0; }
+  size_t zerocopy_pending() const { return zerocopy_pending_.size(); }
+
+  bool has_pending() const { return !outbound_.empty(); }
+  size_t pending_bytes() const { return outbound_.size(); }
+  uint64_t dropped_messages() const { return dropped_; }
+
+  WireFormat wire_format() const { return wire_format_; }
+  void set_wire_format(WireFormat format) { wire_format_ = format; }
+
+  // 最新值模式：落後時 (outbound ring 還有資料) 不再排入新的 tick，
+  // 只記下哪些 symbol 有更新，socket 可寫時再送各 symbol 的最新值；
+  // symbols 為 symbol 總數，0 代表關閉
+  void set_conflated(bool conflated, size_t symbols);
+  bool conflated() const { return conflated_; }
+  void mark_dirty(uint32_t symbol) {
+    uint64_t &word = dirty_[symbol / 64];
+    const uint64_t bit = uint64_t{1} << (symbol % 64);
+    dirty_count_ += (word & bit) == 0;
+    word |= bit;
+  }
+  bool has_dirty() const { return dirty_count_ > 0; }
+  // 依 symbol 順序取出最多 max 個有更新的 symbol 並清除標記，回傳數量
+  size_t take_dirty(uint32_t *out, size_t max);
+
+  // 目前是否已向 epoll 註冊 EPOLLOUT
+  bool write_armed() const { return write_armed_; }
+  void set_write_armed(bool armed) { write_armed_ = armed; }
 
 private:
   int fd_;
   std::string read_buffer_;
+  OutboundRing outbound_;
+  uint64_t dropped_ = 0;
+  bool write_armed_ = false;
+  WireFormat wire_format_ = WireFormat::Text;
+  bool conflated_ = false;
+  std::vector<uint64_t> dirty_; // symbol 的 bitset，大小固定，不隨落後程度成長
+  size_t dirty_count_ = 0;
+  IoCounters *counters_ = nullptr;
+
+  // MSG_ZEROCOPY：每次 sendmsg 有一個遞增的序號，kernel 以序號區間回報完成
+  struct ZeroCopyBatch {
+    uint32_t seq;
+    std::vector<PayloadRef> payloads;
+  };
+  size_t zerocopy_threshold_ = 0;
+  uint32_t zerocopy_seq_ = 0;
+  std::deque<ZeroCopyBatch> zerocopy_pending_;
+
+  // 放入 outbound ring，滿了依 policy 丟棄；回傳 false 代表應該斷線
+  bool enqueue(const PayloadRef &payload, size_t offset,
+               SlowConsumerPolicy policy, bool &dropped);
+
+  void count_syscall() {
+    if (counters_ != nullptr) {
+      counters_->add_syscalls();
+    }
+  }
 };
 
 } // namespace emb
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "payload_pool.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace emb {
+
+// 把一批廣播依連線的格式分成兩份，兩份都與輸入的順序對齊 (第 i 則對應第 i 格)
+//
+// - 文字連線：Raw payload 原樣送出，Binary frame 轉成文字 (每則只轉一次，
+//   同一個事件循環內所有文字連線共用)
+// - 二進位連線：只送 Binary frame，Raw payload 不送 (會破壞 frame 邊界)
+//
+// 某則沒有對應格式的版本時，該格為空的 PayloadRef
+class FanoutBatch {
+public:
+  static constexpr size_t CAPACITY = 64;
+
+  FanoutBatch(PayloadPool &pool, const std::vector<std::string> &symbols)
+      : pool_(pool), symbols_(symbols) {}
+
+  // count 不可超過 CAPACITY；沒有該格式的連線時不必建立那一份
+  void build(const PayloadRef *payloads, size_t count, bool need_text,
+             bool need_binary);
+  void clear();
+
+  size_t size() const { return count_; }
+  const PayloadRef *text() const { return text_; }
+  const PayloadRef *binary() const { return binary_; }
+  // 沒有空格時可以把整個陣列直接交給 send_batch
+  bool text_complete() const { return text_count_ == count_; }
+  bool binary_complete() const { return binary_count_ == count_; }
+
+  // 每則訊息的 symbol id，沒有時為 protocol::NO_SYMBOL
+  const uint32_t *symbols() const { return symbol_ids_; }
+
+  // pool 用完或 frame 無法轉換而沒有送給文字連線的訊息數
+  uint64_t transcode_failures() const { return transcode_failures_; }
+
+private:
+  PayloadPool &pool_;
+  const std::vector<std::string> &symbols_;
+
+  PayloadRef text_[CAPACITY];
+  PayloadRef binary_[CAPACITY];
+  uint32_t symbol_ids_[CAPACITY];
+  size_t count_ = 0;
+  size_t text_count_ = 0;
+  size_t binary_count_ = 0;
+  uint64_t transcode_failures_ = 0;
+};
+
+} // namespace emb
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace emb {
+
+// 每個事件循環一份的 I/O 計數器
+//
+// 只有擁有它的事件循環線程會寫入，所以用 load + store 而不是 fetch_add，
+// 避免在熱路徑上多一個 lock 指令；其他線程可以隨時讀取
+struct IoCounters {
+  std::atomic<uint64_t> syscalls{0};   // accept/recv/send/epoll_wait 等
+  std::atomic<uint64_t> broadcasts{0}; // 分派的廣播訊息數
+
+  void add_syscalls(uint64_t n = 1) { bump(syscalls, n); }
+  void add_broadcasts(uint64_t n = 1) { bump(broadcasts, n); }
+
+private:
+  static void bump(std::atomic<uint64_t> &counter, uint64_t n) {
+    counter.store(counter.load(std::memory_order_relaxed) + n,
+                  std::memory_order_relaxed);
+  }
+};
+
+} // namespace emb
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+namespace emb {
+
+// 每個 symbol 最新一則 frame 的快取，給最新值模式 (conflated) 的連線使用
+//
+// 單一寫入者 (分派廣播的 reactor)、多個讀取者 (所有 reactor)，每個 slot
+// 以 seqlock 保護：寫入前後各把 version 加一 (寫入中為奇數)，讀取者複製內容
+// 之後 version 沒變才算成功。資料以 relaxed atomic 逐字複製，不會有 data race
+class LatestValueCache {
+public:
+  static constexpr size_t MAX_VALUE_SIZE = 64;
+
+  explicit LatestValueCache(size_t symbols)
+      : slots_(std::make_unique<Slot[]>(symbols)), size_(symbols) {}
+
+  LatestValueCache(const LatestValueCache &) = delete;
+  LatestValueCache &operator=(const LatestValueCache &) = delete;
+
+  size_t size() const { return size_; }
+
+  // 只有一個線程可以呼叫；symbol 超出範圍或 len 太大時回傳 false
+  bool update(uint32_t symbol, const char *data, size_t len) {
+    if (symbol >= size_ || len > MAX_VALUE_SIZE) {
+      return false;
+    }
+    Slot &slot = slots_[symbol];
+    uint64_t words[WORDS] = {};
+    std::memcpy(words, data, len);
+
+    const uint64_t version = slot.version.load(std::memory_order_relaxed);
+    slot.version.store(version + 1, std::memory_order_relaxed);
+    // 讓奇數 version 先於資料被看到
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < WORDS; ++i) {
+      slot.words[i].store(words[i], std::memory_order_relaxed);
+    }
+    slot.length.store(static_cast<uint32_t>(len), std::memory_order_relaxed);
+    slot.version.store(version + 2, std::memory_order_release);
+    return true;
+  }
+
+  // 任何線程都可以呼叫；out 至少 MAX_VALUE_SIZE bytes，
+  // 回傳內容長度，還沒有值時回傳 0
+  size_t read(uint32_t symbol, char *out) const {
+    if (symbol >= size_) {
+      return 0;
+    }
+    const Slot &slot = slots_[symbol];
+    uint64_t words[WORDS];
+    uint32_t length;
+    uint64_t before;
+    uint64_t after;
+    do {
+      before = slot.version.load(std::memory_order_acquire);
+      if (before & 1) {
+        continue; // 寫入中
+      }
+      for (size_t i = 0; i < WORDS; ++i) {
+        words[i] = slot.words[i].load(std::memory_order_relaxed);
+      }
+      length = slot.length.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      after = slot.version.load(std::memory_order_relaxed);
+    } while ((before & 1) || before != after);
+
+    if (before == 0) {
+      return 0;
+    }
+    std::memcpy(out, words, length);
+    return length;
+  }
+
+private:
+  static constexpr size_t WORDS = MAX_VALUE_SIZE / sizeof(uint64_t);
+
+  // 各自一條 cache line 起頭，避免相鄰 symbol 的寫入互相干擾
+  struct alignas(64) Slot {
+    std::atomic<uint64_t> version{0};
+    std::atomic<uint32_t> length{0};
+    std::atomic<uint64_t> words[WORDS] = {};
+  };
+
+  std::unique_ptr<Slot[]> slots_;
+  size_t size_;
+};
+
+} // namespace emb
@@ -3,6 +3,7 @@
 #include <atomic>
 #include <cstddef>
 #include <optional>
+#include <utility>
 
 namespace emb {
 
@@ -34,7 +35,7 @@ public:
       return std::nullopt;
     }
 
-    T item = buffer_[current_head];
+    T item = std::move(buffer_[current_head]);
     head_.store((current_head + 1) % Capacity, std::memory_order_release);
     return item;
   }
@@ -0,0 +1,92 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace emb {
+
+// Vyukov bounded MPMC queue
+// 每個 slot 都有自己的 sequence，生產者與消費者只需要 CAS 搶 index，
+// 搶到之後該 slot 就由自己獨佔，所以多個線程同時 push 也是安全的
+template <typename T, std::size_t Capacity> class MPMCQueue {
+  static_assert((Capacity & (Capacity - 1)) == 0 && Capacity > 0,
+                "Capacity must be power of 2");
+
+public:
+  MPMCQueue() {
+    for (std::size_t i = 0; i < Capacity; ++i) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MPMCQueue(const MPMCQueue &) = delete;
+  MPMCQueue &operator=(const MPMCQueue &) = delete;
+
+  template <typename U> bool push(U &&item) {
+    std::size_t pos = tail_.load(std::memory_order_relaxed);
+    Slot *slot;
+
+    while (true) {
+      slot = &slots_[pos & (Capacity - 1)];
+      // 使用 acquire 是因為要確保讀取到消費者 pop 之前的修改
+      std::size_t seq = slot->sequence.load(std::memory_order_acquire);
+      intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+      if (diff == 0) {
+        if (tail_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false; // full
+      } else {
+        pos = tail_.load(std::memory_order_relaxed); // 被別人搶走了
+      }
+    }
+
+    slot->item = std::forward<U>(item);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  std::optional<T> pop() {
+    std::size_t pos = head_.load(std::memory_order_relaxed);
+    Slot *slot;
+
+    while (true) {
+      slot = &slots_[pos & (Capacity - 1)];
+      std::size_t seq = slot->sequence.load(std::memory_order_acquire);
+      intptr_t diff =
+          static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+
+      if (diff == 0) {
+        if (head_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return std::nullopt; // empty
+      } else {
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+
+    T item = std::move(slot->item);
+    slot->sequence.store(pos + Capacity, std::memory_order_release);
+    return item;
+  }
+
+private:
+  // 每個 slot 放在獨立的 cache line，避免相鄰 slot 互相 false sharing
+  struct alignas(64) Slot {
+    std::atomic<std::size_t> sequence;
+    T item;
+  };
+
+  std::array<Slot, Capacity> slots_;
+  alignas(64) std::atomic<std::size_t> head_{0};
+  alignas(64) std::atomic<std::size_t> tail_{0};
+};
+} // namespace emb
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "payload_pool.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <sys/uio.h>
+#include <vector>
+
+namespace emb {
+
+// 每個連線的待送訊息 ring，容量以 bytes 與訊息數量雙重限制
+//
+// 每個 entry 只是共用 payload 的參考與已送出的 offset，不複製內容；
+// payload 完整送出後 entry 被移除，參考計數隨之釋放。
+// 丟棄時以整則訊息為單位，已經送出一部分的第一則訊息永遠不會被丟棄，
+// 避免 client 收到破碎的訊息
+class OutboundRing {
+public:
+  // max_messages 會向上取整到 2 的冪次
+  OutboundRing(size_t max_bytes, size_t max_messages);
+
+  // offset 為這則訊息已經送出的 bytes 數 (直接送出一部分後才放入時)
+  bool push(const PayloadRef &payload, size_t offset = 0);
+
+  // 以最多 max_iov 段 iovec 描述待送的資料 (每則訊息一段)，回傳段數
+  int peek(iovec *iov, int max_iov) const;
+
+  // 標記 n bytes 已經送出；retain 不為 nullptr 時，這 n bytes 涉及的每則
+  // payload (包含只送出一部分的) 都會多留一份參考在 retain 中
+  void consume(size_t n, std::vector<PayloadRef> *retain = nullptr);
+
+  // 從最舊的未送訊息開始丟棄，直到空間足以放下 needed bytes 且
+  // 至少空出一個 entry，回傳丟棄數
+  size_t drop_oldest(size_t needed);
+
+  // 丟棄所有尚未開始送出的訊息，回傳丟棄數
+  size_t drop_unsent();
+
+  bool empty() const { return count_ == 0; }
+  size_t size() const { return bytes_; }
+  size_t free_space() const { return max_bytes_ - bytes_; }
+  size_t capacity() const { return max_bytes_; }
+  size_t messages() const { return count_; }
+
+private:
+  struct Entry {
+    PayloadRef payload;
+    size_t offset = 0;
+  };
+
+  Entry &at(size_t i) { return entries_[(head_ + i) & mask_]; }
+  const Entry &at(size_t i) const { return entries_[(head_ + i) & mask_]; }
+
+  // 第一則訊息是否已經送出一部分 (不可丟棄)
+  bool front_started() const { return count_ > 0 && at(0).offset > 0; }
+
+  // 移除第 first 則開始的 count 則訊息，後面的 entry 往前搬
+  void erase_messages(size_t first, size_t count);
+
+  std::vector<Entry> entries_;
+  size_t mask_;
+  size_t head_ = 0;
+  size_t count_ = 0;
+  size_t bytes_ = 0; // 尚未送出的 bytes
+  size_t max_bytes_;
+};
+
+} // namespace emb
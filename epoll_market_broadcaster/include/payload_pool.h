@@ -0,0 +1,153 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace emb {
+
+class PayloadPool;
+
+// payload 內容的格式，決定要送給哪些連線
+enum class PayloadFormat : uint8_t {
+  Raw,    // 原樣送給文字格式的連線
+  Binary, // protocol.h 的 frame，文字連線收到的是轉換後的文字
+};
+
+// 廣播用的不可變訊息 buffer，由 PayloadPool 配置
+//
+// 生產者寫入內容後發布，之後只讀；同一份 payload 被所有客戶端的
+// outbound queue 共用，最後一個 PayloadRef 釋放時自動歸還 pool
+class Payload {
+public:
+  const char *data() const { return data_; }
+  size_t size() const { return size_; }
+
+  // 只能在發布前 (只有一個 PayloadRef 時) 寫入
+  char *mutable_data() { return data_; }
+  size_t capacity() const { return capacity_; }
+  void set_size(size_t size) { size_ = static_cast<uint32_t>(size); }
+
+  PayloadFormat format() const { return format_; }
+  void set_format(PayloadFormat format) { format_ = format; }
+
+private:
+  friend class PayloadPool;
+  friend class PayloadRef;
+
+  PayloadPool *pool_ = nullptr;
+  std::atomic<uint32_t> refs_{0};
+  uint32_t size_ = 0;
+  uint32_t capacity_ = 0;
+  PayloadFormat format_ = PayloadFormat::Raw;
+  char *data_ = nullptr;
+};
+
+// Payload 的參考計數 handle，複製時 +1，解構時 -1
+class PayloadRef {
+public:
+  PayloadRef() = default;
+  explicit PayloadRef(Payload *payload) : payload_(payload) {}
+  ~PayloadRef() { reset(); }
+
+  PayloadRef(const PayloadRef &other) : payload_(other.payload_) {
+    if (payload_) {
+      payload_->refs_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  PayloadRef &operator=(const PayloadRef &other) {
+    PayloadRef(other).swap(*this);
+    return *this;
+  }
+
+  PayloadRef(PayloadRef &&other) noexcept
+      : payload_(std::exchange(other.payload_, nullptr)) {}
+
+  PayloadRef &operator=(PayloadRef &&other) noexcept {
+    PayloadRef(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  void swap(PayloadRef &other) noexcept { std::swap(payload_, other.payload_); }
+
+  inline void reset();
+
+  explicit operator bool() const { return payload_ != nullptr; }
+  Payload *get() const { return payload_; }
+  Payload *operator->() const { return payload_; }
+
+  const char *data() const { return payload_->data(); }
+  size_t size() const { return payload_->size(); }
+
+  uint32_t use_count() const {
+    return payload_ ? payload_->refs_.load(std::memory_order_relaxed) : 0;
+  }
+
+private:
+  Payload *payload_ = nullptr;
+};
+
+// 固定數量、固定大小的 payload pool
+//
+// 所有 buffer 在建構時一次配置，數量由 server 依設定決定；
+// free list 為以 index 串起的 lock-free stack (head 帶版本號避免 ABA)，
+// 生產者線程取用、event loop 線程歸還都不需要鎖，剛歸還的 buffer 最先被取用
+class PayloadPool {
+public:
+  static constexpr size_t DEFAULT_CAPACITY = 16384;
+  static constexpr size_t DEFAULT_SLOT_SIZE = 256;
+
+  // capacity 必須介於 1 與 2^32 - 2 之間，否則丟出 std::invalid_argument
+  explicit PayloadPool(size_t slot_size = DEFAULT_SLOT_SIZE,
+                       size_t capacity = DEFAULT_CAPACITY);
+
+  PayloadPool(const PayloadPool &) = delete;
+  PayloadPool &operator=(const PayloadPool &) = delete;
+
+  // 取得一個空的 payload，pool 用完時回傳空的 PayloadRef
+  PayloadRef acquire();
+
+  // 取得 payload 並複製 data，超過 slot_size 或 pool 用完時回傳空的 PayloadRef
+  PayloadRef make(const char *data, size_t len);
+
+  size_t slot_size() const { return slot_size_; }
+  size_t capacity() const { return capacity_; }
+  // 所有 payload 共用的連續記憶體，可整塊註冊為 io_uring fixed buffer
+  char *storage() const { return storage_.get(); }
+  size_t storage_size() const { return capacity_ * slot_size_; }
+  size_t available() const {
+    return available_.load(std::memory_order_relaxed);
+  }
+
+private:
+  friend class PayloadRef;
+  void release(Payload *payload);
+
+  static constexpr uint32_t NO_INDEX = UINT32_MAX;
+
+  size_t slot_size_;
+  size_t capacity_;
+  std::unique_ptr<Payload[]> payloads_;
+  std::unique_ptr<char[]> storage_;
+  // next_[i] 為 free list 中 payload i 的下一個
+  std::unique_ptr<std::atomic<uint32_t>[]> next_;
+  // 高 32 bits 為版本號 (每次修改 +1)，低 32 bits 為 stack 頂端的 index
+  alignas(64) std::atomic<uint64_t> head_{NO_INDEX};
+  std::atomic<size_t> available_{0};
+};
+
+inline void PayloadRef::reset() {
+  if (payload_ == nullptr) {
+    return;
+  }
+  // acq_rel：確保其他持有者的讀取都發生在歸還之前
+  if (payload_->refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    payload_->pool_->release(payload_);
+  }
+  payload_ = nullptr;
+}
+
+} // namespace emb
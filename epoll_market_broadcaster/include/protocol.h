@@ -0,0 +1,239 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// server 與 client 共用的二進位行情協定
+//
+// 每個 frame 固定長度、little-endian，開頭是 FrameHeader (含整個 frame 的長度)，
+// 所以在 byte stream 中可以直接切出 frame，不需要掃描分隔字元。
+// 欄位都放在自然對齊的位置，編碼與解碼都只是一次 memcpy。
+//
+// 協商：連線建立後預設為文字格式 (SEQ|SYMBOL|PRICE|VOLUME\n)；
+// client 送出 "PROTO BINARY\n"，server 回覆 "OK BINARY\n" 之後的資料全部是 frame
+namespace emb::protocol {
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
+              "wire format is little-endian; add byte swapping for this host");
+
+constexpr uint8_t VERSION = 1;
+
+// 價格以 1/10000 為單位的定點數
+constexpr int64_t PRICE_SCALE = 10000;
+
+constexpr const char *BINARY_REQUEST = "PROTO BINARY";
+constexpr const char *TEXT_REQUEST = "PROTO TEXT";
+constexpr const char *BINARY_ACK = "OK BINARY\n";
+constexpr const char *TEXT_ACK = "OK TEXT\n";
+
+enum class MessageType : uint8_t {
+  Quote = 'Q',
+  Trade = 'T',
+  SnapshotEnd = 'E',
+};
+
+enum class Side : uint8_t {
+  Buy = 'B',
+  Sell = 'S',
+};
+
+struct FrameHeader {
+  uint16_t length; // 整個 frame 的 bytes 數，包含 header
+  MessageType type;
+  uint8_t version;
+};
+
+struct QuoteFrame {
+  FrameHeader header;
+  uint32_t symbol_id;
+  uint64_t seq;          // server 分派時填入，所有廣播共用一個遞增序列
+  uint64_t send_time_ns; // 發布時間 (CLOCK_REALTIME)
+  int64_t price;         // 定點數，見 PRICE_SCALE
+  uint32_t volume;
+  uint32_t reserved;
+};
+
+struct TradeFrame {
+  FrameHeader header;
+  uint32_t symbol_id;
+  uint64_t seq;
+  uint64_t send_time_ns;
+  int64_t price;
+  uint32_t quantity;
+  Side side;
+  uint8_t reserved[3];
+};
+
+// 快照結束：之前收到的是截至 resume_seq - 1 的完整狀態，
+// 之後是 seq 從 resume_seq 開始遞增的即時資料
+struct SnapshotEndFrame {
+  FrameHeader header;
+  uint32_t reserved;
+  uint64_t resume_seq;
+};
+
+static_assert(sizeof(FrameHeader) == 4);
+static_assert(sizeof(QuoteFrame) == 40);
+static_assert(sizeof(TradeFrame) == 40);
+static_assert(sizeof(SnapshotEndFrame) == 16);
+static_assert(std::is_trivially_copyable_v<QuoteFrame> &&
+              std::is_trivially_copyable_v<TradeFrame> &&
+              std::is_trivially_copyable_v<SnapshotEndFrame>);
+static_assert(offsetof(QuoteFrame, symbol_id) ==
+                  offsetof(TradeFrame, symbol_id) &&
+              offsetof(QuoteFrame, seq) == offsetof(TradeFrame, seq));
+
+constexpr size_t MAX_FRAME_SIZE = 256;
+
+// decode() 遇到不合法的 length 時回傳
+constexpr size_t DECODE_ERROR = static_cast<size_t>(-1);
+
+// 沒有 symbol 的訊息 (原始字串、不認得的 frame)
+constexpr uint32_t NO_SYMBOL = UINT32_MAX;
+
+// 訂閱指令，symbol 之間以空白或逗號分隔，"*" 代表全部
+constexpr const char *SUBSCRIBE = "SUB";
+constexpr const char *UNSUBSCRIBE = "UNSUB";
+
+// 回補：SNAPSHOT 先送每個 symbol 的最新值，以 SnapshotEndFrame 結尾再接即時資料；
+// "REPLAY <seq>" 從 seq 開始重送 (已經不在重送 ring 中時改為 SNAPSHOT)
+constexpr const char *SNAPSHOT_REQUEST = "SNAPSHOT";
+constexpr const char *REPLAY_REQUEST = "REPLAY";
+
+// 傳送模式：CONFLATED 在落後時只收各 symbol 的最新值，STREAM 收每一則
+constexpr const char *CONFLATED_REQUEST = "MODE CONFLATED";
+constexpr const char *STREAM_REQUEST = "MODE STREAM";
+
+inline int64_t to_fixed(double price) {
+  return static_cast<int64_t>(price * PRICE_SCALE + (price < 0 ? -0.5 : 0.5));
+}
+
+inline double from_fixed(int64_t price) {
+  return static_cast<double>(price) / PRICE_SCALE;
+}
+
+inline QuoteFrame make_quote(uint32_t symbol_id, uint64_t seq,
+                             uint64_t send_time_ns, int64_t price,
+                             uint32_t volume) {
+  QuoteFrame frame{};
+  frame.header = {sizeof(QuoteFrame), MessageType::Quote, VERSION};
+  frame.symbol_id = symbol_id;
+  frame.seq = seq;
+  frame.send_time_ns = send_time_ns;
+  frame.price = price;
+  frame.volume = volume;
+  return frame;
+}
+
+inline TradeFrame make_trade(uint32_t symbol_id, uint64_t seq,
+                             uint64_t send_time_ns, int64_t price,
+                             uint32_t quantity, Side side) {
+  TradeFrame frame{};
+  frame.header = {sizeof(TradeFrame), MessageType::Trade, VERSION};
+  frame.symbol_id = symbol_id;
+  frame.seq = seq;
+  frame.send_time_ns = send_time_ns;
+  frame.price = price;
+  frame.quantity = quantity;
+  frame.side = side;
+  return frame;
+}
+
+inline SnapshotEndFrame make_snapshot_end(uint64_t resume_seq) {
+  SnapshotEndFrame frame{};
+  frame.header = {sizeof(SnapshotEndFrame), MessageType::SnapshotEnd, VERSION};
+  frame.resume_seq = resume_seq;
+  return frame;
+}
+
+// quote 與 trade 的 symbol_id 位置相同，直接從 header 之後讀出
+inline uint32_t symbol_of(const char *frame, size_t len) {
+  if (len < sizeof(FrameHeader) + sizeof(uint32_t)) {
+    return NO_SYMBOL;
+  }
+  FrameHeader header;
+  std::memcpy(&header, frame, sizeof(header));
+  if (header.type != MessageType::Quote && header.type != MessageType::Trade) {
+    return NO_SYMBOL;
+  }
+  uint32_t id;
+  std::memcpy(&id, frame + offsetof(QuoteFrame, symbol_id), sizeof(id));
+  return id;
+}
+
+// frame 的 seq，不是 quote 或 trade 時回傳 0
+inline uint64_t seq_of(const char *frame, size_t len) {
+  if (symbol_of(frame, len) == NO_SYMBOL || len < sizeof(QuoteFrame)) {
+    return 0;
+  }
+  uint64_t seq;
+  std::memcpy(&seq, frame + offsetof(QuoteFrame, seq), sizeof(seq));
+  return seq;
+}
+
+// 改寫 frame 的 seq (quote 與 trade 位置相同)，不是這兩種 frame 時回傳 false
+inline bool set_seq(char *frame, size_t len, uint64_t seq) {
+  if (symbol_of(frame, len) == NO_SYMBOL || len < sizeof(QuoteFrame)) {
+    return false;
+  }
+  std::memcpy(frame + offsetof(QuoteFrame, seq), &seq, sizeof(seq));
+  return true;
+}
+
+// 編碼：out 至少要有 sizeof(Frame) bytes，回傳寫入的 bytes 數
+template <typename Frame> size_t encode(const Frame &frame, char *out) {
+  std::memcpy(out, &frame, sizeof(frame));
+  return sizeof(frame);
+}
+
+// 從 byte stream 中解出所有完整的 frame，依型別呼叫
+// handler.on_quote(const QuoteFrame &) / handler.on_trade(const TradeFrame &) /
+// handler.on_snapshot_end(const SnapshotEndFrame &)；
+// 不認得的型別依 length 跳過。回傳用掉的 bytes 數 (結尾不完整的 frame 留給
+// 下一次)，length 不合法時回傳 DECODE_ERROR
+template <typename Handler>
+size_t decode(const char *data, size_t len, Handler &&handler) {
+  size_t pos = 0;
+  while (len - pos >= sizeof(FrameHeader)) {
+    FrameHeader header;
+    std::memcpy(&header, data + pos, sizeof(header));
+    if (header.length < sizeof(FrameHeader) ||
+        header.length > MAX_FRAME_SIZE) {
+      return DECODE_ERROR;
+    }
+    if (len - pos < header.length) {
+      break;
+    }
+
+    if (header.type == MessageType::Quote &&
+        header.length >= sizeof(QuoteFrame)) {
+      QuoteFrame frame;
+      std::memcpy(&frame, data + pos, sizeof(frame));
+      handler.on_quote(frame);
+    } else if (header.type == MessageType::Trade &&
+               header.length >= sizeof(TradeFrame)) {
+      TradeFrame frame;
+      std::memcpy(&frame, data + pos, sizeof(frame));
+      handler.on_trade(frame);
+    } else if (header.type == MessageType::SnapshotEnd &&
+               header.length >= sizeof(SnapshotEndFrame)) {
+      SnapshotEndFrame frame;
+      std::memcpy(&frame, data + pos, sizeof(frame));
+      handler.on_snapshot_end(frame);
+    }
+    pos += header.length;
+  }
+  return pos;
+}
+
+// 把 frame 轉成文字格式 (給沒有協商二進位的 client)，quote/trade 開頭是 seq，
+// symbols[id] 為代號，查不到時輸出數字 id。回傳寫入的 bytes 數，frame 不認得或空間不足時回傳 0
+size_t format_text(const char *frame, size_t len,
+                   const std::vector<std::string> &symbols, char *out,
+                   size_t capacity);
+
+} // namespace emb::protocol
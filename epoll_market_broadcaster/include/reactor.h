@@ -0,0 +1,174 @@
+#pragma once
+
+#include "connect.h"
+#include "fanout_batch.h"
+#include "io_counters.h"
+#include "latest_value_cache.h"
+#include "lockfree_queue.h"
+#include "payload_pool.h"
+#include "retransmit_ring.h"
+#include "subscription_index.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace emb {
+
+struct ServerConfig;
+
+// 單一 epoll 事件循環，負責自己的 listen socket 與一部分連線
+//
+// 多個 reactor 時各自以 SO_REUSEPORT bind 同一個 port，由 kernel 分配新連線；
+// 廣播的 payload 經由每個 reactor 自己的 SPSC inbox 送進來，
+// reactor 之間不共享任何連線狀態
+class Reactor {
+public:
+  static constexpr size_t INBOX_CAPACITY = 4096;
+  // 每次從 inbox 取出、合併成一個 sendmsg 的最大訊息數
+  static constexpr size_t MAX_BATCH = 64;
+
+  // pool 用於協商回覆與轉成文字的 payload，latest 為最新值模式的快取，
+  // 兩者都必須比 reactor 晚解構
+  Reactor(size_t id, const ServerConfig &config, PayloadPool &pool,
+          const LatestValueCache &latest);
+  ~Reactor();
+
+  Reactor(const Reactor &) = delete;
+  Reactor &operator=(const Reactor &) = delete;
+
+  // 執行事件循環直到 running 變為 false
+  void run(const std::atomic<bool> &running);
+
+  // 每輪事件循環都會呼叫 (只給負責分派廣播的 reactor 使用)，
+  // 回傳是否處理了任何工作；有工作時 reactor 不會進入睡眠
+  void set_dispatcher(std::function<bool()> dispatcher) {
+    dispatcher_ = std::move(dispatcher);
+  }
+
+  // 由分派線程 (唯一的生產者) 呼叫，inbox 滿時回傳 false
+  bool post(PayloadRef payload);
+
+  // 放入工作之後呼叫：只有在事件循環真的阻塞 (或準備阻塞) 時才寫 eventfd
+  void wake_if_sleeping();
+  void wake();
+
+  size_t id() const { return id_; }
+  size_t connection_count() const {
+    return connection_count_.load(std::memory_order_relaxed);
+  }
+  uint64_t inbox_drops() const {
+    return inbox_drops_.load(std::memory_order_relaxed);
+  }
+  const IoCounters &counters() const { return counters_; }
+
+private:
+  void create_listen_socket(uint16_t port, bool reuse_port);
+  void create_epoll();
+  void set_nonblocking(int fd);
+  void add_to_epoll(int fd, uint32_t events);
+  void modify_epoll(int fd, uint32_t events);
+  void remove_from_epoll(int fd);
+
+  // 處理新的連接
+  void handle_accept();
+  // 處裡連線斷開
+  void handle_close(int fd);
+  // 處理可讀
+  void handle_read(int fd);
+  // 處理可寫：送出 outbound ring 中的待送資料
+  void handle_write(int fd);
+  // 處理 EPOLLERR：MSG_ZEROCOPY 的完成通知回傳 true，其餘錯誤關閉連線
+  bool handle_error(int fd);
+  // 處理 client 送來的一行文字 (格式協商、訂閱與傳送模式)，
+  // 連線被關閉時回傳 false
+  bool handle_message(Connection &conn, const std::string &msg);
+  void switch_format(Connection &conn, WireFormat format);
+
+  // 最新值模式：outbound ring 送完之後送出有更新的 symbol 的最新值，
+  // 應該斷線時回傳 false
+  bool send_latest(Connection &conn);
+
+  // SNAPSHOT / REPLAY：先送快照或重送 ring 中的 frame，追上之後才收即時資料；
+  // 每次只在 outbound ring 送完時補送一批，不會讓 ring 塞滿
+  struct Recovery;
+  void start_recovery(Connection &conn, const std::string &msg);
+  void begin_snapshot(Recovery &recovery) const;
+  bool pump_recovery(Connection &conn);
+  // 新的 frame 進入重送 ring 之後，讓回補中且 outbound ring 已送完的連線繼續
+  void pump_recoveries(std::vector<int> &to_close);
+
+  // 把 frame 轉成連線的格式放進新的 payload，pool 用完時回傳空的 PayloadRef
+  PayloadRef frame_payload(const Connection &conn, const char *frame,
+                           size_t len);
+  // 同上，但同一則 frame (以 seq 識別) 在所有回補中的連線之間共用一個 payload
+  PayloadRef shared_frame_payload(const Connection &conn, const char *frame,
+                                  size_t len);
+  // 沒有連線在回補時放掉共用的 payload
+  void release_shared_frames();
+  // 送出並釋放 payloads，應該斷線時回傳 false
+  bool send_chunk(Connection &conn, PayloadRef *payloads, size_t count);
+
+  // 只在有待送資料時註冊 EPOLLOUT，避免 ET 下無意義的喚醒
+  void update_write_interest(Connection &conn);
+
+  // 依 config 把目前的線程綁到指定 CPU
+  void pin_thread();
+  // 跑一次 dispatcher 並清空 inbox，回傳是否處理了任何工作
+  bool poll_queues();
+  void drain_wake_fd();
+
+  // 一批訊息只送給有訂閱的連線，每個連線只做一次 sendmsg
+  void broadcast(const PayloadRef *payloads, size_t count);
+  bool process_inbox();
+
+  size_t id_;
+  const ServerConfig &config_;
+  int listen_fd_{-1};
+  int epoll_fd_{-1};
+  int wake_fd_{-1}; // eventfd
+
+  PayloadPool &pool_;
+  const LatestValueCache &latest_;
+  std::unordered_map<int, Connection> connections_;
+  std::atomic<size_t> connection_count_{0};
+  size_t binary_connections_ = 0;
+  FanoutBatch batch_;
+  SubscriptionIndex subscriptions_; // 以 fd 為訂閱者 id
+
+  // 快照的截止點 cut_seq：快照 (最新值加上重送 ring 中 seq <= cut_seq、
+  // 比該 symbol 快照值新的 frame) 送完後送出 SnapshotEndFrame(cut_seq + 1)，
+  // 之後的 frame seq 都大於 cut_seq 且依序送出
+  struct Recovery {
+    bool snapshot = false;
+    bool end_pending = false; // 還沒送出 SnapshotEndFrame
+    uint32_t next_symbol = 0; // 快照送到哪個 symbol
+    uint64_t position = 0;    // 快照之後從重送 ring 的哪個位置接著送
+    uint64_t cut_seq = 0;
+    std::vector<uint64_t> snapshot_seqs; // 每個 symbol 快照值的 seq
+  };
+  RetransmitRing retransmit_;
+  std::unordered_map<int, Recovery> recoveries_;
+
+  // 回補送出的 frame 依 seq 直接映射：大量連線同時重連回補時，
+  // 每則 frame 每種格式只佔用一個 pool slot，最多佔用 2 * SHARED_FRAMES 個
+  struct SharedFrame {
+    uint64_t seq = 0;
+    PayloadRef binary;
+    PayloadRef text;
+  };
+  static constexpr size_t SHARED_FRAMES = 256;
+  std::array<SharedFrame, SHARED_FRAMES> shared_frames_;
+
+  LockFreeQueue<PayloadRef, INBOX_CAPACITY> inbox_;
+  std::atomic<uint64_t> inbox_drops_{0};
+  IoCounters counters_;
+  std::atomic<bool> sleeping_{false};
+  std::function<bool()> dispatcher_;
+};
+
+} // namespace emb
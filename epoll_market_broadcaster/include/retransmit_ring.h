@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace emb {
+
+// 最近廣播過的 frame 的重送 ring，每個 reactor 一份 (只給單一線程使用)
+//
+// 每則 frame 複製到固定大小的 slot，不佔用 payload pool；
+// 位置 (position) 從 0 開始遞增、永不重複，ring 保留 [begin(), end()) 這一段，
+// 寫滿之後覆蓋最舊的。seq 單調遞增但可能不連續 (inbox 滿時會漏掉)，
+// 以 lower_bound() 從 seq 找到位置
+class RetransmitRing {
+public:
+  // 能放進 slot 的最大 frame (protocol.h 的 frame 都是 40 bytes)
+  static constexpr size_t MAX_FRAME_SIZE = 48;
+
+  struct Entry {
+    uint64_t seq;
+    uint32_t symbol;
+    uint32_t length;
+    char data[MAX_FRAME_SIZE];
+  };
+  static_assert(sizeof(Entry) == 64);
+
+  // capacity 會向上取整到 2 的冪次
+  explicit RetransmitRing(size_t capacity);
+
+  // seq 必須比之前的都大；frame 太大時不保留並回傳 false
+  bool push(uint64_t seq, uint32_t symbol, const char *data, size_t len);
+
+  uint64_t begin() const { return end_ - size_; }
+  uint64_t end() const { return end_; }
+  bool empty() const { return size_ == 0; }
+
+  // pos 必須在 [begin(), end()) 之間
+  const Entry &at(uint64_t pos) const { return entries_[pos & mask_]; }
+
+  // 第一個 seq >= seq 的位置，沒有時回傳 end()
+  uint64_t lower_bound(uint64_t seq) const;
+
+private:
+  std::vector<Entry> entries_;
+  uint64_t mask_;
+  uint64_t end_ = 0;
+  uint64_t size_ = 0;
+};
+
+} // namespace emb
@@ -1,50 +1,55 @@
 #pragma once
 
-#include "connect.h"
-#include "lockfree_queue.h"
+#include "broadcast_server.h"
+#include "latest_value_cache.h"
+#include "mpmc_queue.h"
+#include "payload_pool.h"
+#include "reactor.h"
 
 #include <atomic>
 #include <cstdint>
+#include <memory>
 #include <string>
-#include <unordered_map>
+#include <vector>
 
 namespace emb {
 
-class EpollServer {
+class EpollServer : public BroadcastServer {
 public:
   explicit EpollServer(uint16_t port);
-  ~EpollServer();
+  explicit EpollServer(const ServerConfig &config);
+  ~EpollServer() override;
 
   EpollServer(const EpollServer &) = delete;
   EpollServer &operator=(const EpollServer &) = delete;
 
-  void run();
-  void stop();
+  // reactor 0 在呼叫的線程上執行，其餘各自一個線程；stop() 之後才返回
+  void run() override;
+  void stop() override;
 
-  bool enqueue_broadcast(const std::string &data);
+  bool enqueue_broadcast(const std::string &data) override;
+  PayloadRef acquire_payload() override { return payload_pool_->acquire(); }
+  bool enqueue_broadcast(PayloadRef payload) override;
+
+  ServerStats stats() const override;
+  size_t connection_count() const;
+  // 因為 reactor inbox 滿而沒有送到該 reactor 的廣播數
+  uint64_t inbox_drops() const;
 
 private:
-  int listen_fd_{-1};
-  int epoll_fd_{-1};
+  // 由 reactor 0 呼叫：把 broadcast_queue_ 中的 payload 分派到每個 reactor
+  bool dispatch_broadcasts();
+
+  ServerConfig config_;
   std::atomic<bool> running_{false};
-  std::unordered_map<int, Connection> connections_;
-  emb::LockFreeQueue<std::string, 1024> broadcast_queue;
-
-  void create_listen_socket(uint16_t port);
-  void create_epoll();
-  void set_nonblocking(int fd);
-  void add_to_epoll(int fd, uint32_t events);
-  void remove_from_epoll(int fd);
-
-  // 處理新的連接
-  void handle_accept();
-  // 處裡連線斷開
-  void handle_close(int fd);
-  // 處理可讀
-  void handle_read(int fd);
-
-  void broadcast(const std::string &data);
-  void process_broadcast_queue();
+  // pool 必須比持有 PayloadRef 的 queue 與 reactors_ 晚解構
+  std::unique_ptr<PayloadPool> payload_pool_;
+  std::unique_ptr<MPMCQueue<PayloadRef, 1024>> broadcast_queue_;
+  // 各 symbol 的最新值，由 reactor 0 寫入、所有 reactor 讀取
+  std::unique_ptr<LatestValueCache> latest_;
+  std::vector<std::unique_ptr<Reactor>> reactors_;
+  IoCounters counters_; // 只記錄 broadcasts，由 reactor 0 寫入
+  uint64_t last_seq_ = 0; // 最後一個分派的 frame seq，只有 reactor 0 使用
 };
 
 } // namespace emb
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace emb {
+
+// symbol → 訂閱者的索引，每個事件循環一份 (只給單一線程使用)
+//
+// 訂閱者以小整數 id 表示 (epoll 為 fd，io_uring 為連線 slot)。
+// 每個 symbol 一個訂閱者 id 的緊密 vector，分派一則訊息只走訪真正訂閱的連線；
+// 新連線預設訂閱全部 (與加入訂閱功能前的行為相同)，送出第一個 SUB 之後
+// 只收指定的 symbol
+class SubscriptionIndex {
+public:
+  // 一次 route() 最多幾則訊息 (mask 的 bit 數)
+  static constexpr size_t MAX_BATCH = 64;
+
+  enum class CommandResult {
+    NotCommand,    // 不是 SUB/UNSUB
+    Applied,
+    UnknownSymbol, // 部分 symbol 不存在，其餘已套用
+  };
+
+  // 一次 route() 的結果：mask 的第 i bit 代表這個訂閱者要收第 i 則
+  struct Recipient {
+    uint32_t id;
+    uint64_t mask;
+  };
+
+  explicit SubscriptionIndex(const std::vector<std::string> &symbols);
+
+  // 新連線，預設訂閱全部
+  void add(uint32_t id);
+  void remove(uint32_t id);
+
+  // 以下回傳 false 代表 symbol id 不存在
+  bool subscribe(uint32_t id, uint32_t symbol);
+  bool unsubscribe(uint32_t id, uint32_t symbol);
+  void subscribe_all(uint32_t id);
+  void unsubscribe_all(uint32_t id);
+
+  // 解析 "SUB AAPL,GOOG" / "UNSUB *" 並套用到 id
+  CommandResult apply_command(uint32_t id, const std::string &line);
+
+  // 找不到時回傳 protocol::NO_SYMBOL
+  uint32_t find_symbol(const std::string &name) const;
+
+  // symbols[i] 為第 i 則訊息的 symbol，NO_SYMBOL 的訊息送給所有連線；
+  // 回傳每個要收到訊息的訂閱者一筆，內容在下一次呼叫前有效
+  const std::vector<Recipient> &route(const uint32_t *symbols, size_t count);
+
+  // id 是否會收到這個 symbol 的訊息 (NO_SYMBOL 一律為 true)
+  bool wants(uint32_t id, uint32_t symbol) const;
+
+  size_t subscriber_count(uint32_t symbol) const;
+  size_t size() const { return members_.size(); }
+
+private:
+  struct Subscriber {
+    bool active = false;
+    bool all = false;
+    std::vector<uint64_t> bits; // 明確訂閱的 symbol
+  };
+
+  bool has(const Subscriber &sub, uint32_t symbol) const {
+    return (sub.bits[symbol / 64] >> (symbol % 64)) & 1;
+  }
+  void set_all(uint32_t id, Subscriber &sub, bool all);
+  void mark(const std::vector<uint32_t> &ids, uint64_t bit);
+
+  static void erase_id(std::vector<uint32_t> &ids, uint32_t id);
+
+  std::unordered_map<std::string, uint32_t> symbol_ids_;
+  std::vector<std::vector<uint32_t>> by_symbol_;
+  std::vector<uint32_t> wildcard_; // 訂閱全部的連線
+  std::vector<uint32_t> members_;  // 所有連線，NO_SYMBOL 的訊息用
+  std::vector<Subscriber> subscribers_;
+
+  // route() 的暫存：masks_ 以 id 為索引，用完即歸零
+  std::vector<uint64_t> masks_;
+  std::vector<Recipient> recipients_;
+};
+
+} // namespace emb
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <linux/io_uring.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <sys/uio.h>
+
+namespace emb {
+
+// 直接以 io_uring_setup/io_uring_enter/io_uring_register syscall 操作的 ring，
+// 不依賴 liburing
+//
+// 只給單一線程使用：取得 SQE、submit 與收割 CQE 都必須在同一個線程
+class IoUring {
+public:
+  // entries 為 SQ 大小，cq_entries 為 0 時使用 kernel 預設 (2 * entries)
+  explicit IoUring(unsigned entries, unsigned cq_entries = 0);
+  ~IoUring();
+
+  IoUring(const IoUring &) = delete;
+  IoUring &operator=(const IoUring &) = delete;
+
+  int fd() const { return ring_fd_; }
+
+  // 取得下一個已清零的 SQE，SQ 滿時回傳 nullptr
+  io_uring_sqe *get_sqe();
+  // 尚未 submit 的 SQE 數量
+  unsigned pending() const { return sqe_tail_ - sqe_head_; }
+  // 還能取得的 SQE 數量
+  unsigned space() const {
+    const unsigned head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+    return sq_entries_ - (sqe_tail_ - head);
+  }
+
+  // 送出所有待送的 SQE，並等待至少 wait_nr 個完成事件；
+  // 回傳送出的 SQE 數量，失敗時回傳 -errno
+  int submit_and_wait(unsigned wait_nr);
+  int submit() { return submit_and_wait(0); }
+
+  // 依序把每個可用的 CQE 交給 f，結束後一次推進 CQ head，回傳處理數量
+  template <typename F> unsigned for_each_cqe(F &&f) {
+    unsigned head = *cq_head_;
+    const unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    unsigned count = 0;
+    for (; head != tail; ++head, ++count) {
+      f(cqes_[head & cq_mask_]);
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    return count;
+  }
+
+  // 以下回傳 0 或 -errno
+  int register_files(const int *fds, unsigned count);
+  int update_file(unsigned slot, int fd);
+  int register_buffers(const iovec *iovs, unsigned count);
+  int register_buf_ring(io_uring_buf_ring *ring, unsigned entries,
+                        uint16_t group_id);
+
+  // 目前為止呼叫 io_uring_enter / io_uring_register 的次數
+  uint64_t syscalls() const {
+    return syscalls_.load(std::memory_order_relaxed);
+  }
+
+private:
+  int do_register(unsigned opcode, const void *arg, unsigned nr_args);
+  void count_syscall() {
+    syscalls_.store(syscalls_.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_relaxed);
+  }
+
+  int ring_fd_{-1};
+
+  void *ring_ptr_{nullptr};
+  size_t ring_size_{0};
+  io_uring_sqe *sqes_{nullptr};
+  size_t sqes_size_{0};
+
+  // SQ
+  unsigned *sq_head_{nullptr};
+  unsigned *sq_tail_{nullptr};
+  unsigned sq_mask_{0};
+  unsigned sq_entries_{0};
+  unsigned sqe_head_{0}; // 已交給 kernel 的位置
+  unsigned sqe_tail_{0}; // 已經取出的 SQE 位置
+
+  // CQ
+  unsigned *cq_head_{nullptr};
+  unsigned *cq_tail_{nullptr};
+  unsigned cq_mask_{0};
+  io_uring_cqe *cqes_{nullptr};
+
+  std::atomic<uint64_t> syscalls_{0};
+};
+
+} // namespace emb
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "broadcast_server.h"
+#include "fanout_batch.h"
+#include "io_counters.h"
+#include "mpmc_queue.h"
+#include "payload_pool.h"
+#include "subscription_index.h"
+#include "uring.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace emb {
+
+// 以 io_uring 實作的單線程廣播 server，對外介面與 EpollServer 相同
+//
+// - accept：一個 multishot accept 持續產生新連線
+// - 讀取：每個連線一個 multishot recv，資料放在 provided buffer ring 中
+// - 廣播：每輪把 broadcast queue 整批分派到有訂閱的連線的待送佇列，
+//   每個連線一次最多送出 MAX_BATCH 則，所有連線的 SQE 一起以一次
+//   io_uring_enter 送出
+// - 開啟 uring_registered_buffers 時，payload pool 註冊為 fixed buffer，
+//   每則訊息一個 SEND_ZC，同一連線的一批以 IOSQE_IO_LINK 串起來保持順序；
+//   否則每批一個 SENDMSG (iovec 每則訊息一段)
+class UringServer : public BroadcastServer {
+public:
+  static constexpr size_t MAX_BATCH = 64;
+
+  explicit UringServer(const ServerConfig &config);
+  ~UringServer() override;
+
+  UringServer(const UringServer &) = delete;
+  UringServer &operator=(const UringServer &) = delete;
+
+  void run() override;
+  void stop() override;
+
+  bool enqueue_broadcast(const std::string &data) override;
+  PayloadRef acquire_payload() override { return payload_pool_->acquire(); }
+  bool enqueue_broadcast(PayloadRef payload) override;
+
+  ServerStats stats() const override;
+
+private:
+  struct Conn;
+
+  // user_data 高 8 bits 為操作種類，低 32 bits 為連線 slot
+  enum class Op : uint8_t { Accept = 1, Recv, Send, Wake };
+
+  static uint64_t make_user_data(Op op, uint32_t slot) {
+    return (static_cast<uint64_t>(op) << 56) | slot;
+  }
+
+  void create_listen_socket(uint16_t port);
+  void setup_buffer_ring();
+  void setup_fixed_buffers();
+
+  io_uring_sqe *get_sqe();
+  void arm_accept();
+  void arm_recv(uint32_t slot);
+  void arm_wake();
+
+  void handle_cqe(const io_uring_cqe &cqe);
+  void handle_accept(const io_uring_cqe &cqe);
+  void handle_recv(uint32_t slot, const io_uring_cqe &cqe);
+  void handle_send(uint32_t slot, const io_uring_cqe &cqe);
+  // 處理 client 送來的一行文字 (格式協商與訂閱)
+  void handle_message(uint32_t slot, const std::string &msg);
+
+  // 把 recv 用完的 buffer 放回 provided buffer ring
+  void recycle_buffer(uint16_t bid);
+
+  bool dispatch_broadcasts();
+  void enqueue_to(Conn &conn, const PayloadRef &payload);
+  void submit_sends();
+  void submit_batch(uint32_t slot, Conn &conn);
+
+  void close_conn(uint32_t slot);
+  // 關閉中的連線在所有操作都完成後才釋放 slot
+  void maybe_release(uint32_t slot);
+
+  ServerConfig config_;
+  int listen_fd_{-1};
+  int wake_fd_{-1};
+  uint64_t wake_value_{0};
+  std::atomic<bool> running_{false};
+  std::atomic<bool> sleeping_{false};
+
+  std::unique_ptr<IoUring> ring_;
+
+  // provided buffer ring
+  io_uring_buf_ring *buf_ring_{nullptr};
+  size_t buf_ring_size_{0};
+  std::unique_ptr<char[]> recv_buffers_;
+  uint16_t buf_ring_tail_{0};
+
+  // pool 必須比持有 PayloadRef 的 queue 與連線晚解構
+  std::unique_ptr<PayloadPool> payload_pool_;
+  std::unique_ptr<MPMCQueue<PayloadRef, 1024>> broadcast_queue_;
+  bool fixed_buffers_{false};
+  FanoutBatch batch_;
+  SubscriptionIndex subscriptions_; // 以連線 slot 為訂閱者 id
+
+  std::vector<Conn> conns_;
+  std::vector<uint32_t> free_slots_;
+  std::vector<uint32_t> open_slots_; // 分派廣播時只走訪開啟中的連線
+  std::vector<uint32_t> send_ready_; // 有待送資料、且沒有送出中的連線
+  std::atomic<size_t> connection_count_{0};
+  size_t binary_conns_{0};
+  uint64_t last_seq_{0}; // 最後一個分派的 frame seq
+
+  IoCounters counters_; // 只記錄 broadcasts，syscall 數由 ring_ 計算
+};
+
+} // namespace emb
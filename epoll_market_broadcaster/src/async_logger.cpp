@@ -0,0 +1,245 @@
+#include "async_logger.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace emb::log {
+
+namespace {
+
+// 累積到這個大小就寫出一次
+constexpr size_t FLUSH_BYTES = 64 * 1024;
+
+struct State {
+  std::mutex mutex; // 保護 rings 與 start()/stop()
+  std::vector<std::unique_ptr<detail::Ring>> rings;
+
+  // start() 在背景線程建立前設定，stop() join 之後才關閉，背景線程不需要拿鎖
+  std::FILE *out = nullptr;
+  bool own_file = false;
+  std::thread backend;
+  std::atomic<bool> stop_requested{false};
+};
+
+State &state() {
+  static State s;
+  return s;
+}
+
+std::mutex sync_mutex; // 同步模式下寫 stderr
+
+const char *level_name(Level level) {
+  switch (level) {
+  case Level::Debug:
+    return "debug";
+  case Level::Info:
+    return "info";
+  case Level::Warn:
+    return "warning";
+  case Level::Error:
+    return "error";
+  case Level::Off:
+    break;
+  }
+  return "off";
+}
+
+// 與 spdlog 預設格式相同：[2024-01-01 09:30:00.123456] [info] ...
+void format_line(fmt::memory_buffer &out, int64_t time_ns, Level level,
+                 std::string_view format, detail::FormatFn format_fn,
+                 const uint8_t *payload) {
+  const time_t sec = static_cast<time_t>(time_ns / 1'000'000'000);
+  const auto micros = static_cast<int>(time_ns % 1'000'000'000 / 1000);
+  tm local;
+  localtime_r(&sec, &local);
+  fmt::format_to(std::back_inserter(out),
+                 "[{:04}-{:02}-{:02} {:02}:{:02}:{:02}.{:06}] [{}] ",
+                 local.tm_year + 1900, local.tm_mon + 1, local.tm_mday,
+                 local.tm_hour, local.tm_min, local.tm_sec, micros,
+                 level_name(level));
+  try {
+    format_fn(out, format, payload);
+  } catch (const fmt::format_error &e) {
+    fmt::format_to(std::back_inserter(out), "<format error: {}> {}", e.what(),
+                   format);
+  }
+  out.push_back('\n');
+}
+
+void flush_buffer(fmt::memory_buffer &buffer, std::FILE *out) {
+  std::fwrite(buffer.data(), 1, buffer.size(), out);
+  buffer.clear();
+}
+
+// 背景線程自己的 ring 清單，只在有新線程登記時才需要拿鎖更新
+struct Drainer {
+  std::vector<detail::Ring *> rings;
+  std::vector<uint64_t> reported_drops; // 每個 ring 上次回報過的丟棄數
+};
+
+// 取出所有 ring 中的訊息並格式化，回傳處理的筆數；
+// 格式化與寫檔都不持有鎖，不會擋住其他線程的第一次 log (register_thread)
+size_t drain(State &s, Drainer &d, fmt::memory_buffer &buffer) {
+  {
+    // ring 只會增加、不會釋放，複製指標之後就可以放開鎖
+    std::lock_guard<std::mutex> lock(s.mutex);
+    for (size_t i = d.rings.size(); i < s.rings.size(); ++i) {
+      d.rings.push_back(s.rings[i].get());
+      d.reported_drops.push_back(0);
+    }
+  }
+
+  size_t drained = 0;
+  for (size_t i = 0; i < d.rings.size(); ++i) {
+    detail::Ring &ring = *d.rings[i];
+    const uint64_t head = ring.head.load(std::memory_order_relaxed);
+    const uint64_t tail = ring.tail.load(std::memory_order_acquire);
+    for (uint64_t pos = head; pos < tail; ++pos) {
+      const detail::Record &r = ring.slots[pos & (detail::Ring::CAPACITY - 1)];
+      format_line(buffer, r.time_ns, r.level,
+                  std::string_view(r.format, r.format_len), r.format_fn,
+                  r.payload);
+      if (buffer.size() >= FLUSH_BYTES) {
+        flush_buffer(buffer, s.out);
+      }
+    }
+    // 格式化完才釋放 slot，寫入端才能覆寫
+    ring.head.store(tail, std::memory_order_release);
+    drained += tail - head;
+
+    const uint64_t drops = ring.dropped.load(std::memory_order_relaxed);
+    if (drops != d.reported_drops[i]) {
+      fmt::format_to(std::back_inserter(buffer),
+                     "[async logger] ring {} full, {} messages dropped\n", i,
+                     drops - d.reported_drops[i]);
+      d.reported_drops[i] = drops;
+    }
+  }
+  flush_buffer(buffer, s.out);
+  return drained;
+}
+
+void backend_loop(int cpu, int idle_sleep_us) {
+  if (cpu >= 0) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (rc != 0) {
+      EMB_LOG_WARN("async logger: failed to pin to CPU {}: {}", cpu,
+                   strerror(rc));
+    }
+  }
+
+  State &s = state();
+  Drainer drainer;
+  fmt::memory_buffer buffer;
+  while (!s.stop_requested.load(std::memory_order_acquire)) {
+    if (drain(s, drainer, buffer) == 0) {
+      std::fflush(s.out);
+      std::this_thread::sleep_for(std::chrono::microseconds(idle_sleep_us));
+    }
+  }
+  drain(s, drainer, buffer);
+  std::fflush(s.out);
+}
+
+} // namespace
+
+void start(const LoggerConfig &config) {
+  State &s = state();
+  std::lock_guard<std::mutex> lock(s.mutex);
+  if (s.backend.joinable()) {
+    throw std::logic_error("async logger already started");
+  }
+
+  if (config.path.empty()) {
+    s.out = stdout;
+    s.own_file = false;
+  } else {
+    s.out = std::fopen(config.path.c_str(), "a");
+    if (s.out == nullptr) {
+      throw std::runtime_error("failed to open log file " + config.path +
+                               ": " + strerror(errno));
+    }
+    s.own_file = true;
+  }
+
+  set_level(config.level);
+  s.stop_requested.store(false, std::memory_order_relaxed);
+  s.backend = std::thread(backend_loop, config.cpu,
+                          std::max(config.idle_sleep_us, 1));
+  detail::g_running.store(true, std::memory_order_release);
+}
+
+void stop() {
+  State &s = state();
+  // 之後的 log 改走同步路徑
+  detail::g_running.store(false, std::memory_order_release);
+  s.stop_requested.store(true, std::memory_order_release);
+  if (s.backend.joinable()) {
+    s.backend.join();
+  }
+
+  std::lock_guard<std::mutex> lock(s.mutex);
+  if (s.own_file && s.out != nullptr) {
+    std::fclose(s.out);
+  }
+  s.out = nullptr;
+  s.own_file = false;
+}
+
+void set_level(Level level) {
+  detail::g_level.store(level, std::memory_order_relaxed);
+}
+
+uint64_t dropped() {
+  State &s = state();
+  std::lock_guard<std::mutex> lock(s.mutex);
+  uint64_t total = 0;
+  for (const auto &ring : s.rings) {
+    total += ring->dropped.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+namespace detail {
+
+Ring *register_thread() {
+  auto ring = std::make_unique<Ring>();
+  Ring *ptr = ring.get();
+  State &s = state();
+  std::lock_guard<std::mutex> lock(s.mutex);
+  // ring 在程式結束前不釋放，線程結束或重新 start() 後指標仍然有效
+  s.rings.push_back(std::move(ring));
+  tls_ring = ptr;
+  return ptr;
+}
+
+void write_sync(Level level, std::string_view format, FormatFn format_fn,
+                const uint8_t *payload) {
+  fmt::memory_buffer buffer;
+  format_line(buffer, now_ns(), level, format, format_fn, payload);
+  std::lock_guard<std::mutex> lock(sync_mutex);
+  std::fwrite(buffer.data(), 1, buffer.size(), stderr);
+}
+
+int64_t now_ns() {
+  timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  return static_cast<int64_t>(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+}
+
+} // namespace detail
+
+} // namespace emb::log
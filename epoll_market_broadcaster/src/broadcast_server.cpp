@@ -0,0 +1,34 @@
+#include "broadcast_server.h"
+#include "server.h"
+#include "uring_server.h"
+
+#include <algorithm>
+
+namespace emb {
+
+namespace {
+
+// 每個事件循環的餘裕：inbox (4096)、回補共用的 frame 與協商回覆等
+constexpr size_t PAYLOAD_POOL_HEADROOM = 8192;
+
+} // namespace
+
+size_t payload_pool_capacity(const ServerConfig &config, size_t event_loops) {
+  if (config.payload_pool_size > 0) {
+    return config.payload_pool_size;
+  }
+  return std::max<size_t>(event_loops, 1) *
+         (2 * config.outbound_messages + PAYLOAD_POOL_HEADROOM);
+}
+
+std::unique_ptr<BroadcastServer> make_server(const ServerConfig &config) {
+  switch (config.backend) {
+  case Backend::IoUring:
+    return std::make_unique<UringServer>(config);
+  case Backend::Epoll:
+    break;
+  }
+  return std::make_unique<EpollServer>(config);
+}
+
+} // namespace emb
@@ -1,17 +1,22 @@
 #include "connect.h"
+#include "async_logger.h"
 
 #include <cerrno>
 #include <cstddef>
 #include <cstring>
+#include <linux/errqueue.h>
+#include <netinet/in.h>
 #include <optional>
-#include <spdlog/spdlog.h>
 #include <sys/socket.h>
 #include <unistd.h>
 #include <utility>
 
 namespace emb {
 
-Connection::Connection(int fd) : fd_{fd} {}
+Connection::Connection(int fd, size_t outbound_capacity,
+                       size_t outbound_messages, IoCounters *counters)
+    : fd_{fd}, outbound_(outbound_capacity, outbound_messages),
+      counters_(counters) {}
 
 Connection::~Connection() {
   if (fd_ != -1) {
@@ -21,7 +26,14 @@ Connection::~Connection() {
 
 Connection::Connection(Connection &&other) noexcept
     : fd_{std::exchange(other.fd_, -1)},
-      read_buffer_(std::move(other.read_buffer_)) {}
+      read_buffer_(std::move(other.read_buffer_)),
+      outbound_(std::move(other.outbound_)), dropped_(other.dropped_),
+      write_armed_(other.write_armed_), wire_format_(other.wire_format_),
+      conflated_(other.conflated_), dirty_(std::move(other.dirty_)),
+      dirty_count_(other.dirty_count_), counters_(other.counters_),
+      zerocopy_threshold_(other.zerocopy_threshold_),
+      zerocopy_seq_(other.zerocopy_seq_),
+      zerocopy_pending_(std::move(other.zerocopy_pending_)) {}
 
 Connection &Connection::operator=(Connection &&other) noexcept {
   if (this != &other) {
@@ -31,6 +43,17 @@ Connection &Connection::operator=(Connection &&other) noexcept {
 
     fd_ = std::exchange(other.fd_, -1);
     read_buffer_ = std::move(other.read_buffer_);
+    outbound_ = std::move(other.outbound_);
+    dropped_ = other.dropped_;
+    write_armed_ = other.write_armed_;
+    wire_format_ = other.wire_format_;
+    conflated_ = other.conflated_;
+    dirty_ = std::move(other.dirty_);
+    dirty_count_ = other.dirty_count_;
+    counters_ = other.counters_;
+    zerocopy_threshold_ = other.zerocopy_threshold_;
+    zerocopy_seq_ = other.zerocopy_seq_;
+    zerocopy_pending_ = std::move(other.zerocopy_pending_);
   }
 
   return *this;
@@ -39,6 +62,7 @@ Connection &Connection::operator=(Connection &&other) noexcept {
 ssize_t Connection::read_to_buffer() {
   char buf[1024];
   ssize_t n = ::recv(fd_, buf, sizeof(buf), 0);
+  count_syscall();
 
   if (n > 0) {
     read_buffer_.append(buf, n);
@@ -60,25 +84,194 @@ std::optional<std::string> Connection::get_message() {
   return message;
 }
 
-bool Connection::send_data(const std::string &data) {
-  size_t total_send = 0;
+SendResult Connection::send_data(const PayloadRef &payload,
+                                 SlowConsumerPolicy policy) {
+  const size_t size = payload.size();
+  size_t sent = 0;
 
-  while (total_send < data.size()) {
-    ssize_t n =
-        ::send(fd_, data.data() + total_send, data.size() - total_send, 0);
+  // 前面還有待送資料時不能直接送，否則順序會亂
+  if (outbound_.empty()) {
+    while (sent < size) {
+      ssize_t n =
+          ::send(fd_, payload.data() + sent, size - sent, MSG_NOSIGNAL);
+      count_syscall();
+      if (n == -1) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+          break;
+        }
+        EMB_LOG_ERROR("send() failed: {}", strerror(errno));
+        return SendResult::Error;
+      }
+      sent += n;
+    }
+
+    if (sent == size) {
+      return SendResult::Ok;
+    }
+  }
+
+  bool dropped = false;
+  if (!enqueue(payload, sent, policy, dropped)) {
+    return SendResult::Overflow;
+  }
+  return dropped ? SendResult::Dropped : SendResult::Ok;
+}
+
+SendResult Connection::send_batch(const PayloadRef *payloads, size_t count,
+                                  SlowConsumerPolicy policy) {
+  bool dropped = false;
+  for (size_t i = 0; i < count; ++i) {
+    if (!enqueue(payloads[i], 0, policy, dropped)) {
+      return SendResult::Overflow;
+    }
+  }
+
+  if (!write_armed_ && !flush()) {
+    return SendResult::Error;
+  }
+  return dropped ? SendResult::Dropped : SendResult::Ok;
+}
 
+bool Connection::enqueue(const PayloadRef &payload, size_t offset,
+                         SlowConsumerPolicy policy, bool &dropped) {
+  if (outbound_.push(payload, offset)) {
+    return true;
+  }
+
+  // 已經送出一部分的訊息必須完整送完，放不下只能斷線
+  if (offset > 0 || policy == SlowConsumerPolicy::Disconnect) {
+    return false;
+  }
+
+  size_t count = policy == SlowConsumerPolicy::DropOldest
+                     ? outbound_.drop_oldest(payload.size())
+                     : outbound_.drop_unsent();
+  if (!outbound_.push(payload)) {
+    ++count; // 單則訊息比可用空間還大，丟棄新的這則
+  }
+  dropped_ += count;
+  dropped = true;
+  return true;
+}
+
+bool Connection::flush() {
+  constexpr int MAX_IOV = 64;
+  bool allow_zerocopy = zerocopy_threshold_ > 0;
+
+  while (!outbound_.empty()) {
+    iovec iov[MAX_IOV];
+    const int iovcnt = outbound_.peek(iov, MAX_IOV);
+
+    size_t total = 0;
+    for (int i = 0; i < iovcnt; ++i) {
+      total += iov[i].iov_len;
+    }
+    // 小資料 pin page 與完成通知的成本比複製還高，只有大批資料才用 zerocopy
+    const bool zerocopy = allow_zerocopy && total >= zerocopy_threshold_;
+
+    msghdr msg{};
+    msg.msg_iov = iov;
+    msg.msg_iovlen = iovcnt;
+    ssize_t n =
+        ::sendmsg(fd_, &msg, MSG_NOSIGNAL | (zerocopy ? MSG_ZEROCOPY : 0));
+    count_syscall();
     if (n == -1) {
       if (errno == EAGAIN || errno == EWOULDBLOCK) {
-        spdlog::warn("Send buffer full for fd {}", fd_);
-        return false;
+        return true; // 等下一次 EPOLLOUT
+      }
+      if (zerocopy && errno == ENOBUFS) {
+        allow_zerocopy = false; // optmem 用完，這次改回一般複製
+        continue;
       }
-      spdlog::error("send() failed: {}", strerror(errno));
+      EMB_LOG_ERROR("sendmsg() failed: {}", strerror(errno));
       return false;
     }
 
-    total_send += n;
+    if (zerocopy) {
+      // kernel 直接引用 payload 的記憶體，完成通知之前不能釋放
+      ZeroCopyBatch batch{zerocopy_seq_++, {}};
+      outbound_.consume(static_cast<size_t>(n), &batch.payloads);
+      zerocopy_pending_.push_back(std::move(batch));
+    } else {
+      outbound_.consume(static_cast<size_t>(n));
+    }
+  }
+  return true;
+}
+
+void Connection::set_conflated(bool conflated, size_t symbols) {
+  conflated_ = conflated && symbols > 0;
+  dirty_.assign(conflated_ ? (symbols + 63) / 64 : 0, 0);
+  dirty_count_ = 0;
+}
+
+size_t Connection::take_dirty(uint32_t *out, size_t max) {
+  size_t n = 0;
+  for (size_t word = 0; word < dirty_.size() && n < max; ++word) {
+    while (dirty_[word] != 0 && n < max) {
+      const int bit = __builtin_ctzll(dirty_[word]);
+      dirty_[word] &= dirty_[word] - 1;
+      out[n++] = static_cast<uint32_t>(word * 64 + bit);
+    }
   }
+  dirty_count_ -= n;
+  return n;
+}
+
+bool Connection::enable_zerocopy(size_t threshold) {
+  int one = 1;
+  if (::setsockopt(fd_, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) == -1) {
+    return false;
+  }
+  zerocopy_threshold_ = threshold > 0 ? threshold : 1;
+  return true;
+}
+
+bool Connection::reap_zerocopy() {
+  while (true) {
+    char control[128];
+    msghdr msg{};
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
 
+    ssize_t n = ::recvmsg(fd_, &msg, MSG_ERRQUEUE);
+    count_syscall();
+    if (n == -1) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        return false;
+      }
+      break; // error queue 讀完了
+    }
+
+    for (cmsghdr *cm = CMSG_FIRSTHDR(&msg); cm != nullptr;
+         cm = CMSG_NXTHDR(&msg, cm)) {
+      const bool recverr =
+          (cm->cmsg_level == SOL_IP && cm->cmsg_type == IP_RECVERR) ||
+          (cm->cmsg_level == SOL_IPV6 && cm->cmsg_type == IPV6_RECVERR);
+      if (!recverr) {
+        continue;
+      }
+
+      auto *err = reinterpret_cast<sock_extended_err *>(CMSG_DATA(cm));
+      if (err->ee_origin != SO_EE_ORIGIN_ZEROCOPY || err->ee_errno != 0) {
+        return false;
+      }
+      // [ee_info, ee_data] 區間的 sendmsg 都已完成，序號可能 wrap
+      const uint32_t last = err->ee_data;
+      while (!zerocopy_pending_.empty() &&
+             static_cast<int32_t>(zerocopy_pending_.front().seq - last) <= 0) {
+        zerocopy_pending_.pop_front();
+      }
+    }
+  }
+
+  // error queue 之外可能還有真正的 socket 錯誤
+  int error = 0;
+  socklen_t len = sizeof(error);
+  if (::getsockopt(fd_, SOL_SOCKET, SO_ERROR, &error, &len) == -1 ||
+      error != 0) {
+    return false;
+  }
   return true;
 }
 
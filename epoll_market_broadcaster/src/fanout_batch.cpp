@@ -0,0 +1,54 @@
+#include "fanout_batch.h"
+#include "protocol.h"
+
+namespace emb {
+
+void FanoutBatch::build(const PayloadRef *payloads, size_t count,
+                        bool need_text, bool need_binary) {
+  clear();
+  count_ = count;
+
+  for (size_t i = 0; i < count; ++i) {
+    const PayloadRef &payload = payloads[i];
+
+    if (payload->format() == PayloadFormat::Raw) {
+      symbol_ids_[i] = protocol::NO_SYMBOL;
+      if (need_text) {
+        text_[i] = payload;
+        ++text_count_;
+      }
+      continue;
+    }
+
+    symbol_ids_[i] = protocol::symbol_of(payload.data(), payload.size());
+    if (need_binary) {
+      binary_[i] = payload;
+      ++binary_count_;
+    }
+    if (need_text) {
+      PayloadRef text = pool_.acquire();
+      size_t len = 0;
+      if (text) {
+        len = protocol::format_text(payload.data(), payload.size(), symbols_,
+                                    text->mutable_data(), text->capacity());
+      }
+      if (len == 0) {
+        ++transcode_failures_;
+        continue;
+      }
+      text->set_size(len);
+      text_[i] = std::move(text);
+      ++text_count_;
+    }
+  }
+}
+
+void FanoutBatch::clear() {
+  for (size_t i = 0; i < count_; ++i) {
+    text_[i].reset();
+    binary_[i].reset();
+  }
+  count_ = text_count_ = binary_count_ = 0;
+}
+
+} // namespace emb
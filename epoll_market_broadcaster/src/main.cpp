@@ -1,31 +1,87 @@
-#include "server.h"
+#include "async_logger.h"
+#include "broadcast_server.h"
+#include "protocol.h"
 
 #include <atomic>
+#include <chrono>
 #include <csignal>
 #include <cstdint>
 #include <exception>
-#include <spdlog/common.h>
-#include <spdlog/spdlog.h>
+#include <string>
+#include <thread>
+#include <utility>
 
-emb::EpollServer *g_server = nullptr;
+emb::BroadcastServer *g_server = nullptr;
+std::atomic<int> g_signal{0};
 
+// log 的 ring 不可重入，signal handler 中只記下訊號，由 main 在之後輸出
 void signal_handler(int sig) {
-  spdlog::info("Received signal {}, shutting down...", sig);
+  g_signal.store(sig);
   if (g_server) {
     g_server->stop();
   }
 }
 
 int main(int argc, char *argv[]) {
-  spdlog::set_level(spdlog::level::debug);
-
-  uint16_t port = 8888;
+  // 用法: epoll_market_broadcaster [port] [drop|disconnect|conflate|latest]
+  //                                [reactors] [cpu,cpu,...]
+  //                                [epoll|uring|uring-zc] [log_cpu]
+  emb::ServerConfig config;
+  // 格式化與寫檔在背景線程，應綁在不跑 reactor 的管理核心上
+  emb::log::LoggerConfig log_config;
+  log_config.level = emb::log::Level::Debug;
+  // symbol id 即為在這個表中的位置
+  config.symbols = {"AAPL", "GOOG", "TSLA", "MSFT", "AMZN"};
   if (argc > 1) {
-    port = static_cast<uint16_t>(std::atoi(argv[1]));
+    config.port = static_cast<uint16_t>(std::atoi(argv[1]));
+  }
+  if (argc > 2) {
+    std::string policy = argv[2];
+    if (policy == "disconnect") {
+      config.slow_consumer_policy = emb::SlowConsumerPolicy::Disconnect;
+    } else if (policy == "conflate") {
+      config.slow_consumer_policy = emb::SlowConsumerPolicy::Conflate;
+    } else if (policy == "latest") {
+      // 落後的連線只收各 symbol 的最新值 (epoll backend)
+      config.conflate_by_default = true;
+    }
+  }
+  if (argc > 3) {
+    config.num_reactors = static_cast<size_t>(std::atoi(argv[3]));
+  }
+  if (argc > 4) {
+    // 例如 "2,3,4,5"：第 i 個 reactor 綁到第 i 個 CPU
+    std::string cpus = argv[4];
+    size_t pos = 0;
+    while (pos < cpus.size()) {
+      size_t comma = cpus.find(',', pos);
+      if (comma == std::string::npos) {
+        comma = cpus.size();
+      }
+      config.reactor_cpus.push_back(
+          std::atoi(cpus.substr(pos, comma - pos).c_str()));
+      pos = comma + 1;
+    }
+  }
+  if (argc > 5) {
+    // uring-zc：client socket 註冊為 fixed file，payload pool 註冊為 fixed
+    // buffer，以 SEND_ZC 送出
+    std::string backend = argv[5];
+    if (backend == "uring" || backend == "uring-zc") {
+      config.backend = emb::Backend::IoUring;
+      config.uring_fixed_files = backend == "uring-zc";
+      config.uring_registered_buffers = backend == "uring-zc";
+    }
+  }
+  if (argc > 6) {
+    log_config.cpu = std::atoi(argv[6]);
   }
 
   try {
-    emb::EpollServer server(port);
+    emb::log::start(log_config);
+
+    auto server_ptr = emb::make_server(config);
+    emb::BroadcastServer &server = *server_ptr;
     g_server = &server;
 
     std::signal(SIGINT, signal_handler);
@@ -33,47 +89,63 @@ int main(int argc, char *argv[]) {
 
     std::atomic<bool> running{true};
 
-    std::thread producer([&server, &running]() {
-      int tick = 0;
-
-      const char *symbols[] = {"AAPL", "GOOG", "TSLA", "MSFT", "AMZN"};
-      const int num_symbols = 5;
+    std::thread producer([&server, &running, &config]() {
+      uint64_t tick = 0;
+      const size_t num_symbols = config.symbols.size();
 
       while (running.load(std::memory_order_relaxed)) {
-        int idx = tick % num_symbols;
+        const size_t idx = tick % num_symbols;
         double price = 100.0 + (idx * 50) + (tick % 10);
-        int volume = 100 * ((tick % 5) + 1);
-
-        // 格式: SYMBOL|PRICE|VOLUME\n
-        std::string quote = std::string(symbols[idx]) + "|" +
-                            std::to_string(price) + "|" +
-                            std::to_string(volume) + "\n";
-
-        if (!server.enqueue_broadcast(quote)) {
-          spdlog::warn("Broadcast queue full, dropping message");
+        uint32_t volume = 100 * ((tick % 5) + 1);
+
+        // 以二進位 frame 發布，文字連線由 server 轉成 SEQ|SYMBOL|PRICE|VOLUME\n
+        emb::PayloadRef payload = server.acquire_payload();
+        if (!payload) {
+          EMB_LOG_WARN("Payload pool exhausted, dropping message");
+        } else {
+          const auto now = std::chrono::system_clock::now().time_since_epoch();
+          const auto quote = emb::protocol::make_quote(
+              static_cast<uint32_t>(idx), tick,
+              static_cast<uint64_t>(
+                  std::chrono::duration_cast<std::chrono::nanoseconds>(now)
+                      .count()),
+              emb::protocol::to_fixed(price), volume);
+          payload->set_size(
+              emb::protocol::encode(quote, payload->mutable_data()));
+          payload->set_format(emb::PayloadFormat::Binary);
+
+          if (!server.enqueue_broadcast(std::move(payload))) {
+            EMB_LOG_WARN("Broadcast queue full, dropping message");
+          }
         }
 
-        spdlog::debug("Producing: {}", quote.substr(0, quote.size() - 1));
+        EMB_LOG_DEBUG("Producing: {} {} {}", config.symbols[idx], price,
+                      volume);
 
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
         tick++;
       }
 
-      spdlog::info("Producer thread stopped");
+      EMB_LOG_INFO("Producer thread stopped");
     });
 
-    spdlog::info("Starting event loop...");
+    EMB_LOG_INFO("Starting event loop...");
     server.run();
 
+    if (const int sig = g_signal.load()) {
+      EMB_LOG_INFO("Received signal {}, shutting down...", sig);
+    }
     running.store(false, std::memory_order_relaxed);
     producer.join();
 
-    spdlog::info("Server shutdown complete");
+    EMB_LOG_INFO("Server shutdown complete");
 
   } catch (const std::exception &e) {
-    spdlog::error("Fatal error: {}", e.what());
+    EMB_LOG_ERROR("Fatal error: {}", e.what());
+    emb::log::stop();
     return 1;
   }
 
+  emb::log::stop();
   return 0;
 }
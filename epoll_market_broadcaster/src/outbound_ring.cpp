@@ -0,0 +1,119 @@
+#include "outbound_ring.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace emb {
+
+namespace {
+
+size_t round_up_pow2(size_t n) {
+  size_t p = 1;
+  while (p < n) {
+    p <<= 1;
+  }
+  return p;
+}
+
+} // namespace
+
+OutboundRing::OutboundRing(size_t max_bytes, size_t max_messages)
+    : entries_(round_up_pow2(std::max<size_t>(max_messages, 2))),
+      mask_(entries_.size() - 1), max_bytes_(max_bytes) {}
+
+bool OutboundRing::push(const PayloadRef &payload, size_t offset) {
+  const size_t len = payload.size() - offset;
+  if (len == 0) {
+    return true;
+  }
+  if (len > free_space() || count_ == entries_.size()) {
+    return false;
+  }
+
+  Entry &entry = at(count_);
+  entry.payload = payload;
+  entry.offset = offset;
+  ++count_;
+  bytes_ += len;
+  return true;
+}
+
+int OutboundRing::peek(iovec *iov, int max_iov) const {
+  int n = 0;
+  for (size_t i = 0; i < count_ && n < max_iov; ++i, ++n) {
+    const Entry &entry = at(i);
+    iov[n].iov_base = const_cast<char *>(entry.payload.data() + entry.offset);
+    iov[n].iov_len = entry.payload.size() - entry.offset;
+  }
+  return n;
+}
+
+void OutboundRing::consume(size_t n, std::vector<PayloadRef> *retain) {
+  bytes_ -= n;
+
+  while (n > 0) {
+    Entry &entry = at(0);
+    const size_t remaining = entry.payload.size() - entry.offset;
+    if (retain != nullptr) {
+      retain->push_back(entry.payload);
+    }
+    if (n < remaining) {
+      entry.offset += n;
+      return;
+    }
+
+    // 這則訊息送完，釋放 payload 參考
+    n -= remaining;
+    entry.payload.reset();
+    entry.offset = 0;
+    head_ = (head_ + 1) & mask_;
+    --count_;
+  }
+}
+
+size_t OutboundRing::drop_oldest(size_t needed) {
+  const size_t first = front_started() ? 1 : 0;
+
+  size_t count = 0;
+  size_t freed = 0;
+  // bytes 還夠但 entry 數量滿了時也要丟，否則新訊息永遠放不進來
+  while ((free_space() + freed < needed || count_ - count == entries_.size()) &&
+         first + count < count_) {
+    freed += at(first + count).payload.size();
+    ++count;
+  }
+
+  erase_messages(first, count);
+  return count;
+}
+
+size_t OutboundRing::drop_unsent() {
+  const size_t first = front_started() ? 1 : 0;
+  const size_t count = count_ - first;
+  erase_messages(first, count);
+  return count;
+}
+
+void OutboundRing::erase_messages(size_t first, size_t count) {
+  if (count == 0) {
+    return;
+  }
+
+  for (size_t i = first; i < first + count; ++i) {
+    bytes_ -= at(i).payload.size() - at(i).offset;
+    at(i).payload.reset();
+    at(i).offset = 0;
+  }
+
+  if (first == 0) {
+    head_ = (head_ + count) & mask_;
+  } else {
+    // 只有第一則被保留，把後面的 entry 往前搬
+    for (size_t i = first; i + count < count_; ++i) {
+      at(i) = std::move(at(i + count));
+    }
+  }
+  count_ -= count;
+}
+
+} // namespace emb
@@ -0,0 +1,86 @@
+#include "payload_pool.h"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace emb {
+
+namespace {
+
+uint64_t next_head(uint64_t head, uint32_t index) {
+  return ((head >> 32) + 1) << 32 | index;
+}
+
+} // namespace
+
+PayloadPool::PayloadPool(size_t slot_size, size_t capacity)
+    : slot_size_(slot_size), capacity_(capacity) {
+  if (capacity_ == 0 || capacity_ >= NO_INDEX) {
+    throw std::invalid_argument("payload pool capacity out of range");
+  }
+  payloads_.reset(new Payload[capacity_]);
+  storage_.reset(new char[capacity_ * slot_size_]);
+  next_.reset(new std::atomic<uint32_t>[capacity_]);
+
+  // 依 index 由小到大串起來，先取用的 buffer 在記憶體中連續
+  for (size_t i = 0; i < capacity_; ++i) {
+    Payload &p = payloads_[i];
+    p.pool_ = this;
+    p.capacity_ = static_cast<uint32_t>(slot_size_);
+    p.data_ = storage_.get() + i * slot_size_;
+    next_[i].store(i + 1 < capacity_ ? static_cast<uint32_t>(i + 1) : NO_INDEX,
+                   std::memory_order_relaxed);
+  }
+  head_.store(0, std::memory_order_relaxed);
+  available_.store(capacity_, std::memory_order_relaxed);
+}
+
+PayloadRef PayloadPool::acquire() {
+  uint64_t head = head_.load(std::memory_order_acquire);
+  uint32_t index;
+  while (true) {
+    index = static_cast<uint32_t>(head);
+    if (index == NO_INDEX) {
+      return PayloadRef();
+    }
+    // 讀到的 next 可能已經過期 (別的線程先取走了)，此時版本號不同，CAS 失敗重來
+    const uint32_t next = next_[index].load(std::memory_order_relaxed);
+    if (head_.compare_exchange_weak(head, next_head(head, next),
+                                    std::memory_order_acquire)) {
+      break;
+    }
+  }
+
+  available_.fetch_sub(1, std::memory_order_relaxed);
+  Payload *p = &payloads_[index];
+  p->size_ = 0;
+  p->format_ = PayloadFormat::Raw;
+  p->refs_.store(1, std::memory_order_relaxed);
+  return PayloadRef(p);
+}
+
+PayloadRef PayloadPool::make(const char *data, size_t len) {
+  if (len > slot_size_) {
+    return PayloadRef();
+  }
+
+  PayloadRef ref = acquire();
+  if (ref) {
+    std::memcpy(ref->mutable_data(), data, len);
+    ref->set_size(len);
+  }
+  return ref;
+}
+
+void PayloadPool::release(Payload *payload) {
+  available_.fetch_add(1, std::memory_order_relaxed);
+  const auto index = static_cast<uint32_t>(payload - payloads_.get());
+  uint64_t head = head_.load(std::memory_order_relaxed);
+  do {
+    next_[index].store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+  } while (!head_.compare_exchange_weak(head, next_head(head, index),
+                                        std::memory_order_release,
+                                        std::memory_order_relaxed));
+}
+
+} // namespace emb
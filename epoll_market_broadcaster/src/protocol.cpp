@@ -0,0 +1,71 @@
+#include "protocol.h"
+
+#include <cinttypes>
+#include <cstdio>
+
+namespace emb::protocol {
+
+namespace {
+
+// 回傳 symbol 代號，查不到時把 id 寫進 fallback
+const char *symbol_name(uint32_t id, const std::vector<std::string> &symbols,
+                        char (&fallback)[16]) {
+  if (id < symbols.size()) {
+    return symbols[id].c_str();
+  }
+  std::snprintf(fallback, sizeof(fallback), "%" PRIu32, id);
+  return fallback;
+}
+
+size_t checked(int n, size_t capacity) {
+  return n > 0 && static_cast<size_t>(n) < capacity ? static_cast<size_t>(n)
+                                                    : 0;
+}
+
+} // namespace
+
+size_t format_text(const char *frame, size_t len,
+                   const std::vector<std::string> &symbols, char *out,
+                   size_t capacity) {
+  if (len < sizeof(FrameHeader)) {
+    return 0;
+  }
+  FrameHeader header;
+  std::memcpy(&header, frame, sizeof(header));
+
+  char fallback[16];
+  // SEQ|SYMBOL|PRICE|VOLUME\n，價格 6 位小數；開頭的 seq 讓文字連線
+  // 也能偵測跳號並送出 REPLAY
+  if (header.type == MessageType::Quote && len >= sizeof(QuoteFrame)) {
+    QuoteFrame quote;
+    std::memcpy(&quote, frame, sizeof(quote));
+    return checked(
+        std::snprintf(out, capacity, "%" PRIu64 "|%s|%.6f|%" PRIu32 "\n",
+                      quote.seq,
+                      symbol_name(quote.symbol_id, symbols, fallback),
+                      from_fixed(quote.price), quote.volume),
+        capacity);
+  }
+  if (header.type == MessageType::Trade && len >= sizeof(TradeFrame)) {
+    TradeFrame trade;
+    std::memcpy(&trade, frame, sizeof(trade));
+    return checked(
+        std::snprintf(out, capacity, "%" PRIu64 "|%s|%.6f|%" PRIu32 "|%c\n",
+                      trade.seq,
+                      symbol_name(trade.symbol_id, symbols, fallback),
+                      from_fixed(trade.price), trade.quantity,
+                      static_cast<char>(trade.side)),
+        capacity);
+  }
+  if (header.type == MessageType::SnapshotEnd &&
+      len >= sizeof(SnapshotEndFrame)) {
+    SnapshotEndFrame end;
+    std::memcpy(&end, frame, sizeof(end));
+    return checked(std::snprintf(out, capacity, "SNAPSHOT_END|%" PRIu64 "\n",
+                                 end.resume_seq),
+                   capacity);
+  }
+  return 0;
+}
+
+} // namespace emb::protocol
@@ -0,0 +1,834 @@
+#include "reactor.h"
+#include "async_logger.h"
+#include "broadcast_server.h"
+#include "protocol.h"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdexcept>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace emb {
+
+Reactor::Reactor(size_t id, const ServerConfig &config, PayloadPool &pool,
+                 const LatestValueCache &latest)
+    : id_(id), config_(config), pool_(pool), latest_(latest),
+      batch_(pool, config.symbols), subscriptions_(config.symbols),
+      retransmit_(config.retransmit_capacity) {
+  create_listen_socket(config_.port, config_.num_reactors > 1);
+  create_epoll();
+
+  wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (wake_fd_ == -1) {
+    throw std::runtime_error("eventfd() failed: " +
+                             std::string(strerror(errno)));
+  }
+
+  add_to_epoll(listen_fd_, EPOLLIN);
+  add_to_epoll(wake_fd_, EPOLLIN);
+}
+
+Reactor::~Reactor() {
+  connections_.clear();
+
+  if (wake_fd_ != -1) {
+    ::close(wake_fd_);
+  }
+  if (epoll_fd_ != -1) {
+    ::close(epoll_fd_);
+  }
+  if (listen_fd_ != -1) {
+    ::close(listen_fd_);
+  }
+}
+
+void Reactor::create_listen_socket(uint16_t port, bool reuse_port) {
+  listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+  if (listen_fd_ < 0) {
+    throw std::runtime_error("socket() failed: " +
+                             std::string(strerror(errno)));
+  }
+
+  int reuse = 1;
+  if (::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse,
+                   sizeof(reuse)) == -1) {
+    throw std::runtime_error("setsockopt() failed: " +
+                             std::string(strerror(errno)));
+  }
+
+  // 每個 reactor 各自 bind 同一個 port，由 kernel 依 4-tuple hash 分配新連線，
+  // accept 不需要任何跨線程協調
+  if (reuse_port && ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEPORT, &reuse,
+                                 sizeof(reuse)) == -1) {
+    throw std::runtime_error("setsockopt(SO_REUSEPORT) failed: " +
+                             std::string(strerror(errno)));
+  }
+
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = INADDR_ANY;
+  addr.sin_port = htons(port);
+
+  if (::bind(listen_fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) ==
+      -1) {
+    throw std::runtime_error("bind() failed: " + std::string(strerror(errno)));
+  }
+
+  if (::listen(listen_fd_, SOMAXCONN) == -1) {
+    throw std::runtime_error("listen() failed: " +
+                             std::string(strerror(errno)));
+  }
+
+  set_nonblocking(listen_fd_);
+}
+
+void Reactor::set_nonblocking(int fd) {
+  int flags = ::fcntl(fd, F_GETFL, 0); // get all flags
+  if (flags == -1) {
+    throw std::runtime_error("fcntl F_GETFL failed");
+  }
+  if (::fcntl(fd, F_SETFL, flags | O_NONBLOCK) == -1) {
+    throw std::runtime_error("fcntl F_SETFL failed");
+  }
+}
+
+void Reactor::create_epoll() {
+  epoll_fd_ = epoll_create1(0);
+  if (epoll_fd_ == -1) {
+    throw std::runtime_error("epoll_create1() failed");
+  }
+}
+
+void Reactor::add_to_epoll(int fd, uint32_t events) {
+  epoll_event ev{};
+  ev.events = events | EPOLLET; // Edege-Triggered
+  ev.data.fd = fd;
+
+  if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) == -1) {
+    throw std::runtime_error("epoll_ctl ADD failed");
+  }
+}
+
+void Reactor::modify_epoll(int fd, uint32_t events) {
+  epoll_event ev{};
+  ev.events = events | EPOLLET;
+  ev.data.fd = fd;
+
+  if (epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &ev) == -1) {
+    throw std::runtime_error("epoll_ctl MOD failed");
+  }
+}
+
+void Reactor::remove_from_epoll(int fd) {
+  epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+void Reactor::pin_thread() {
+  if (id_ >= config_.reactor_cpus.size()) {
+    return;
+  }
+
+  const int cpu = config_.reactor_cpus[id_];
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+  if (rc != 0) {
+    EMB_LOG_WARN("Reactor {}: failed to pin to CPU {}: {}", id_, cpu,
+                 strerror(rc));
+    return;
+  }
+  EMB_LOG_INFO("Reactor {} pinned to CPU {}", id_, cpu);
+}
+
+void Reactor::run(const std::atomic<bool> &running) {
+  constexpr int MAX_EVENTS = 64;
+  epoll_event events[MAX_EVENTS]{};
+
+  pin_thread();
+
+  while (running.load(std::memory_order_relaxed)) {
+    int timeout = 0;
+    if (!poll_queues() && !config_.busy_poll) {
+      // 先宣告要睡了再檢查一次 queue，與 wake_if_sleeping 的
+      // 「先放入再檢查 sleeping_」配對，兩邊至少有一方會看到對方
+      sleeping_.store(true, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (!poll_queues() && running.load(std::memory_order_relaxed)) {
+        timeout = -1;
+      }
+    }
+
+    int n = ::epoll_wait(epoll_fd_, events, MAX_EVENTS, timeout);
+    counters_.add_syscalls();
+    sleeping_.store(false, std::memory_order_relaxed);
+
+    if (n == -1) {
+      if (errno == EINTR) { // signal interupt
+        continue;
+      }
+      throw std::runtime_error("epoll_wait failed");
+    }
+
+    for (int i = 0; i < n; ++i) {
+      int fd = events[i].data.fd;
+      uint32_t ev = events[i].events;
+
+      if (fd == listen_fd_) {
+        handle_accept();
+      } else if (fd == wake_fd_) {
+        drain_wake_fd();
+      } else if (ev & EPOLLHUP) { // 對方中斷連線
+        handle_close(fd);
+      } else {
+        if ((ev & EPOLLERR) && !handle_error(fd)) {
+          continue;
+        }
+        if (ev & EPOLLIN) {
+          handle_read(fd);
+        }
+        if (ev & EPOLLOUT) {
+          handle_write(fd);
+        }
+      }
+    }
+  }
+}
+
+bool Reactor::poll_queues() {
+  bool worked = dispatcher_ ? dispatcher_() : false;
+  worked |= process_inbox();
+  return worked;
+}
+
+bool Reactor::post(PayloadRef payload) {
+  if (!inbox_.push(std::move(payload))) {
+    inbox_drops_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  return true;
+}
+
+void Reactor::wake_if_sleeping() {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (sleeping_.load(std::memory_order_relaxed)) {
+    wake();
+  }
+}
+
+void Reactor::wake() {
+  uint64_t one = 1;
+  // 計數器溢位 (EAGAIN) 代表已經有未處理的喚醒，可以忽略
+  [[maybe_unused]] ssize_t n = ::write(wake_fd_, &one, sizeof(one));
+}
+
+void Reactor::drain_wake_fd() {
+  uint64_t value;
+  // eventfd 一次 read 就會把計數器歸零
+  [[maybe_unused]] ssize_t n = ::read(wake_fd_, &value, sizeof(value));
+  counters_.add_syscalls();
+}
+
+void Reactor::handle_accept() {
+  while (true) { // ET 下必需處裡完成，因為不會再次通知
+    sockaddr_in client_addr{};
+    socklen_t client_len = sizeof(client_addr);
+
+    int client_fd = ::accept(
+        listen_fd_, reinterpret_cast<sockaddr *>(&client_addr), &client_len);
+    counters_.add_syscalls();
+
+    if (client_fd == -1) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        break; // 讀完了
+      }
+
+      EMB_LOG_ERROR("accept() failed: {}", strerror(errno));
+      break;
+    }
+
+    set_nonblocking(client_fd);
+    add_to_epoll(client_fd, EPOLLIN);
+
+    connections_.emplace(client_fd,
+                         Connection(client_fd, config_.outbound_capacity,
+                                    config_.outbound_messages, &counters_));
+    subscriptions_.add(static_cast<uint32_t>(client_fd));
+    if (config_.conflate_by_default) {
+      connections_.at(client_fd).set_conflated(true, latest_.size());
+    }
+    connection_count_.store(connections_.size(), std::memory_order_relaxed);
+
+    if (config_.zerocopy_threshold > 0 &&
+        !connections_.at(client_fd).enable_zerocopy(
+            config_.zerocopy_threshold)) {
+      EMB_LOG_WARN("SO_ZEROCOPY not supported on fd {}", client_fd);
+    }
+
+    char ip_str[INET_ADDRSTRLEN];
+    ::inet_ntop(AF_INET, &client_addr.sin_addr, ip_str, sizeof(ip_str));
+    EMB_LOG_INFO("Reactor {}: new connection fd={} from {}:{}, total={}", id_,
+                 client_fd, ip_str, ntohs(client_addr.sin_port),
+                 connections_.size());
+  }
+}
+
+void Reactor::handle_read(int fd) {
+  auto it = connections_.find(fd);
+  if (it == connections_.end()) {
+    EMB_LOG_WARN("Unknown fd {} in handle_read", fd);
+    return;
+  }
+
+  Connection &conn = it->second;
+
+  while (true) {
+    ssize_t n = conn.read_to_buffer();
+
+    if (n == -1) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        break; // 讀完了
+      }
+      EMB_LOG_ERROR("recv() failed: {}", strerror(errno));
+      handle_close(fd);
+      return;
+    } else if (n == 0) {
+      // 正常關閉
+      handle_close(fd);
+      return;
+    }
+  }
+
+  while (auto msg = conn.get_message()) {
+    if (!msg->empty() && msg->back() == '\r') {
+      msg->pop_back();
+    }
+    if (!handle_message(conn, *msg)) {
+      return;
+    }
+  }
+}
+
+bool Reactor::handle_message(Connection &conn, const std::string &msg) {
+  if (msg == protocol::BINARY_REQUEST) {
+    switch_format(conn, WireFormat::Binary);
+  } else if (msg == protocol::TEXT_REQUEST) {
+    switch_format(conn, WireFormat::Text);
+  } else if (msg == protocol::CONFLATED_REQUEST ||
+             msg == protocol::STREAM_REQUEST) {
+    // 與訂閱指令一樣不回覆；切回 STREAM 時尚未送出的最新值直接丟棄
+    conn.set_conflated(msg == protocol::CONFLATED_REQUEST, latest_.size());
+    EMB_LOG_DEBUG("Reactor {}: fd={} {}", id_, conn.fd(), msg);
+    return true;
+  } else if (msg == protocol::SNAPSHOT_REQUEST ||
+             msg.rfind(std::string(protocol::REPLAY_REQUEST) + " ", 0) == 0) {
+    start_recovery(conn, msg);
+    if (!pump_recovery(conn)) {
+      handle_close(conn.fd());
+      return false;
+    }
+    update_write_interest(conn);
+    return true;
+  } else {
+    // 訂閱指令不回覆：二進位連線的資料流中不能夾雜文字
+    switch (subscriptions_.apply_command(static_cast<uint32_t>(conn.fd()),
+                                         msg)) {
+    case SubscriptionIndex::CommandResult::NotCommand:
+      EMB_LOG_DEBUG("Received from fd {}: {}", conn.fd(), msg);
+      break;
+    case SubscriptionIndex::CommandResult::Applied:
+      EMB_LOG_DEBUG("Reactor {}: fd={} {}", id_, conn.fd(), msg);
+      break;
+    case SubscriptionIndex::CommandResult::UnknownSymbol:
+      EMB_LOG_WARN("Reactor {}: fd={} unknown symbol in '{}'", id_, conn.fd(),
+                   msg);
+      break;
+    }
+    return true;
+  }
+
+  // 回覆以文字送出，排在所有舊格式的資料之後；client 看到回覆之後就換格式
+  const char *ack = conn.wire_format() == WireFormat::Binary
+                        ? protocol::BINARY_ACK
+                        : protocol::TEXT_ACK;
+  PayloadRef reply = pool_.make(ack, std::strlen(ack));
+  if (!reply || conn.send_data(reply, SlowConsumerPolicy::Disconnect) !=
+                    SendResult::Ok) {
+    handle_close(conn.fd());
+    return false;
+  }
+  update_write_interest(conn);
+  return true;
+}
+
+void Reactor::switch_format(Connection &conn, WireFormat format) {
+  if (conn.wire_format() == format) {
+    return;
+  }
+  conn.set_wire_format(format);
+  if (format == WireFormat::Binary) {
+    ++binary_connections_;
+  } else {
+    --binary_connections_;
+  }
+  EMB_LOG_INFO("Reactor {}: fd={} switched to {} format", id_, conn.fd(),
+               format == WireFormat::Binary ? "binary" : "text");
+}
+
+void Reactor::handle_write(int fd) {
+  auto it = connections_.find(fd);
+  if (it == connections_.end()) {
+    return; // 同一輪事件中已經在 handle_read 被關閉
+  }
+
+  Connection &conn = it->second;
+  if (!conn.flush() || !pump_recovery(conn) || !send_latest(conn)) {
+    handle_close(fd);
+    return;
+  }
+  update_write_interest(conn);
+}
+
+bool Reactor::send_latest(Connection &conn) {
+  uint32_t symbols[MAX_BATCH];
+  PayloadRef payloads[MAX_BATCH];
+  char frame[LatestValueCache::MAX_VALUE_SIZE];
+
+  while (conn.has_dirty() && !conn.has_pending()) {
+    const size_t n = conn.take_dirty(symbols, MAX_BATCH);
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+      const size_t len = latest_.read(symbols[i], frame);
+      if (len > 0 && (payloads[count] = frame_payload(conn, frame, len))) {
+        ++count;
+      }
+    }
+    if (!send_chunk(conn, payloads, count)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void Reactor::start_recovery(Connection &conn, const std::string &msg) {
+  Recovery recovery;
+  recovery.position = retransmit_.end();
+
+  if (msg == protocol::SNAPSHOT_REQUEST) {
+    begin_snapshot(recovery);
+  } else {
+    const uint64_t seq = std::strtoull(
+        msg.c_str() + std::strlen(protocol::REPLAY_REQUEST), nullptr, 10);
+    // 要求的 seq 比 ring 中最舊的還早 (不論 ring 是否已經覆蓋過)，
+    // 或是不在 ring 中 (inbox 滿時漏掉)：中間有缺口，改送快照。
+    // 落在 end() 表示 client 已經收到最新的一則，沒有缺口
+    const uint64_t position = retransmit_.lower_bound(seq);
+    if (!retransmit_.empty() &&
+        (seq < retransmit_.at(retransmit_.begin()).seq ||
+         (position < retransmit_.end() &&
+          retransmit_.at(position).seq != seq))) {
+      begin_snapshot(recovery);
+    } else {
+      recovery.position = position;
+    }
+  }
+
+  EMB_LOG_INFO("Reactor {}: fd={} {}, {} retained frames to replay", id_,
+               conn.fd(), recovery.snapshot ? "snapshot" : "replay",
+               retransmit_.end() - recovery.position);
+  recoveries_[conn.fd()] = std::move(recovery);
+}
+
+void Reactor::begin_snapshot(Recovery &recovery) const {
+  recovery.snapshot = true;
+  recovery.end_pending = true;
+  recovery.next_symbol = 0;
+  recovery.position = retransmit_.end();
+  // ring 中已有的 frame 在快取裡都已經是這則或更新的值，不需要重送
+  recovery.cut_seq =
+      retransmit_.empty() ? 0 : retransmit_.at(retransmit_.end() - 1).seq;
+  recovery.snapshot_seqs.assign(latest_.size(), 0);
+}
+
+bool Reactor::pump_recovery(Connection &conn) {
+  auto it = recoveries_.find(conn.fd());
+  if (it == recoveries_.end()) {
+    return true;
+  }
+  Recovery &recovery = it->second;
+  const auto id = static_cast<uint32_t>(conn.fd());
+  PayloadRef payloads[MAX_BATCH];
+  char frame[LatestValueCache::MAX_VALUE_SIZE];
+
+  // 快照結束標記放進這一批，pool 用完時回傳 false
+  auto push_end = [&](size_t &count) {
+    char end[sizeof(protocol::SnapshotEndFrame)];
+    protocol::encode(protocol::make_snapshot_end(recovery.cut_seq + 1), end);
+    if (!(payloads[count] = frame_payload(conn, end, sizeof(end)))) {
+      return false;
+    }
+    ++count;
+    recovery.end_pending = false;
+    return true;
+  };
+
+  while (!conn.has_pending()) {
+    size_t count = 0;
+    // pool 用完：停在這一則，先送出這一批已經放進去的，
+    // 之後 (EPOLLOUT 或下一批廣播) 從同一則接著送，不會留下缺口
+    bool stalled = false;
+
+    if (recovery.snapshot) {
+      while (count < MAX_BATCH && recovery.next_symbol < latest_.size()) {
+        const uint32_t symbol = recovery.next_symbol;
+        const size_t len = subscriptions_.wants(id, symbol)
+                               ? latest_.read(symbol, frame)
+                               : 0;
+        if (len > 0) {
+          if (!(payloads[count] = shared_frame_payload(conn, frame, len))) {
+            stalled = true;
+            break;
+          }
+          const uint64_t seq = protocol::seq_of(frame, len);
+          recovery.snapshot_seqs[symbol] = seq;
+          recovery.cut_seq = std::max(recovery.cut_seq, seq);
+          ++count;
+        }
+        ++recovery.next_symbol;
+      }
+      recovery.snapshot = recovery.next_symbol < latest_.size();
+    } else {
+      if (recovery.position < retransmit_.begin()) {
+        // client 太慢，要接著送的部分已經被覆蓋：重新從快照開始
+        EMB_LOG_WARN("Reactor {}: fd={} fell out of the retransmit ring, "
+                     "restarting from snapshot",
+                     id_, conn.fd());
+        begin_snapshot(recovery);
+        continue;
+      }
+      while (count < MAX_BATCH && recovery.position < retransmit_.end()) {
+        const auto &entry = retransmit_.at(recovery.position);
+        // 第一則超過截止點的 frame 之前送出快照結束標記
+        if (recovery.end_pending && entry.seq > recovery.cut_seq) {
+          if (!push_end(count)) {
+            stalled = true;
+            break;
+          }
+          continue;
+        }
+        // 快照裡的值已經是這則或更新的：不重送，避免 client 看到舊價格
+        const bool superseded =
+            entry.symbol < recovery.snapshot_seqs.size() &&
+            entry.seq <= recovery.snapshot_seqs[entry.symbol];
+        if (!superseded && subscriptions_.wants(id, entry.symbol)) {
+          if (!(payloads[count] =
+                    shared_frame_payload(conn, entry.data, entry.length))) {
+            stalled = true;
+            break;
+          }
+          ++count;
+        }
+        ++recovery.position;
+      }
+      // 截止點之前的 frame 都已經進入 ring (inbox 漏掉的除外) 才結束快照
+      const uint64_t last_seq =
+          retransmit_.empty() ? 0 : retransmit_.at(retransmit_.end() - 1).seq;
+      if (!stalled && recovery.end_pending &&
+          recovery.position == retransmit_.end() && count < MAX_BATCH &&
+          last_seq >= recovery.cut_seq && !push_end(count)) {
+        stalled = true;
+      }
+      if (!stalled && count == 0 && recovery.position == retransmit_.end()) {
+        if (!recovery.end_pending) {
+          recoveries_.erase(it); // 追上了，之後照常收即時資料
+          if (recoveries_.empty()) {
+            release_shared_frames();
+          }
+        }
+        // 快取比這個 reactor 的 inbox 新：等截止點之前的 frame 進入 ring
+        return true;
+      }
+    }
+
+    if (!send_chunk(conn, payloads, count)) {
+      return false;
+    }
+    if (stalled) {
+      EMB_LOG_DEBUG("Reactor {}: fd={} recovery waiting for payload pool", id_,
+                    conn.fd());
+      return true;
+    }
+  }
+  return true;
+}
+
+void Reactor::pump_recoveries(std::vector<int> &to_close) {
+  std::vector<int> fds;
+  fds.reserve(recoveries_.size());
+  for (const auto &[fd, recovery] : recoveries_) {
+    fds.push_back(fd);
+  }
+  for (int fd : fds) {
+    auto it = connections_.find(fd);
+    if (it == connections_.end()) {
+      continue;
+    }
+    Connection &conn = it->second;
+    if (!pump_recovery(conn)) {
+      to_close.push_back(fd);
+      continue;
+    }
+    update_write_interest(conn);
+  }
+}
+
+PayloadRef Reactor::frame_payload(const Connection &conn, const char *frame,
+                                  size_t len) {
+  if (conn.wire_format() == WireFormat::Binary) {
+    return pool_.make(frame, len);
+  }
+  PayloadRef payload = pool_.acquire();
+  if (!payload) {
+    return payload;
+  }
+  const size_t text_len =
+      protocol::format_text(frame, len, config_.symbols,
+                            payload->mutable_data(), payload->capacity());
+  if (text_len == 0) {
+    return PayloadRef();
+  }
+  payload->set_size(text_len);
+  return payload;
+}
+
+PayloadRef Reactor::shared_frame_payload(const Connection &conn,
+                                         const char *frame, size_t len) {
+  const uint64_t seq = protocol::seq_of(frame, len);
+  if (seq == 0) {
+    return frame_payload(conn, frame, len);
+  }
+  // seq 相同的 frame 內容相同 (快取與重送 ring 存的都是廣播時的 frame)
+  SharedFrame &shared = shared_frames_[seq % SHARED_FRAMES];
+  if (shared.seq != seq) {
+    shared.seq = seq;
+    shared.binary.reset();
+    shared.text.reset();
+  }
+  PayloadRef &payload = conn.wire_format() == WireFormat::Binary
+                            ? shared.binary
+                            : shared.text;
+  if (!payload) {
+    payload = frame_payload(conn, frame, len);
+  }
+  return payload;
+}
+
+void Reactor::release_shared_frames() {
+  for (SharedFrame &shared : shared_frames_) {
+    shared = SharedFrame();
+  }
+}
+
+bool Reactor::send_chunk(Connection &conn, PayloadRef *payloads,
+                         size_t count) {
+  if (count == 0) {
+    return true;
+  }
+
+  SendResult result =
+      conn.send_batch(payloads, count, config_.slow_consumer_policy);
+  // 在 handle_write 中 EPOLLOUT 還沒取消，send_batch 不會自己送
+  if (result != SendResult::Overflow && result != SendResult::Error &&
+      conn.write_armed() && !conn.flush()) {
+    result = SendResult::Error;
+  }
+  for (size_t i = 0; i < count; ++i) {
+    payloads[i].reset();
+  }
+  return result != SendResult::Overflow && result != SendResult::Error;
+}
+
+bool Reactor::handle_error(int fd) {
+  auto it = connections_.find(fd);
+  if (it == connections_.end()) {
+    return false;
+  }
+
+  // 開啟 MSG_ZEROCOPY 時，完成通知也是經由 error queue 以 EPOLLERR 送達
+  Connection &conn = it->second;
+  if (conn.zerocopy_enabled() && conn.reap_zerocopy()) {
+    return true;
+  }
+  handle_close(fd);
+  return false;
+}
+
+void Reactor::update_write_interest(Connection &conn) {
+  const bool want_write = conn.has_pending();
+  if (want_write == conn.write_armed()) {
+    return;
+  }
+
+  modify_epoll(conn.fd(), want_write ? (EPOLLIN | EPOLLOUT) : EPOLLIN);
+  counters_.add_syscalls();
+  conn.set_write_armed(want_write);
+}
+
+void Reactor::handle_close(int fd) {
+  EMB_LOG_INFO("Reactor {}: connection closed fd={}, remaining={}", id_, fd,
+               connections_.size() - 1); // -1 因為還沒 erase
+  remove_from_epoll(fd);
+  auto it = connections_.find(fd);
+  if (it != connections_.end() &&
+      it->second.wire_format() == WireFormat::Binary) {
+    --binary_connections_;
+  }
+  subscriptions_.remove(static_cast<uint32_t>(fd));
+  if (recoveries_.erase(fd) > 0 && recoveries_.empty()) {
+    release_shared_frames();
+  }
+  connections_.erase(fd);
+  connection_count_.store(connections_.size(), std::memory_order_relaxed);
+}
+
+void Reactor::broadcast(const PayloadRef *payloads, size_t count) {
+  // 每則 frame 在這個 reactor 只轉一次文字，所有文字連線共用
+  batch_.build(payloads, count, connections_.size() > binary_connections_,
+               binary_connections_ > 0);
+  for (size_t i = 0; i < count; ++i) {
+    if (payloads[i]->format() == PayloadFormat::Binary) {
+      const PayloadRef &frame = payloads[i];
+      retransmit_.push(protocol::seq_of(frame.data(), frame.size()),
+                       batch_.symbols()[i], frame.data(), frame.size());
+    }
+  }
+  const uint64_t full_mask =
+      count >= 64 ? ~uint64_t{0} : (uint64_t{1} << count) - 1;
+
+  // 走訪時不能 erase，需要斷線的連線先記下來
+  std::vector<int> to_close;
+  PayloadRef selected[MAX_BATCH];
+
+  for (const auto &recipient : subscriptions_.route(batch_.symbols(), count)) {
+    const int fd = static_cast<int>(recipient.id);
+    auto it = connections_.find(fd);
+    if (it == connections_.end()) {
+      continue;
+    }
+    Connection &conn = it->second;
+    // 回補中的連線由 pump_recoveries 從重送 ring 送出，這裡跳過
+    if (!recoveries_.empty() && recoveries_.count(fd) > 0) {
+      continue;
+    }
+
+    const bool binary = conn.wire_format() == WireFormat::Binary;
+    const PayloadRef *source = binary ? batch_.binary() : batch_.text();
+    const PayloadRef *batch = source;
+    size_t batch_count = count;
+    // 最新值模式且已經落後：有 symbol 的訊息只標記，等可寫時再送最新值
+    const bool conflating =
+        conn.conflated() && (conn.has_pending() || conn.has_dirty());
+    // 收整批且沒有空格時直接用共用的陣列，否則挑出要送的幾則
+    if (conflating || recipient.mask != full_mask ||
+        !(binary ? batch_.binary_complete() : batch_.text_complete())) {
+      batch_count = 0;
+      for (uint64_t bits = recipient.mask; bits != 0; bits &= bits - 1) {
+        const int index = __builtin_ctzll(bits);
+        const uint32_t symbol = batch_.symbols()[index];
+        if (conflating && symbol < latest_.size()) {
+          conn.mark_dirty(symbol);
+          continue;
+        }
+        const PayloadRef &payload = source[index];
+        if (payload) {
+          selected[batch_count++] = payload;
+        }
+      }
+      batch = selected;
+    }
+    if (batch_count == 0) {
+      continue;
+    }
+
+    const SendResult result =
+        conn.send_batch(batch, batch_count, config_.slow_consumer_policy);
+    if (batch == selected) {
+      for (size_t i = 0; i < batch_count; ++i) {
+        selected[i].reset();
+      }
+    }
+
+    switch (result) {
+    case SendResult::Ok:
+      break;
+    case SendResult::Dropped:
+      EMB_LOG_DEBUG("Slow consumer fd {}: {} messages dropped so far", fd,
+                    conn.dropped_messages());
+      break;
+    case SendResult::Overflow:
+      EMB_LOG_WARN("Slow consumer fd {}: outbound buffer full ({} bytes), "
+                   "disconnecting",
+                   fd, conn.pending_bytes());
+      to_close.push_back(fd);
+      continue;
+    case SendResult::Error:
+      to_close.push_back(fd);
+      continue;
+    }
+    if (conn.has_dirty() && !send_latest(conn)) {
+      to_close.push_back(fd);
+      continue;
+    }
+    update_write_interest(conn);
+  }
+
+  if (!recoveries_.empty()) {
+    pump_recoveries(to_close);
+  }
+
+  for (int fd : to_close) {
+    handle_close(fd);
+  }
+  batch_.clear();
+}
+
+bool Reactor::process_inbox() {
+  PayloadRef batch[MAX_BATCH];
+  bool worked = false;
+
+  while (true) {
+    size_t count = 0;
+    while (count < MAX_BATCH) {
+      auto payload = inbox_.pop();
+      if (!payload) {
+        break;
+      }
+      batch[count++] = std::move(*payload);
+    }
+    if (count == 0) {
+      break;
+    }
+
+    broadcast(batch, count);
+    for (size_t i = 0; i < count; ++i) {
+      batch[i].reset();
+    }
+    worked = true;
+  }
+  return worked;
+}
+
+} // namespace emb
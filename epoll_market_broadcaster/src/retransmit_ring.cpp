@@ -0,0 +1,55 @@
+#include "retransmit_ring.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace emb {
+
+namespace {
+
+size_t round_up_pow2(size_t n) {
+  size_t p = 1;
+  while (p < n) {
+    p <<= 1;
+  }
+  return p;
+}
+
+} // namespace
+
+RetransmitRing::RetransmitRing(size_t capacity)
+    : entries_(round_up_pow2(std::max<size_t>(capacity, 2))),
+      mask_(entries_.size() - 1) {}
+
+bool RetransmitRing::push(uint64_t seq, uint32_t symbol, const char *data,
+                          size_t len) {
+  if (len > MAX_FRAME_SIZE) {
+    return false;
+  }
+
+  Entry &entry = entries_[end_ & mask_];
+  entry.seq = seq;
+  entry.symbol = symbol;
+  entry.length = static_cast<uint32_t>(len);
+  std::memcpy(entry.data, data, len);
+  ++end_;
+  size_ = std::min<uint64_t>(size_ + 1, entries_.size());
+  return true;
+}
+
+uint64_t RetransmitRing::lower_bound(uint64_t seq) const {
+  // seq 在 ring 中遞增，二分搜尋
+  uint64_t lo = begin();
+  uint64_t hi = end_;
+  while (lo < hi) {
+    const uint64_t mid = lo + (hi - lo) / 2;
+    if (at(mid).seq < seq) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+} // namespace emb
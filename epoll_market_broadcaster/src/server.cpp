@@ -1,226 +1,148 @@
 #include "server.h"
+#include "async_logger.h"
+#include "protocol.h"
 
-#include <atomic>
-#include <spdlog/spdlog.h>
-
-#include <arpa/inet.h>
-#include <cerrno>
-#include <cstring>
-#include <fcntl.h>
-#include <netinet/in.h>
 #include <stdexcept>
-#include <sys/epoll.h>
-#include <sys/socket.h>
-#include <unistd.h>
+#include <thread>
+#include <utility>
+#include <vector>
 
 namespace emb {
 
-EpollServer::EpollServer(uint16_t port) {
-  create_listen_socket(port);
-  create_epoll();
-
-  add_to_epoll(listen_fd_, EPOLLIN);
-
-  spdlog::info("Server listening on port {}", port);
+EpollServer::EpollServer(uint16_t port)
+    : EpollServer([port] {
+        ServerConfig config;
+        config.port = port;
+        return config;
+      }()) {}
+
+EpollServer::EpollServer(const ServerConfig &config)
+    : config_(config),
+      payload_pool_(std::make_unique<PayloadPool>(
+          config_.max_payload_size,
+          payload_pool_capacity(config_, config_.num_reactors))),
+      broadcast_queue_(std::make_unique<MPMCQueue<PayloadRef, 1024>>()),
+      latest_(std::make_unique<LatestValueCache>(config_.symbols.size())) {
+  if (config_.num_reactors == 0) {
+    throw std::invalid_argument("num_reactors must be at least 1");
+  }
+
+  reactors_.reserve(config_.num_reactors);
+  for (size_t i = 0; i < config_.num_reactors; ++i) {
+    reactors_.push_back(
+        std::make_unique<Reactor>(i, config_, *payload_pool_, *latest_));
+  }
+  reactors_[0]->set_dispatcher([this] { return dispatch_broadcasts(); });
+
+  EMB_LOG_INFO("Server listening on port {} with {} reactor(s)", config_.port,
+               config_.num_reactors);
 }
 
-void EpollServer::create_listen_socket(uint16_t port) {
-  listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
-  if (listen_fd_ < 0) {
-    throw std::runtime_error("socket() failed: " +
-                             std::string(strerror(errno)));
-  }
+EpollServer::~EpollServer() = default;
 
-  int reuse = 1;
-  if (::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse,
-                   sizeof(reuse)) == -1) {
-    throw std::runtime_error("setsockopt() failed: " +
-                             std::string(strerror(errno)));
-  }
+void EpollServer::run() {
+  running_.store(true, std::memory_order_release);
 
-  sockaddr_in addr{};
-  addr.sin_family = AF_INET;
-  addr.sin_addr.s_addr = INADDR_ANY;
-  addr.sin_port = htons(port);
+  std::vector<std::thread> threads;
+  threads.reserve(reactors_.size() - 1);
 
-  if (::bind(listen_fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) ==
-      -1) {
-    throw std::runtime_error("bind() failed: " + std::string(strerror(errno)));
+  try {
+    for (size_t i = 1; i < reactors_.size(); ++i) {
+      threads.emplace_back([this, i] { reactors_[i]->run(running_); });
+    }
+    reactors_[0]->run(running_);
+  } catch (...) {
+    stop();
+    for (auto &t : threads) {
+      t.join();
+    }
+    throw;
   }
 
-  if (::listen(listen_fd_, SOMAXCONN) == -1) {
-    throw std::runtime_error("listen() failed: " +
-                             std::string(strerror(errno)));
+  for (auto &t : threads) {
+    t.join();
   }
-
-  set_nonblocking(listen_fd_);
 }
 
-EpollServer::~EpollServer() {
-  connections_.clear();
-
-  if (epoll_fd_ != -1) {
-    ::close(epoll_fd_);
-  }
-  if (listen_fd_ != -1) {
-    ::close(listen_fd_);
+void EpollServer::stop() {
+  running_.store(false, std::memory_order_relaxed);
+  for (auto &reactor : reactors_) {
+    reactor->wake();
   }
 }
 
-void EpollServer::set_nonblocking(int fd) {
-  int flags = ::fcntl(fd, F_GETFL, 0); // get all flags
-  if (flags == -1) {
-    throw std::runtime_error("fcntl F_GETFL failed");
-  }
-  if (::fcntl(fd, F_SETFL, flags | O_NONBLOCK) == -1) {
-    throw std::runtime_error("fcntl F_SETFL failed");
+ServerStats EpollServer::stats() const {
+  ServerStats stats;
+  stats.connections = connection_count();
+  stats.broadcasts = counters_.broadcasts.load(std::memory_order_relaxed);
+  for (const auto &reactor : reactors_) {
+    stats.syscalls +=
+        reactor->counters().syscalls.load(std::memory_order_relaxed);
   }
+  return stats;
 }
 
-void EpollServer::create_epoll() {
-  epoll_fd_ = epoll_create1(0);
-  if (epoll_fd_ == -1) {
-    throw std::runtime_error("epoll_create1() failed");
+size_t EpollServer::connection_count() const {
+  size_t total = 0;
+  for (const auto &reactor : reactors_) {
+    total += reactor->connection_count();
   }
+  return total;
 }
 
-void EpollServer::add_to_epoll(int fd, uint32_t events) {
-  epoll_event ev{};
-  ev.events = events | EPOLLET; // Edege-Triggered
-  ev.data.fd = fd;
-
-  if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) == -1) {
-    throw std::runtime_error("epoll_ctl ADD failed");
+uint64_t EpollServer::inbox_drops() const {
+  uint64_t total = 0;
+  for (const auto &reactor : reactors_) {
+    total += reactor->inbox_drops();
   }
+  return total;
 }
 
-void EpollServer::remove_from_epoll(int fd) {
-  epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
-}
-
-void EpollServer::run() {
-  constexpr int MAX_EVENTS = 64;
-  epoll_event events[MAX_EVENTS]{};
-
-  running_.store(true, std::memory_order_release);
-
-  while (running_.load(std::memory_order_relaxed)) {
-    int n = ::epoll_wait(epoll_fd_, events, MAX_EVENTS, 10);
-
-    if (n == -1) {
-      if (errno == EINTR) { // signal interupt
-        continue;
-      }
-      throw std::runtime_error("epoll_wait failed");
-    }
-
-    for (int i = 0; i < n; ++i) {
-      int fd = events[i].data.fd;
-      uint32_t ev = events[i].events;
-
-      if (fd == listen_fd_) {
-        handle_accept();
-      } else if (ev & (EPOLLERR | EPOLLHUP)) { // 錯誤或者對方中斷連線
-        handle_close(fd);
-      } else if (ev & EPOLLIN) {
-        handle_read(fd);
-      }
-    }
-
-    process_broadcast_queue();
+bool EpollServer::enqueue_broadcast(const std::string &data) {
+  PayloadRef payload = payload_pool_->make(data.data(), data.size());
+  if (!payload) {
+    return false; // 訊息過大或 pool 用完
   }
+  return enqueue_broadcast(std::move(payload));
 }
 
-void EpollServer::handle_accept() {
-  while (true) { // ET 下必需處裡完成，因為不會再次通知
-    sockaddr_in client_addr{};
-    socklen_t client_len = sizeof(client_addr);
-
-    int client_fd = ::accept(
-        listen_fd_, reinterpret_cast<sockaddr *>(&client_addr), &client_len);
-
-    if (client_fd == -1) {
-      if (errno == EAGAIN || errno == EWOULDBLOCK) {
-        break; // 讀完了
-      }
-
-      spdlog::error("accept() failed: {}", strerror(errno));
-      break;
-    }
-
-    set_nonblocking(client_fd);
-    add_to_epoll(client_fd, EPOLLIN);
-
-    connections_.emplace(client_fd, Connection(client_fd));
-
-    char ip_str[INET_ADDRSTRLEN];
-    ::inet_ntop(AF_INET, &client_addr.sin_addr, ip_str, sizeof(ip_str));
-    spdlog::info("New connection: fd={} from {}:{}, total={}", client_fd,
-                 ip_str, ntohs(client_addr.sin_port), connections_.size());
+bool EpollServer::enqueue_broadcast(PayloadRef payload) {
+  if (!broadcast_queue_->push(std::move(payload))) {
+    return false;
   }
+  reactors_[0]->wake_if_sleeping();
+  return true;
 }
 
-void EpollServer::handle_read(int fd) {
-  auto it = connections_.find(fd);
-  if (it == connections_.end()) {
-    spdlog::warn("Unknown fd {} in handle_read", fd);
-    return;
-  }
-
-  Connection &conn = it->second;
-
-  while (true) {
-    ssize_t n = conn.read_to_buffer();
-
-    if (n == -1) {
-      if (errno == EAGAIN || errno == EWOULDBLOCK) {
-        break; // 讀完了
+bool EpollServer::dispatch_broadcasts() {
+  bool worked = false;
+  while (auto payload = broadcast_queue_->pop()) {
+    // 填入 seq 並更新快取之後才分派：這時只有這裡持有 payload，可以改寫；
+    // reactor 看到這則時快取已經是這則或更新的值
+    if ((*payload)->format() == PayloadFormat::Binary) {
+      if (protocol::set_seq((*payload)->mutable_data(), payload->size(),
+                            last_seq_ + 1)) {
+        ++last_seq_;
       }
-      spdlog::error("recv() failed: {}", strerror(errno));
-      handle_close(fd);
-      return;
-    } else if (n == 0) {
-      // 正常關閉
-      handle_close(fd);
-      return;
+      latest_->update(
+          protocol::symbol_of(payload->data(), payload->size()),
+          payload->data(), payload->size());
     }
-  }
-
-  while (auto msg = conn.get_message()) {
-    spdlog::debug("Received from fd {}: {}", fd, *msg);
-
-    // Echo
-    // conn.send_data(*msg + "\n");
-  }
-}
-
-void EpollServer::handle_close(int fd) {
-  spdlog::info("Connection closed: fd={}, remaining={}", fd,
-               connections_.size() - 1); // -1 因為還沒 erase
-  remove_from_epoll(fd);
-  connections_.erase(fd);
-  remove_from_epoll(fd);
-  connections_.erase(fd);
-}
 
-void EpollServer::stop() { running_.store(false, std::memory_order_relaxed); }
-
-void EpollServer::broadcast(const std::string &data) {
-  for (auto &[fd, conn] : connections_) {
-    if (!conn.send_data(data)) {
-      spdlog::warn("Failed to send to fd {}", fd);
+    // 每個 reactor 只多一份參考，payload 內容不複製
+    for (auto &reactor : reactors_) {
+      reactor->post(*payload);
     }
+    counters_.add_broadcasts();
+    worked = true;
   }
-}
-
-bool EpollServer::enqueue_broadcast(const std::string &data) {
-  return broadcast_queue.push(data);
-}
 
-void EpollServer::process_broadcast_queue() {
-  while (auto msg = broadcast_queue.pop()) {
-    broadcast(*msg);
+  if (worked) {
+    for (size_t i = 1; i < reactors_.size(); ++i) {
+      reactors_[i]->wake_if_sleeping();
+    }
   }
+  return worked;
 }
 
 } // namespace emb
@@ -0,0 +1,204 @@
+#include "subscription_index.h"
+#include "protocol.h"
+
+#include <algorithm>
+
+namespace emb {
+
+SubscriptionIndex::SubscriptionIndex(const std::vector<std::string> &symbols)
+    : by_symbol_(symbols.size()) {
+  for (size_t i = 0; i < symbols.size(); ++i) {
+    symbol_ids_.emplace(symbols[i], static_cast<uint32_t>(i));
+  }
+}
+
+void SubscriptionIndex::add(uint32_t id) {
+  if (id >= subscribers_.size()) {
+    subscribers_.resize(id + 1);
+    masks_.resize(id + 1);
+  }
+  Subscriber &sub = subscribers_[id];
+  if (sub.active) {
+    remove(id);
+  }
+  sub.active = true;
+  sub.all = false;
+  sub.bits.assign((by_symbol_.size() + 63) / 64, 0);
+  members_.push_back(id);
+  set_all(id, sub, true);
+}
+
+void SubscriptionIndex::remove(uint32_t id) {
+  if (id >= subscribers_.size() || !subscribers_[id].active) {
+    return;
+  }
+  Subscriber &sub = subscribers_[id];
+  unsubscribe_all(id);
+  erase_id(members_, id);
+  sub.active = false;
+}
+
+bool SubscriptionIndex::subscribe(uint32_t id, uint32_t symbol) {
+  if (symbol >= by_symbol_.size()) {
+    return false;
+  }
+  Subscriber &sub = subscribers_[id];
+  if (sub.all) {
+    // 第一個明確的 SUB：從「全部」改為只收指定的 symbol
+    set_all(id, sub, false);
+  }
+  if (!has(sub, symbol)) {
+    sub.bits[symbol / 64] |= uint64_t{1} << (symbol % 64);
+    by_symbol_[symbol].push_back(id);
+  }
+  return true;
+}
+
+bool SubscriptionIndex::unsubscribe(uint32_t id, uint32_t symbol) {
+  if (symbol >= by_symbol_.size()) {
+    return false;
+  }
+  Subscriber &sub = subscribers_[id];
+  if (sub.all) {
+    // 訂閱全部時退訂一個：展開成其餘所有 symbol
+    set_all(id, sub, false);
+    for (uint32_t s = 0; s < by_symbol_.size(); ++s) {
+      if (s != symbol) {
+        subscribe(id, s);
+      }
+    }
+    return true;
+  }
+  if (has(sub, symbol)) {
+    sub.bits[symbol / 64] &= ~(uint64_t{1} << (symbol % 64));
+    erase_id(by_symbol_[symbol], id);
+  }
+  return true;
+}
+
+void SubscriptionIndex::subscribe_all(uint32_t id) {
+  Subscriber &sub = subscribers_[id];
+  unsubscribe_all(id);
+  set_all(id, sub, true);
+}
+
+void SubscriptionIndex::unsubscribe_all(uint32_t id) {
+  Subscriber &sub = subscribers_[id];
+  set_all(id, sub, false);
+  for (size_t word = 0; word < sub.bits.size(); ++word) {
+    for (uint64_t bits = sub.bits[word]; bits != 0; bits &= bits - 1) {
+      const size_t symbol = word * 64 + __builtin_ctzll(bits);
+      erase_id(by_symbol_[symbol], id);
+    }
+    sub.bits[word] = 0;
+  }
+}
+
+SubscriptionIndex::CommandResult
+SubscriptionIndex::apply_command(uint32_t id, const std::string &line) {
+  const size_t space = line.find(' ');
+  const std::string verb = line.substr(0, space);
+  bool sub;
+  if (verb == protocol::SUBSCRIBE) {
+    sub = true;
+  } else if (verb == protocol::UNSUBSCRIBE) {
+    sub = false;
+  } else {
+    return CommandResult::NotCommand;
+  }
+
+  bool unknown = false;
+  size_t pos = space == std::string::npos ? line.size() : space + 1;
+  while (pos < line.size()) {
+    size_t end = line.find_first_of(" ,", pos);
+    if (end == std::string::npos) {
+      end = line.size();
+    }
+    if (end > pos) {
+      const std::string name = line.substr(pos, end - pos);
+      if (name == "*") {
+        sub ? subscribe_all(id) : unsubscribe_all(id);
+      } else {
+        const uint32_t symbol = find_symbol(name);
+        if (symbol == protocol::NO_SYMBOL) {
+          unknown = true;
+        } else {
+          sub ? subscribe(id, symbol) : unsubscribe(id, symbol);
+        }
+      }
+    }
+    pos = end + 1;
+  }
+  return unknown ? CommandResult::UnknownSymbol : CommandResult::Applied;
+}
+
+uint32_t SubscriptionIndex::find_symbol(const std::string &name) const {
+  auto it = symbol_ids_.find(name);
+  return it == symbol_ids_.end() ? protocol::NO_SYMBOL : it->second;
+}
+
+const std::vector<SubscriptionIndex::Recipient> &
+SubscriptionIndex::route(const uint32_t *symbols, size_t count) {
+  recipients_.clear();
+  for (size_t i = 0; i < count && i < MAX_BATCH; ++i) {
+    const uint64_t bit = uint64_t{1} << i;
+    if (symbols[i] == protocol::NO_SYMBOL) {
+      mark(members_, bit);
+      continue;
+    }
+    if (symbols[i] < by_symbol_.size()) {
+      mark(by_symbol_[symbols[i]], bit);
+    }
+    mark(wildcard_, bit);
+  }
+
+  for (Recipient &r : recipients_) {
+    r.mask = masks_[r.id];
+    masks_[r.id] = 0;
+  }
+  return recipients_;
+}
+
+bool SubscriptionIndex::wants(uint32_t id, uint32_t symbol) const {
+  if (id >= subscribers_.size() || !subscribers_[id].active) {
+    return false;
+  }
+  const Subscriber &sub = subscribers_[id];
+  return sub.all || symbol >= by_symbol_.size() || has(sub, symbol);
+}
+
+size_t SubscriptionIndex::subscriber_count(uint32_t symbol) const {
+  return (symbol < by_symbol_.size() ? by_symbol_[symbol].size() : 0) +
+         wildcard_.size();
+}
+
+void SubscriptionIndex::set_all(uint32_t id, Subscriber &sub, bool all) {
+  if (sub.all == all) {
+    return;
+  }
+  sub.all = all;
+  if (all) {
+    wildcard_.push_back(id);
+  } else {
+    erase_id(wildcard_, id);
+  }
+}
+
+void SubscriptionIndex::mark(const std::vector<uint32_t> &ids, uint64_t bit) {
+  for (uint32_t id : ids) {
+    if (masks_[id] == 0) {
+      recipients_.push_back({id, 0});
+    }
+    masks_[id] |= bit;
+  }
+}
+
+void SubscriptionIndex::erase_id(std::vector<uint32_t> &ids, uint32_t id) {
+  auto it = std::find(ids.begin(), ids.end(), id);
+  if (it != ids.end()) {
+    *it = ids.back();
+    ids.pop_back();
+  }
+}
+
+} // namespace emb
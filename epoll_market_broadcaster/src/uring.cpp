@@ -0,0 +1,165 @@
+#include "uring.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace emb {
+
+namespace {
+
+int sys_io_uring_setup(unsigned entries, io_uring_params *params) {
+  return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete,
+                       unsigned flags) {
+  return static_cast<int>(::syscall(__NR_io_uring_enter, fd, to_submit,
+                                    min_complete, flags, nullptr, 0));
+}
+
+int sys_io_uring_register(int fd, unsigned opcode, const void *arg,
+                          unsigned nr_args) {
+  return static_cast<int>(
+      ::syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+} // namespace
+
+IoUring::IoUring(unsigned entries, unsigned cq_entries) {
+  io_uring_params params{};
+  if (cq_entries > 0) {
+    params.flags |= IORING_SETUP_CQSIZE;
+    params.cq_entries = cq_entries;
+  }
+
+  ring_fd_ = sys_io_uring_setup(entries, &params);
+  if (ring_fd_ < 0) {
+    throw std::runtime_error("io_uring_setup() failed: " +
+                             std::string(strerror(errno)));
+  }
+  if (!(params.features & IORING_FEAT_SINGLE_MMAP)) {
+    ::close(ring_fd_);
+    throw std::runtime_error("io_uring: kernel lacks IORING_FEAT_SINGLE_MMAP");
+  }
+
+  // SQ 與 CQ ring 共用一次 mmap
+  const size_t sq_size =
+      params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  const size_t cq_size =
+      params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  ring_size_ = sq_size > cq_size ? sq_size : cq_size;
+
+  ring_ptr_ = ::mmap(nullptr, ring_size_, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+  if (ring_ptr_ == MAP_FAILED) {
+    ring_ptr_ = nullptr;
+    ::close(ring_fd_);
+    throw std::runtime_error("io_uring: mmap ring failed");
+  }
+
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  void *sqes = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    ::munmap(ring_ptr_, ring_size_);
+    ::close(ring_fd_);
+    throw std::runtime_error("io_uring: mmap sqes failed");
+  }
+  sqes_ = static_cast<io_uring_sqe *>(sqes);
+
+  char *base = static_cast<char *>(ring_ptr_);
+  sq_head_ = reinterpret_cast<unsigned *>(base + params.sq_off.head);
+  sq_tail_ = reinterpret_cast<unsigned *>(base + params.sq_off.tail);
+  sq_mask_ = *reinterpret_cast<unsigned *>(base + params.sq_off.ring_mask);
+  sq_entries_ = params.sq_entries;
+
+  // SQ array 固定為 index i -> SQE i，之後只需要推進 tail
+  unsigned *sq_array = reinterpret_cast<unsigned *>(base + params.sq_off.array);
+  for (unsigned i = 0; i < sq_entries_; ++i) {
+    sq_array[i] = i;
+  }
+  sqe_head_ = sqe_tail_ = *sq_tail_;
+
+  cq_head_ = reinterpret_cast<unsigned *>(base + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<unsigned *>(base + params.cq_off.tail);
+  cq_mask_ = *reinterpret_cast<unsigned *>(base + params.cq_off.ring_mask);
+  cqes_ = reinterpret_cast<io_uring_cqe *>(base + params.cq_off.cqes);
+}
+
+IoUring::~IoUring() {
+  if (sqes_ != nullptr) {
+    ::munmap(sqes_, sqes_size_);
+  }
+  if (ring_ptr_ != nullptr) {
+    ::munmap(ring_ptr_, ring_size_);
+  }
+  if (ring_fd_ != -1) {
+    ::close(ring_fd_);
+  }
+}
+
+io_uring_sqe *IoUring::get_sqe() {
+  const unsigned head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+  if (sqe_tail_ - head >= sq_entries_) {
+    return nullptr;
+  }
+
+  io_uring_sqe *sqe = &sqes_[sqe_tail_ & sq_mask_];
+  ++sqe_tail_;
+  std::memset(sqe, 0, sizeof(*sqe));
+  return sqe;
+}
+
+int IoUring::submit_and_wait(unsigned wait_nr) {
+  const unsigned to_submit = sqe_tail_ - sqe_head_;
+  if (to_submit > 0) {
+    // release：讓 kernel 看到 tail 時 SQE 內容已經寫好
+    __atomic_store_n(sq_tail_, sqe_tail_, __ATOMIC_RELEASE);
+    sqe_head_ = sqe_tail_;
+  }
+  if (to_submit == 0 && wait_nr == 0) {
+    return 0;
+  }
+
+  const unsigned flags = wait_nr > 0 ? IORING_ENTER_GETEVENTS : 0;
+  int ret = sys_io_uring_enter(ring_fd_, to_submit, wait_nr, flags);
+  count_syscall();
+  return ret < 0 ? -errno : ret;
+}
+
+int IoUring::do_register(unsigned opcode, const void *arg, unsigned nr_args) {
+  int ret = sys_io_uring_register(ring_fd_, opcode, arg, nr_args);
+  count_syscall();
+  return ret < 0 ? -errno : 0;
+}
+
+int IoUring::register_files(const int *fds, unsigned count) {
+  return do_register(IORING_REGISTER_FILES, fds, count);
+}
+
+int IoUring::update_file(unsigned slot, int fd) {
+  io_uring_files_update update{};
+  update.offset = slot;
+  update.fds = reinterpret_cast<uint64_t>(&fd);
+  return do_register(IORING_REGISTER_FILES_UPDATE, &update, 1);
+}
+
+int IoUring::register_buffers(const iovec *iovs, unsigned count) {
+  return do_register(IORING_REGISTER_BUFFERS, iovs, count);
+}
+
+int IoUring::register_buf_ring(io_uring_buf_ring *ring, unsigned entries,
+                               uint16_t group_id) {
+  io_uring_buf_reg reg{};
+  reg.ring_addr = reinterpret_cast<uint64_t>(ring);
+  reg.ring_entries = entries;
+  reg.bgid = group_id;
+  return do_register(IORING_REGISTER_PBUF_RING, &reg, 1);
+}
+
+} // namespace emb
@@ -0,0 +1,761 @@
+#include "uring_server.h"
+#include "async_logger.h"
+#include "connect.h"
+#include "protocol.h"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <stdexcept>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <utility>
+
+namespace emb {
+
+namespace {
+
+constexpr unsigned RECV_BUFFER_COUNT = 1024; // 必須是 2 的冪次
+constexpr size_t RECV_BUFFER_SIZE = 2048;
+constexpr uint16_t RECV_BUFFER_GROUP = 0;
+
+size_t round_up_pow2(size_t n) {
+  size_t p = 1;
+  while (p < n) {
+    p <<= 1;
+  }
+  return p;
+}
+
+} // namespace
+
+struct UringServer::Conn {
+  enum class State : uint8_t { Free, Open, Closing };
+
+  State state = State::Free;
+  int fd = -1;
+  size_t open_index = 0; // 在 open_slots_ 中的位置
+  WireFormat format = WireFormat::Text;
+  bool recv_armed = false;
+  bool send_scheduled = false; // 已經在 send_ready_ 中
+
+  // 尚未交給 kernel 的訊息 (ring，容量為 2 的冪次)
+  std::vector<PayloadRef> queue;
+  size_t head = 0;
+  size_t count = 0;
+  size_t bytes = 0;
+  uint64_t dropped = 0;
+
+  // 送出中的一批：payload 參考要保留到 kernel 用完為止
+  PayloadRef inflight[MAX_BATCH];
+  size_t inflight_count = 0;
+  size_t inflight_bytes = 0;
+  unsigned send_ops = 0; // 尚未完成的 send 操作 (SEND_ZC 含 notification)
+  iovec iov[MAX_BATCH];
+  msghdr msg{};
+
+  std::string read_buffer;
+
+  PayloadRef &at(size_t i) { return queue[(head + i) & (queue.size() - 1)]; }
+
+  void pop_front() {
+    PayloadRef &front = at(0);
+    bytes -= front.size();
+    front.reset();
+    head = (head + 1) & (queue.size() - 1);
+    --count;
+  }
+};
+
+UringServer::UringServer(const ServerConfig &config)
+    : config_(config),
+      payload_pool_(std::make_unique<PayloadPool>(
+          config_.max_payload_size, payload_pool_capacity(config_, 1))),
+      broadcast_queue_(std::make_unique<MPMCQueue<PayloadRef, 1024>>()),
+      batch_(*payload_pool_, config_.symbols),
+      subscriptions_(config_.symbols),
+      conns_(config_.max_connections) {
+  if (config_.max_connections == 0 || config_.max_connections > UINT32_MAX) {
+    throw std::invalid_argument("max_connections out of range");
+  }
+  if (config_.num_reactors > 1) {
+    EMB_LOG_WARN("io_uring backend runs a single event loop, "
+                 "ignoring num_reactors={}",
+                 config_.num_reactors);
+  }
+
+  // 多數 CQE 來自 multishot recv 與 send，CQ 留大一點避免 overflow
+  ring_ = std::make_unique<IoUring>(config_.uring_entries,
+                                    config_.uring_entries * 4);
+
+  create_listen_socket(config_.port);
+
+  wake_fd_ = ::eventfd(0, EFD_CLOEXEC);
+  if (wake_fd_ == -1) {
+    throw std::runtime_error("eventfd() failed: " +
+                             std::string(strerror(errno)));
+  }
+
+  setup_buffer_ring();
+
+  if (config_.uring_fixed_files) {
+    // 先註冊一張全空的 table，accept 之後再填入對應的 slot
+    std::vector<int> fds(config_.max_connections, -1);
+    int ret = ring_->register_files(fds.data(),
+                                    static_cast<unsigned>(fds.size()));
+    if (ret < 0) {
+      EMB_LOG_WARN("io_uring: register files failed ({}), using plain fds",
+                   strerror(-ret));
+      config_.uring_fixed_files = false;
+    }
+  }
+  if (config_.uring_registered_buffers) {
+    setup_fixed_buffers();
+  }
+
+  free_slots_.reserve(config_.max_connections);
+  for (size_t i = config_.max_connections; i > 0; --i) {
+    free_slots_.push_back(static_cast<uint32_t>(i - 1));
+  }
+  open_slots_.reserve(config_.max_connections);
+  send_ready_.reserve(config_.max_connections);
+
+  EMB_LOG_INFO("Server listening on port {} (io_uring, fixed files: {}, "
+               "fixed buffers: {})",
+               config_.port, config_.uring_fixed_files, fixed_buffers_);
+}
+
+UringServer::~UringServer() {
+  // 先關掉 ring，kernel 取消所有操作之後才能釋放它們用到的記憶體
+  ring_.reset();
+
+  for (auto &conn : conns_) {
+    if (conn.fd != -1) {
+      ::close(conn.fd);
+    }
+  }
+  if (buf_ring_ != nullptr) {
+    ::munmap(buf_ring_, buf_ring_size_);
+  }
+  if (wake_fd_ != -1) {
+    ::close(wake_fd_);
+  }
+  if (listen_fd_ != -1) {
+    ::close(listen_fd_);
+  }
+}
+
+void UringServer::create_listen_socket(uint16_t port) {
+  listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+  if (listen_fd_ < 0) {
+    throw std::runtime_error("socket() failed: " +
+                             std::string(strerror(errno)));
+  }
+
+  int reuse = 1;
+  if (::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse,
+                   sizeof(reuse)) == -1) {
+    throw std::runtime_error("setsockopt() failed: " +
+                             std::string(strerror(errno)));
+  }
+
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = INADDR_ANY;
+  addr.sin_port = htons(port);
+
+  if (::bind(listen_fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) ==
+      -1) {
+    throw std::runtime_error("bind() failed: " + std::string(strerror(errno)));
+  }
+
+  if (::listen(listen_fd_, SOMAXCONN) == -1) {
+    throw std::runtime_error("listen() failed: " +
+                             std::string(strerror(errno)));
+  }
+}
+
+void UringServer::setup_buffer_ring() {
+  // buffer ring 本身必須 page 對齊
+  buf_ring_size_ = RECV_BUFFER_COUNT * sizeof(io_uring_buf);
+  void *mem = ::mmap(nullptr, buf_ring_size_, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (mem == MAP_FAILED) {
+    throw std::runtime_error("io_uring: mmap buffer ring failed");
+  }
+  buf_ring_ = static_cast<io_uring_buf_ring *>(mem);
+
+  int ret =
+      ring_->register_buf_ring(buf_ring_, RECV_BUFFER_COUNT, RECV_BUFFER_GROUP);
+  if (ret < 0) {
+    throw std::runtime_error("io_uring: register buffer ring failed: " +
+                             std::string(strerror(-ret)));
+  }
+
+  recv_buffers_.reset(new char[RECV_BUFFER_COUNT * RECV_BUFFER_SIZE]);
+  for (unsigned i = 0; i < RECV_BUFFER_COUNT; ++i) {
+    recycle_buffer(static_cast<uint16_t>(i));
+  }
+}
+
+void UringServer::setup_fixed_buffers() {
+  iovec iov{};
+  iov.iov_base = payload_pool_->storage();
+  iov.iov_len = payload_pool_->storage_size();
+
+  int ret = ring_->register_buffers(&iov, 1);
+  if (ret < 0) {
+    // 通常是 RLIMIT_MEMLOCK 不夠
+    EMB_LOG_WARN("io_uring: register buffers failed ({}), using SENDMSG",
+                 strerror(-ret));
+    return;
+  }
+  fixed_buffers_ = true;
+}
+
+void UringServer::recycle_buffer(uint16_t bid) {
+  const unsigned mask = RECV_BUFFER_COUNT - 1;
+  // 不能用 buf_ring_->bufs：__DECLARE_FLEX_ARRAY 在 C++ 中的空 struct
+  // 佔 1 byte，bufs 會被排到 offset 8，與 kernel 的 layout 不符
+  io_uring_buf &buf =
+      reinterpret_cast<io_uring_buf *>(buf_ring_)[buf_ring_tail_ & mask];
+  buf.addr = reinterpret_cast<uint64_t>(recv_buffers_.get() +
+                                        bid * RECV_BUFFER_SIZE);
+  buf.len = RECV_BUFFER_SIZE;
+  buf.bid = bid;
+  ++buf_ring_tail_;
+  // release：kernel 看到新的 tail 時 entry 已經寫好
+  __atomic_store_n(&buf_ring_->tail, buf_ring_tail_, __ATOMIC_RELEASE);
+}
+
+io_uring_sqe *UringServer::get_sqe() {
+  io_uring_sqe *sqe = ring_->get_sqe();
+  if (sqe == nullptr) {
+    // SQ 滿了，先送出目前累積的再取
+    ring_->submit();
+    sqe = ring_->get_sqe();
+    if (sqe == nullptr) {
+      throw std::runtime_error("io_uring: submission queue full");
+    }
+  }
+  return sqe;
+}
+
+void UringServer::arm_accept() {
+  io_uring_sqe *sqe = get_sqe();
+  sqe->opcode = IORING_OP_ACCEPT;
+  sqe->fd = listen_fd_;
+  sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+  sqe->user_data = make_user_data(Op::Accept, 0);
+}
+
+void UringServer::arm_recv(uint32_t slot) {
+  Conn &conn = conns_[slot];
+
+  io_uring_sqe *sqe = get_sqe();
+  sqe->opcode = IORING_OP_RECV;
+  if (config_.uring_fixed_files) {
+    sqe->fd = static_cast<int>(slot);
+    sqe->flags |= IOSQE_FIXED_FILE;
+  } else {
+    sqe->fd = conn.fd;
+  }
+  sqe->ioprio = IORING_RECV_MULTISHOT;
+  sqe->flags |= IOSQE_BUFFER_SELECT;
+  sqe->buf_group = RECV_BUFFER_GROUP;
+  sqe->user_data = make_user_data(Op::Recv, slot);
+  conn.recv_armed = true;
+}
+
+void UringServer::arm_wake() {
+  io_uring_sqe *sqe = get_sqe();
+  sqe->opcode = IORING_OP_READ;
+  sqe->fd = wake_fd_;
+  sqe->addr = reinterpret_cast<uint64_t>(&wake_value_);
+  sqe->len = sizeof(wake_value_);
+  sqe->user_data = make_user_data(Op::Wake, 0);
+}
+
+void UringServer::run() {
+  running_.store(true, std::memory_order_release);
+
+  arm_accept();
+  arm_wake();
+
+  while (running_.load(std::memory_order_relaxed)) {
+    unsigned wait_nr = 1;
+    if (dispatch_broadcasts() || config_.busy_poll) {
+      wait_nr = 0;
+    } else {
+      // 與 EpollServer 的 reactor 相同：先宣告要睡了再檢查一次 queue
+      sleeping_.store(true, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (dispatch_broadcasts() || !running_.load(std::memory_order_relaxed)) {
+        wait_nr = 0;
+      }
+    }
+    submit_sends();
+
+    int ret = ring_->submit_and_wait(wait_nr);
+    sleeping_.store(false, std::memory_order_relaxed);
+    if (ret < 0 && ret != -EINTR && ret != -EAGAIN && ret != -EBUSY) {
+      throw std::runtime_error("io_uring_enter failed: " +
+                               std::string(strerror(-ret)));
+    }
+
+    ring_->for_each_cqe([this](const io_uring_cqe &cqe) { handle_cqe(cqe); });
+  }
+}
+
+void UringServer::stop() {
+  running_.store(false, std::memory_order_relaxed);
+  uint64_t one = 1;
+  [[maybe_unused]] ssize_t n = ::write(wake_fd_, &one, sizeof(one));
+}
+
+void UringServer::handle_cqe(const io_uring_cqe &cqe) {
+  const auto op = static_cast<Op>(cqe.user_data >> 56);
+  const auto slot = static_cast<uint32_t>(cqe.user_data & 0xffffffffu);
+
+  switch (op) {
+  case Op::Accept:
+    handle_accept(cqe);
+    break;
+  case Op::Recv:
+    handle_recv(slot, cqe);
+    break;
+  case Op::Send:
+    handle_send(slot, cqe);
+    break;
+  case Op::Wake:
+    if (running_.load(std::memory_order_relaxed)) {
+      arm_wake();
+    }
+    break;
+  }
+}
+
+void UringServer::handle_accept(const io_uring_cqe &cqe) {
+  if (!(cqe.flags & IORING_CQE_F_MORE) &&
+      running_.load(std::memory_order_relaxed)) {
+    arm_accept(); // multishot 被 kernel 終止，重新註冊
+  }
+
+  if (cqe.res < 0) {
+    EMB_LOG_ERROR("accept failed: {}", strerror(-cqe.res));
+    return;
+  }
+
+  const int client_fd = cqe.res;
+  if (free_slots_.empty()) {
+    EMB_LOG_WARN("Too many connections, rejecting fd={}", client_fd);
+    ::close(client_fd);
+    return;
+  }
+
+  const uint32_t slot = free_slots_.back();
+  if (config_.uring_fixed_files) {
+    int ret = ring_->update_file(slot, client_fd);
+    if (ret < 0) {
+      EMB_LOG_ERROR("io_uring: update file failed: {}", strerror(-ret));
+      ::close(client_fd);
+      return;
+    }
+  }
+  free_slots_.pop_back();
+
+  Conn &conn = conns_[slot];
+  conn.state = Conn::State::Open;
+  conn.fd = client_fd;
+  conn.format = WireFormat::Text;
+  const size_t capacity =
+      round_up_pow2(std::max<size_t>(config_.outbound_messages, 2));
+  if (conn.queue.size() != capacity) {
+    conn.queue.assign(capacity, PayloadRef());
+  }
+  conn.head = conn.count = conn.bytes = 0;
+  conn.dropped = 0;
+  conn.read_buffer.clear();
+  conn.open_index = open_slots_.size();
+  open_slots_.push_back(slot);
+  subscriptions_.add(slot);
+
+  arm_recv(slot);
+  connection_count_.fetch_add(1, std::memory_order_relaxed);
+
+  EMB_LOG_INFO("New connection: fd={} slot={}, total={}", client_fd, slot,
+               connection_count_.load(std::memory_order_relaxed));
+}
+
+void UringServer::handle_recv(uint32_t slot, const io_uring_cqe &cqe) {
+  Conn &conn = conns_[slot];
+
+  if (cqe.res > 0 && (cqe.flags & IORING_CQE_F_BUFFER)) {
+    const auto bid =
+        static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+    if (conn.state == Conn::State::Open) {
+      conn.read_buffer.append(recv_buffers_.get() + bid * RECV_BUFFER_SIZE,
+                              static_cast<size_t>(cqe.res));
+    }
+    recycle_buffer(bid);
+
+    size_t pos;
+    while (conn.state == Conn::State::Open &&
+           (pos = conn.read_buffer.find('\n')) != std::string::npos) {
+      std::string msg = conn.read_buffer.substr(0, pos);
+      conn.read_buffer.erase(0, pos + 1);
+      if (!msg.empty() && msg.back() == '\r') {
+        msg.pop_back();
+      }
+      handle_message(slot, msg);
+    }
+  } else if (cqe.res == 0) {
+    close_conn(slot); // 對方正常關閉
+  } else if (cqe.res < 0 && cqe.res != -ENOBUFS) {
+    if (conn.state == Conn::State::Open) {
+      EMB_LOG_ERROR("recv failed on fd {}: {}", conn.fd, strerror(-cqe.res));
+    }
+    close_conn(slot);
+  }
+  // -ENOBUFS：buffer ring 暫時用完，multishot 會結束，下面重新註冊即可
+
+  if (!(cqe.flags & IORING_CQE_F_MORE)) {
+    conn.recv_armed = false;
+    if (conn.state == Conn::State::Open) {
+      arm_recv(slot);
+    } else {
+      maybe_release(slot);
+    }
+  }
+}
+
+void UringServer::handle_message(uint32_t slot, const std::string &msg) {
+  Conn &conn = conns_[slot];
+  WireFormat format;
+  if (msg == protocol::BINARY_REQUEST) {
+    format = WireFormat::Binary;
+  } else if (msg == protocol::TEXT_REQUEST) {
+    format = WireFormat::Text;
+  } else {
+    // 訂閱指令不回覆：二進位連線的資料流中不能夾雜文字
+    switch (subscriptions_.apply_command(slot, msg)) {
+    case SubscriptionIndex::CommandResult::NotCommand:
+      EMB_LOG_DEBUG("Received from fd {}: {}", conn.fd, msg);
+      break;
+    case SubscriptionIndex::CommandResult::Applied:
+      EMB_LOG_DEBUG("fd={} {}", conn.fd, msg);
+      break;
+    case SubscriptionIndex::CommandResult::UnknownSymbol:
+      EMB_LOG_WARN("fd={} unknown symbol in '{}'", conn.fd, msg);
+      break;
+    }
+    return;
+  }
+
+  if (conn.format != format) {
+    conn.format = format;
+    if (format == WireFormat::Binary) {
+      ++binary_conns_;
+    } else {
+      --binary_conns_;
+    }
+    EMB_LOG_INFO("fd={} switched to {} format", conn.fd,
+                 format == WireFormat::Binary ? "binary" : "text");
+  }
+
+  // 回覆排在所有舊格式的資料之後，client 看到回覆之後就換格式
+  const char *ack = format == WireFormat::Binary ? protocol::BINARY_ACK
+                                                 : protocol::TEXT_ACK;
+  PayloadRef reply = payload_pool_->make(ack, std::strlen(ack));
+  if (!reply) {
+    close_conn(slot);
+    return;
+  }
+  enqueue_to(conn, reply);
+}
+
+void UringServer::handle_send(uint32_t slot, const io_uring_cqe &cqe) {
+  Conn &conn = conns_[slot];
+
+  if (!(cqe.flags & IORING_CQE_F_NOTIF)) {
+    bool failed = cqe.res < 0;
+    // MSG_WAITALL 下只有出錯才會送不完
+    if (!fixed_buffers_ && !failed &&
+        static_cast<size_t>(cqe.res) != conn.inflight_bytes) {
+      failed = true;
+    }
+    if (failed) {
+      if (conn.state == Conn::State::Open && cqe.res != -ECANCELED) {
+        EMB_LOG_ERROR("send failed on fd {}: {}", conn.fd,
+                      cqe.res < 0 ? strerror(-cqe.res) : "short write");
+      }
+      close_conn(slot);
+    }
+    if (cqe.flags & IORING_CQE_F_MORE) {
+      return; // SEND_ZC：等 notification 之後 buffer 才能釋放
+    }
+  }
+
+  if (--conn.send_ops > 0) {
+    return;
+  }
+
+  for (size_t i = 0; i < conn.inflight_count; ++i) {
+    conn.inflight[i].reset();
+  }
+  conn.inflight_count = 0;
+  conn.inflight_bytes = 0;
+
+  if (conn.state != Conn::State::Open) {
+    maybe_release(slot);
+  } else if (conn.count > 0 && !conn.send_scheduled) {
+    conn.send_scheduled = true;
+    send_ready_.push_back(slot);
+  }
+}
+
+bool UringServer::enqueue_broadcast(const std::string &data) {
+  PayloadRef payload = payload_pool_->make(data.data(), data.size());
+  if (!payload) {
+    return false; // 訊息過大或 pool 用完
+  }
+  return enqueue_broadcast(std::move(payload));
+}
+
+bool UringServer::enqueue_broadcast(PayloadRef payload) {
+  if (!broadcast_queue_->push(std::move(payload))) {
+    return false;
+  }
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (sleeping_.load(std::memory_order_relaxed)) {
+    uint64_t one = 1;
+    [[maybe_unused]] ssize_t n = ::write(wake_fd_, &one, sizeof(one));
+  }
+  return true;
+}
+
+bool UringServer::dispatch_broadcasts() {
+  bool worked = false;
+  PayloadRef payloads[FanoutBatch::CAPACITY];
+  while (true) {
+    size_t count = 0;
+    while (count < FanoutBatch::CAPACITY) {
+      auto payload = broadcast_queue_->pop();
+      if (!payload) {
+        break;
+      }
+      // 與 epoll backend 相同，分派時填入全域遞增的 seq
+      if ((*payload)->format() == PayloadFormat::Binary &&
+          protocol::set_seq((*payload)->mutable_data(), payload->size(),
+                            last_seq_ + 1)) {
+        ++last_seq_;
+      }
+      payloads[count++] = std::move(*payload);
+    }
+    if (count == 0) {
+      break;
+    }
+
+    batch_.build(payloads, count, open_slots_.size() > binary_conns_,
+                 binary_conns_ > 0);
+    // enqueue_to 斷線時只會把連線標成 Closing，route 的結果仍然有效
+    const auto &recipients = subscriptions_.route(batch_.symbols(), count);
+    for (const auto &recipient : recipients) {
+      Conn &conn = conns_[recipient.id];
+      const PayloadRef *source =
+          conn.format == WireFormat::Binary ? batch_.binary() : batch_.text();
+      for (uint64_t bits = recipient.mask;
+           bits != 0 && conn.state == Conn::State::Open; bits &= bits - 1) {
+        const PayloadRef &payload = source[__builtin_ctzll(bits)];
+        if (payload) {
+          enqueue_to(conn, payload);
+        }
+      }
+    }
+    batch_.clear();
+
+    for (size_t i = 0; i < count; ++i) {
+      payloads[i].reset();
+      counters_.add_broadcasts();
+    }
+    worked = true;
+  }
+  return worked;
+}
+
+void UringServer::enqueue_to(Conn &conn, const PayloadRef &payload) {
+  const size_t size = payload.size();
+  const bool full = conn.count == conn.queue.size() ||
+                    conn.bytes + size > config_.outbound_capacity;
+
+  if (full) {
+    switch (config_.slow_consumer_policy) {
+    case SlowConsumerPolicy::Disconnect:
+      EMB_LOG_WARN("Slow consumer fd {}: outbound queue full ({} bytes), "
+                   "disconnecting",
+                   conn.fd, conn.bytes);
+      close_conn(static_cast<uint32_t>(&conn - conns_.data()));
+      return;
+    case SlowConsumerPolicy::DropOldest:
+      while (conn.count > 0 &&
+             (conn.count == conn.queue.size() ||
+              conn.bytes + size > config_.outbound_capacity)) {
+        conn.pop_front();
+        ++conn.dropped;
+      }
+      break;
+    case SlowConsumerPolicy::Conflate:
+      conn.dropped += conn.count;
+      while (conn.count > 0) {
+        conn.pop_front();
+      }
+      break;
+    }
+    if (size > config_.outbound_capacity) {
+      ++conn.dropped; // 單則訊息比整個佇列還大
+      return;
+    }
+  }
+
+  conn.at(conn.count) = payload;
+  ++conn.count;
+  conn.bytes += size;
+
+  if (conn.send_ops == 0 && !conn.send_scheduled) {
+    conn.send_scheduled = true;
+    send_ready_.push_back(static_cast<uint32_t>(&conn - conns_.data()));
+  }
+}
+
+void UringServer::submit_sends() {
+  for (uint32_t slot : send_ready_) {
+    Conn &conn = conns_[slot];
+    conn.send_scheduled = false;
+    if (conn.state == Conn::State::Open && conn.send_ops == 0 &&
+        conn.count > 0) {
+      submit_batch(slot, conn);
+    }
+  }
+  send_ready_.clear();
+}
+
+void UringServer::submit_batch(uint32_t slot, Conn &conn) {
+  const size_t n = std::min(conn.count, MAX_BATCH);
+
+  conn.inflight_bytes = 0;
+  for (size_t i = 0; i < n; ++i) {
+    PayloadRef &front = conn.at(0);
+    conn.inflight_bytes += front.size();
+    conn.bytes -= front.size();
+    conn.inflight[i] = std::move(front);
+    conn.head = (conn.head + 1) & (conn.queue.size() - 1);
+    --conn.count;
+  }
+  conn.inflight_count = n;
+
+  auto set_target = [&](io_uring_sqe *sqe) {
+    if (config_.uring_fixed_files) {
+      sqe->fd = static_cast<int>(slot);
+      sqe->flags |= IOSQE_FIXED_FILE;
+    } else {
+      sqe->fd = conn.fd;
+    }
+    sqe->user_data = make_user_data(Op::Send, slot);
+  };
+
+  if (!fixed_buffers_) {
+    // 一批一個 SENDMSG，每則訊息一段 iovec
+    for (size_t i = 0; i < n; ++i) {
+      conn.iov[i].iov_base = const_cast<char *>(conn.inflight[i].data());
+      conn.iov[i].iov_len = conn.inflight[i].size();
+    }
+    conn.msg = msghdr{};
+    conn.msg.msg_iov = conn.iov;
+    conn.msg.msg_iovlen = n;
+
+    io_uring_sqe *sqe = get_sqe();
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->addr = reinterpret_cast<uint64_t>(&conn.msg);
+    sqe->msg_flags = MSG_NOSIGNAL | MSG_WAITALL;
+    set_target(sqe);
+    conn.send_ops = 1;
+    return;
+  }
+
+  // 一則訊息一個 SEND_ZC，以 IOSQE_IO_LINK 串成一條保證順序的鏈；
+  // 整條鏈必須在同一次 submit 中，SQ 空間不夠就先送出
+  if (ring_->space() < n) {
+    ring_->submit();
+  }
+  for (size_t i = 0; i < n; ++i) {
+    io_uring_sqe *sqe = get_sqe();
+    sqe->opcode = IORING_OP_SEND_ZC;
+    sqe->addr = reinterpret_cast<uint64_t>(conn.inflight[i].data());
+    sqe->len = static_cast<uint32_t>(conn.inflight[i].size());
+    sqe->msg_flags = MSG_NOSIGNAL | MSG_WAITALL;
+    sqe->ioprio = IORING_RECVSEND_FIXED_BUF;
+    sqe->buf_index = 0;
+    set_target(sqe);
+    if (i + 1 < n) {
+      sqe->flags |= IOSQE_IO_LINK;
+    }
+  }
+  conn.send_ops = static_cast<unsigned>(n);
+}
+
+void UringServer::close_conn(uint32_t slot) {
+  Conn &conn = conns_[slot];
+  if (conn.state != Conn::State::Open) {
+    return;
+  }
+
+  conn.state = Conn::State::Closing;
+  if (conn.format == WireFormat::Binary) {
+    --binary_conns_;
+  }
+  subscriptions_.remove(slot);
+  const uint32_t last = open_slots_.back();
+  open_slots_[conn.open_index] = last;
+  conns_[last].open_index = conn.open_index;
+  open_slots_.pop_back();
+  // shutdown 讓 multishot recv 與送出中的 send 盡快結束
+  ::shutdown(conn.fd, SHUT_RDWR);
+  while (conn.count > 0) {
+    conn.pop_front();
+  }
+  connection_count_.fetch_sub(1, std::memory_order_relaxed);
+
+  EMB_LOG_INFO("Connection closed: fd={}, remaining={}", conn.fd,
+               connection_count_.load(std::memory_order_relaxed));
+  maybe_release(slot);
+}
+
+void UringServer::maybe_release(uint32_t slot) {
+  Conn &conn = conns_[slot];
+  if (conn.state != Conn::State::Closing || conn.recv_armed ||
+      conn.send_ops > 0) {
+    return;
+  }
+
+  if (config_.uring_fixed_files) {
+    ring_->update_file(slot, -1);
+  }
+  ::close(conn.fd);
+  conn.fd = -1;
+  conn.state = Conn::State::Free;
+  free_slots_.push_back(slot);
+}
+
+ServerStats UringServer::stats() const {
+  ServerStats stats;
+  stats.connections = connection_count_.load(std::memory_order_relaxed);
+  stats.broadcasts = counters_.broadcasts.load(std::memory_order_relaxed);
+  stats.syscalls = ring_->syscalls();
+  return stats;
+}
+
+} // namespace emb
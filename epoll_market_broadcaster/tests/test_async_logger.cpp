@@ -0,0 +1,68 @@
+#include "async_logger.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace emb::test {
+
+namespace {
+
+std::vector<std::string> read_lines(const std::string &path) {
+  std::ifstream in(path);
+  std::vector<std::string> lines;
+  for (std::string line; std::getline(in, line);) {
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+} // namespace
+
+// 背景線程持續寫檔時，新線程陸續登記 ring；停止時所有訊息都要寫出
+TEST(AsyncLoggerTest, DrainsEveryThread) {
+  const std::string path =
+      "/tmp/emb_async_logger_test_" + std::to_string(::getpid()) + ".log";
+  std::remove(path.c_str());
+
+  constexpr int THREADS = 8;
+  constexpr int MESSAGES = 200;
+  log::start({path, -1, log::Level::Info, 10});
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < THREADS; ++t) {
+    threads.emplace_back([t] {
+      EMB_LOG_INFO("thread start");
+      for (int i = 0; i < MESSAGES; ++i) {
+        EMB_LOG_INFO("thread {} message {} {}", t, i, std::string("payload"));
+      }
+      EMB_LOG_DEBUG("filtered out");
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  log::stop();
+
+  const auto lines = read_lines(path);
+  std::remove(path.c_str());
+  EXPECT_EQ(log::dropped(), 0u);
+  ASSERT_EQ(lines.size(), static_cast<size_t>(THREADS * (MESSAGES + 1)));
+
+  std::set<std::string> bodies;
+  for (const auto &line : lines) {
+    EXPECT_NE(line.find("[info] "), std::string::npos) << line;
+    bodies.insert(line.substr(line.find("[info] ") + 7));
+  }
+  EXPECT_EQ(bodies.count("thread start"), 1u);
+  EXPECT_EQ(bodies.count("thread 3 message 199 payload"), 1u);
+  EXPECT_EQ(bodies.size(), static_cast<size_t>(THREADS * MESSAGES + 1));
+}
+
+} // namespace emb::test
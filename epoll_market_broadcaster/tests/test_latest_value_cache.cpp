@@ -0,0 +1,76 @@
+#include "latest_value_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <thread>
+
+namespace emb::test {
+
+TEST(LatestValueCacheTest, EmptyUntilUpdated) {
+  LatestValueCache cache(4);
+  char out[LatestValueCache::MAX_VALUE_SIZE];
+
+  EXPECT_EQ(cache.size(), 4u);
+  EXPECT_EQ(cache.read(0, out), 0u);
+  EXPECT_EQ(cache.read(4, out), 0u);
+}
+
+TEST(LatestValueCacheTest, KeepsLatestValuePerSymbol) {
+  LatestValueCache cache(4);
+  char out[LatestValueCache::MAX_VALUE_SIZE];
+
+  EXPECT_TRUE(cache.update(1, "first", 5));
+  EXPECT_TRUE(cache.update(1, "second!", 7));
+  EXPECT_TRUE(cache.update(3, "x", 1));
+
+  ASSERT_EQ(cache.read(1, out), 7u);
+  EXPECT_EQ(std::string(out, 7), "second!");
+  ASSERT_EQ(cache.read(3, out), 1u);
+  EXPECT_EQ(out[0], 'x');
+  EXPECT_EQ(cache.read(0, out), 0u);
+}
+
+TEST(LatestValueCacheTest, RejectsOutOfRange) {
+  LatestValueCache cache(2);
+  const std::string big(LatestValueCache::MAX_VALUE_SIZE + 1, 'a');
+
+  EXPECT_FALSE(cache.update(2, "a", 1));
+  EXPECT_FALSE(cache.update(0, big.data(), big.size()));
+  EXPECT_TRUE(cache.update(0, big.data(), LatestValueCache::MAX_VALUE_SIZE));
+}
+
+// 讀取者在寫入同時進行時，永遠只會看到完整寫入的某一個值
+TEST(LatestValueCacheTest, ConcurrentReadsAreNeverTorn) {
+  LatestValueCache cache(1);
+  constexpr int ITERATIONS = 200000;
+  std::atomic<bool> done{false};
+
+  std::thread writer([&] {
+    char value[LatestValueCache::MAX_VALUE_SIZE];
+    for (int i = 1; i <= ITERATIONS; ++i) {
+      std::memset(value, 'a' + i % 26, sizeof(value));
+      cache.update(0, value, 16 + i % 48);
+    }
+    done.store(true, std::memory_order_release);
+  });
+
+  size_t torn = 0;
+  char out[LatestValueCache::MAX_VALUE_SIZE];
+  while (!done.load(std::memory_order_acquire)) {
+    const size_t len = cache.read(0, out);
+    for (size_t i = 1; i < len; ++i) {
+      if (out[i] != out[0]) {
+        ++torn;
+        break;
+      }
+    }
+  }
+  writer.join();
+
+  EXPECT_EQ(torn, 0u);
+}
+
+} // namespace emb::test
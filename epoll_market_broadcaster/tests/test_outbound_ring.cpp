@@ -0,0 +1,176 @@
+#include "outbound_ring.h"
+#include "payload_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <sys/uio.h>
+#include <vector>
+
+namespace emb::test {
+
+namespace {
+
+PayloadRef make(PayloadPool &pool, const std::string &text) {
+  PayloadRef ref = pool.make(text.data(), text.size());
+  EXPECT_TRUE(ref);
+  return ref;
+}
+
+// 依序取出 ring 中所有待送的資料
+std::vector<std::string> pending(const OutboundRing &ring) {
+  iovec iov[64];
+  const int n = ring.peek(iov, 64);
+  std::vector<std::string> out;
+  for (int i = 0; i < n; ++i) {
+    out.emplace_back(static_cast<const char *>(iov[i].iov_base),
+                     iov[i].iov_len);
+  }
+  return out;
+}
+
+} // namespace
+
+TEST(OutboundRingTest, PushPeekConsume) {
+  PayloadPool pool;
+  OutboundRing ring(1024, 8);
+
+  EXPECT_TRUE(ring.empty());
+  EXPECT_TRUE(ring.push(make(pool, "abc")));
+  EXPECT_TRUE(ring.push(make(pool, "defg")));
+  EXPECT_EQ(ring.messages(), 2u);
+  EXPECT_EQ(ring.size(), 7u);
+  EXPECT_EQ(pending(ring), (std::vector<std::string>{"abc", "defg"}));
+
+  // 跨訊息邊界的部分送出
+  ring.consume(5);
+  EXPECT_EQ(ring.messages(), 1u);
+  EXPECT_EQ(ring.size(), 2u);
+  EXPECT_EQ(pending(ring), (std::vector<std::string>{"fg"}));
+
+  ring.consume(2);
+  EXPECT_TRUE(ring.empty());
+  EXPECT_EQ(ring.size(), 0u);
+}
+
+TEST(OutboundRingTest, PushWithOffset) {
+  PayloadPool pool;
+  OutboundRing ring(1024, 8);
+
+  EXPECT_TRUE(ring.push(make(pool, "hello"), 2));
+  EXPECT_EQ(ring.size(), 3u);
+  EXPECT_EQ(pending(ring), (std::vector<std::string>{"llo"}));
+
+  // 已經完整送出的訊息不佔位置
+  EXPECT_TRUE(ring.push(make(pool, "xy"), 2));
+  EXPECT_EQ(ring.messages(), 1u);
+}
+
+TEST(OutboundRingTest, RejectsWhenFull) {
+  PayloadPool pool;
+  OutboundRing ring(8, 2);
+
+  EXPECT_TRUE(ring.push(make(pool, "12345")));
+  EXPECT_FALSE(ring.push(make(pool, "6789")));
+  EXPECT_TRUE(ring.push(make(pool, "678")));
+  EXPECT_EQ(ring.free_space(), 0u);
+
+  // bytes 還有空間但 entry 用完
+  ring.consume(8);
+  EXPECT_TRUE(ring.push(make(pool, "a")));
+  EXPECT_TRUE(ring.push(make(pool, "b")));
+  EXPECT_FALSE(ring.push(make(pool, "c")));
+}
+
+TEST(OutboundRingTest, ConsumeRetainsPayloads) {
+  PayloadPool pool;
+  OutboundRing ring(1024, 8);
+
+  PayloadRef first = make(pool, "abc");
+  PayloadRef second = make(pool, "def");
+  ring.push(first);
+  ring.push(second);
+
+  std::vector<PayloadRef> retain;
+  ring.consume(4, &retain);
+  ASSERT_EQ(retain.size(), 2u);
+  EXPECT_EQ(retain[0].get(), first.get());
+  EXPECT_EQ(retain[1].get(), second.get());
+  EXPECT_EQ(first.use_count(), 2u);  // 本地 + retain
+  EXPECT_EQ(second.use_count(), 3u); // 本地 + ring + retain
+}
+
+TEST(OutboundRingTest, ReleasesPayloadsToPool) {
+  PayloadPool pool;
+  const size_t available = pool.available();
+  {
+    OutboundRing ring(1024, 8);
+    ring.push(make(pool, "abc"));
+    ring.push(make(pool, "def"));
+    EXPECT_EQ(pool.available(), available - 2);
+
+    ring.consume(3);
+    EXPECT_EQ(pool.available(), available - 1);
+  }
+  EXPECT_EQ(pool.available(), available);
+}
+
+TEST(OutboundRingTest, DropOldestFreesBytes) {
+  PayloadPool pool;
+  OutboundRing ring(10, 8);
+
+  ring.push(make(pool, "aaaa"));
+  ring.push(make(pool, "bbbb"));
+  EXPECT_FALSE(ring.push(make(pool, "cccc")));
+
+  EXPECT_EQ(ring.drop_oldest(4), 1u);
+  EXPECT_TRUE(ring.push(make(pool, "cccc")));
+  EXPECT_EQ(pending(ring), (std::vector<std::string>{"bbbb", "cccc"}));
+}
+
+// 回歸測試：entry 數量滿但 bytes 還夠時，仍要丟掉最舊的訊息
+TEST(OutboundRingTest, DropOldestFreesEntrySlot) {
+  PayloadPool pool;
+  OutboundRing ring(1024, 4);
+
+  for (const char *text : {"1", "2", "3", "4"}) {
+    ASSERT_TRUE(ring.push(make(pool, text)));
+  }
+  EXPECT_FALSE(ring.push(make(pool, "5")));
+
+  EXPECT_EQ(ring.drop_oldest(1), 1u);
+  EXPECT_TRUE(ring.push(make(pool, "5")));
+  EXPECT_EQ(pending(ring), (std::vector<std::string>{"2", "3", "4", "5"}));
+}
+
+TEST(OutboundRingTest, DropOldestKeepsPartiallySentFront) {
+  PayloadPool pool;
+  OutboundRing ring(1024, 4);
+
+  for (const char *text : {"11", "22", "33", "44"}) {
+    ASSERT_TRUE(ring.push(make(pool, text)));
+  }
+  ring.consume(1);
+
+  EXPECT_EQ(ring.drop_oldest(1), 1u);
+  EXPECT_TRUE(ring.push(make(pool, "55")));
+  EXPECT_EQ(pending(ring),
+            (std::vector<std::string>{"1", "33", "44", "55"}));
+  EXPECT_EQ(ring.size(), 7u);
+}
+
+TEST(OutboundRingTest, DropUnsentKeepsPartiallySentFront) {
+  PayloadPool pool;
+  OutboundRing ring(1024, 8);
+
+  ring.push(make(pool, "abc"));
+  ring.push(make(pool, "def"));
+  ring.push(make(pool, "ghi"));
+  ring.consume(1);
+
+  EXPECT_EQ(ring.drop_unsent(), 2u);
+  EXPECT_EQ(pending(ring), (std::vector<std::string>{"bc"}));
+  EXPECT_EQ(ring.size(), 2u);
+}
+
+} // namespace emb::test
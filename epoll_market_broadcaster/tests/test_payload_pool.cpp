@@ -0,0 +1,82 @@
+#include "broadcast_server.h"
+#include "payload_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace emb::test {
+
+TEST(PayloadPoolTest, ExhaustsAtCapacity) {
+  PayloadPool pool(64, 3);
+  EXPECT_EQ(pool.capacity(), 3u);
+  EXPECT_EQ(pool.storage_size(), 3u * 64);
+
+  std::vector<PayloadRef> held;
+  for (int i = 0; i < 3; ++i) {
+    held.push_back(pool.acquire());
+    ASSERT_TRUE(held.back());
+  }
+  EXPECT_EQ(pool.available(), 0u);
+  EXPECT_FALSE(pool.acquire());
+
+  // 最後一個參考釋放時歸還，可以再取得
+  PayloadRef copy = held[1];
+  held[1].reset();
+  EXPECT_FALSE(pool.acquire());
+  copy.reset();
+  EXPECT_EQ(pool.available(), 1u);
+  EXPECT_TRUE(pool.acquire());
+
+  EXPECT_THROW(PayloadPool(64, 0), std::invalid_argument);
+}
+
+TEST(PayloadPoolTest, ConcurrentAcquireRelease) {
+  constexpr size_t CAPACITY = 64;
+  constexpr int THREADS = 4;
+  constexpr int ITERATIONS = 100000;
+  PayloadPool pool(64, CAPACITY);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < THREADS; ++t) {
+    threads.emplace_back([&pool, t] {
+      for (int i = 0; i < ITERATIONS; ++i) {
+        PayloadRef payload = pool.acquire();
+        if (payload) {
+          // 同一個 buffer 同時只會交給一個持有者
+          payload->mutable_data()[0] = static_cast<char>(t);
+          payload->set_size(1);
+          EXPECT_EQ(payload.data()[0], static_cast<char>(t));
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(pool.available(), CAPACITY);
+
+  std::vector<PayloadRef> all;
+  while (PayloadRef payload = pool.acquire()) {
+    all.push_back(std::move(payload));
+  }
+  EXPECT_EQ(all.size(), CAPACITY);
+}
+
+// 預設依 reactor 數與每個連線可以排隊的訊息數放大
+TEST(PayloadPoolTest, CapacityFollowsConfig) {
+  ServerConfig config;
+  const size_t one = payload_pool_capacity(config, 1);
+  EXPECT_GE(one, 2 * config.outbound_messages);
+  EXPECT_EQ(payload_pool_capacity(config, 4), 4 * one);
+
+  config.outbound_messages *= 2;
+  EXPECT_GT(payload_pool_capacity(config, 1), one);
+
+  config.payload_pool_size = 100;
+  EXPECT_EQ(payload_pool_capacity(config, 4), 100u);
+}
+
+} // namespace emb::test
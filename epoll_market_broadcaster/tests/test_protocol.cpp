@@ -0,0 +1,153 @@
+#include "protocol.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+namespace emb::test {
+using namespace emb::protocol;
+
+namespace {
+
+struct Collector {
+  std::vector<QuoteFrame> quotes;
+  std::vector<TradeFrame> trades;
+  std::vector<SnapshotEndFrame> ends;
+
+  void on_quote(const QuoteFrame &frame) { quotes.push_back(frame); }
+  void on_trade(const TradeFrame &frame) { trades.push_back(frame); }
+  void on_snapshot_end(const SnapshotEndFrame &frame) { ends.push_back(frame); }
+};
+
+template <typename Frame> void append(std::string &out, const Frame &frame) {
+  char buf[sizeof(Frame)];
+  out.append(buf, encode(frame, buf));
+}
+
+} // namespace
+
+TEST(ProtocolTest, FixedPointRoundTrip) {
+  EXPECT_EQ(to_fixed(150.25), 1502500);
+  EXPECT_EQ(to_fixed(-1.00005), -10001);
+  EXPECT_DOUBLE_EQ(from_fixed(1502500), 150.25);
+}
+
+TEST(ProtocolTest, DecodeQuoteAndTrade) {
+  std::string stream;
+  append(stream, make_quote(3, 10, 111, to_fixed(1.5), 100));
+  append(stream, make_trade(4, 11, 222, to_fixed(2.5), 7, Side::Sell));
+
+  Collector out;
+  EXPECT_EQ(decode(stream.data(), stream.size(), out), stream.size());
+  ASSERT_EQ(out.quotes.size(), 1u);
+  ASSERT_EQ(out.trades.size(), 1u);
+  EXPECT_EQ(out.quotes[0].symbol_id, 3u);
+  EXPECT_EQ(out.quotes[0].seq, 10u);
+  EXPECT_EQ(out.quotes[0].send_time_ns, 111u);
+  EXPECT_EQ(out.quotes[0].price, 15000);
+  EXPECT_EQ(out.quotes[0].volume, 100u);
+  EXPECT_EQ(out.trades[0].symbol_id, 4u);
+  EXPECT_EQ(out.trades[0].quantity, 7u);
+  EXPECT_EQ(out.trades[0].side, Side::Sell);
+}
+
+TEST(ProtocolTest, DecodeSnapshotEnd) {
+  std::string stream;
+  append(stream, make_quote(1, 41, 0, 0, 0));
+  append(stream, make_snapshot_end(42));
+  append(stream, make_quote(1, 42, 0, 0, 0));
+
+  Collector out;
+  EXPECT_EQ(decode(stream.data(), stream.size(), out), stream.size());
+  ASSERT_EQ(out.ends.size(), 1u);
+  EXPECT_EQ(out.ends[0].resume_seq, 42u);
+  EXPECT_EQ(out.quotes.size(), 2u);
+
+  // 不屬於任何 symbol，不會進入訂閱分派與重送 ring
+  char buf[sizeof(SnapshotEndFrame)];
+  encode(make_snapshot_end(42), buf);
+  EXPECT_EQ(symbol_of(buf, sizeof(buf)), NO_SYMBOL);
+  EXPECT_EQ(seq_of(buf, sizeof(buf)), 0u);
+}
+
+TEST(ProtocolTest, DecodeLeavesPartialFrame) {
+  std::string stream;
+  append(stream, make_quote(1, 1, 0, 0, 0));
+  append(stream, make_quote(2, 2, 0, 0, 0));
+
+  Collector out;
+  const size_t partial = stream.size() - 5;
+  EXPECT_EQ(decode(stream.data(), partial, out), sizeof(QuoteFrame));
+  EXPECT_EQ(out.quotes.size(), 1u);
+
+  // header 也不完整時一樣不前進
+  EXPECT_EQ(decode(stream.data(), 2, out), 0u);
+}
+
+TEST(ProtocolTest, DecodeSkipsUnknownType) {
+  std::string stream;
+  FrameHeader unknown{8, static_cast<MessageType>('X'), VERSION};
+  stream.append(reinterpret_cast<const char *>(&unknown), sizeof(unknown));
+  stream.append(4, '\0');
+  append(stream, make_quote(9, 1, 0, 0, 0));
+
+  Collector out;
+  EXPECT_EQ(decode(stream.data(), stream.size(), out), stream.size());
+  ASSERT_EQ(out.quotes.size(), 1u);
+  EXPECT_EQ(out.quotes[0].symbol_id, 9u);
+}
+
+TEST(ProtocolTest, DecodeRejectsInvalidLength) {
+  Collector out;
+
+  FrameHeader too_short{2, MessageType::Quote, VERSION};
+  EXPECT_EQ(decode(reinterpret_cast<const char *>(&too_short),
+                   sizeof(too_short), out),
+            DECODE_ERROR);
+
+  FrameHeader too_long{MAX_FRAME_SIZE + 1, MessageType::Quote, VERSION};
+  EXPECT_EQ(decode(reinterpret_cast<const char *>(&too_long), sizeof(too_long),
+                   out),
+            DECODE_ERROR);
+  EXPECT_TRUE(out.quotes.empty());
+}
+
+TEST(ProtocolTest, SymbolAndSeqAccessors) {
+  char buf[sizeof(QuoteFrame)];
+  encode(make_quote(42, 7, 0, 0, 0), buf);
+
+  EXPECT_EQ(symbol_of(buf, sizeof(buf)), 42u);
+  EXPECT_EQ(seq_of(buf, sizeof(buf)), 7u);
+  EXPECT_TRUE(set_seq(buf, sizeof(buf), 99));
+  EXPECT_EQ(seq_of(buf, sizeof(buf)), 99u);
+
+  EXPECT_EQ(symbol_of(buf, 4), NO_SYMBOL);
+  const char *text = "AAPL|1.0|1\n";
+  EXPECT_EQ(symbol_of(text, 11), NO_SYMBOL);
+  EXPECT_EQ(seq_of(text, 11), 0u);
+}
+
+TEST(ProtocolTest, FormatText) {
+  const std::vector<std::string> symbols{"AAPL", "MSFT"};
+  char buf[sizeof(TradeFrame)];
+  char out[64];
+
+  encode(make_quote(1, 42, 0, to_fixed(310.5), 200), buf);
+  size_t n = format_text(buf, sizeof(QuoteFrame), symbols, out, sizeof(out));
+  EXPECT_EQ(std::string(out, n), "42|MSFT|310.500000|200\n");
+
+  encode(make_trade(5, 43, 0, to_fixed(1.25), 3, Side::Buy), buf);
+  n = format_text(buf, sizeof(TradeFrame), symbols, out, sizeof(out));
+  EXPECT_EQ(std::string(out, n), "43|5|1.250000|3|B\n");
+
+  encode(make_snapshot_end(7), buf);
+  n = format_text(buf, sizeof(SnapshotEndFrame), symbols, out, sizeof(out));
+  EXPECT_EQ(std::string(out, n), "SNAPSHOT_END|7\n");
+
+  // 空間不足
+  encode(make_trade(5, 0, 0, to_fixed(1.25), 3, Side::Buy), buf);
+  EXPECT_EQ(format_text(buf, sizeof(TradeFrame), symbols, out, 8), 0u);
+}
+
+} // namespace emb::test
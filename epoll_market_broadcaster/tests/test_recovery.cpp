@@ -0,0 +1,287 @@
+#include "broadcast_server.h"
+#include "protocol.h"
+
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <netinet/in.h>
+#include <poll.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace emb::test {
+
+namespace {
+
+constexpr uint16_t PORT = 19517;
+
+int connect_client(uint16_t port) {
+  int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  ::inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+  for (int i = 0; i < 100; ++i) {
+    if (::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0) {
+      return fd;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ::close(fd);
+  return -1;
+}
+
+// 依序記下收到的 frame，以及 SnapshotEndFrame 出現的位置
+struct Received {
+  struct Item {
+    uint32_t symbol;
+    uint64_t seq;
+  };
+  std::vector<Item> items;
+  size_t end_index = 0;
+  uint64_t resume_seq = 0;
+  size_t ends = 0;
+
+  void on_quote(const protocol::QuoteFrame &q) {
+    items.push_back({q.symbol_id, q.seq});
+  }
+  void on_trade(const protocol::TradeFrame &t) {
+    items.push_back({t.symbol_id, t.seq});
+  }
+  void on_snapshot_end(const protocol::SnapshotEndFrame &e) {
+    end_index = items.size();
+    resume_seq = e.resume_seq;
+    ++ends;
+  }
+};
+
+struct Client {
+  int fd = -1;
+  std::string buffer;
+  bool acked = false;
+  Received out;
+
+  bool done() const {
+    return out.ends > 0 && out.items.size() >= out.end_index + 500;
+  }
+
+  // 文字的 "OK BINARY\n" 之後全部是 frame，錯誤時回傳 false
+  bool read() {
+    char chunk[4096];
+    const ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+    if (n <= 0) {
+      return false;
+    }
+    buffer.append(chunk, static_cast<size_t>(n));
+    if (!acked) {
+      // 連線預設訂閱全部，回覆之前可能先收到文字格式的行情
+      const size_t ack = buffer.find(protocol::BINARY_ACK);
+      if (ack == std::string::npos) {
+        return true;
+      }
+      buffer.erase(0, ack + std::strlen(protocol::BINARY_ACK));
+      acked = true;
+    }
+    const size_t used = protocol::decode(buffer.data(), buffer.size(), out);
+    if (used == protocol::DECODE_ERROR) {
+      return false;
+    }
+    buffer.erase(0, used);
+    return true;
+  }
+};
+
+// 發布 count 則 quote (seq 從 1 開始)，等全部分派完
+bool publish_quotes(BroadcastServer &server, uint32_t count) {
+  for (uint32_t i = 0; i < count; ++i) {
+    PayloadRef payload = server.acquire_payload();
+    if (!payload) {
+      return false;
+    }
+    const auto quote =
+        protocol::make_quote(i % 4, 0, 0, protocol::to_fixed(i), 100);
+    payload->set_size(protocol::encode(quote, payload->mutable_data()));
+    payload->set_format(PayloadFormat::Binary);
+    if (!server.enqueue_broadcast(std::move(payload))) {
+      return false;
+    }
+  }
+  for (int i = 0; i < 100 && server.stats().broadcasts < count; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return server.stats().broadcasts == count;
+}
+
+// 送出指令後讀到 done() 為止，逾時或錯誤時回傳 false
+template <typename Done>
+bool request(Client &client, const std::string &command, Done done) {
+  const std::string data =
+      std::string(protocol::BINARY_REQUEST) + "\n" + command + "\n";
+  if (::send(client.fd, data.data(), data.size(), 0) !=
+      static_cast<ssize_t>(data.size())) {
+    return false;
+  }
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(2);
+  while (!done() && std::chrono::steady_clock::now() < deadline) {
+    pollfd pfd{client.fd, POLLIN, 0};
+    if (::poll(&pfd, 1, 100) > 0 && !client.read()) {
+      return false;
+    }
+  }
+  return done();
+}
+
+} // namespace
+
+// ring 還沒覆蓋過時，要求的 seq 比最舊的還早一樣是缺口，改送快照；
+// ring 中有的 seq 直接從該則開始重送
+TEST(RecoveryTest, ReplayFallsBackToSnapshotOnGap) {
+  ServerConfig config;
+  config.port = PORT + 1;
+  config.symbols = {"AAPL", "GOOG", "MSFT", "TSLA"};
+  auto server = make_server(config);
+  std::thread server_thread([&server] { server->run(); });
+
+  Client gap;
+  Client replay;
+  gap.fd = connect_client(config.port);
+  replay.fd = connect_client(config.port);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  bool ok = gap.fd >= 0 && replay.fd >= 0 && publish_quotes(*server, 10);
+  ok = ok && request(gap, "REPLAY 0", [&] { return gap.out.ends > 0; });
+  ok = ok && request(replay, "REPLAY 5",
+                     [&] { return replay.out.items.size() >= 6; });
+
+  for (const Client *client : {&gap, &replay}) {
+    if (client->fd >= 0) {
+      ::close(client->fd);
+    }
+  }
+  server->stop();
+  server_thread.join();
+
+  ASSERT_TRUE(ok);
+  EXPECT_EQ(gap.out.resume_seq, 11u);
+  EXPECT_EQ(gap.out.end_index, 4u); // 每個 symbol 的最新值
+
+  EXPECT_EQ(replay.out.ends, 0u);
+  ASSERT_EQ(replay.out.items.size(), 6u);
+  for (size_t i = 0; i < replay.out.items.size(); ++i) {
+    EXPECT_EQ(replay.out.items[i].seq, 5 + i);
+  }
+}
+
+// 生產者持續發布時下達 SNAPSHOT：快照結束前的每個 symbol 不會倒退，
+// 結束標記之後的 seq 從 resume_seq 開始連續遞增。
+// 兩個 reactor 時 reactor 1 的 inbox 落後於快取，快照會比重送 ring 新
+TEST(RecoveryTest, SnapshotEndsWithResumeSeq) {
+  constexpr size_t CLIENTS = 8;
+
+  ServerConfig config;
+  config.port = PORT;
+  config.num_reactors = 2;
+  config.symbols = {"AAPL", "GOOG", "MSFT", "TSLA"};
+  auto server = make_server(config);
+  std::thread server_thread([&server] { server->run(); });
+
+  std::atomic<bool> publishing{true};
+  std::thread producer([&] {
+    uint32_t tick = 0;
+    while (publishing.load(std::memory_order_relaxed)) {
+      PayloadRef payload = server->acquire_payload();
+      if (!payload) {
+        std::this_thread::yield();
+        continue;
+      }
+      const auto quote =
+          protocol::make_quote(tick % 4, 0, 0, protocol::to_fixed(tick), 100);
+      payload->set_size(protocol::encode(quote, payload->mutable_data()));
+      payload->set_format(PayloadFormat::Binary);
+      if (server->enqueue_broadcast(std::move(payload))) {
+        ++tick;
+      }
+      if (tick % 64 == 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+      }
+    }
+  });
+
+  // 執行緒都還在跑，失敗時先收尾再檢查
+  std::vector<Client> clients(CLIENTS);
+  bool ok = true;
+  for (Client &client : clients) {
+    client.fd = connect_client(PORT);
+    ok = ok && client.fd >= 0;
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  const std::string request = std::string(protocol::BINARY_REQUEST) + "\n" +
+                              protocol::SNAPSHOT_REQUEST + "\n";
+  for (Client &client : clients) {
+    ok = ok && ::send(client.fd, request.data(), request.size(), 0) ==
+                   static_cast<ssize_t>(request.size());
+  }
+
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  size_t remaining = CLIENTS;
+  while (ok && remaining > 0 && std::chrono::steady_clock::now() < deadline) {
+    std::vector<pollfd> pfds;
+    for (const Client &client : clients) {
+      pfds.push_back({client.fd, POLLIN, 0});
+    }
+    if (::poll(pfds.data(), pfds.size(), 100) <= 0) {
+      continue;
+    }
+    remaining = 0;
+    for (size_t i = 0; i < CLIENTS; ++i) {
+      if ((pfds[i].revents & POLLIN) && !clients[i].done()) {
+        ok = ok && clients[i].read();
+      }
+      remaining += clients[i].done() ? 0 : 1;
+    }
+  }
+
+  publishing.store(false);
+  producer.join();
+  for (const Client &client : clients) {
+    if (client.fd >= 0) {
+      ::close(client.fd);
+    }
+  }
+  server->stop();
+  server_thread.join();
+
+  ASSERT_TRUE(ok);
+  for (size_t c = 0; c < CLIENTS; ++c) {
+    const Received &out = clients[c].out;
+    ASSERT_EQ(out.ends, 1u) << "client " << c;
+    ASSERT_GE(out.items.size(), out.end_index + 500) << "client " << c;
+
+    // 快照 (含重送) 中每個 symbol 的 seq 只會變大，且都在截止點之前
+    std::map<uint32_t, uint64_t> last;
+    for (size_t i = 0; i < out.end_index; ++i) {
+      const auto &item = out.items[i];
+      EXPECT_LT(item.seq, out.resume_seq) << "client " << c;
+      EXPECT_GT(item.seq, last[item.symbol])
+          << "client " << c << " stale frame at " << i;
+      last[item.symbol] = item.seq;
+    }
+
+    // 結束標記之後從 resume_seq 開始連續
+    uint64_t expected = out.resume_seq;
+    for (size_t i = out.end_index; i < out.items.size(); ++i) {
+      EXPECT_EQ(out.items[i].seq, expected) << "client " << c << " at " << i;
+      expected = out.items[i].seq + 1;
+    }
+  }
+}
+
+} // namespace emb::test
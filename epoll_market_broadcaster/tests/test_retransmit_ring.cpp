@@ -0,0 +1,81 @@
+#include "retransmit_ring.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace emb::test {
+
+namespace {
+
+void push(RetransmitRing &ring, uint64_t seq, uint32_t symbol = 0) {
+  const std::string data = "frame" + std::to_string(seq);
+  ASSERT_TRUE(ring.push(seq, symbol, data.data(), data.size()));
+}
+
+} // namespace
+
+TEST(RetransmitRingTest, PushAndRead) {
+  RetransmitRing ring(4);
+  EXPECT_TRUE(ring.empty());
+  EXPECT_EQ(ring.begin(), 0u);
+  EXPECT_EQ(ring.end(), 0u);
+
+  push(ring, 10, 3);
+  EXPECT_FALSE(ring.empty());
+  EXPECT_EQ(ring.end(), 1u);
+
+  const auto &entry = ring.at(0);
+  EXPECT_EQ(entry.seq, 10u);
+  EXPECT_EQ(entry.symbol, 3u);
+  EXPECT_EQ(std::string(entry.data, entry.length), "frame10");
+}
+
+TEST(RetransmitRingTest, RejectsOversizedFrame) {
+  RetransmitRing ring(4);
+  const std::string big(RetransmitRing::MAX_FRAME_SIZE + 1, 'x');
+  EXPECT_FALSE(ring.push(1, 0, big.data(), big.size()));
+  EXPECT_TRUE(ring.empty());
+}
+
+TEST(RetransmitRingTest, OverwritesOldest) {
+  RetransmitRing ring(4);
+  for (uint64_t seq = 1; seq <= 6; ++seq) {
+    push(ring, seq);
+  }
+
+  EXPECT_EQ(ring.begin(), 2u);
+  EXPECT_EQ(ring.end(), 6u);
+  EXPECT_EQ(ring.at(ring.begin()).seq, 3u);
+  EXPECT_EQ(ring.at(ring.end() - 1).seq, 6u);
+}
+
+TEST(RetransmitRingTest, LowerBoundWithGaps) {
+  RetransmitRing ring(8);
+  for (uint64_t seq : {10, 11, 15, 20}) {
+    push(ring, seq);
+  }
+
+  EXPECT_EQ(ring.lower_bound(0), 0u);
+  EXPECT_EQ(ring.lower_bound(10), 0u);
+  EXPECT_EQ(ring.lower_bound(12), 2u);
+  EXPECT_EQ(ring.lower_bound(15), 2u);
+  EXPECT_EQ(ring.lower_bound(20), 3u);
+  EXPECT_EQ(ring.lower_bound(21), ring.end());
+}
+
+TEST(RetransmitRingTest, LowerBoundAfterWrap) {
+  RetransmitRing ring(4);
+  for (uint64_t seq = 1; seq <= 10; ++seq) {
+    push(ring, seq * 2);
+  }
+
+  // 保留的是 seq 14, 16, 18, 20 (位置 6..9)
+  EXPECT_EQ(ring.lower_bound(1), ring.begin());
+  EXPECT_EQ(ring.lower_bound(15), 7u);
+  EXPECT_EQ(ring.at(ring.lower_bound(15)).seq, 16u);
+  EXPECT_EQ(ring.lower_bound(20), 9u);
+  EXPECT_EQ(ring.lower_bound(21), ring.end());
+}
+
+} // namespace emb::test
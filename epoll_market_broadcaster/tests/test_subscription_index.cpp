@@ -0,0 +1,134 @@
+#include "protocol.h"
+#include "subscription_index.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace emb::test {
+
+namespace {
+
+const std::vector<std::string> SYMBOLS{"AAPL", "GOOG", "MSFT", "TSLA"};
+
+// route() 的結果依 id 排序成 (id, mask)
+std::vector<std::pair<uint32_t, uint64_t>>
+route(SubscriptionIndex &index, const std::vector<uint32_t> &symbols) {
+  std::vector<std::pair<uint32_t, uint64_t>> out;
+  for (const auto &r : index.route(symbols.data(), symbols.size())) {
+    out.emplace_back(r.id, r.mask);
+  }
+  std::sort(out.begin(), out.end());
+  return out;
+}
+
+using Routes = std::vector<std::pair<uint32_t, uint64_t>>;
+
+} // namespace
+
+TEST(SubscriptionIndexTest, NewConnectionReceivesEverything) {
+  SubscriptionIndex index(SYMBOLS);
+  index.add(3);
+  index.add(7);
+
+  EXPECT_EQ(index.size(), 2u);
+  EXPECT_TRUE(index.wants(3, 2));
+  EXPECT_EQ(index.subscriber_count(0), 2u);
+  EXPECT_EQ(route(index, {0, 1}), (Routes{{3, 0b11}, {7, 0b11}}));
+}
+
+TEST(SubscriptionIndexTest, FirstSubNarrowsToListedSymbols) {
+  SubscriptionIndex index(SYMBOLS);
+  index.add(1);
+  index.add(2);
+
+  EXPECT_EQ(index.apply_command(1, "SUB GOOG,TSLA"),
+            SubscriptionIndex::CommandResult::Applied);
+  EXPECT_FALSE(index.wants(1, 0));
+  EXPECT_TRUE(index.wants(1, 1));
+  EXPECT_TRUE(index.wants(1, 3));
+
+  // 訊息 0=AAPL, 1=GOOG, 2=TSLA
+  EXPECT_EQ(route(index, {0, 1, 3}), (Routes{{1, 0b110}, {2, 0b111}}));
+}
+
+TEST(SubscriptionIndexTest, UnsubscribeFromAllExpandsRemaining) {
+  SubscriptionIndex index(SYMBOLS);
+  index.add(0);
+
+  EXPECT_EQ(index.apply_command(0, "UNSUB MSFT"),
+            SubscriptionIndex::CommandResult::Applied);
+  EXPECT_TRUE(index.wants(0, 0));
+  EXPECT_FALSE(index.wants(0, 2));
+  EXPECT_EQ(index.subscriber_count(2), 0u);
+  EXPECT_EQ(index.subscriber_count(3), 1u);
+
+  EXPECT_EQ(index.apply_command(0, "UNSUB *"),
+            SubscriptionIndex::CommandResult::Applied);
+  EXPECT_TRUE(route(index, {0, 1, 2, 3}).empty());
+
+  EXPECT_EQ(index.apply_command(0, "SUB *"),
+            SubscriptionIndex::CommandResult::Applied);
+  EXPECT_EQ(route(index, {2}), (Routes{{0, 0b1}}));
+}
+
+TEST(SubscriptionIndexTest, CommandParsing) {
+  SubscriptionIndex index(SYMBOLS);
+  index.add(0);
+
+  EXPECT_EQ(index.apply_command(0, "HELLO"),
+            SubscriptionIndex::CommandResult::NotCommand);
+  EXPECT_EQ(index.apply_command(0, "SUBX AAPL"),
+            SubscriptionIndex::CommandResult::NotCommand);
+
+  // 未知的 symbol 不影響其餘的套用
+  EXPECT_EQ(index.apply_command(0, "SUB  AAPL, NOPE ,MSFT"),
+            SubscriptionIndex::CommandResult::UnknownSymbol);
+  EXPECT_TRUE(index.wants(0, 0));
+  EXPECT_FALSE(index.wants(0, 1));
+  EXPECT_TRUE(index.wants(0, 2));
+
+  EXPECT_EQ(index.find_symbol("TSLA"), 3u);
+  EXPECT_EQ(index.find_symbol("NOPE"), protocol::NO_SYMBOL);
+}
+
+TEST(SubscriptionIndexTest, NoSymbolGoesToEveryMember) {
+  SubscriptionIndex index(SYMBOLS);
+  index.add(1);
+  index.add(2);
+  index.apply_command(1, "UNSUB *");
+
+  EXPECT_TRUE(index.wants(1, protocol::NO_SYMBOL));
+  EXPECT_EQ(route(index, {0, protocol::NO_SYMBOL}),
+            (Routes{{1, 0b10}, {2, 0b11}}));
+}
+
+TEST(SubscriptionIndexTest, RemoveAndReuseId) {
+  SubscriptionIndex index(SYMBOLS);
+  index.add(5);
+  index.apply_command(5, "SUB AAPL");
+  index.remove(5);
+
+  EXPECT_EQ(index.size(), 0u);
+  EXPECT_FALSE(index.wants(5, 0));
+  EXPECT_EQ(index.subscriber_count(0), 0u);
+  EXPECT_TRUE(route(index, {0, protocol::NO_SYMBOL}).empty());
+
+  // 重新使用同一個 id (fd 被重用) 時回到訂閱全部
+  index.add(5);
+  EXPECT_TRUE(index.wants(5, 1));
+  EXPECT_EQ(route(index, {1}), (Routes{{5, 0b1}}));
+}
+
+TEST(SubscriptionIndexTest, RouteResetsMasksBetweenCalls) {
+  SubscriptionIndex index(SYMBOLS);
+  index.add(0);
+
+  EXPECT_EQ(route(index, {0, 1, 2}), (Routes{{0, 0b111}}));
+  EXPECT_EQ(route(index, {3}), (Routes{{0, 0b1}}));
+}
+
+} // namespace emb::test
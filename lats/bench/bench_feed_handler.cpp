@@ -0,0 +1,77 @@
+#include "core/latency_stats.hpp"
+#include "feed/feed_handler.hpp"
+#include "feed/multicast_sender.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+namespace lats::feed::bench {
+using namespace lats::feed;
+
+// ============================================================================
+// Benchmark: loopback multicast 的 wire-to-parse 延遲
+// ============================================================================
+// 從 recvmmsg 返回到解析線程處理完封包的時間，包含 SPSCQueue 的跨線程傳遞
+static void BM_FeedWireToParse(benchmark::State &state) {
+  constexpr uint64_t NUM_PACKETS = 50000;
+
+  FeedConfig config;
+  config.group = "239.255.0.2";
+  config.port = 40002;
+  config.interface = "127.0.0.1";
+  // 核心不夠時 busy poll 會讓兩條線程互搶 CPU
+  config.busy_poll = std::thread::hardware_concurrency() >= 3;
+
+  for (auto _ : state) {
+    try {
+      FeedHandler handler(config);
+      MulticastSender sender(config.group, config.port, config.interface);
+      handler.start(nullptr);
+
+      uint8_t payload[64] = {};
+      for (uint64_t i = 0; i < NUM_PACKETS; ++i) {
+        sender.send_packet(1 + i, 1, payload, sizeof(payload));
+        // 放慢發送速度，量測的是延遲而非 socket buffer 的排隊時間
+        if (i % 64 == 0) {
+          std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+      }
+
+      const auto &counters = handler.counters();
+      auto deadline =
+          std::chrono::steady_clock::now() + std::chrono::seconds(5);
+      while (counters.packets_parsed.load() < NUM_PACKETS &&
+             std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+      handler.stop();
+
+      const core::LatencyStats &latency = handler.latency();
+      std::cout << "\n========================================\n";
+      std::cout << "Feed Handler Wire-to-Parse Latency\n";
+      std::cout << "========================================\n";
+      std::cout << "Packets: " << counters.packets_parsed.load() << "/"
+                << NUM_PACKETS << "  gaps: " << counters.gaps.load()
+                << "  drops: " << counters.queue_full_drops.load() << "\n";
+      if (latency.count() > 0) {
+        std::cout << "P50: " << latency.p50() << " ns  P99: " << latency.p99()
+                  << " ns  P999: " << latency.p999()
+                  << " ns  Max: " << latency.max() << " ns\n";
+      }
+      std::cout << "========================================\n\n";
+
+      state.SetItemsProcessed(counters.packets_parsed.load());
+    } catch (const std::runtime_error &e) {
+      state.SkipWithError(e.what());
+      break;
+    }
+  }
+}
+BENCHMARK(BM_FeedWireToParse)->Iterations(1)->Unit(benchmark::kMillisecond);
+
+} // namespace lats::feed::bench
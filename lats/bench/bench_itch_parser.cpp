@@ -0,0 +1,234 @@
+#include "feed/itch_book_builder.hpp"
+#include "feed/itch_parser.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace lats::feed::bench {
+using namespace lats::feed;
+using namespace lats::feed::itch;
+
+namespace {
+
+constexpr size_t NUM_MESSAGES = 1'000'000;
+constexpr size_t MESSAGES_PER_PACKET = 16;
+constexpr uint32_t MID_PRICE = 1'000'000; // 100.0000
+
+// 合成的 MoldUDP64 capture：Add 50%、Delete 25%、Execute 10%、Cancel 10%、
+// Replace 5%，最後刪除所有存活訂單，讓 capture 可以重複回放到同一個簿上
+struct Capture {
+  std::vector<std::vector<uint8_t>> packets;
+  size_t messages = 0;
+  size_t bytes = 0;
+};
+
+class CaptureBuilder {
+public:
+  template <typename Msg> void add(const Msg &msg) {
+    if (current_.empty()) {
+      current_.resize(MoldUDP64Header::SIZE);
+    }
+    BE16 len;
+    len.set(sizeof(Msg));
+    current_.insert(current_.end(), len.bytes, len.bytes + sizeof(len));
+    const auto *bytes = reinterpret_cast<const uint8_t *>(&msg);
+    current_.insert(current_.end(), bytes, bytes + sizeof(Msg));
+
+    if (++count_ == MESSAGES_PER_PACKET) {
+      flush();
+    }
+  }
+
+  void flush() {
+    if (count_ == 0) {
+      return;
+    }
+    MoldUDP64Header header{};
+    std::memcpy(header.session, "BENCH     ", MoldUDP64Header::SESSION_SIZE);
+    header.sequence = sequence_;
+    header.message_count = static_cast<uint16_t>(count_);
+    header.encode(current_.data());
+
+    capture_.messages += count_;
+    capture_.bytes += current_.size();
+    capture_.packets.push_back(std::move(current_));
+    sequence_ += count_;
+    current_.clear();
+    count_ = 0;
+  }
+
+  Capture take() {
+    flush();
+    return std::move(capture_);
+  }
+
+private:
+  Capture capture_;
+  std::vector<uint8_t> current_;
+  size_t count_ = 0;
+  uint64_t sequence_ = 1;
+};
+
+template <typename Msg> Msg make(char type, uint64_t ts) {
+  Msg msg{};
+  msg.header.type = type;
+  msg.header.stock_locate.set(1);
+  msg.header.tracking_number.set(0);
+  msg.header.timestamp.set(ts);
+  return msg;
+}
+
+const Capture &synthetic_capture() {
+  static const Capture capture = [] {
+    CaptureBuilder builder;
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<int> action(0, 99);
+    std::uniform_int_distribution<uint32_t> level(1, 50);
+
+    struct Live {
+      uint64_t ref;
+      uint32_t shares;
+      bool buy;
+    };
+    std::vector<Live> live;
+    uint64_t next_ref = 1;
+
+    // 隨機挑一筆存活訂單並換到尾端，刪除時只需 pop_back
+    auto take_random = [&]() -> Live & {
+      std::uniform_int_distribution<size_t> pick(0, live.size() - 1);
+      std::swap(live[pick(rng)], live.back());
+      return live.back();
+    };
+    auto price_for = [&](bool buy) {
+      return buy ? MID_PRICE - level(rng) : MID_PRICE + level(rng);
+    };
+    auto reduce = [&](Live &order, uint32_t shares) {
+      if (order.shares <= shares) {
+        live.pop_back();
+      } else {
+        order.shares -= shares;
+      }
+    };
+
+    for (size_t i = 0; i < NUM_MESSAGES; ++i) {
+      const int a = action(rng);
+      if (live.empty() || a < 50) {
+        // 買在中價以下、賣在中價以上，不會交叉
+        const bool buy = rng() & 1;
+        auto msg = make<AddOrder>(AddOrder::TYPE, i);
+        msg.order_ref.set(next_ref);
+        msg.side_indicator = buy ? 'B' : 'S';
+        msg.shares.set(100);
+        std::memcpy(msg.stock, "AAPL    ", 8);
+        msg.price_raw.set(price_for(buy));
+        builder.add(msg);
+        live.push_back({next_ref++, 100, buy});
+      } else if (a < 75) {
+        auto msg = make<OrderDelete>(OrderDelete::TYPE, i);
+        msg.order_ref.set(take_random().ref);
+        builder.add(msg);
+        live.pop_back();
+      } else if (a < 85) {
+        Live &order = take_random();
+        auto msg = make<OrderExecuted>(OrderExecuted::TYPE, i);
+        msg.order_ref.set(order.ref);
+        msg.executed_shares.set(40);
+        builder.add(msg);
+        reduce(order, 40);
+      } else if (a < 95) {
+        Live &order = take_random();
+        auto msg = make<OrderCancel>(OrderCancel::TYPE, i);
+        msg.order_ref.set(order.ref);
+        msg.cancelled_shares.set(40);
+        builder.add(msg);
+        reduce(order, 40);
+      } else {
+        Live &order = take_random();
+        auto msg = make<OrderReplace>(OrderReplace::TYPE, i);
+        msg.original_order_ref.set(order.ref);
+        msg.new_order_ref.set(next_ref);
+        msg.shares.set(order.shares);
+        msg.price_raw.set(price_for(order.buy));
+        builder.add(msg);
+        order.ref = next_ref++;
+      }
+    }
+
+    for (const Live &order : live) {
+      auto msg = make<OrderDelete>(OrderDelete::TYPE, NUM_MESSAGES);
+      msg.order_ref.set(order.ref);
+      builder.add(msg);
+    }
+    return builder.take();
+  }();
+  return capture;
+}
+
+// 讀取每個訊息的欄位，避免整個解碼被優化掉
+struct ChecksumHandler : NullHandler {
+  uint64_t sum = 0;
+
+  void on_add(const AddOrder &msg) {
+    sum += msg.order_id() + static_cast<uint64_t>(msg.price()) +
+           msg.quantity() + static_cast<uint64_t>(msg.side());
+  }
+  void on_executed(const OrderExecuted &msg) {
+    sum += msg.order_id() + msg.quantity();
+  }
+  void on_cancel(const OrderCancel &msg) {
+    sum += msg.order_id() + msg.quantity();
+  }
+  void on_delete(const OrderDelete &msg) { sum += msg.order_id(); }
+  void on_replace(const OrderReplace &msg) {
+    sum += msg.new_order_id() + static_cast<uint64_t>(msg.price());
+  }
+};
+
+} // namespace
+
+// ============================================================================
+// Benchmark 1: 純解碼吞吐量 (messages/sec)
+// ============================================================================
+static void BM_ItchDecode(benchmark::State &state) {
+  const Capture &capture = synthetic_capture();
+  ChecksumHandler handler;
+  Parser<ChecksumHandler> parser(handler);
+
+  for (auto _ : state) {
+    for (const auto &packet : capture.packets) {
+      benchmark::DoNotOptimize(
+          parser.parse_packet(packet.data(), packet.size()));
+    }
+  }
+
+  benchmark::DoNotOptimize(handler.sum);
+  state.SetItemsProcessed(state.iterations() * capture.messages);
+  state.SetBytesProcessed(state.iterations() * capture.bytes);
+}
+BENCHMARK(BM_ItchDecode)->Unit(benchmark::kMillisecond);
+
+// ============================================================================
+// Benchmark 2: 解碼並重建 OrderBook
+// ============================================================================
+static void BM_ItchBookBuild(benchmark::State &state) {
+  const Capture &capture = synthetic_capture();
+  lob::OrderBook book;
+  BookBuilder builder(book);
+  Parser<BookBuilder> parser(builder);
+
+  for (auto _ : state) {
+    for (const auto &packet : capture.packets) {
+      parser.parse_packet(packet.data(), packet.size());
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * capture.messages);
+  state.counters["orders_left"] = static_cast<double>(book.order_count());
+}
+BENCHMARK(BM_ItchBookBuild)->Unit(benchmark::kMillisecond);
+
+} // namespace lats::feed::bench
@@ -0,0 +1,116 @@
+#include "lob/depth_delta.hpp"
+#include "lob/order_book.hpp"
+
+#include <benchmark/benchmark.h>
+
+namespace lats::lob::bench {
+using namespace lats::lob;
+
+namespace {
+
+constexpr Price MID_PRICE = 100 * PRICE_SCALE;
+constexpr int LEVELS = 100; // 每邊檔位數
+
+BookConfig depth_config(size_t depth) {
+  BookConfig config;
+  config.depth_levels = depth;
+  return config;
+}
+
+OrderID populate(OrderBook &book) {
+  OrderID id = 1;
+  for (int level = 1; level <= LEVELS; ++level) {
+    for (int i = 0; i < 4; ++i) {
+      book.add_order(id++, Side::Buy, MID_PRICE - level, 100, 0);
+      book.add_order(id++, Side::Sell, MID_PRICE + level, 100, 0);
+    }
+  }
+  return id;
+}
+
+} // namespace
+
+// ============================================================================
+// Benchmark 1: 維護 L2 聚合的額外成本 (arg = depth，0 代表不維護)
+// ============================================================================
+static void BM_AddCancelWithDepth(benchmark::State &state) {
+  OrderBook book(depth_config(static_cast<size_t>(state.range(0))));
+  OrderID id = populate(book);
+
+  for (auto _ : state) {
+    // 落在最優 16 檔內，每次都會更新聚合
+    Price price = MID_PRICE - 1 - static_cast<Price>(id % 16);
+    benchmark::DoNotOptimize(book.add_order(id, Side::Buy, price, 100, 0));
+    benchmark::DoNotOptimize(book.cancel_order(id));
+    ++id;
+  }
+
+  state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_AddCancelWithDepth)->Arg(0)->Arg(5)->Arg(16);
+
+// ============================================================================
+// Benchmark 2: 最優檔被吃光，聚合需從 ladder 補上一檔
+// ============================================================================
+static void BM_BestLevelRefill(benchmark::State &state) {
+  OrderBook book(depth_config(static_cast<size_t>(state.range(0))));
+  OrderID id = populate(book);
+
+  for (auto _ : state) {
+    // 單筆掛在最優價之上再撤掉：每次都是整檔移除與補檔
+    const Price price = *book.best_ask() - 1;
+    book.add_order(id, Side::Sell, price, 100, 0);
+    benchmark::DoNotOptimize(book.cancel_order(id));
+    ++id;
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BestLevelRefill)->Arg(0)->Arg(5)->Arg(16);
+
+// ============================================================================
+// Benchmark 3: 取快照 (兩邊 SoA 陣列整塊複製)
+// ============================================================================
+static void BM_DepthSnapshot(benchmark::State &state) {
+  OrderBook book(depth_config(L2_MAX_DEPTH));
+  populate(book);
+  DepthSnapshot snapshot;
+
+  for (auto _ : state) {
+    book.depth_snapshot(snapshot);
+    benchmark::DoNotOptimize(snapshot);
+    benchmark::ClobberMemory();
+  }
+
+  state.SetBytesProcessed(state.iterations() * 2 *
+                          static_cast<int64_t>(sizeof(DepthLevels)));
+}
+BENCHMARK(BM_DepthSnapshot);
+
+// ============================================================================
+// Benchmark 4: 增量編碼 (在兩份只差幾檔的快照間交替)
+// ============================================================================
+static void BM_DepthDeltaEncode(benchmark::State &state) {
+  OrderBook book(depth_config(L2_MAX_DEPTH));
+  OrderID id = populate(book);
+  DepthSnapshot snapshots[2];
+  book.depth_snapshot(snapshots[0]);
+  book.add_order(id, Side::Buy, MID_PRICE - 3, 10, 0);
+  book.execute_order(1, 50);
+  book.cancel_order(id - 1);
+  book.depth_snapshot(snapshots[1]);
+
+  DepthDeltaEncoder encoder;
+  size_t updates = 0;
+  size_t i = 0;
+  for (auto _ : state) {
+    updates += encoder.encode(snapshots[i++ & 1]);
+    benchmark::DoNotOptimize(encoder.updates());
+  }
+
+  state.counters["updates_per_encode"] = benchmark::Counter(
+      static_cast<double>(updates), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_DepthDeltaEncode);
+
+} // namespace lats::lob::bench
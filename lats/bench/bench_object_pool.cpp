@@ -0,0 +1,113 @@
+#include "core/latency_stats.hpp"
+#include "core/object_pool.hpp"
+#include "core/timer.hpp"
+#include "lob/order.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace lats::core::bench {
+using namespace lats::core;
+using lats::lob::Order;
+
+namespace {
+
+constexpr size_t LIVE_OBJECTS = 100000;
+
+// 與 new/delete 共用的配置介面
+struct PoolAllocator {
+  static constexpr const char *NAME = "ObjectPool";
+  ObjectPool<Order> pool{LIVE_OBJECTS * 2};
+  Order *create() { return pool.construct(); }
+  void release(Order *order) { pool.destroy(order); }
+};
+
+struct HeapAllocator {
+  static constexpr const char *NAME = "new/delete";
+  Order *create() { return new Order(); }
+  void release(Order *order) { delete order; }
+};
+
+} // namespace
+
+// ============================================================================
+// Benchmark 1: 單次配置 + 釋放
+// ============================================================================
+template <typename Allocator>
+static void BM_AllocFree(benchmark::State &state) {
+  Allocator alloc;
+
+  for (auto _ : state) {
+    Order *order = alloc.create();
+    benchmark::DoNotOptimize(order);
+    alloc.release(order);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_AllocFree, PoolAllocator);
+BENCHMARK_TEMPLATE(BM_AllocFree, HeapAllocator);
+
+// ============================================================================
+// Benchmark 2: 大量存活物件下隨機配置/釋放的延遲分佈
+// ============================================================================
+template <typename Allocator>
+static void BM_AllocatorLatency(benchmark::State &state) {
+  constexpr size_t NUM_SAMPLES = 200000;
+
+  static bool calibrated = false;
+  if (!calibrated) {
+    Timer::calibrate();
+    calibrated = true;
+  }
+
+  for (auto _ : state) {
+    Allocator alloc;
+    LatencyStats alloc_stats, free_stats;
+    std::mt19937_64 rng(42);
+
+    // 先建立大量存活物件，模擬盤中訂單簿的碎片化狀態
+    std::vector<Order *> live;
+    live.reserve(LIVE_OBJECTS);
+    for (size_t i = 0; i < LIVE_OBJECTS; ++i) {
+      live.push_back(alloc.create());
+    }
+
+    for (size_t i = 0; i < NUM_SAMPLES; ++i) {
+      size_t victim = rng() % live.size();
+
+      uint64_t start = Timer::now();
+      alloc.release(live[victim]);
+      free_stats.add_sample(Timer::cycles_to_ns(Timer::now() - start));
+
+      start = Timer::now();
+      live[victim] = alloc.create();
+      alloc_stats.add_sample(Timer::cycles_to_ns(Timer::now() - start));
+    }
+
+    for (Order *order : live) {
+      alloc.release(order);
+    }
+
+    std::cout << "\n" << Allocator::NAME << " Latency\n";
+    std::cout << "  Alloc  P50: " << alloc_stats.p50()
+              << " ns  P99: " << alloc_stats.p99()
+              << " ns  P999: " << alloc_stats.p999()
+              << " ns  Max: " << alloc_stats.max() << " ns\n";
+    std::cout << "  Free   P50: " << free_stats.p50()
+              << " ns  P99: " << free_stats.p99()
+              << " ns  P999: " << free_stats.p999()
+              << " ns  Max: " << free_stats.max() << " ns\n";
+  }
+}
+BENCHMARK_TEMPLATE(BM_AllocatorLatency, PoolAllocator)
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_AllocatorLatency, HeapAllocator)
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace lats::core::bench
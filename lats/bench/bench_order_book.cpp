@@ -0,0 +1,166 @@
+#include "core/latency_stats.hpp"
+#include "core/timer.hpp"
+#include "lob/order_book.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace lats::lob::bench {
+using namespace lats::core;
+using namespace lats::lob;
+
+namespace {
+
+constexpr Price MID_PRICE = 100 * PRICE_SCALE;
+constexpr int DEPTH = 100;      // 每邊檔位數
+constexpr int ORDERS_PER_LEVEL = 10;
+
+// 建立每邊 DEPTH 檔、每檔 ORDERS_PER_LEVEL 筆的初始訂單簿
+OrderID populate(OrderBook &book) {
+  OrderID id = 1;
+  for (int level = 1; level <= DEPTH; ++level) {
+    for (int i = 0; i < ORDERS_PER_LEVEL; ++i) {
+      book.add_order(id++, Side::Buy, MID_PRICE - level, 100, 0);
+      book.add_order(id++, Side::Sell, MID_PRICE + level, 100, 0);
+    }
+  }
+  return id;
+}
+
+void print_stats(const char *name, const LatencyStats &stats) {
+  std::cout << name << "  P50: " << stats.p50()
+            << " ns  P99: " << stats.p99() << " ns  P999: " << stats.p999()
+            << " ns  Max: " << stats.max() << " ns"
+            << (stats.p99() < 1000 ? "  [P99 < 1us OK]" : "  [P99 >= 1us]")
+            << "\n";
+}
+
+} // namespace
+
+// ============================================================================
+// Benchmark 1: 掛單 + 撤單 (不成交)
+// ============================================================================
+static void BM_AddCancel(benchmark::State &state) {
+  OrderBook book;
+  OrderID id = populate(book);
+
+  for (auto _ : state) {
+    Price price = MID_PRICE - 1 - static_cast<Price>(id % DEPTH);
+    benchmark::DoNotOptimize(book.add_order(id, Side::Buy, price, 100, 0));
+    benchmark::DoNotOptimize(book.cancel_order(id));
+    ++id;
+  }
+
+  state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_AddCancel);
+
+// ============================================================================
+// Benchmark 2: 吃掉最優檔的一筆掛單後補回
+// ============================================================================
+static void BM_AggressiveMatch(benchmark::State &state) {
+  OrderBook book;
+  OrderID id = populate(book);
+  uint64_t filled = 0;
+  auto on_trade = [&filled](const Trade &t) { filled += t.quantity; };
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        book.add_order(id++, Side::Buy, MID_PRICE + 1, 100, 0, on_trade));
+    book.add_order(id++, Side::Sell, MID_PRICE + 1, 100, 0);
+  }
+
+  benchmark::DoNotOptimize(filled);
+  state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_AggressiveMatch);
+
+// ============================================================================
+// Benchmark 3: 最優檔耗盡後尋找下一檔 (稀疏檔位，依賴 bitmap 掃描)
+// ============================================================================
+static void BM_BestLevelDepletion(benchmark::State &state) {
+  const Price gap = state.range(0); // 相鄰檔位間隔的 tick 數
+  OrderBook book;
+  OrderID id = 1;
+  for (int level = 0; level < DEPTH; ++level) {
+    book.add_order(id++, Side::Sell, MID_PRICE + level * gap, 100, 0);
+  }
+
+  for (auto _ : state) {
+    // 吃掉最優檔後在最差一檔之後補回，檔位數不變但價格持續漂移 (觸發 recenter)
+    Price best = *book.best_ask();
+    book.add_order(id++, Side::Buy, best, 100, 0);
+    benchmark::DoNotOptimize(book.best_ask());
+    book.add_order(id++, Side::Sell, best + DEPTH * gap, 100, 0);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BestLevelDepletion)->Arg(1)->Arg(8)->Arg(32);
+
+// ============================================================================
+// Benchmark 4: 單筆訂單處理延遲分佈 (目標 P99 < 1us)
+// ============================================================================
+static void BM_OrderLatency(benchmark::State &state) {
+  constexpr size_t NUM_SAMPLES = 100000;
+
+  static bool calibrated = false;
+  if (!calibrated) {
+    Timer::calibrate();
+    calibrated = true;
+  }
+
+  for (auto _ : state) {
+    OrderBook book;
+    OrderID next_id = populate(book);
+    LatencyStats add_stats, cancel_stats, execute_stats;
+
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<int> level_dist(1, DEPTH);
+    std::vector<OrderID> live;
+    live.reserve(NUM_SAMPLES);
+
+    for (size_t i = 0; i < NUM_SAMPLES; ++i) {
+      Side side = (i & 1) ? Side::Sell : Side::Buy;
+      int level = level_dist(rng);
+      Price price = side == Side::Buy ? MID_PRICE - level : MID_PRICE + level;
+      OrderID id = next_id++;
+
+      uint64_t start = Timer::now();
+      book.add_order(id, side, price, 100, 0);
+      add_stats.add_sample(Timer::cycles_to_ns(Timer::now() - start));
+      live.push_back(id);
+    }
+
+    std::shuffle(live.begin(), live.end(), rng);
+    for (size_t i = 0; i < live.size(); ++i) {
+      OrderID id = live[i];
+      uint64_t start = Timer::now();
+      if (i & 1) {
+        book.execute_order(id, 100);
+        execute_stats.add_sample(Timer::cycles_to_ns(Timer::now() - start));
+      } else {
+        book.cancel_order(id);
+        cancel_stats.add_sample(Timer::cycles_to_ns(Timer::now() - start));
+      }
+    }
+
+    static bool first_run = true;
+    if (first_run) {
+      std::cout << "\n========================================\n";
+      std::cout << "Order Book Latency Analysis\n";
+      std::cout << "========================================\n";
+      print_stats("Add    ", add_stats);
+      print_stats("Cancel ", cancel_stats);
+      print_stats("Execute", execute_stats);
+      std::cout << "========================================\n\n";
+      first_run = false;
+    }
+  }
+}
+BENCHMARK(BM_OrderLatency)->Iterations(1)->Unit(benchmark::kMillisecond);
+
+} // namespace lats::lob::bench
@@ -0,0 +1,102 @@
+#include "feed/sharded_book_pipeline.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace lats::feed::bench {
+using namespace lats::feed;
+
+namespace {
+
+constexpr uint16_t NUM_SYMBOLS = 256;
+constexpr size_t EVENTS_PER_BATCH = 1 << 16;
+
+// 每筆 Add 之後緊接著同一 symbol 的 Delete，簿的大小維持固定，
+// 同一批事件可以重複送入；hot 時一半的事件集中在 symbol 0
+std::vector<BookEvent> make_events(bool hot) {
+  std::vector<BookEvent> events;
+  events.reserve(EVENTS_PER_BATCH);
+  std::mt19937_64 rng(42);
+  lob::OrderID next_id = 1;
+
+  while (events.size() < EVENTS_PER_BATCH) {
+    const auto symbol = static_cast<uint16_t>(
+        hot && rng() % 2 == 0 ? 0 : rng() % NUM_SYMBOLS);
+    const lob::Side side = rng() % 2 == 0 ? lob::Side::Buy : lob::Side::Sell;
+
+    BookEvent add;
+    add.type = BookEvent::Type::Add;
+    add.symbol = symbol;
+    add.side = side;
+    add.order_id = next_id++;
+    add.quantity = 100;
+    const auto offset = static_cast<lob::Price>(rng() % 50);
+    add.price = side == lob::Side::Buy ? 1000 - offset : 1001 + offset;
+    events.push_back(add);
+
+    BookEvent del = add;
+    del.type = BookEvent::Type::Delete;
+    events.push_back(del);
+  }
+  return events;
+}
+
+} // namespace
+
+// ============================================================================
+// 依 symbol 分 shard 的吞吐量與各 shard 的 dispatch-to-apply 延遲
+// Args: {shard 數, 是否有熱門 symbol}
+// ============================================================================
+static void BM_ShardedBookPipeline(benchmark::State &state) {
+  const auto num_shards = static_cast<size_t>(state.range(0));
+  const bool hot = state.range(1) != 0;
+  const std::vector<BookEvent> events = make_events(hot);
+
+  PipelineConfig config;
+  config.num_shards = num_shards;
+  config.max_symbols = NUM_SYMBOLS;
+  // hash 不保證平均，每個 shard 都要能容納全部 symbol
+  config.books_per_shard = NUM_SYMBOLS;
+  config.book_config = {1 << 12, 1 << 8, 1, 256, {}};
+  // worker 數可能多於核心數，沒資料時讓出 CPU
+  config.busy_poll = false;
+
+  ShardedBookPipeline pipeline(config);
+  pipeline.start();
+
+  for (auto _ : state) {
+    for (const BookEvent &event : events) {
+      pipeline.dispatch(event);
+    }
+  }
+  pipeline.stop();
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(events.size()));
+
+  // 熱門 symbol 只應拖慢自己所在的 shard
+  uint64_t min_p99 = UINT64_MAX;
+  uint64_t max_p99 = 0;
+  for (size_t shard = 0; shard < num_shards; ++shard) {
+    const core::LatencyStats &stats = pipeline.latency(shard);
+    if (stats.count() == 0) {
+      continue;
+    }
+    min_p99 = std::min(min_p99, stats.p99());
+    max_p99 = std::max(max_p99, stats.p99());
+  }
+  if (max_p99 > 0) {
+    state.counters["p99_min_shard_ns"] = static_cast<double>(min_p99);
+    state.counters["p99_max_shard_ns"] = static_cast<double>(max_p99);
+  }
+}
+BENCHMARK(BM_ShardedBookPipeline)
+    ->ArgsProduct({{1, 2, 4}, {0, 1}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace lats::feed::bench
@@ -1,12 +1,21 @@
+#include "core/disruptor.hpp"
 #include "core/latency_stats.hpp"
+#include "core/mpmc_queue.hpp"
+#include "core/shm_spsc_queue.hpp"
 #include "core/spsc_queue.hpp"
 #include "core/timer.hpp"
 
 #include <benchmark/benchmark.h>
 
+#include <algorithm>
 #include <iostream>
+#include <memory>
+#include <set>
 #include <sched.h>
+#include <string>
 #include <thread>
+#include <unistd.h>
+#include <vector>
 
 namespace lats::core::bench {
 using namespace lats::core;
@@ -57,96 +66,150 @@ BENCHMARK(BM_SinglePushPop);
 // ============================================================================
 // Benchmark 2: Producer-Consumer 延遲（關鍵測試）
 // ============================================================================
-static void BM_ProducerConsumerLatency(benchmark::State &state) {
-  constexpr size_t QUEUE_SIZE = 1024;
+// 生產端與消費端可以是同一個 queue 物件，也可以是附加到同一塊共享記憶體的
+// 兩個 handle；每個 title 只在第一次執行時輸出結果 (同一個 instantiation
+// 會被不同參數的 benchmark 共用，所以以 title 區分)
+template <typename ProducerQueue, typename ConsumerQueue>
+static void run_producer_consumer_latency(ProducerQueue &producer_queue,
+                                          ConsumerQueue &consumer_queue,
+                                          const std::string &title) {
   constexpr size_t NUM_SAMPLES = 100000;
 
-  for (auto _ : state) {
-    SPSCQueue<SmallMessage, QUEUE_SIZE> queue;
-    LatencyStats stats;
+  LatencyStats stats;
 
-    std::atomic<bool> start{false};
-    std::atomic<bool> done{false};
-    std::atomic<uint64_t> samples_collected{0};
+  std::atomic<bool> start{false};
+  std::atomic<bool> done{false};
+  std::atomic<uint64_t> samples_collected{0};
 
-    // 校準 TSC 頻率（只需執行一次）
-    static bool calibrated = false;
-    if (!calibrated) {
-      Timer::calibrate();
-      calibrated = true;
-    }
+  // 校準 TSC 頻率（只需執行一次）
+  static bool calibrated = false;
+  if (!calibrated) {
+    Timer::calibrate();
+    calibrated = true;
+  }
 
-    // Consumer 線程
-    std::thread consumer([&]() {
-      // 等待開始信號
-      while (!start.load(std::memory_order_acquire)) {
-        std::this_thread::yield();
-      }
+  // Consumer 線程
+  std::thread consumer([&]() {
+    // 等待開始信號
+    while (!start.load(std::memory_order_acquire)) {
+      std::this_thread::yield();
+    }
 
-      while (samples_collected.load(std::memory_order_relaxed) < NUM_SAMPLES) {
-        auto result = queue.try_pop();
-        if (result.has_value()) {
-          uint64_t now = Timer::now();
-          uint64_t latency_cycles = now - result->timestamp;
-          uint64_t latency_ns = Timer::cycles_to_ns(latency_cycles);
-          stats.add_sample(latency_ns);
-          samples_collected.fetch_add(1, std::memory_order_relaxed);
-        }
-      }
-      done.store(true, std::memory_order_release);
-    });
-
-    // Producer 線程 (主線程)
-    start.store(true, std::memory_order_release);
-
-    uint64_t sent = 0;
-    while (sent < NUM_SAMPLES) {
-      SmallMessage msg(Timer::now(), sent);
-      if (queue.try_push(std::move(msg))) {
-        sent++;
-      } else {
-        std::this_thread::yield();
+    while (samples_collected.load(std::memory_order_relaxed) < NUM_SAMPLES) {
+      auto result = consumer_queue.try_pop();
+      if (result.has_value()) {
+        uint64_t now = Timer::now();
+        uint64_t latency_cycles = now - result->timestamp;
+        uint64_t latency_ns = Timer::cycles_to_ns(latency_cycles);
+        stats.add_sample(latency_ns);
+        samples_collected.fetch_add(1, std::memory_order_relaxed);
       }
     }
-
-    // 等待 consumer 完成
-    while (!done.load(std::memory_order_acquire)) {
+    done.store(true, std::memory_order_release);
+  });
+
+  // Producer 線程 (主線程)
+  start.store(true, std::memory_order_release);
+
+  uint64_t sent = 0;
+  while (sent < NUM_SAMPLES) {
+    SmallMessage msg(Timer::now(), sent);
+    if (producer_queue.try_push(std::move(msg))) {
+      sent++;
+    } else {
       std::this_thread::yield();
     }
+  }
 
-    consumer.join();
+  // 等待 consumer 完成
+  while (!done.load(std::memory_order_acquire)) {
+    std::this_thread::yield();
+  }
 
-    // 計算統計數據
-    stats.compute();
-
-    // 輸出詳細結果（只在第一次迭代時輸出）
-    static bool first_run = true;
-    if (first_run) {
-      std::cout << "\n========================================\n";
-      std::cout << "Producer-Consumer Latency Analysis\n";
-      std::cout << "========================================\n";
-      std::cout << "Samples:      " << NUM_SAMPLES << "\n";
-      std::cout << "Min Latency:  " << stats.min() << " ns\n";
-      std::cout << "Mean Latency: " << static_cast<uint64_t>(stats.mean())
-                << " ns\n";
-      std::cout << "P50 Latency:  " << stats.p50() << " ns\n";
-      std::cout << "P95 Latency:  " << stats.p95() << " ns\n";
-      std::cout << "P99 Latency:  " << stats.p99() << " ns\n";
-      std::cout << "P999 Latency: " << stats.p999() << " ns\n";
-      std::cout << "Max Latency:  " << stats.max() << " ns\n";
-      std::cout << "========================================\n\n";
-      first_run = false;
-    }
+  consumer.join();
+
+  // 輸出詳細結果（每個 title 只在第一次迭代時輸出）
+  static std::set<std::string> reported;
+  if (reported.insert(title).second) {
+    std::cout << "\n========================================\n";
+    std::cout << title << "\n";
+    std::cout << "========================================\n";
+    std::cout << "Samples:      " << NUM_SAMPLES << "\n";
+    std::cout << "Min Latency:  " << stats.min() << " ns\n";
+    std::cout << "Mean Latency: " << static_cast<uint64_t>(stats.mean())
+              << " ns\n";
+    std::cout << "P50 Latency:  " << stats.p50() << " ns\n";
+    std::cout << "P95 Latency:  " << stats.p95() << " ns\n";
+    std::cout << "P99 Latency:  " << stats.p99() << " ns\n";
+    std::cout << "P999 Latency: " << stats.p999() << " ns\n";
+    std::cout << "Max Latency:  " << stats.max() << " ns\n";
+    std::cout << "========================================\n\n";
+  }
+}
+
+static constexpr size_t LATENCY_QUEUE_SIZE = 1024;
+
+static void BM_ProducerConsumerLatency(benchmark::State &state) {
+  for (auto _ : state) {
+    SPSCQueue<SmallMessage, LATENCY_QUEUE_SIZE> queue;
+    run_producer_consumer_latency(queue, queue,
+                                  "Producer-Consumer Latency Analysis");
   }
 }
 BENCHMARK(BM_ProducerConsumerLatency)
     ->Iterations(1)
     ->Unit(benchmark::kMillisecond);
 
+// 同一個 ring 放在共享記憶體 (ShmSPSCQueue)，與上面的行程內版本比較；
+// 兩端在同一行程的兩個線程，記憶體存取路徑與跨行程時相同。
+// arg: 1 = 優先使用 hugepages (沒有 hugetlbfs 時退回一般頁面)
+static void BM_ShmProducerConsumerLatency(benchmark::State &state) {
+  const std::string name = "/lats_bench_spsc_" + std::to_string(::getpid());
+  const bool hugepages = state.range(0) != 0;
+
+  for (auto _ : state) {
+    auto producer = ShmSPSCQueue<SmallMessage, LATENCY_QUEUE_SIZE>::create(
+        name, ShmRole::Producer, hugepages);
+    auto consumer = ShmSPSCQueue<SmallMessage, LATENCY_QUEUE_SIZE>::attach(
+        name, ShmRole::Consumer);
+    // 標題註明實際使用的頁面，hugepages 退回一般頁面時也看得出來
+    const std::string title =
+        std::string("Shared-Memory Producer-Consumer Latency Analysis (") +
+        (hugepages ? "hugepages requested, " : "") +
+        (producer.hugepages() ? "2MB pages)" : "4KB pages)");
+    run_producer_consumer_latency(producer, consumer, title);
+  }
+}
+BENCHMARK(BM_ShmProducerConsumerLatency)
+    ->Arg(0)
+    ->Arg(1)
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
+
 // ============================================================================
 // Benchmark 3: 吞吐量測試
 // ============================================================================
+// 0: 單筆 try_push/try_pop
+// 1: 批次 try_push_n/try_pop_n
+// 2: 原地 alloc/publish + front/pop
+enum class AccessMode : int64_t { Single = 0, Batch = 1, InPlace = 2 };
+
+static const char *mode_name(AccessMode mode) {
+  switch (mode) {
+  case AccessMode::Single:
+    return "single";
+  case AccessMode::Batch:
+    return "batch";
+  case AccessMode::InPlace:
+    return "in-place";
+  }
+  return "";
+}
+
 static void BM_Throughput(benchmark::State &state) {
+  constexpr size_t BATCH_SIZE = 32;
+  const auto mode = static_cast<AccessMode>(state.range(0));
+
   for (auto _ : state) {
     SPSCQueue<SmallMessage, 2048> queue;
     std::atomic<bool> producer_done{false};
@@ -156,21 +219,62 @@ static void BM_Throughput(benchmark::State &state) {
 
     // Consumer 線程
     std::thread consumer([&]() {
+      SmallMessage batch[BATCH_SIZE];
       while (items_consumed.load(std::memory_order_relaxed) < num_items) {
-        auto result = queue.try_pop();
-        if (result.has_value()) {
-          items_consumed.fetch_add(1, std::memory_order_relaxed);
-          benchmark::DoNotOptimize(result);
+        if (mode == AccessMode::Batch) {
+          size_t n = queue.try_pop_n(batch, BATCH_SIZE);
+          benchmark::DoNotOptimize(batch);
+          items_consumed.fetch_add(n, std::memory_order_relaxed);
+        } else if (mode == AccessMode::InPlace) {
+          if (SmallMessage *msg = queue.front()) {
+            benchmark::DoNotOptimize(msg->sequence);
+            queue.pop();
+            items_consumed.fetch_add(1, std::memory_order_relaxed);
+          }
+        } else {
+          auto result = queue.try_pop();
+          if (result.has_value()) {
+            items_consumed.fetch_add(1, std::memory_order_relaxed);
+            benchmark::DoNotOptimize(result);
+          }
         }
       }
     });
 
     // Producer 線程
     std::thread producer([&]() {
-      for (uint64_t i = 0; i < num_items; ++i) {
-        SmallMessage msg(Timer::now(), i);
-        while (!queue.try_push(std::move(msg))) {
-          std::this_thread::yield();
+      if (mode == AccessMode::Batch) {
+        SmallMessage batch[BATCH_SIZE];
+        for (uint64_t i = 0; i < num_items;) {
+          size_t n = std::min<size_t>(BATCH_SIZE, num_items - i);
+          for (size_t j = 0; j < n; ++j) {
+            batch[j] = SmallMessage(Timer::now(), i + j);
+          }
+          size_t pushed = 0;
+          while (pushed < n) {
+            pushed += queue.try_push_n(batch + pushed, n - pushed);
+            if (pushed < n) {
+              std::this_thread::yield();
+            }
+          }
+          i += n;
+        }
+      } else if (mode == AccessMode::InPlace) {
+        for (uint64_t i = 0; i < num_items; ++i) {
+          SmallMessage *slot;
+          while ((slot = queue.alloc()) == nullptr) {
+            std::this_thread::yield();
+          }
+          slot->timestamp = Timer::now();
+          slot->sequence = i;
+          queue.publish();
+        }
+      } else {
+        for (uint64_t i = 0; i < num_items; ++i) {
+          SmallMessage msg(Timer::now(), i);
+          while (!queue.try_push(std::move(msg))) {
+            std::this_thread::yield();
+          }
         }
       }
       producer_done.store(true, std::memory_order_release);
@@ -181,27 +285,290 @@ static void BM_Throughput(benchmark::State &state) {
 
     state.SetItemsProcessed(num_items);
   }
+
+  state.SetLabel(mode_name(mode));
 }
-BENCHMARK(BM_Throughput)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Throughput)
+    ->Arg(static_cast<int64_t>(AccessMode::Single))
+    ->Arg(static_cast<int64_t>(AccessMode::Batch))
+    ->Arg(static_cast<int64_t>(AccessMode::InPlace))
+    ->Unit(benchmark::kMillisecond);
 
 // ============================================================================
 // Benchmark 4: 不同消息大小的影響
 // ============================================================================
-template <typename T> static void BM_MessageSize(benchmark::State &state) {
+// InPlace 為 true 時以 alloc/publish + front/pop 直接在 ring 上讀寫，
+// 省去 std::optional<T> 的回傳複製，消息越大差距越明顯
+template <typename T, bool InPlace>
+static void BM_MessageSize(benchmark::State &state) {
   SPSCQueue<T, 1024> queue;
   uint64_t counter = 0;
 
   for (auto _ : state) {
-    T msg(Timer::now(), counter++);
-    benchmark::DoNotOptimize(queue.try_push(std::move(msg)));
-    auto result = queue.try_pop();
-    benchmark::DoNotOptimize(result);
+    if constexpr (InPlace) {
+      T *slot = queue.alloc();
+      slot->timestamp = Timer::now();
+      slot->sequence = counter++;
+      queue.publish();
+
+      T *msg = queue.front();
+      benchmark::DoNotOptimize(msg->sequence);
+      queue.pop();
+    } else {
+      T msg(Timer::now(), counter++);
+      benchmark::DoNotOptimize(queue.try_push(std::move(msg)));
+      auto result = queue.try_pop();
+      benchmark::DoNotOptimize(result);
+    }
   }
 
-  state.SetLabel(std::to_string(sizeof(T)) + " bytes");
+  state.SetLabel(std::to_string(sizeof(T)) + " bytes" +
+                 (InPlace ? ", in-place" : ""));
   state.SetItemsProcessed(state.iterations());
 }
-BENCHMARK_TEMPLATE(BM_MessageSize, SmallMessage);
-BENCHMARK_TEMPLATE(BM_MessageSize, MediumMessage);
+BENCHMARK_TEMPLATE(BM_MessageSize, SmallMessage, false);
+BENCHMARK_TEMPLATE(BM_MessageSize, MediumMessage, false);
+BENCHMARK_TEMPLATE(BM_MessageSize, SmallMessage, true);
+BENCHMARK_TEMPLATE(BM_MessageSize, MediumMessage, true);
+
+// ============================================================================
+// Benchmark 5: 多生產者吞吐量 (MPMC vs 每個生產者一條 SPSC)
+// ============================================================================
+// MPMC：所有生產者共用一條 queue
+static void BM_MPMCMultiProducer(benchmark::State &state) {
+  const int num_producers = static_cast<int>(state.range(0));
+  const size_t items_per_producer = 1000000 / num_producers;
+  const size_t total = items_per_producer * num_producers;
+
+  for (auto _ : state) {
+    auto queue = std::make_unique<MPMCQueue<SmallMessage, 2048>>();
+
+    std::thread consumer([&]() {
+      size_t consumed = 0;
+      while (consumed < total) {
+        auto result = queue->try_pop();
+        if (result.has_value()) {
+          benchmark::DoNotOptimize(result);
+          ++consumed;
+        }
+      }
+    });
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < num_producers; ++p) {
+      producers.emplace_back([&]() {
+        for (uint64_t i = 0; i < items_per_producer; ++i) {
+          SmallMessage msg(Timer::now(), i);
+          while (!queue->try_push(msg)) {
+            std::this_thread::yield();
+          }
+        }
+      });
+    }
+
+    for (auto &t : producers) {
+      t.join();
+    }
+    consumer.join();
+
+    state.SetItemsProcessed(total);
+  }
+}
+BENCHMARK(BM_MPMCMultiProducer)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// SPSC：SPSCQueue 不允許多個生產者，因此每個生產者一條，消費者輪詢全部
+static void BM_SPSCFanIn(benchmark::State &state) {
+  using Queue = SPSCQueue<SmallMessage, 2048>;
+  const int num_producers = static_cast<int>(state.range(0));
+  const size_t items_per_producer = 1000000 / num_producers;
+  const size_t total = items_per_producer * num_producers;
+
+  for (auto _ : state) {
+    std::vector<std::unique_ptr<Queue>> queues;
+    for (int p = 0; p < num_producers; ++p) {
+      queues.push_back(std::make_unique<Queue>());
+    }
+
+    std::thread consumer([&]() {
+      size_t consumed = 0;
+      while (consumed < total) {
+        for (auto &queue : queues) {
+          auto result = queue->try_pop();
+          if (result.has_value()) {
+            benchmark::DoNotOptimize(result);
+            ++consumed;
+          }
+        }
+      }
+    });
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < num_producers; ++p) {
+      producers.emplace_back([&, p]() {
+        Queue &queue = *queues[p];
+        for (uint64_t i = 0; i < items_per_producer; ++i) {
+          SmallMessage msg(Timer::now(), i);
+          while (!queue.try_push(msg)) {
+            std::this_thread::yield();
+          }
+        }
+      });
+    }
+
+    for (auto &t : producers) {
+      t.join();
+    }
+    consumer.join();
+
+    state.SetItemsProcessed(total);
+  }
+}
+BENCHMARK(BM_SPSCFanIn)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// ============================================================================
+// Benchmark 6: 一對多廣播 (Disruptor vs 每個消費者一條 SPSC)
+// ============================================================================
+// 每個消費者各自量測發布到讀取的延遲，最後合併
+static void BM_DisruptorLatency(benchmark::State &state) {
+  constexpr size_t NUM_SAMPLES = 100000;
+  const size_t num_consumers = static_cast<size_t>(state.range(0));
+
+  static bool calibrated = false;
+  if (!calibrated) {
+    Timer::calibrate();
+    calibrated = true;
+  }
+
+  for (auto _ : state) {
+    auto ring = std::make_unique<Disruptor<SmallMessage, 1024>>();
+    std::vector<LatencyStats> stats(num_consumers);
+    for (size_t c = 0; c < num_consumers; ++c) {
+      ring->add_consumer();
+    }
+
+    std::vector<std::thread> consumers;
+    for (size_t c = 0; c < num_consumers; ++c) {
+      consumers.emplace_back([&, c]() {
+        size_t received = 0;
+        while (received < NUM_SAMPLES) {
+          const size_t n =
+              ring->poll(c, [&](const SmallMessage &msg, uint64_t) {
+                const uint64_t now = Timer::now();
+                stats[c].add_sample(Timer::cycles_to_ns(now - msg.timestamp));
+              });
+          received += n;
+          if (n == 0) {
+            std::this_thread::yield();
+          }
+        }
+      });
+    }
+
+    uint64_t sent = 0;
+    while (sent < NUM_SAMPLES) {
+      if (SmallMessage *slot = ring->try_claim()) {
+        *slot = SmallMessage(Timer::now(), sent++);
+        ring->publish();
+      } else {
+        std::this_thread::yield();
+      }
+    }
+    for (auto &t : consumers) {
+      t.join();
+    }
+
+    LatencyStats merged;
+    for (const auto &s : stats) {
+      merged.merge(s);
+    }
+    state.counters["p50_ns"] = static_cast<double>(merged.p50());
+    state.counters["p99_ns"] = static_cast<double>(merged.p99());
+    state.counters["p999_ns"] = static_cast<double>(merged.p999());
+  }
+}
+BENCHMARK(BM_DisruptorLatency)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
+
+// args: {消費者數, 0 = 每個消費者一條 SPSCQueue (生產者複製 N 份),
+//        1 = 一個 Disruptor (只寫一次)}
+static void BM_FanOutThroughput(benchmark::State &state) {
+  using Queue = SPSCQueue<SmallMessage, 2048>;
+  using Ring = Disruptor<SmallMessage, 2048>;
+  const size_t num_consumers = static_cast<size_t>(state.range(0));
+  const bool use_disruptor = state.range(1) != 0;
+  const size_t num_items = 1000000;
+
+  for (auto _ : state) {
+    std::vector<std::unique_ptr<Queue>> queues;
+    auto ring = std::make_unique<Ring>();
+    for (size_t c = 0; c < num_consumers; ++c) {
+      queues.push_back(std::make_unique<Queue>());
+      ring->add_consumer();
+    }
+
+    std::vector<std::thread> consumers;
+    for (size_t c = 0; c < num_consumers; ++c) {
+      consumers.emplace_back([&, c]() {
+        size_t consumed = 0;
+        while (consumed < num_items) {
+          size_t n = 0;
+          if (use_disruptor) {
+            n = ring->poll(c, [](const SmallMessage &msg, uint64_t) {
+              benchmark::DoNotOptimize(msg.sequence);
+            });
+          } else if (auto result = queues[c]->try_pop()) {
+            benchmark::DoNotOptimize(result);
+            n = 1;
+          }
+          consumed += n;
+          if (n == 0) {
+            std::this_thread::yield();
+          }
+        }
+      });
+    }
+
+    for (uint64_t i = 0; i < num_items; ++i) {
+      const SmallMessage msg(Timer::now(), i);
+      if (use_disruptor) {
+        while (!ring->try_publish(msg)) {
+          std::this_thread::yield();
+        }
+        continue;
+      }
+      for (auto &queue : queues) {
+        while (!queue->try_push(msg)) {
+          std::this_thread::yield();
+        }
+      }
+    }
+    for (auto &t : consumers) {
+      t.join();
+    }
+
+    state.SetItemsProcessed(num_items);
+  }
+  state.SetLabel(use_disruptor ? "disruptor" : "spsc x N");
+}
+BENCHMARK(BM_FanOutThroughput)
+    ->ArgsProduct({{1, 2, 4}, {0, 1}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
 
 } // namespace lats::core::bench
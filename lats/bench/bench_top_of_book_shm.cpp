@@ -0,0 +1,160 @@
+#include "core/cpu_affinity.hpp"
+#include "core/latency_stats.hpp"
+#include "core/timer.hpp"
+#include "lob/top_of_book_shm.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+namespace lats::lob::bench {
+using namespace lats::lob;
+using core::Timer;
+
+namespace {
+
+std::string bench_shm_name() {
+  return "/lats_bench_tob_" + std::to_string(::getpid());
+}
+
+void fill_levels(BookLevel *levels, uint32_t depth, uint64_t i) {
+  for (uint32_t k = 0; k < depth; ++k) {
+    levels[k] = {static_cast<Price>(i + k), i};
+  }
+}
+
+} // namespace
+
+// ============================================================================
+// Benchmark 1: 發布成本 (單線程，沒有讀取端競爭)
+// ============================================================================
+static void BM_TobPublish(benchmark::State &state) {
+  const auto depth = static_cast<uint32_t>(state.range(0));
+  TopOfBookPublisher publisher(bench_shm_name(), 64, depth);
+  BookLevel levels[TOB_MAX_DEPTH];
+  uint64_t i = 0;
+
+  for (auto _ : state) {
+    fill_levels(levels, depth, i);
+    publisher.publish(static_cast<uint32_t>(i & 63), levels, depth, levels,
+                      depth, i);
+    ++i;
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TobPublish)->Arg(1)->Arg(5)->Arg(10);
+
+// ============================================================================
+// Benchmark 2: 讀取成本 (單線程，entry 在 cache 中)
+// ============================================================================
+static void BM_TobRead(benchmark::State &state) {
+  const auto depth = static_cast<uint32_t>(state.range(0));
+  TopOfBookPublisher publisher(bench_shm_name(), 64, depth);
+  TopOfBookReader reader(publisher.name());
+  BookLevel levels[TOB_MAX_DEPTH];
+  for (uint32_t s = 0; s < 64; ++s) {
+    fill_levels(levels, depth, s);
+    publisher.publish(s, levels, depth, levels, depth, s);
+  }
+
+  TopOfBook tob;
+  uint32_t symbol = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(reader.try_read(symbol++ & 63, tob));
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TobRead)->Arg(1)->Arg(5)->Arg(10);
+
+// ============================================================================
+// Benchmark 3: 跨核心可見延遲
+// ============================================================================
+// 寫入端以 Timer::now() 當時間戳發布，讀取端輪詢版本，看到新版本後讀出
+// 時間戳並計算差值；每次等讀取端確認後才發布下一筆，量到的是純粹的
+// cache line 轉移延遲而不是佇列堆積。args: {depth, writer cpu, reader cpu}
+static void BM_TobVisibilityLatency(benchmark::State &state) {
+  constexpr uint64_t NUM_SAMPLES = 100000;
+  const auto depth = static_cast<uint32_t>(state.range(0));
+  const int writer_cpu = static_cast<int>(state.range(1));
+  const int reader_cpu = static_cast<int>(state.range(2));
+
+  Timer::calibrate();
+
+  for (auto _ : state) {
+    TopOfBookPublisher publisher(bench_shm_name(), 1, depth);
+    TopOfBookReader reader(publisher.name());
+    core::LatencyStats stats;
+    std::atomic<uint64_t> acked{0};
+
+    std::thread consumer([&] {
+      core::pin_current_thread(reader_cpu);
+      TopOfBook tob;
+      uint64_t seen = 0;
+      for (uint64_t n = 0; n < NUM_SAMPLES; ++n) {
+        for (unsigned spins = 0; reader.version(0) == seen; ++spins) {
+          if (spins < 1024) {
+            __builtin_ia32_pause();
+          } else {
+            std::this_thread::yield();
+          }
+        }
+        reader.read(0, tob);
+        const uint64_t now = Timer::now();
+        seen = tob.version;
+        stats.add_sample(Timer::cycles_to_ns(now - tob.timestamp));
+        acked.store(n + 1, std::memory_order_release);
+      }
+    });
+
+    std::thread producer([&] {
+      core::pin_current_thread(writer_cpu);
+      BookLevel levels[TOB_MAX_DEPTH];
+      for (uint64_t n = 0; n < NUM_SAMPLES; ++n) {
+        fill_levels(levels, depth, n);
+        publisher.publish(0, levels, depth, levels, depth, Timer::now());
+        while (acked.load(std::memory_order_acquire) <= n) {
+          // 單核心機器上讓出 CPU 給讀取端
+          std::this_thread::yield();
+        }
+      }
+    });
+    producer.join();
+    consumer.join();
+
+    state.counters["p50_ns"] = static_cast<double>(stats.p50());
+    state.counters["p99_ns"] = static_cast<double>(stats.p99());
+    state.counters["p999_ns"] = static_cast<double>(stats.p999());
+
+    static bool first_run = true;
+    if (first_run) {
+      std::cout << "\n========================================\n";
+      std::cout << "Top-of-Book Visibility Latency (depth " << depth
+                << ", cpu " << writer_cpu << " -> " << reader_cpu << ")\n";
+      std::cout << "========================================\n";
+      std::cout << "Samples:      " << stats.count() << "\n";
+      std::cout << "Min Latency:  " << stats.min() << " ns\n";
+      std::cout << "Mean Latency: " << static_cast<uint64_t>(stats.mean())
+                << " ns\n";
+      std::cout << "P50 Latency:  " << stats.p50() << " ns\n";
+      std::cout << "P99 Latency:  " << stats.p99() << " ns\n";
+      std::cout << "P999 Latency: " << stats.p999() << " ns\n";
+      std::cout << "Max Latency:  " << stats.max() << " ns\n";
+      std::cout << "========================================\n\n";
+      first_run = false;
+    }
+  }
+}
+BENCHMARK(BM_TobVisibilityLatency)
+    ->Args({1, 0, 1})
+    ->Args({10, 0, 1})
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace lats::lob::bench
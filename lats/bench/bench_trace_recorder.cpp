@@ -0,0 +1,44 @@
+#include "core/trace_recorder.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+
+namespace lats::core::bench {
+using namespace lats::core;
+
+// ============================================================================
+// tracepoint 的 hot path 成本：未註冊 (只檢查 thread_local) 與寫入 ring
+// ============================================================================
+static void BM_TracePointDisabled(benchmark::State &state) {
+  uint64_t seq = 0;
+  for (auto _ : state) {
+    trace(0, seq++);
+  }
+  benchmark::DoNotOptimize(seq);
+}
+BENCHMARK(BM_TracePointDisabled);
+
+static void BM_TracePointEnabled(benchmark::State &state) {
+  const std::string path =
+      "/tmp/lats_bench_trace_" + std::to_string(::getpid()) + ".bin";
+  TraceRecorder recorder(path, {"recv", "parse"});
+  recorder.register_thread();
+
+  uint64_t seq = 0;
+  for (auto _ : state) {
+    trace(static_cast<uint32_t>(seq & 1), seq);
+    ++seq;
+  }
+
+  TraceRecorder::unregister_thread();
+  recorder.stop();
+  state.counters["dropped"] = static_cast<double>(recorder.dropped());
+  std::remove(path.c_str());
+}
+BENCHMARK(BM_TracePointEnabled);
+
+} // namespace lats::core::bench
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <pthread.h>
+#include <sched.h>
+
+namespace lats::core {
+
+/// 將呼叫端線程綁定到指定 CPU，cpu < 0 代表不綁定。
+/// 搭配 isolcpus/nohz_full 隔離的核心，避免排程器把熱路徑線程搬走
+inline bool pin_current_thread(int cpu) {
+  if (cpu < 0) {
+    return true;
+  }
+
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+} // namespace lats::core
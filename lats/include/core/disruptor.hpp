@@ -0,0 +1,183 @@
+#pragma once
+
+#include "core/spsc_queue.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace lats::core {
+
+/// 單生產者、多消費者的廣播 ring (LMAX Disruptor)
+///
+/// 每則訊息只寫入 ring 一次，所有消費者讀取同一個 slot，不需要為每個
+/// 消費者複製一份到各自的 SPSCQueue。位置以遞增的 sequence 表示：
+/// - 生產者的 cursor 是已發布的數量，每個消費者的 cursor 是已處理的數量
+/// - 生產者要寫 sequence s 時，所有消費者的 cursor 都必須大於 s - Capacity
+///   (最慢的消費者決定 ring 能否覆寫)
+/// - 消費者可讀到 min(生產者 cursor, 所依賴消費者的 cursor)，因此可以組成
+///   依賴鏈，例如 logger 只處理 book builder 已處理過的訊息
+///
+/// 消費者必須在開始發布前以 add_consumer() 註冊；每個消費者只能由一個線程
+/// 呼叫 poll()。沒有任何消費者時生產者不受限制。
+template <typename T, size_t Capacity, size_t MaxConsumers = 8>
+class Disruptor {
+  static_assert((Capacity & (Capacity - 1)) == 0 && Capacity > 0,
+                "Capacity must be power of 2");
+
+  static_assert(std::is_default_constructible_v<T>,
+                "T must be DefaultConstructible for zero-overhead");
+
+  struct alignas(CACHE_LINE_SIZE) ConsumerState {
+    std::atomic<uint64_t> cursor{0};
+    // 以下只有該消費者的線程讀寫
+    uint64_t barrier_cache = 0;
+    size_t num_dependencies = 0;
+    std::array<size_t, MaxConsumers> dependencies{};
+  };
+
+public:
+  using ConsumerId = size_t;
+
+  Disruptor() = default;
+
+  // Disable copy and move
+  Disruptor(const Disruptor &) = delete;
+  Disruptor &operator=(const Disruptor &) = delete;
+
+  /// 註冊消費者，dependencies 為必須先處理完同一則訊息的消費者；
+  /// 超過 MaxConsumers、依賴超過 MaxConsumers 個或不存在時丟出
+  /// std::invalid_argument，此時不會留下任何註冊狀態
+  ConsumerId
+  add_consumer(std::initializer_list<ConsumerId> dependencies = {}) {
+    if (num_consumers_ == MaxConsumers) {
+      throw std::invalid_argument("too many disruptor consumers");
+    }
+    // 先檢查整份清單再寫入
+    if (dependencies.size() > MaxConsumers) {
+      throw std::invalid_argument("too many disruptor dependencies");
+    }
+    for (ConsumerId dep : dependencies) {
+      if (dep >= num_consumers_) {
+        throw std::invalid_argument("disruptor dependency must be an "
+                                    "already registered consumer");
+      }
+    }
+    ConsumerState &state = consumers_[num_consumers_];
+    state.num_dependencies = 0;
+    for (ConsumerId dep : dependencies) {
+      state.dependencies[state.num_dependencies++] = dep;
+    }
+    // 從目前的位置開始，不會讀到註冊前發布的訊息
+    const uint64_t start = cursor_.load(std::memory_order_relaxed);
+    state.cursor.store(start, std::memory_order_relaxed);
+    state.barrier_cache = start;
+    return num_consumers_++;
+  }
+
+  size_t consumer_count() const { return num_consumers_; }
+
+  // ---- 生產者 ----
+
+  /// 取得下一個可寫的 slot，最慢的消費者還沒讀完時回傳 nullptr；
+  /// 寫完後呼叫 publish()
+  T *try_claim() {
+    if (next_ - gating_cache_ >= Capacity) {
+      gating_cache_ = min_consumer_cursor();
+      if (next_ - gating_cache_ >= Capacity) {
+        return nullptr;
+      }
+    }
+    return &buffer_[next_ & (Capacity - 1)];
+  }
+
+  /// 發布 try_claim() 取得的 slot
+  void publish() { cursor_.store(++next_, std::memory_order_release); }
+
+  template <typename U> bool try_publish(U &&item) {
+    T *slot = try_claim();
+    if (slot == nullptr) {
+      return false;
+    }
+    *slot = std::forward<U>(item);
+    publish();
+    return true;
+  }
+
+  /// 已發布的數量
+  uint64_t cursor() const { return cursor_.load(std::memory_order_acquire); }
+
+  // ---- 消費者 ----
+
+  /// 依序處理 consumer 目前可讀的訊息 (最多 max 則)，f(const T &, sequence)；
+  /// 整批處理完才推進一次 cursor。回傳處理數量
+  template <typename F>
+  size_t poll(ConsumerId consumer, F &&f,
+              size_t max = std::numeric_limits<size_t>::max()) {
+    ConsumerState &state = consumers_[consumer];
+    const uint64_t from = state.cursor.load(std::memory_order_relaxed);
+
+    if (from == state.barrier_cache) {
+      state.barrier_cache = barrier(state);
+      if (from == state.barrier_cache) {
+        return 0;
+      }
+    }
+
+    uint64_t to = state.barrier_cache;
+    if (to - from > max) {
+      to = from + max;
+    }
+    for (uint64_t seq = from; seq < to; ++seq) {
+      f(static_cast<const T &>(buffer_[seq & (Capacity - 1)]), seq);
+    }
+    state.cursor.store(to, std::memory_order_release);
+    return static_cast<size_t>(to - from);
+  }
+
+  /// consumer 已處理的數量
+  uint64_t consumer_cursor(ConsumerId consumer) const {
+    return consumers_[consumer].cursor.load(std::memory_order_acquire);
+  }
+
+private:
+  std::array<T, Capacity> buffer_;
+  std::array<ConsumerState, MaxConsumers> consumers_{};
+  size_t num_consumers_ = 0;
+
+  // 生產者：已發布的數量，與只有生產者讀寫的欄位放在同一條 cache line
+  alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> cursor_{0};
+  uint64_t next_ = 0;         // 下一個要寫的 sequence
+  uint64_t gating_cache_ = 0; // 生產者看到的最慢消費者 cursor
+
+  uint64_t min_consumer_cursor() const {
+    uint64_t min = next_;
+    for (size_t i = 0; i < num_consumers_; ++i) {
+      const uint64_t c = consumers_[i].cursor.load(std::memory_order_acquire);
+      if (c < min) {
+        min = c;
+      }
+    }
+    return min;
+  }
+
+  uint64_t barrier(const ConsumerState &state) const {
+    uint64_t limit = cursor_.load(std::memory_order_acquire);
+    for (size_t i = 0; i < state.num_dependencies; ++i) {
+      const uint64_t c = consumers_[state.dependencies[i]].cursor.load(
+          std::memory_order_acquire);
+      if (c < limit) {
+        limit = c;
+      }
+    }
+    return limit;
+  }
+};
+
+} // namespace lats::core
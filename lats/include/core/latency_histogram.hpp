@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace lats::core {
+
+/// Log-linear 延遲直方圖 (HDR Histogram 的簡化版)
+///
+/// 每個 2 的冪次區間 [2^k, 2^(k+1)) 再切成 SUB_BUCKET_COUNT 個等寬
+/// sub-bucket，因此相對誤差上限為 1 / SUB_BUCKET_COUNT (約 0.8%)，
+/// 小於 2 * SUB_BUCKET_COUNT 的值則是精確的。bucket 數量固定，
+/// record() 為 O(1) 且不配置記憶體，percentile 只需走訪 bucket 不需排序。
+///
+/// 非 thread-safe：每個線程各自記錄，再由彙整端 merge()。
+class LatencyHistogram {
+public:
+  static constexpr unsigned SUB_BUCKET_BITS = 7;
+  static constexpr size_t SUB_BUCKET_COUNT = size_t{1} << SUB_BUCKET_BITS;
+  // shift = 0..(63 - SUB_BUCKET_BITS)，另加 [0, SUB_BUCKET_COUNT) 的線性區
+  static constexpr size_t BUCKET_COUNT =
+      (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+  LatencyHistogram();
+
+  void record(uint64_t value) {
+    ++counts_[bucket_index(value)];
+    ++total_;
+    sum_ += value;
+    if (value < min_) {
+      min_ = value;
+    }
+    if (value > max_) {
+      max_ = value;
+    }
+  }
+
+  /// 將另一個直方圖的計數加進來 (例如彙整各線程的結果)
+  void merge(const LatencyHistogram &other);
+
+  /// 清空所有計數，不釋放記憶體
+  void reset();
+
+  /// 取出目前區間的結果到 out 並清空自己，用於週期性輸出。
+  /// 以 swap 實作，out 原本的內容會被清掉，不會配置記憶體
+  void snapshot_and_reset(LatencyHistogram &out);
+
+  bool empty() const { return total_ == 0; }
+  uint64_t count() const { return total_; }
+  uint64_t min() const { return total_ == 0 ? 0 : min_; }
+  uint64_t max() const { return max_; }
+  double mean() const;
+
+  /// p 介於 0.0 ~ 1.0，回傳該 bucket 可代表的最大值 (不超過 max())
+  uint64_t percentile(double p) const;
+
+  static size_t bucket_index(uint64_t value) {
+    if (value < SUB_BUCKET_COUNT) {
+      return static_cast<size_t>(value);
+    }
+    // value 的最高位落在 msb，保留最高的 SUB_BUCKET_BITS + 1 位
+    const unsigned msb = 63 - static_cast<unsigned>(__builtin_clzll(value));
+    const unsigned shift = msb - SUB_BUCKET_BITS;
+    const size_t top = static_cast<size_t>(value >> shift); // [128, 256)
+    return (shift + 1) * SUB_BUCKET_COUNT + (top - SUB_BUCKET_COUNT);
+  }
+
+  /// bucket 涵蓋的最小值與最大值
+  static uint64_t bucket_lowest(size_t index);
+  static uint64_t bucket_highest(size_t index);
+
+private:
+  std::vector<uint64_t> counts_;
+  uint64_t total_ = 0;
+  uint64_t sum_ = 0;
+  uint64_t min_ = UINT64_MAX;
+  uint64_t max_ = 0;
+};
+
+} // namespace lats::core
@@ -1,28 +1,40 @@
 #pragma once
 
-#include <algorithm>
+#include "core/latency_histogram.hpp"
+
 #include <cstdint>
-#include <vector>
 
 namespace lats::core {
 
+/// 延遲統計，底層為固定大小的 LatencyHistogram：
+/// 記憶體不隨樣本數成長，取 percentile 也不需要排序
 class LatencyStats {
 public:
-  void add_sample(uint64_t latency_ns) { samples_.push_back(latency_ns); }
+  void add_sample(uint64_t latency_ns) { histogram_.record(latency_ns); }
+
+  // 保留給舊的呼叫端，histogram 不需要事先排序
+  void compute() {}
 
-  void compute() { std::sort(samples_.begin(), samples_.end()); }
+  void merge(const LatencyStats &other) { histogram_.merge(other.histogram_); }
+  void reset() { histogram_.reset(); }
+  void snapshot_and_reset(LatencyStats &out) {
+    histogram_.snapshot_and_reset(out.histogram_);
+  }
 
-  uint64_t min() const { return samples_.front(); }
-  uint64_t max() const { return samples_.back(); }
-  uint64_t percentile(double p) const;
+  uint64_t count() const { return histogram_.count(); }
+  uint64_t min() const;
+  uint64_t max() const;
+  uint64_t percentile(double p) const { return histogram_.percentile(p); }
   uint64_t p50() const { return percentile(0.50); }
   uint64_t p95() const { return percentile(0.95); }
   uint64_t p99() const { return percentile(0.99); }
   uint64_t p999() const { return percentile(0.999); }
-  double mean() const;
+  double mean() const { return histogram_.mean(); }
+
+  const LatencyHistogram &histogram() const { return histogram_; }
 
 private:
-  std::vector<uint64_t> samples_;
+  LatencyHistogram histogram_;
 };
 
 } // namespace lats::core
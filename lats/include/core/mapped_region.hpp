@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+
+namespace lats::core {
+
+inline constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+/// 匿名 mmap 記憶體區塊 (RAII)
+///
+/// hugepages 為 true 時優先使用 MAP_HUGETLB，系統未預留 hugepage 時退回一般頁面
+/// 並以 madvise(MADV_HUGEPAGE) 提示 THP。prefault 為 true 時在建構期間觸碰每一頁，
+/// 避免執行期間第一次寫入觸發 page fault。
+class MappedRegion {
+public:
+  MappedRegion() = default;
+  MappedRegion(size_t size, bool hugepages, bool prefault);
+  ~MappedRegion();
+
+  MappedRegion(const MappedRegion &) = delete;
+  MappedRegion &operator=(const MappedRegion &) = delete;
+
+  MappedRegion(MappedRegion &&other) noexcept;
+  MappedRegion &operator=(MappedRegion &&other) noexcept;
+
+  void *data() const { return data_; }
+  size_t size() const { return size_; }
+  bool hugepages() const { return hugepages_; }
+
+private:
+  void *data_ = nullptr;
+  size_t size_ = 0;
+  bool hugepages_ = false;
+
+  void release();
+};
+
+} // namespace lats::core
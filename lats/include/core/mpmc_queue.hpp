@@ -0,0 +1,113 @@
+#pragma once
+
+#include "core/spsc_queue.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+
+namespace lats::core {
+
+/// Bounded MPMC Queue (Dmitry Vyukov)
+///
+/// 每個 cell 帶一個 sequence：sequence == pos 代表可寫入，sequence == pos + 1
+/// 代表可讀取。生產者/消費者只以 CAS 搶 head_/tail_，搶到後獨佔該 cell，
+/// 不需要鎖。與 SPSCQueue 不同，Capacity 個位置全部可用。
+template <typename T, size_t Capacity> class MPMCQueue {
+  static_assert((Capacity & (Capacity - 1)) == 0 && Capacity > 0,
+                "Capacity must be power of 2");
+
+  static_assert(std::is_default_constructible_v<T>,
+                "T must be DefaultConstructible for zero-overhead");
+
+  // 每個 cell 獨佔 cache line，相鄰 cell 的讀寫不會互相 false sharing
+  struct alignas(CACHE_LINE_SIZE) Cell {
+    std::atomic<size_t> sequence;
+    T data;
+  };
+
+public:
+  MPMCQueue() {
+    for (size_t i = 0; i < Capacity; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  // Disable copy and move
+  MPMCQueue(const MPMCQueue &) = delete;
+  MPMCQueue &operator=(const MPMCQueue &) = delete;
+
+  template <typename U> bool try_push(U &&item) {
+    size_t pos = head_.load(std::memory_order_relaxed);
+    Cell *cell;
+
+    while (true) {
+      cell = &cells_[pos & (Capacity - 1)];
+      const size_t seq = cell->sequence.load(std::memory_order_acquire);
+      const intptr_t diff =
+          static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+      if (diff == 0) {
+        // cell 可寫，搶 head_；失敗時 pos 會被更新為最新值
+        if (head_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false; // 滿了：cell 還沒被上一輪的消費者讀走
+      } else {
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+
+    cell->data = std::forward<U>(item);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  std::optional<T> try_pop() {
+    size_t pos = tail_.load(std::memory_order_relaxed);
+    Cell *cell;
+
+    while (true) {
+      cell = &cells_[pos & (Capacity - 1)];
+      const size_t seq = cell->sequence.load(std::memory_order_acquire);
+      const intptr_t diff =
+          static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+
+      if (diff == 0) {
+        if (tail_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return std::nullopt; // 空的
+      } else {
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+
+    T item = std::move(cell->data);
+    // 交還給下一輪 (pos + Capacity) 的生產者
+    cell->sequence.store(pos + Capacity, std::memory_order_release);
+    return item;
+  }
+
+  // 多線程下只是近似值
+  bool empty() const {
+    return head_.load(std::memory_order_acquire) ==
+           tail_.load(std::memory_order_acquire);
+  }
+
+private:
+  std::array<Cell, Capacity> cells_;
+
+  // Cache line padding to prevent false sharing
+  alignas(CACHE_LINE_SIZE) std::atomic<size_t> head_{0};
+  alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail_{0};
+};
+
+} // namespace lats::core
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "core/mapped_region.hpp"
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace lats::core {
+
+struct PoolOptions {
+  bool hugepages = false; // 使用 hugepage 降低 TLB miss
+  bool prefault = true;   // 建構時預先觸發 page fault
+};
+
+/// 固定容量物件池 (單線程)
+///
+/// 所有 slot 在建構時一次 mmap，之後不再向系統要記憶體。
+/// 空閒 slot 的前 8 bytes 直接存放下一個空閒 slot 的指標 (intrusive free list)，
+/// 從未使用過的 slot 以 bump pointer 依序配出，因此 allocate/deallocate 皆為 O(1)。
+/// 容量耗盡時回傳 nullptr 而不是擴充。
+template <typename T> class ObjectPool {
+  union Slot {
+    Slot *next;
+    alignas(T) unsigned char storage[sizeof(T)];
+  };
+
+public:
+  explicit ObjectPool(size_t capacity, PoolOptions options = {})
+      : region_(capacity * sizeof(Slot), options.hugepages, options.prefault),
+        slots_(static_cast<Slot *>(region_.data())), capacity_(capacity) {}
+
+  // 池中仍存活的物件不會被解構，由使用者負責
+  ~ObjectPool() = default;
+
+  ObjectPool(const ObjectPool &) = delete;
+  ObjectPool &operator=(const ObjectPool &) = delete;
+
+  template <typename... Args> T *construct(Args &&...args) {
+    void *p = allocate();
+    if (p == nullptr) {
+      return nullptr;
+    }
+    return new (p) T(std::forward<Args>(args)...);
+  }
+
+  void destroy(T *obj) {
+    obj->~T();
+    deallocate(obj);
+  }
+
+  void *allocate() {
+    Slot *slot = free_list_;
+    if (slot != nullptr) {
+      free_list_ = slot->next;
+    } else if (next_unused_ < capacity_) {
+      slot = &slots_[next_unused_++];
+    } else {
+      return nullptr;
+    }
+
+    ++in_use_;
+    return slot->storage;
+  }
+
+  void deallocate(void *p) {
+    Slot *slot = static_cast<Slot *>(p);
+    slot->next = free_list_;
+    free_list_ = slot;
+    --in_use_;
+  }
+
+  bool owns(const void *p) const {
+    const auto *slot = static_cast<const Slot *>(p);
+    return slot >= slots_ && slot < slots_ + capacity_;
+  }
+
+  size_t capacity() const { return capacity_; }
+  size_t in_use() const { return in_use_; }
+  size_t available() const { return capacity_ - in_use_; }
+  bool hugepages() const { return region_.hugepages(); }
+
+private:
+  MappedRegion region_;
+  Slot *slots_;
+  size_t capacity_;
+
+  Slot *free_list_ = nullptr;
+  size_t next_unused_ = 0;
+  size_t in_use_ = 0;
+};
+
+} // namespace lats::core
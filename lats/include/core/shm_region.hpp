@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace lats::core {
+
+/// POSIX shared memory (shm_open + mmap) 區塊 (RAII)
+///
+/// 同一台機器上的行程以名稱 (例如 "/lats_tob") 共用同一塊記憶體。
+/// create() 建立 (已存在時重設大小) 並清零，解構時 unlink；
+/// open() 對應既有的區塊，大小取自 fstat，解構時只 munmap。
+/// 映射建立後存取完全不經過 syscall。
+///
+/// hugepages 為 true 時優先建立在 hugetlbfs (/dev/hugepages) 上，大小補齊到
+/// HUGE_PAGE_SIZE；沒有掛載或沒有預留 hugepage 時退回 shm_open 並以
+/// madvise(MADV_HUGEPAGE) 提示 THP。open() 兩個位置都會尋找。
+class ShmRegion {
+public:
+  ShmRegion() = default;
+  ~ShmRegion();
+
+  /// 失敗時丟出 std::runtime_error
+  static ShmRegion create(const std::string &name, size_t size,
+                          bool hugepages = false, bool prefault = true);
+  static ShmRegion open(const std::string &name, bool writable = false);
+
+  ShmRegion(const ShmRegion &) = delete;
+  ShmRegion &operator=(const ShmRegion &) = delete;
+
+  ShmRegion(ShmRegion &&other) noexcept;
+  ShmRegion &operator=(ShmRegion &&other) noexcept;
+
+  void *data() const { return data_; }
+  size_t size() const { return size_; }
+  const std::string &name() const { return name_; }
+  bool hugepages() const { return hugepages_; }
+  bool owner() const { return owner_; }
+
+private:
+  void *data_ = nullptr;
+  size_t size_ = 0;
+  std::string name_;
+  bool hugepages_ = false;
+  bool owner_ = false;
+
+  void release();
+};
+
+} // namespace lats::core
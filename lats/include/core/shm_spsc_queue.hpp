@@ -0,0 +1,286 @@
+#pragma once
+
+#include "core/shm_region.hpp"
+#include "core/spsc_queue.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <signal.h>
+#include <stdexcept>
+#include <string>
+#include <sys/types.h>
+#include <type_traits>
+#include <unistd.h>
+
+namespace lats::core {
+
+enum class ShmRole : uint8_t { Producer, Consumer };
+
+/// 對方行程的狀態，見 ShmSPSCQueue::peer_state()
+enum class PeerState : uint8_t {
+  NotAttached, // 還沒有附加，或已正常 detach
+  Alive,
+  Dead, // 沒有 detach 就結束 (crash 或被 kill)
+};
+
+namespace detail {
+
+inline constexpr uint64_t SHM_QUEUE_MAGIC = 0x315150535354414C; // "LATSSPQ1"
+inline constexpr uint32_t SHM_QUEUE_LAYOUT_VERSION = 1;
+
+/// segment 開頭的描述資訊，attach 時逐項比對；magic 最後以 release 寫入
+struct alignas(CACHE_LINE_SIZE) ShmQueueHeader {
+  std::atomic<uint64_t> magic;
+  uint32_t layout_version;
+  uint32_t element_size;
+  uint32_t element_align;
+  uint32_t reserved;
+  uint64_t capacity;
+  uint64_t buffer_offset;
+  // 兩端附加時登記自己的 pid，detach 時清回 0
+  std::atomic<int32_t> pids[2];
+};
+
+/// head/tail 各佔一條 cache line，跨行程共用
+struct alignas(CACHE_LINE_SIZE) ShmQueueIndex {
+  std::atomic<size_t> value;
+};
+
+static_assert(std::atomic<size_t>::is_always_lock_free &&
+                  std::atomic<int32_t>::is_always_lock_free,
+              "shared memory atomics must be lock-free");
+
+} // namespace detail
+
+/// 跨行程的 SPSC ring，演算法與 SPSCQueue 相同
+///
+/// 元素與 head/tail index 都放在具名的 shared memory segment 中，
+/// 讓 feed handler 與策略可以分成兩個行程以隔離故障。一端 create()，
+/// 另一端以相同的 T/Capacity attach()，attach 時檢查 layout 版本、元素大小、
+/// 對齊與容量，不符時丟出例外。各自看到的對方 index 快取放在行程內，
+/// 不寫回共享記憶體。
+///
+/// T 必須是 trivially copyable 且不含指標 (兩個行程的位址空間不同)。
+/// 每個角色同時只能有一個行程附加；對方 crash 後，peer_state() 回傳 Dead，
+/// 新的行程可以直接以同一角色 attach 接手。
+template <typename T, size_t Capacity> class ShmSPSCQueue {
+  static_assert((Capacity & (Capacity - 1)) == 0 && Capacity > 0,
+                "Capacity must be power of 2");
+  static_assert(std::is_trivially_copyable_v<T>,
+                "T must be trivially copyable to cross process boundaries");
+
+  using Header = detail::ShmQueueHeader;
+  using Index = detail::ShmQueueIndex;
+
+  static constexpr size_t BUFFER_ALIGN =
+      alignof(T) > CACHE_LINE_SIZE ? alignof(T) : CACHE_LINE_SIZE;
+  static constexpr size_t BUFFER_OFFSET =
+      (sizeof(Header) + 2 * sizeof(Index) + BUFFER_ALIGN - 1) /
+      BUFFER_ALIGN * BUFFER_ALIGN;
+
+public:
+  static constexpr size_t SEGMENT_SIZE = BUFFER_OFFSET + sizeof(T) * Capacity;
+
+  /// 建立 segment 並以 role 附加，解構時 unlink (已附加的對方仍可繼續使用)
+  static ShmSPSCQueue create(const std::string &name, ShmRole role,
+                             bool hugepages = false) {
+    ShmRegion region = ShmRegion::create(name, SEGMENT_SIZE, hugepages);
+    auto *header = static_cast<Header *>(region.data());
+    header->layout_version = detail::SHM_QUEUE_LAYOUT_VERSION;
+    header->element_size = sizeof(T);
+    header->element_align = alignof(T);
+    header->capacity = Capacity;
+    header->buffer_offset = BUFFER_OFFSET;
+    header->magic.store(detail::SHM_QUEUE_MAGIC, std::memory_order_release);
+    return ShmSPSCQueue(std::move(region), role);
+  }
+
+  /// 附加到既有的 segment；不存在、layout 不符或角色已被活著的行程佔用時
+  /// 丟出 std::runtime_error
+  static ShmSPSCQueue attach(const std::string &name, ShmRole role) {
+    ShmRegion region = ShmRegion::open(name, true);
+    if (region.size() < SEGMENT_SIZE) {
+      throw std::runtime_error("shared memory " + name + " is too small");
+    }
+
+    const auto *header = static_cast<const Header *>(region.data());
+    if (header->magic.load(std::memory_order_acquire) !=
+        detail::SHM_QUEUE_MAGIC) {
+      throw std::runtime_error("shared memory " + name +
+                               " is not an initialized queue");
+    }
+    if (header->layout_version != detail::SHM_QUEUE_LAYOUT_VERSION) {
+      throw std::runtime_error("unsupported queue layout version " +
+                               std::to_string(header->layout_version));
+    }
+    if (header->element_size != sizeof(T) ||
+        header->element_align != alignof(T) ||
+        header->capacity != Capacity ||
+        header->buffer_offset != BUFFER_OFFSET) {
+      throw std::runtime_error("shared memory " + name +
+                               " holds a queue with a different layout");
+    }
+    return ShmSPSCQueue(std::move(region), role);
+  }
+
+  ~ShmSPSCQueue() { detach(); }
+
+  ShmSPSCQueue(const ShmSPSCQueue &) = delete;
+  ShmSPSCQueue &operator=(const ShmSPSCQueue &) = delete;
+
+  ShmSPSCQueue(ShmSPSCQueue &&other) noexcept
+      : region_(std::move(other.region_)), header_(other.header_),
+        head_(other.head_), tail_(other.tail_), buffer_(other.buffer_),
+        role_(other.role_), pid_(other.pid_), tail_cache_(other.tail_cache_),
+        head_cache_(other.head_cache_) {
+    other.header_ = nullptr;
+  }
+  ShmSPSCQueue &operator=(ShmSPSCQueue &&) = delete;
+
+  // ---- 生產者 ----
+
+  bool try_push(const T &item) {
+    T *slot = alloc();
+    if (slot == nullptr) {
+      return false;
+    }
+    *slot = item;
+    publish();
+    return true;
+  }
+
+  /// 取得下一個可寫的 slot，滿了回傳 nullptr；寫完後呼叫 publish()
+  T *alloc() {
+    const size_t head = head_->value.load(std::memory_order_relaxed);
+    const size_t next_head = (head + 1) & (Capacity - 1);
+
+    if (next_head == tail_cache_) {
+      tail_cache_ = tail_->value.load(std::memory_order_acquire);
+      if (next_head == tail_cache_) {
+        return nullptr;
+      }
+    }
+    return &buffer_[head];
+  }
+
+  void publish() {
+    const size_t head = head_->value.load(std::memory_order_relaxed);
+    head_->value.store((head + 1) & (Capacity - 1), std::memory_order_release);
+  }
+
+  // ---- 消費者 ----
+
+  std::optional<T> try_pop() {
+    const T *item = front();
+    if (item == nullptr) {
+      return std::nullopt;
+    }
+    T copy = *item;
+    pop();
+    return copy;
+  }
+
+  /// 取得隊首元素，空的回傳 nullptr；用完後呼叫 pop()
+  T *front() {
+    const size_t tail = tail_->value.load(std::memory_order_relaxed);
+
+    if (tail == head_cache_) {
+      head_cache_ = head_->value.load(std::memory_order_acquire);
+      if (tail == head_cache_) {
+        return nullptr;
+      }
+    }
+    return &buffer_[tail];
+  }
+
+  void pop() {
+    const size_t tail = tail_->value.load(std::memory_order_relaxed);
+    tail_->value.store((tail + 1) & (Capacity - 1), std::memory_order_release);
+  }
+
+  bool empty() const {
+    return head_->value.load(std::memory_order_acquire) ==
+           tail_->value.load(std::memory_order_acquire);
+  }
+
+  // ---- 連線狀態 ----
+
+  /// 對方是否還活著，需要 kill(pid, 0) syscall，不要放在 hot path，
+  /// 建議在 ring 持續為空 (或持續為滿) 時定期檢查
+  PeerState peer_state() const {
+    const int32_t pid = header_->pids[peer_index()].load(
+        std::memory_order_acquire);
+    if (pid == 0) {
+      return PeerState::NotAttached;
+    }
+    return process_alive(pid) ? PeerState::Alive : PeerState::Dead;
+  }
+
+  /// 放棄自己的角色，之後只能解構；解構時會自動呼叫
+  void detach() {
+    if (header_ == nullptr) {
+      return;
+    }
+    int32_t expected = pid_;
+    header_->pids[role_index()].compare_exchange_strong(
+        expected, 0, std::memory_order_acq_rel);
+    header_ = nullptr;
+  }
+
+  ShmRole role() const { return role_; }
+  const std::string &name() const { return region_.name(); }
+  bool hugepages() const { return region_.hugepages(); }
+  static constexpr size_t capacity() { return Capacity; }
+
+private:
+  ShmRegion region_;
+  Header *header_;
+  Index *head_;
+  Index *tail_;
+  T *buffer_;
+  ShmRole role_;
+  int32_t pid_;
+
+  // 行程內的對方 index 快取，與 SPSCQueue 相同
+  size_t tail_cache_ = 0; // 生產者看到的 tail
+  size_t head_cache_ = 0; // 消費者看到的 head
+
+  ShmSPSCQueue(ShmRegion region, ShmRole role)
+      : region_(std::move(region)),
+        header_(static_cast<Header *>(region_.data())),
+        head_(reinterpret_cast<Index *>(header_ + 1)), tail_(head_ + 1),
+        buffer_(reinterpret_cast<T *>(static_cast<char *>(region_.data()) +
+                                      BUFFER_OFFSET)),
+        role_(role), pid_(static_cast<int32_t>(::getpid())) {
+    // 登記角色；原本的持有者已經死掉時直接接手
+    std::atomic<int32_t> &slot = header_->pids[role_index()];
+    int32_t current = slot.load(std::memory_order_acquire);
+    while (true) {
+      if (current != 0 && process_alive(current)) {
+        header_ = nullptr;
+        throw std::runtime_error("queue " + region_.name() + " already has a " +
+                                 (role == ShmRole::Producer ? "producer"
+                                                            : "consumer"));
+      }
+      if (slot.compare_exchange_weak(current, pid_,
+                                     std::memory_order_acq_rel)) {
+        break;
+      }
+    }
+
+    tail_cache_ = tail_->value.load(std::memory_order_acquire);
+    head_cache_ = head_->value.load(std::memory_order_acquire);
+  }
+
+  size_t role_index() const { return role_ == ShmRole::Producer ? 0 : 1; }
+  size_t peer_index() const { return 1 - role_index(); }
+
+  static bool process_alive(int32_t pid) {
+    return ::kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM;
+  }
+};
+
+} // namespace lats::core
@@ -3,6 +3,7 @@
 #include <array>
 #include <atomic>
 #include <cstddef>
+#include <new>
 #include <optional>
 #include <type_traits>
 namespace lats::core {
@@ -28,8 +29,12 @@ public:
     const size_t head = head_.load(std::memory_order_relaxed);
     const size_t next_head = (head + 1) & (Capacity - 1);
 
-    if (next_head == tail_.load(std::memory_order_acquire)) {
-      return false;
+    if (next_head == tail_cache_) {
+      // 只有看起來滿了才去讀對方的 index，減少跨核 cache line 傳輸
+      tail_cache_ = tail_.load(std::memory_order_acquire);
+      if (next_head == tail_cache_) {
+        return false;
+      }
     }
 
     buffer_[head] = std::forward<U>(item);
@@ -37,11 +42,31 @@ public:
     return true;
   }
 
+  /// 直接在 ring 中建構元素
+  template <typename... Args> bool emplace(Args &&...args) {
+    T *slot = alloc();
+    if (slot == nullptr) {
+      return false;
+    }
+
+    if constexpr (std::is_nothrow_constructible_v<T, Args...>) {
+      slot->~T();
+      new (slot) T(std::forward<Args>(args)...);
+    } else {
+      *slot = T(std::forward<Args>(args)...);
+    }
+    publish();
+    return true;
+  }
+
   std::optional<T> try_pop() {
     const size_t tail = tail_.load(std::memory_order_relaxed);
 
-    if (tail == head_.load(std::memory_order_acquire)) {
-      return std::nullopt;
+    if (tail == head_cache_) {
+      head_cache_ = head_.load(std::memory_order_acquire);
+      if (tail == head_cache_) {
+        return std::nullopt;
+      }
     }
 
     T item = std::move(buffer_[tail]);
@@ -49,6 +74,89 @@ public:
     return item;
   }
 
+  /// 批次寫入最多 n 個元素，只做一次 release store，回傳實際寫入數量
+  template <typename InputIt> size_t try_push_n(InputIt first, size_t n) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+
+    size_t free_slots = (tail_cache_ - head - 1) & (Capacity - 1);
+    if (free_slots < n) {
+      tail_cache_ = tail_.load(std::memory_order_acquire);
+      free_slots = (tail_cache_ - head - 1) & (Capacity - 1);
+    }
+
+    const size_t count = n < free_slots ? n : free_slots;
+    for (size_t i = 0; i < count; ++i, ++first) {
+      buffer_[(head + i) & (Capacity - 1)] = *first;
+    }
+
+    if (count > 0) {
+      head_.store((head + count) & (Capacity - 1), std::memory_order_release);
+    }
+    return count;
+  }
+
+  /// 批次讀出最多 n 個元素到 out，只做一次 release store，回傳實際讀出數量
+  size_t try_pop_n(T *out, size_t n) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+
+    size_t used = (head_cache_ - tail) & (Capacity - 1);
+    if (used < n) {
+      head_cache_ = head_.load(std::memory_order_acquire);
+      used = (head_cache_ - tail) & (Capacity - 1);
+    }
+
+    const size_t count = n < used ? n : used;
+    for (size_t i = 0; i < count; ++i) {
+      out[i] = std::move(buffer_[(tail + i) & (Capacity - 1)]);
+    }
+
+    if (count > 0) {
+      tail_.store((tail + count) & (Capacity - 1), std::memory_order_release);
+    }
+    return count;
+  }
+
+  // ---- Claim / Commit：直接在 ring 上讀寫，不經過複製 ----
+
+  /// 生產者取得下一個可寫的 slot，滿了回傳 nullptr；寫完後呼叫 publish()
+  T *alloc() {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    const size_t next_head = (head + 1) & (Capacity - 1);
+
+    if (next_head == tail_cache_) {
+      tail_cache_ = tail_.load(std::memory_order_acquire);
+      if (next_head == tail_cache_) {
+        return nullptr;
+      }
+    }
+    return &buffer_[head];
+  }
+
+  /// 發布 alloc() 取得的 slot
+  void publish() {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    head_.store((head + 1) & (Capacity - 1), std::memory_order_release);
+  }
+
+  /// 消費者取得隊首元素的指標，空的回傳 nullptr；用完後呼叫 pop()
+  T *front() {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+
+    if (tail == head_cache_) {
+      head_cache_ = head_.load(std::memory_order_acquire);
+      if (tail == head_cache_) {
+        return nullptr;
+      }
+    }
+    return &buffer_[tail];
+  }
+
+  /// 釋放 front() 取得的元素
+  void pop() {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    tail_.store((tail + 1) & (Capacity - 1), std::memory_order_release);
+  }
+
   bool empty() const {
     return head_.load(std::memory_order_acquire) ==
            tail_.load(std::memory_order_acquire);
@@ -59,7 +167,10 @@ private:
   std::array<T, Capacity> buffer_;
 
   // Cache line padding to prevent false sharing
+  // 各自的 index 與對方 index 的本地快取放在同一條 cache line
   alignas(CACHE_LINE_SIZE) std::atomic<size_t> head_;
+  size_t tail_cache_ = 0; // 生產者看到的 tail_
   alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail_;
+  size_t head_cache_ = 0; // 消費者看到的 head_
 };
 } // namespace lats::core
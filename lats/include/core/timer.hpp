@@ -1,24 +1,21 @@
 #pragma once
 
+#include "core/tsc_clock.hpp"
+
 #include <cstdint>
-#include <x86intrin.h>
 
 namespace lats::core {
 
 // Time Stamp Counter 計時器
 class Timer {
 public:
-  static inline uint64_t now() {
-    unsigned int aux; // 輔助變數用於接收處理器 ID
-    return __rdtscp(&aux);
-  }
-
-  static uint64_t cycles_to_ns(uint64_t cycles);
-  static void calibrate();
+  static inline uint64_t now() { return TscClock::now(); }
 
-private:
-  // 時脈頻率，尚未校準
-  static double tsc_freq_ghz_;
+  // 換算與校準見 TscClock
+  static uint64_t cycles_to_ns(uint64_t cycles) {
+    return TscClock::cycles_to_ns(cycles);
+  }
+  static void calibrate() { TscClock::calibrate(); }
 };
 
 class ScopedTimer {
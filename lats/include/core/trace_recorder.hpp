@@ -0,0 +1,156 @@
+#pragma once
+
+#include "core/latency_stats.hpp"
+#include "core/spsc_queue.hpp"
+#include "core/timer.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace lats::core {
+
+inline constexpr size_t TRACE_MAX_STAGES = 16;
+inline constexpr size_t TRACE_STAGE_NAME_SIZE = 32;
+inline constexpr uint64_t TRACE_MAGIC = 0x314352545354414C; // "LATSTRC1"
+inline constexpr uint32_t TRACE_FORMAT_VERSION = 1;
+
+/// 一筆 tracepoint：某個 sequence (封包/訊息序號) 在 tsc 時到達 stage
+struct TraceRecord {
+  uint64_t tsc;
+  uint64_t sequence;
+  uint32_t stage;
+  uint32_t thread; // register_thread() 的順序
+};
+static_assert(sizeof(TraceRecord) == 24);
+
+/// dump 檔開頭，之後緊接著 TraceRecord 陣列 (host byte order)
+struct TraceFileHeader {
+  uint64_t magic;
+  uint32_t version;
+  uint32_t record_size;
+  uint32_t num_stages;
+  uint32_t num_threads;
+  double tsc_ghz; // 離線換算 ns 用
+  uint64_t records;
+  uint64_t dropped;
+  char stage_names[TRACE_MAX_STAGES][TRACE_STAGE_NAME_SIZE];
+};
+
+namespace detail {
+
+struct TraceRing {
+  static constexpr size_t CAPACITY = 1 << 14;
+
+  SPSCQueue<TraceRecord, CAPACITY> queue;
+  uint32_t thread = 0;
+  // 只有擁有者線程寫入
+  std::atomic<uint64_t> dropped{0};
+};
+
+inline thread_local TraceRing *tls_trace_ring = nullptr;
+
+} // namespace detail
+
+/// 呼叫端線程是否已註冊到 TraceRecorder；取得 sequence 需要額外成本時
+/// 可以先檢查
+inline bool tracing_enabled() { return detail::tls_trace_ring != nullptr; }
+
+/// Hot path：寫入一筆記錄到呼叫端線程的 ring。不格式化、不配置、不上鎖；
+/// 線程未註冊時直接返回，ring 滿時丟棄並計數
+inline void trace(uint32_t stage, uint64_t sequence, uint64_t tsc) {
+  detail::TraceRing *ring = detail::tls_trace_ring;
+  if (ring == nullptr) {
+    return;
+  }
+  TraceRecord *slot = ring->queue.alloc();
+  if (slot == nullptr) {
+    ring->dropped.store(ring->dropped.load(std::memory_order_relaxed) + 1,
+                        std::memory_order_relaxed);
+    return;
+  }
+  slot->tsc = tsc;
+  slot->sequence = sequence;
+  slot->stage = stage;
+  slot->thread = ring->thread;
+  ring->queue.publish();
+}
+
+inline void trace(uint32_t stage, uint64_t sequence) {
+  if (tracing_enabled()) {
+    trace(stage, sequence, Timer::now());
+  }
+}
+
+/// 各線程 tracepoint 的收集器
+///
+/// 每個要記錄的線程呼叫 register_thread() 取得自己的 ring (SPSCQueue，
+/// 寫入端為該線程、讀取端為 drainer)；背景 drainer 線程定期把所有 ring
+/// 的記錄寫進二進位 dump 檔，之後由 load_trace() / trace_report 離線分析。
+///
+/// recorder 必須比所有已註冊線程的最後一次 trace() 活得久。
+class TraceRecorder {
+public:
+  /// 開檔並啟動 drainer；stage_names[i] 為 stage i 的名稱。
+  /// 開檔失敗丟出 std::runtime_error，stage 設定不合法丟出
+  /// std::invalid_argument
+  TraceRecorder(const std::string &path, std::vector<std::string> stage_names,
+                std::chrono::milliseconds drain_interval =
+                    std::chrono::milliseconds(1));
+  ~TraceRecorder();
+
+  TraceRecorder(const TraceRecorder &) = delete;
+  TraceRecorder &operator=(const TraceRecorder &) = delete;
+
+  /// 為呼叫端線程配置 ring，之後該線程的 trace() 都寫進這個 recorder
+  void register_thread();
+  static void unregister_thread() { detail::tls_trace_ring = nullptr; }
+
+  /// 停止 drainer，寫出剩下的記錄並關檔；解構時自動呼叫
+  void stop();
+
+  uint64_t records_written() const {
+    return records_written_.load(std::memory_order_relaxed);
+  }
+  uint64_t dropped() const;
+
+private:
+  void drain_loop(std::chrono::milliseconds interval);
+  size_t drain_once();
+
+  TraceFileHeader header_{};
+  std::FILE *file_ = nullptr;
+  std::vector<TraceRecord> batch_;
+
+  mutable std::mutex rings_mutex_;
+  std::vector<std::unique_ptr<detail::TraceRing>> rings_;
+
+  std::mutex stop_mutex_;
+  std::condition_variable stop_cv_;
+  bool running_ = true;
+  std::atomic<uint64_t> records_written_{0};
+  std::thread drainer_;
+};
+
+/// 離線分析結果：stage_latency[s] 為同一 sequence 從前一個 stage 到
+/// stage s 的延遲 (ns)，end_to_end 為第一個到最後一個 stage
+struct TraceReport {
+  std::vector<std::string> stage_names;
+  uint64_t records = 0;
+  uint64_t dropped = 0;
+  uint32_t threads = 0;
+  std::vector<LatencyStats> stage_latency;
+  LatencyStats end_to_end;
+};
+
+/// 讀取 dump 檔並計算各 stage 的延遲；格式錯誤時丟出 std::runtime_error
+TraceReport load_trace(const std::string &path);
+
+} // namespace lats::core
@@ -0,0 +1,164 @@
+#pragma once
+
+#include "core/spsc_queue.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <x86intrin.h>
+
+namespace lats::core {
+
+/// CPUID 回報的 TSC 相關功能
+struct TscFeatures {
+  bool tsc = false;
+  bool rdtscp = false;
+  // constant + nonstop：頻率不隨 P-state/C-state 改變，
+  // 沒有這個位元時 TSC 不能拿來換算時間
+  bool invariant = false;
+};
+
+TscFeatures detect_tsc_features();
+
+/// 某顆核心的 TSC 相對於校準核心的偏移 (換算成 ns，正值代表比較快)
+struct CoreSkew {
+  int cpu = -1;
+  bool pinned = false; // 無法綁定到該核心時為 false，offset_ns 無意義
+  int64_t offset_ns = 0;
+};
+
+/// 校準後的 TSC 時鐘
+///
+/// - calibrate() 以 CLOCK_MONOTONIC_RAW 多次取樣，取各區間頻率的中位數；
+///   每次取樣以兩次 rdtscp 夾住 clock_gettime，取窗口最小的一次
+/// - cycles 換 ns 以預先算好的定點數 (mult >> SHIFT) 相乘，不做除法
+/// - to_epoch_ns() 以 (anchor_tsc, anchor_ns) 錨點換算成 CLOCK_REALTIME，
+///   resync() 重新錨定並以更長的基準修正頻率
+///
+/// 換算參數以 seqlock 發布，任何線程都能呼叫換算函式；calibrate()/resync()
+/// 內部序列化。calibrate() 必須在啟動時明確呼叫 (約 100ms)，換算函式不會自行
+/// 校準，未校準時丟出 std::logic_error。
+class TscClock {
+public:
+  static constexpr unsigned SHIFT = 32;
+
+  static uint64_t now() {
+    unsigned int aux;
+    return __rdtscp(&aux);
+  }
+
+  /// 共 samples 個區間，每個區間 interval。TSC 不是 invariant (頻率會隨
+  /// P-state/C-state 改變，常見於隱藏 CPUID 位元的虛擬機) 時只記 warning，
+  /// 呼叫端可由 features().invariant 判斷；require_invariant 為 true 時
+  /// 改為丟出 std::runtime_error
+  static void
+  calibrate(int samples = 5,
+            std::chrono::milliseconds interval = std::chrono::milliseconds(20),
+            bool require_invariant = false);
+  static bool calibrated() {
+    return params_.mult.load(std::memory_order_relaxed) != 0;
+  }
+
+  static uint64_t cycles_to_ns(uint64_t cycles) {
+    const uint64_t mult = params_.mult.load(std::memory_order_relaxed);
+    if (__builtin_expect(mult == 0, 0)) {
+      not_calibrated();
+    }
+    return scale(cycles, mult);
+  }
+
+  /// TSC 讀值換算成 Unix epoch ns
+  static uint64_t to_epoch_ns(uint64_t tsc) {
+    // seq 在第一次校準完成後才不為 0
+    const bool ready = params_.seq.load(std::memory_order_acquire) != 0;
+    if (__builtin_expect(!ready, 0)) {
+      not_calibrated();
+    }
+    uint64_t seq;
+    uint64_t anchor_tsc;
+    uint64_t anchor_ns;
+    uint64_t mult;
+    do {
+      seq = params_.seq.load(std::memory_order_acquire);
+      anchor_tsc = params_.anchor_tsc.load(std::memory_order_relaxed);
+      anchor_ns = params_.anchor_ns.load(std::memory_order_relaxed);
+      mult = params_.mult.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((seq & 1) != 0 ||
+             seq != params_.seq.load(std::memory_order_relaxed));
+
+    // 錨點之前的讀值 (例如 resync 前取得的時間戳) 也要能換算
+    return tsc >= anchor_tsc ? anchor_ns + scale(tsc - anchor_tsc, mult)
+                             : anchor_ns - scale(anchor_tsc - tsc, mult);
+  }
+
+  static uint64_t now_epoch_ns() { return to_epoch_ns(now()); }
+
+  /// 重新錨定到 CLOCK_REALTIME，並以自校準以來的 CLOCK_MONOTONIC_RAW
+  /// 修正頻率。回傳錨點修正量 (實際 - 預測，ns)，即上次同步以來的漂移；
+  /// 未校準時丟出 std::logic_error
+  static int64_t resync();
+
+  static double frequency_ghz();
+  static const TscFeatures &features();
+
+  /// 依序綁定到每個 cpu 取樣，量測與校準核心的 TSC 偏移。
+  /// 偏移遠大於取樣誤差 (數十 ns) 時，不同核心的時間戳不能直接相減
+  static std::vector<CoreSkew> measure_core_skew(const std::vector<int> &cpus);
+
+private:
+  struct alignas(CACHE_LINE_SIZE) Params {
+    std::atomic<uint64_t> seq{0};
+    std::atomic<uint64_t> mult{0}; // ns = cycles * mult >> SHIFT
+    std::atomic<uint64_t> anchor_tsc{0};
+    std::atomic<uint64_t> anchor_ns{0};
+  };
+
+  // 64x64 -> 128 位元乘法，cycles 很大時也不會溢位
+  __extension__ using uint128 = unsigned __int128;
+
+  static uint64_t scale(uint64_t cycles, uint64_t mult) {
+    return static_cast<uint64_t>((static_cast<uint128>(cycles) * mult) >>
+                                 SHIFT);
+  }
+
+  [[noreturn]] static void not_calibrated() __attribute__((noinline, cold));
+  static void publish(uint64_t mult, uint64_t anchor_tsc, uint64_t anchor_ns);
+
+  static Params params_;
+};
+
+/// 背景線程，每隔 interval 呼叫一次 TscClock::resync()；
+/// 應綁定在非隔離的管理核心上。尚未校準時建構子會先校準
+class TscResyncThread {
+public:
+  explicit TscResyncThread(
+      std::chrono::milliseconds interval = std::chrono::milliseconds(1000),
+      int cpu = -1);
+  ~TscResyncThread();
+
+  TscResyncThread(const TscResyncThread &) = delete;
+  TscResyncThread &operator=(const TscResyncThread &) = delete;
+
+  uint64_t resyncs() const { return resyncs_.load(std::memory_order_relaxed); }
+  /// 最近一次 resync() 的修正量
+  int64_t last_error_ns() const {
+    return last_error_ns_.load(std::memory_order_relaxed);
+  }
+
+private:
+  void run(std::chrono::milliseconds interval, int cpu);
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stop_ = false;
+  std::atomic<uint64_t> resyncs_{0};
+  std::atomic<int64_t> last_error_ns_{0};
+  std::thread thread_;
+};
+
+} // namespace lats::core
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "core/latency_stats.hpp"
+#include "core/spsc_queue.hpp"
+#include "core/trace_recorder.hpp"
+#include "feed/packet.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace lats::feed {
+
+/// feed 管線的 tracepoint stage (TraceRecorder 的 stage id)，
+/// sequence 一律使用封包的 MoldUDP64 序號。FeedHandler 記錄前兩個，
+/// 之後的 stage 由 callback (在解析線程上) 自行記錄
+namespace trace_stage {
+inline constexpr uint32_t RECEIVE = 0; // recvmmsg 返回
+inline constexpr uint32_t PARSE = 1;   // callback 結束
+inline constexpr uint32_t BOOK = 2;
+inline constexpr uint32_t PUBLISH = 3;
+} // namespace trace_stage
+
+inline std::vector<std::string> feed_trace_stage_names() {
+  return {"recv", "parse", "book", "publish"};
+}
+
+struct FeedConfig {
+  std::string group = "239.1.1.1";
+  uint16_t port = 30001;
+  std::string interface = "0.0.0.0"; // 加入 multicast group 的本地介面
+  int rx_cpu = -1;                   // 接收線程綁定的 CPU，-1 不綁定
+  int parse_cpu = -1;                // 解析線程綁定的 CPU，-1 不綁定
+  int rcvbuf_bytes = 8 << 20;
+  size_t batch_size = 32; // 每次 recvmmsg 最多收幾個封包
+  // true: 兩條線程都 busy poll；false: 沒資料時 poll()/yield，適合共用核心
+  bool busy_poll = true;
+  // 非 nullptr 時接收與解析線程註冊到此 recorder，必須比 stop() 活得久
+  core::TraceRecorder *tracer = nullptr;
+};
+
+/// 各計數器可在任何線程讀取 (relaxed)
+struct FeedCounters {
+  std::atomic<uint64_t> packets_received{0};
+  std::atomic<uint64_t> packets_parsed{0};
+  std::atomic<uint64_t> queue_full_drops{0}; // 解析線程跟不上，接收端丟棄
+  std::atomic<uint64_t> malformed{0};
+  std::atomic<uint64_t> gaps{0};
+  std::atomic<uint64_t> missed_messages{0};
+  std::atomic<uint64_t> duplicates{0};
+  std::atomic<uint64_t> overlaps{0}; // 部分重複的重送封包，只交出新的訊息
+  std::atomic<uint64_t> end_of_session{0};
+};
+
+/// UDP multicast 行情接收器
+///
+/// 接收線程以 recvmmsg 批次收包，打上 TSC 後經 SPSCQueue 交給解析線程；
+/// 解析線程檢查 MoldUDP64 序號、呼叫 callback，並記錄 wire-to-parse 延遲
+/// (recvmmsg 返回到 callback 結束)。接收線程永不阻塞：queue 滿時丟包，
+/// 由序號檢查回報為 gap。
+class FeedHandler {
+public:
+  static constexpr size_t QUEUE_CAPACITY = 4096;
+  using PacketQueue = core::SPSCQueue<RawPacket, QUEUE_CAPACITY>;
+  using PacketCallback = std::function<void(const RawPacket &)>;
+
+  /// 建立 socket 並加入 multicast group，失敗時拋出 std::runtime_error
+  explicit FeedHandler(FeedConfig config);
+  ~FeedHandler();
+
+  FeedHandler(const FeedHandler &) = delete;
+  FeedHandler &operator=(const FeedHandler &) = delete;
+
+  /// 啟動接收與解析線程，callback 在解析線程上執行
+  void start(PacketCallback on_packet);
+  void stop();
+
+  const FeedConfig &config() const { return config_; }
+  const FeedCounters &counters() const { return counters_; }
+
+  /// 解析線程寫入，stop() 之後才能安全讀取
+  const core::LatencyStats &latency() const { return latency_; }
+
+private:
+  void rx_loop();
+  void parse_loop();
+
+  FeedConfig config_;
+  int fd_ = -1;
+
+  std::unique_ptr<PacketQueue> queue_;
+  PacketCallback on_packet_;
+
+  std::atomic<bool> running_{false};
+  std::atomic<bool> rx_done_{false};
+  std::thread rx_thread_;
+  std::thread parse_thread_;
+
+  FeedCounters counters_;
+  core::LatencyStats latency_;
+};
+
+} // namespace lats::feed
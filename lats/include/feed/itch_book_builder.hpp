@@ -0,0 +1,74 @@
+#pragma once
+
+#include "feed/itch_parser.hpp"
+#include "lob/order_book.hpp"
+
+#include <cstdint>
+
+namespace lats::feed::itch {
+
+/// 以 ITCH 訊息重建單一商品的 OrderBook
+///
+/// stock_locate 為 0 時接受所有商品 (呼叫端已先過濾)，否則只處理該商品。
+/// 交易所送出的 Add 不會與簿中掛單交叉，因此 add_order 不會觸發撮合。
+class BookBuilder : public NullHandler {
+public:
+  explicit BookBuilder(lob::OrderBook &book, uint16_t stock_locate = 0)
+      : book_(book), stock_locate_(stock_locate) {}
+
+  void on_add(const AddOrder &msg) {
+    if (accept(msg.header)) {
+      book_.add_order(msg.order_id(), msg.side(), msg.price(), msg.quantity(),
+                      msg.header.ts());
+    }
+  }
+
+  void on_executed(const OrderExecuted &msg) {
+    if (accept(msg.header)) {
+      book_.execute_order(msg.order_id(), msg.quantity());
+    }
+  }
+
+  void on_executed_with_price(const OrderExecutedWithPrice &msg) {
+    if (accept(msg.header)) {
+      book_.execute_order(msg.order_id(), msg.quantity());
+    }
+  }
+
+  // 部分撤單對簿的影響與成交相同：減少數量，歸零時移除
+  void on_cancel(const OrderCancel &msg) {
+    if (accept(msg.header)) {
+      book_.execute_order(msg.order_id(), msg.quantity());
+    }
+  }
+
+  void on_delete(const OrderDelete &msg) {
+    if (accept(msg.header)) {
+      book_.cancel_order(msg.order_id());
+    }
+  }
+
+  void on_replace(const OrderReplace &msg) {
+    if (!accept(msg.header)) {
+      return;
+    }
+    const lob::Order *order = book_.find_order(msg.original_order_id());
+    if (order == nullptr) {
+      return;
+    }
+    const lob::Side side = order->side;
+    book_.cancel_order(msg.original_order_id());
+    book_.add_order(msg.new_order_id(), side, msg.price(), msg.quantity(),
+                    msg.header.ts());
+  }
+
+private:
+  bool accept(const MessageHeader &header) const {
+    return stock_locate_ == 0 || header.stock_locate.value() == stock_locate_;
+  }
+
+  lob::OrderBook &book_;
+  uint16_t stock_locate_;
+};
+
+} // namespace lats::feed::itch
@@ -0,0 +1,213 @@
+#pragma once
+
+#include "lob/types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace lats::feed::itch {
+
+// ============================================================================
+// Big-endian 欄位
+// ============================================================================
+// 欄位只是 byte 陣列，對齊為 1，可以直接疊在封包 buffer 上讀取；
+// value() 以 memcpy + bswap 取值，編譯後就是一條 load + movbe/bswap
+
+template <typename T> struct BigEndian {
+  uint8_t bytes[sizeof(T)];
+
+  T value() const {
+    T v;
+    std::memcpy(&v, bytes, sizeof(T));
+    if constexpr (sizeof(T) == 2) {
+      return static_cast<T>(__builtin_bswap16(v));
+    } else if constexpr (sizeof(T) == 4) {
+      return static_cast<T>(__builtin_bswap32(v));
+    } else {
+      static_assert(sizeof(T) == 8, "Unsupported field size");
+      return static_cast<T>(__builtin_bswap64(v));
+    }
+  }
+
+  void set(T v) {
+    if constexpr (sizeof(T) == 2) {
+      v = static_cast<T>(__builtin_bswap16(v));
+    } else if constexpr (sizeof(T) == 4) {
+      v = static_cast<T>(__builtin_bswap32(v));
+    } else {
+      v = static_cast<T>(__builtin_bswap64(v));
+    }
+    std::memcpy(bytes, &v, sizeof(T));
+  }
+};
+
+/// ITCH 的 6 bytes 時間戳 (午夜起算的奈秒數)
+struct BigEndian48 {
+  uint8_t bytes[6];
+
+  uint64_t value() const {
+    uint64_t v = 0;
+    for (uint8_t b : bytes) {
+      v = (v << 8) | b;
+    }
+    return v;
+  }
+
+  void set(uint64_t v) {
+    for (int i = 5; i >= 0; --i) {
+      bytes[i] = static_cast<uint8_t>(v);
+      v >>= 8;
+    }
+  }
+};
+
+using BE16 = BigEndian<uint16_t>;
+using BE32 = BigEndian<uint32_t>;
+using BE64 = BigEndian<uint64_t>;
+
+// ITCH 價格固定 4 位小數，與 lob::PRICE_SCALE 相同時不需要換算
+static_assert(lob::PRICE_SCALE == 10'000, "ITCH prices have 4 decimals");
+
+inline lob::Side to_side(char indicator) {
+  return indicator == 'B' ? lob::Side::Buy : lob::Side::Sell;
+}
+
+// ============================================================================
+// ITCH 5.0 訊息 view
+// ============================================================================
+// 只宣告本系統用到的訊息，各欄位位置與長度依 ITCH 5.0 規格
+
+#pragma pack(push, 1)
+
+struct MessageHeader {
+  char type;
+  BE16 stock_locate;
+  BE16 tracking_number;
+  BigEndian48 timestamp;
+
+  lob::TimeStamp ts() const { return timestamp.value(); }
+};
+
+/// 'A' Add Order (無 MPID)；'F' 帶 MPID 的版本多出 4 bytes attribution
+struct AddOrder {
+  static constexpr char TYPE = 'A';
+
+  MessageHeader header;
+  BE64 order_ref;
+  char side_indicator;
+  BE32 shares;
+  char stock[8];
+  BE32 price_raw;
+
+  lob::OrderID order_id() const { return order_ref.value(); }
+  lob::Side side() const { return to_side(side_indicator); }
+  lob::Quantity quantity() const { return shares.value(); }
+  lob::Price price() const { return price_raw.value(); }
+};
+
+struct AddOrderMPID {
+  static constexpr char TYPE = 'F';
+
+  AddOrder add;
+  char attribution[4];
+};
+
+/// 'E' Order Executed：以掛單價成交
+struct OrderExecuted {
+  static constexpr char TYPE = 'E';
+
+  MessageHeader header;
+  BE64 order_ref;
+  BE32 executed_shares;
+  BE64 match_number;
+
+  lob::OrderID order_id() const { return order_ref.value(); }
+  lob::Quantity quantity() const { return executed_shares.value(); }
+};
+
+/// 'C' Order Executed With Price：以不同於掛單價的價格成交
+struct OrderExecutedWithPrice {
+  static constexpr char TYPE = 'C';
+
+  MessageHeader header;
+  BE64 order_ref;
+  BE32 executed_shares;
+  BE64 match_number;
+  char printable;
+  BE32 execution_price;
+
+  lob::OrderID order_id() const { return order_ref.value(); }
+  lob::Quantity quantity() const { return executed_shares.value(); }
+  lob::Price price() const { return execution_price.value(); }
+};
+
+/// 'X' Order Cancel：部分撤單
+struct OrderCancel {
+  static constexpr char TYPE = 'X';
+
+  MessageHeader header;
+  BE64 order_ref;
+  BE32 cancelled_shares;
+
+  lob::OrderID order_id() const { return order_ref.value(); }
+  lob::Quantity quantity() const { return cancelled_shares.value(); }
+};
+
+/// 'D' Order Delete：整筆刪除
+struct OrderDelete {
+  static constexpr char TYPE = 'D';
+
+  MessageHeader header;
+  BE64 order_ref;
+
+  lob::OrderID order_id() const { return order_ref.value(); }
+};
+
+/// 'U' Order Replace：刪除原單並以新的 order_ref 掛入，方向不變、失去時間優先
+struct OrderReplace {
+  static constexpr char TYPE = 'U';
+
+  MessageHeader header;
+  BE64 original_order_ref;
+  BE64 new_order_ref;
+  BE32 shares;
+  BE32 price_raw;
+
+  lob::OrderID original_order_id() const { return original_order_ref.value(); }
+  lob::OrderID new_order_id() const { return new_order_ref.value(); }
+  lob::Quantity quantity() const { return shares.value(); }
+  lob::Price price() const { return price_raw.value(); }
+};
+
+/// 'P' Trade (Non-Cross)：與隱藏單的成交，不影響可見的訂單簿
+struct Trade {
+  static constexpr char TYPE = 'P';
+
+  MessageHeader header;
+  BE64 order_ref;
+  char side_indicator;
+  BE32 shares;
+  char stock[8];
+  BE32 price_raw;
+  BE64 match_number;
+
+  lob::OrderID order_id() const { return order_ref.value(); }
+  lob::Side side() const { return to_side(side_indicator); }
+  lob::Quantity quantity() const { return shares.value(); }
+  lob::Price price() const { return price_raw.value(); }
+};
+
+#pragma pack(pop)
+
+static_assert(sizeof(MessageHeader) == 11);
+static_assert(sizeof(AddOrder) == 36);
+static_assert(sizeof(AddOrderMPID) == 40);
+static_assert(sizeof(OrderExecuted) == 31);
+static_assert(sizeof(OrderExecutedWithPrice) == 36);
+static_assert(sizeof(OrderCancel) == 23);
+static_assert(sizeof(OrderDelete) == 19);
+static_assert(sizeof(OrderReplace) == 35);
+static_assert(sizeof(Trade) == 44);
+
+} // namespace lats::feed::itch
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "feed/itch_messages.hpp"
+#include "feed/packet.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace lats::feed::itch {
+
+/// 所有 callback 都是空的預設 handler
+///
+/// 使用端繼承後只需宣告關心的 callback (name hiding)，Parser 以模板參數
+/// 取得實際型別，呼叫在編譯期決定且可被 inline，沒有 virtual 開銷。
+/// 'F' (帶 MPID 的 Add) 會以內含的 AddOrder 呼叫 on_add。
+struct NullHandler {
+  void on_add(const AddOrder &) {}
+  void on_executed(const OrderExecuted &) {}
+  void on_executed_with_price(const OrderExecutedWithPrice &) {}
+  void on_cancel(const OrderCancel &) {}
+  void on_delete(const OrderDelete &) {}
+  void on_replace(const OrderReplace &) {}
+  void on_trade(const Trade &) {}
+};
+
+/// ITCH 5.0 解碼器
+///
+/// 直接把 view struct 疊在封包 buffer 上，不複製也不配置記憶體；
+/// view 只在 callback 執行期間有效。
+template <typename Handler> class Parser {
+public:
+  explicit Parser(Handler &handler) : handler_(handler) {}
+
+  /// 解碼單一訊息，長度不足回傳 false；不關心的訊息類型略過並回傳 true
+  bool parse_message(const uint8_t *data, size_t len) {
+    if (len == 0) {
+      ++malformed_;
+      return false;
+    }
+
+    switch (static_cast<char>(data[0])) {
+    case AddOrder::TYPE:
+      if (const auto *msg = view<AddOrder>(data, len)) {
+        handler_.on_add(*msg);
+        return true;
+      }
+      return false;
+    case AddOrderMPID::TYPE:
+      if (const auto *msg = view<AddOrderMPID>(data, len)) {
+        handler_.on_add(msg->add);
+        return true;
+      }
+      return false;
+    case OrderExecuted::TYPE:
+      if (const auto *msg = view<OrderExecuted>(data, len)) {
+        handler_.on_executed(*msg);
+        return true;
+      }
+      return false;
+    case OrderExecutedWithPrice::TYPE:
+      if (const auto *msg = view<OrderExecutedWithPrice>(data, len)) {
+        handler_.on_executed_with_price(*msg);
+        return true;
+      }
+      return false;
+    case OrderCancel::TYPE:
+      if (const auto *msg = view<OrderCancel>(data, len)) {
+        handler_.on_cancel(*msg);
+        return true;
+      }
+      return false;
+    case OrderDelete::TYPE:
+      if (const auto *msg = view<OrderDelete>(data, len)) {
+        handler_.on_delete(*msg);
+        return true;
+      }
+      return false;
+    case OrderReplace::TYPE:
+      if (const auto *msg = view<OrderReplace>(data, len)) {
+        handler_.on_replace(*msg);
+        return true;
+      }
+      return false;
+    case Trade::TYPE:
+      if (const auto *msg = view<Trade>(data, len)) {
+        handler_.on_trade(*msg);
+        return true;
+      }
+      return false;
+    default:
+      ++skipped_;
+      return true;
+    }
+  }
+
+  /// 解碼 MoldUDP64 封包：標頭後接 message_count 個 [2 bytes 長度][訊息]，
+  /// 前 first_message 則只略過不分派，回傳成功解碼的訊息數
+  size_t parse_packet(const uint8_t *data, size_t len,
+                      uint16_t first_message = 0) {
+    MoldUDP64Header header;
+    if (!MoldUDP64Header::decode(data, len, header)) {
+      ++malformed_;
+      return 0;
+    }
+
+    if (header.message_count == MoldUDP64Header::END_OF_SESSION) {
+      return 0;
+    }
+
+    size_t offset = MoldUDP64Header::SIZE;
+    size_t parsed = 0;
+    for (uint16_t i = 0; i < header.message_count; ++i) {
+      if (offset + sizeof(BE16) > len) {
+        ++malformed_;
+        break;
+      }
+      const size_t msg_len =
+          reinterpret_cast<const BE16 *>(data + offset)->value();
+      offset += sizeof(BE16);
+      if (offset + msg_len > len) {
+        ++malformed_;
+        break;
+      }
+
+      if (i >= first_message && parse_message(data + offset, msg_len)) {
+        ++parsed;
+      }
+      offset += msg_len;
+    }
+    return parsed;
+  }
+
+  /// FeedHandler 交來的封包，跳過重送時已處理過的訊息
+  size_t parse_packet(const RawPacket &packet) {
+    return parse_packet(packet.data, packet.len, packet.first_message);
+  }
+
+  uint64_t malformed() const { return malformed_; }
+  uint64_t skipped() const { return skipped_; }
+
+private:
+  // view struct 對齊為 1，可直接疊在任意位置的 buffer 上
+  template <typename Msg> const Msg *view(const uint8_t *data, size_t len) {
+    if (len < sizeof(Msg)) {
+      ++malformed_;
+      return nullptr;
+    }
+    return reinterpret_cast<const Msg *>(data);
+  }
+
+  Handler &handler_;
+  uint64_t malformed_ = 0; // 長度不足的訊息或封包
+  uint64_t skipped_ = 0;   // 不關心的訊息類型
+};
+
+} // namespace lats::feed::itch
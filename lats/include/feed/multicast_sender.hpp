@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace lats::feed {
+
+/// 本地測試用的 multicast 發送端，模擬交易所以 MoldUDP64 發送行情
+class MulticastSender {
+public:
+  /// 失敗時拋出 std::runtime_error
+  MulticastSender(const std::string &group, uint16_t port,
+                  const std::string &interface = "127.0.0.1",
+                  bool loopback = true, int ttl = 1);
+  ~MulticastSender();
+
+  MulticastSender(const MulticastSender &) = delete;
+  MulticastSender &operator=(const MulticastSender &) = delete;
+
+  bool send(const void *data, size_t len);
+
+  /// 送出一個 MoldUDP64 封包：標頭 + payload (已編碼的 message blocks)
+  bool send_packet(uint64_t sequence, uint16_t message_count,
+                   const void *payload = nullptr, size_t payload_len = 0);
+
+private:
+  int fd_ = -1;
+  uint32_t group_addr_ = 0; // network byte order
+  uint16_t port_ = 0;
+};
+
+} // namespace lats::feed
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <endian.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace lats::feed {
+
+// 一般乙太網路 MTU 下 UDP payload 的上限
+inline constexpr size_t MAX_PACKET_SIZE = 1472;
+
+/// 接收線程交給解析線程的原始封包
+struct RawPacket {
+  uint64_t rx_tsc = 0; // recvmmsg 返回時的 TSC
+  uint16_t len = 0;
+  // 解析線程填入：重送封包中前 first_message 則已處理過，下游應跳過
+  uint16_t first_message = 0;
+  uint8_t data[MAX_PACKET_SIZE];
+};
+
+/// MoldUDP64 封包標頭 (big-endian)
+///
+/// sequence 為封包內第一則訊息的序號，下一個封包的序號應為
+/// sequence + message_count；message_count 為 0 代表 heartbeat，
+/// END_OF_SESSION 代表 session 結束 (不含訊息)
+struct MoldUDP64Header {
+  static constexpr size_t SIZE = 20;
+  static constexpr size_t SESSION_SIZE = 10;
+  static constexpr uint16_t END_OF_SESSION = 0xFFFF;
+
+  char session[SESSION_SIZE];
+  uint64_t sequence;
+  uint16_t message_count;
+
+  /// 從封包開頭解出標頭，長度不足回傳 false
+  static bool decode(const uint8_t *data, size_t len, MoldUDP64Header &out) {
+    if (len < SIZE) {
+      return false;
+    }
+    std::memcpy(out.session, data, SESSION_SIZE);
+
+    uint64_t seq;
+    uint16_t count;
+    std::memcpy(&seq, data + 10, sizeof(seq));
+    std::memcpy(&count, data + 18, sizeof(count));
+    out.sequence = be64toh(seq);
+    out.message_count = be16toh(count);
+    return true;
+  }
+
+  /// 寫入 SIZE 個 bytes 到 out
+  void encode(uint8_t *out) const {
+    const uint64_t seq = htobe64(sequence);
+    const uint16_t count = htobe16(message_count);
+    std::memcpy(out, session, SESSION_SIZE);
+    std::memcpy(out + 10, &seq, sizeof(seq));
+    std::memcpy(out + 18, &count, sizeof(count));
+  }
+};
+
+} // namespace lats::feed
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "feed/packet.hpp"
+
+#include <cstdint>
+
+namespace lats::feed {
+
+/// 追蹤 MoldUDP64 序號，偵測掉包 (gap) 與重複/過期封包
+class SequenceTracker {
+public:
+  enum class Result { InOrder, Gap, Duplicate, Overlap, EndOfSession };
+
+  /// 第一個封包前預期的序號，MoldUDP64 的 session 從 1 開始
+  explicit SequenceTracker(uint64_t first_expected = 1)
+      : expected_(first_expected) {}
+
+  Result on_packet(uint64_t sequence, uint16_t message_count) {
+    first_new_ = 0;
+
+    if (message_count == MoldUDP64Header::END_OF_SESSION) {
+      // sequence 為 session 的下一個序號，之前的訊息若沒收到仍算遺失
+      if (sequence > expected_) {
+        ++gaps_;
+        missed_ += sequence - expected_;
+        expected_ = sequence;
+      }
+      ended_ = true;
+      return Result::EndOfSession;
+    }
+
+    if (sequence == expected_) {
+      expected_ += message_count;
+      return Result::InOrder;
+    }
+
+    if (sequence > expected_) {
+      // 中間的訊息遺失，記錄後從新的序號繼續
+      ++gaps_;
+      missed_ += sequence - expected_;
+      expected_ = sequence + message_count;
+      return Result::Gap;
+    }
+
+    const uint64_t end = sequence + message_count;
+    if (end > expected_) {
+      // 重送的封包與已處理的部分重疊，只有 [expected_, end) 是新的
+      ++overlaps_;
+      first_new_ = static_cast<uint16_t>(expected_ - sequence);
+      expected_ = end;
+      return Result::Overlap;
+    }
+
+    // 比預期小：重送或亂序抵達，已處理過
+    ++duplicates_;
+    return Result::Duplicate;
+  }
+
+  uint64_t expected() const { return expected_; }
+  /// 上一個封包中第一則未處理過的訊息 index，只有 Overlap 時不為 0
+  uint16_t first_new() const { return first_new_; }
+  bool ended() const { return ended_; }
+
+  uint64_t gaps() const { return gaps_; }
+  uint64_t missed() const { return missed_; }
+  uint64_t duplicates() const { return duplicates_; }
+  uint64_t overlaps() const { return overlaps_; }
+
+private:
+  uint64_t expected_;
+  uint16_t first_new_ = 0;
+  bool ended_ = false;
+  uint64_t gaps_ = 0;
+  uint64_t missed_ = 0; // 遺失的訊息數
+  uint64_t duplicates_ = 0;
+  uint64_t overlaps_ = 0;
+};
+
+} // namespace lats::feed
@@ -0,0 +1,218 @@
+#pragma once
+
+#include "core/latency_stats.hpp"
+#include "core/spsc_queue.hpp"
+#include "core/timer.hpp"
+#include "feed/itch_parser.hpp"
+#include "lob/order_book.hpp"
+#include "lob/types.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace lats::feed {
+
+/// 分派給 book worker 的事件，解碼後的 view 只在 callback 期間有效，
+/// 所以先複製成固定大小的 POD 再進 queue
+struct BookEvent {
+  enum class Type : uint8_t { Add, Execute, Cancel, Delete, Replace };
+
+  Type type = Type::Add;
+  lob::Side side = lob::Side::Buy;
+  uint16_t symbol = 0;
+  lob::Quantity quantity = 0;
+  lob::OrderID order_id = 0;
+  lob::OrderID new_order_id = 0; // 只有 Replace 使用
+  lob::Price price = 0;
+  lob::TimeStamp timestamp = 0; // 交易所時間戳
+  uint64_t dispatch_tsc = 0;    // dispatch() 時填入
+};
+
+struct PipelineConfig {
+  size_t num_shards = 1;
+  // shard i 綁定 shard_cpus[i]；沒有指定或為 -1 時不綁定
+  std::vector<int> shard_cpus;
+  size_t max_symbols = 8192; // symbol id (ITCH stock locate) 的上限
+  // 每個 shard 預先建立的 book 數，symbol 第一次出現時綁定其中一本；
+  // 用完之後新 symbol 的事件被拒絕。記憶體上限為
+  // num_shards * books_per_shard 本 book_config 大小的簿
+  size_t books_per_shard = 16;
+  lob::BookConfig book_config = {1 << 16, 1 << 12, 1, 4096, {}};
+  // true: worker busy poll；false: 沒資料時 yield，適合共用核心
+  bool busy_poll = true;
+};
+
+/// 各計數器可在任何線程讀取 (relaxed)
+struct alignas(core::CACHE_LINE_SIZE) ShardCounters {
+  std::atomic<uint64_t> events{0};     // worker 已套用的事件
+  std::atomic<uint64_t> rejected{0};   // book 拒絕 (重複 ID、找不到單等)
+  std::atomic<uint64_t> queue_full{0}; // try_dispatch() 因 queue 滿而失敗
+  std::atomic<uint64_t> no_book{0};    // rejected 中因 book 已用完而拒絕
+};
+
+/// 依 symbol 分 shard 的 thread-per-symbol book 處理管線
+///
+/// 呼叫端 (通常是解析線程) 以 dispatch() 送入事件，依 symbol 的 hash 選出
+/// shard，經該 shard 專屬的 SPSCQueue 交給 worker 線程。每個 worker 完全
+/// 擁有自己 shard 的 OrderBook，沒有共享狀態也沒有鎖；同一 symbol 永遠在
+/// 同一個 shard，因此事件順序不變，熱門 symbol 也只會拖慢自己的 shard。
+/// 每個 shard 記錄 dispatch 到套用完成的延遲。
+///
+/// book 在 start() 時由各 worker 在自己的核心上建立完畢 (first touch 落在
+/// 該核心的 NUMA node)，熱路徑上只做綁定，不配置記憶體。
+///
+/// dispatch()/try_dispatch() 只能由單一線程呼叫 (SPSC)。
+class ShardedBookPipeline {
+public:
+  static constexpr size_t QUEUE_CAPACITY = 8192;
+  using EventQueue = core::SPSCQueue<BookEvent, QUEUE_CAPACITY>;
+
+  /// 設定不合法時丟出 std::invalid_argument
+  explicit ShardedBookPipeline(PipelineConfig config);
+  ~ShardedBookPipeline();
+
+  ShardedBookPipeline(const ShardedBookPipeline &) = delete;
+  ShardedBookPipeline &operator=(const ShardedBookPipeline &) = delete;
+
+  /// 啟動 worker 線程，等每個 worker 建立好 book 後才返回；
+  /// 建立失敗時停止已啟動的 worker 並重新丟出該例外
+  void start();
+  /// 等每個 worker 處理完 queue 中剩下的事件後結束
+  void stop();
+
+  size_t shard_of(uint16_t symbol) const {
+    // Fibonacci hash：交易所常依字母順序配發 symbol id，
+    // 打散後相鄰的熱門 symbol 不會集中在同一個 shard
+    const uint32_t h = static_cast<uint32_t>(symbol) * 2654435769u;
+    return static_cast<size_t>(h >> 16) % shards_.size();
+  }
+
+  /// queue 滿或 symbol 超出範圍時回傳 false (不重試)
+  bool try_dispatch(const BookEvent &event) {
+    if (event.symbol >= config_.max_symbols) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    Shard &shard = *shards_[shard_of(event.symbol)];
+    BookEvent *slot = shard.queue->alloc();
+    if (slot == nullptr) {
+      shard.counters.queue_full.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    *slot = event;
+    slot->dispatch_tsc = core::Timer::now();
+    shard.queue->publish();
+    return true;
+  }
+
+  /// queue 滿時等待 worker 消化 (book 事件不能丟，必須已經 start())，
+  /// symbol 超出範圍時回傳 false
+  bool dispatch(const BookEvent &event);
+
+  size_t num_shards() const { return shards_.size(); }
+  const PipelineConfig &config() const { return config_; }
+  const ShardCounters &counters(size_t shard) const {
+    return shards_[shard]->counters;
+  }
+  /// symbol 超出範圍的事件數
+  uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+  /// worker 寫入，stop() 之後 (或 start() 之前) 才能安全讀取
+  const core::LatencyStats &latency(size_t shard) const {
+    return shards_[shard]->latency;
+  }
+  /// 同上；symbol 還沒有綁定 book 時回傳 nullptr
+  const lob::OrderBook *book(uint16_t symbol) const;
+
+private:
+  struct alignas(core::CACHE_LINE_SIZE) Shard {
+    std::unique_ptr<EventQueue> queue;
+    std::thread thread;
+    int cpu = -1;
+    // start() 時由 worker 建立，依 symbol 出現的順序綁定
+    std::vector<std::unique_ptr<lob::OrderBook>> storage;
+    size_t bound = 0;
+    // 以 symbol 為索引，只有這個 shard 的 symbol 會綁定
+    std::vector<lob::OrderBook *> books;
+    core::LatencyStats latency;
+    ShardCounters counters;
+  };
+
+  void worker_loop(Shard &shard, std::promise<void> &ready);
+  bool apply(Shard &shard, const BookEvent &event);
+
+  PipelineConfig config_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+  std::atomic<bool> running_{false};
+  std::atomic<uint64_t> dropped_{0};
+};
+
+/// ITCH handler：把解碼後的訊息轉成 BookEvent 送進 pipeline，
+/// 以 stock locate 作為 symbol id
+class ShardedBookDispatcher : public itch::NullHandler {
+public:
+  explicit ShardedBookDispatcher(ShardedBookPipeline &pipeline)
+      : pipeline_(pipeline) {}
+
+  void on_add(const itch::AddOrder &msg) {
+    BookEvent event = make(BookEvent::Type::Add, msg.header, msg.order_id());
+    event.side = msg.side();
+    event.price = msg.price();
+    event.quantity = msg.quantity();
+    pipeline_.dispatch(event);
+  }
+
+  void on_executed(const itch::OrderExecuted &msg) {
+    BookEvent event =
+        make(BookEvent::Type::Execute, msg.header, msg.order_id());
+    event.quantity = msg.quantity();
+    pipeline_.dispatch(event);
+  }
+
+  void on_executed_with_price(const itch::OrderExecutedWithPrice &msg) {
+    BookEvent event =
+        make(BookEvent::Type::Execute, msg.header, msg.order_id());
+    event.quantity = msg.quantity();
+    pipeline_.dispatch(event);
+  }
+
+  void on_cancel(const itch::OrderCancel &msg) {
+    BookEvent event = make(BookEvent::Type::Cancel, msg.header, msg.order_id());
+    event.quantity = msg.quantity();
+    pipeline_.dispatch(event);
+  }
+
+  void on_delete(const itch::OrderDelete &msg) {
+    pipeline_.dispatch(
+        make(BookEvent::Type::Delete, msg.header, msg.order_id()));
+  }
+
+  void on_replace(const itch::OrderReplace &msg) {
+    BookEvent event =
+        make(BookEvent::Type::Replace, msg.header, msg.original_order_id());
+    event.new_order_id = msg.new_order_id();
+    event.price = msg.price();
+    event.quantity = msg.quantity();
+    pipeline_.dispatch(event);
+  }
+
+private:
+  static BookEvent make(BookEvent::Type type, const itch::MessageHeader &header,
+                        lob::OrderID order_id) {
+    BookEvent event;
+    event.type = type;
+    event.symbol = header.stock_locate.value();
+    event.order_id = order_id;
+    event.timestamp = header.ts();
+    return event;
+  }
+
+  ShardedBookPipeline &pipeline_;
+};
+
+} // namespace lats::feed
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "lob/l2_depth.hpp"
+#include "lob/types.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace lats::lob {
+
+/// 一筆價位更新，可直接 memcpy 進廣播的 payload (host byte order)
+struct DepthUpdate {
+  Price price;
+  uint64_t quantity; // 0 代表此價位已不在最優 N 檔內
+  uint32_t orders;
+  Side side;
+  uint8_t reserved[3] = {};
+};
+static_assert(sizeof(DepthUpdate) == 24);
+
+/// 每邊最多 L2_MAX_DEPTH 筆移除加上 L2_MAX_DEPTH 筆新增/修改
+inline constexpr size_t DEPTH_MAX_UPDATES = 4 * L2_MAX_DEPTH;
+
+/// L2 快照的增量編碼器
+///
+/// 與上一次 encode() 的快照比較，只輸出改變的價位：先輸出所有移除
+/// (quantity = 0)，再依價格優先順序輸出新增或數量/掛單數改變的價位。
+/// 接收端依序以 apply_depth_updates() 套用即可還原快照。
+/// 第一次 encode() (或 reset() 之後) 輸出完整快照。
+class DepthDeltaEncoder {
+public:
+  /// 回傳本次的更新筆數，內容見 updates()
+  size_t encode(const DepthSnapshot &snapshot);
+
+  const DepthUpdate *updates() const { return updates_.data(); }
+  size_t size() const { return size_; }
+
+  /// 上一次 encode() 的快照
+  const DepthSnapshot &last() const { return last_; }
+
+  /// 下一次 encode() 輸出完整快照 (例如新的訂閱者加入時)
+  void reset() { last_ = DepthSnapshot{}; }
+
+private:
+  DepthSnapshot last_;
+  std::array<DepthUpdate, DEPTH_MAX_UPDATES> updates_;
+  size_t size_ = 0;
+};
+
+/// 接收端：把 encode() 產生的更新依序套用到本地快照 (不改變 sequence)
+void apply_depth_updates(DepthSnapshot &snapshot, const DepthUpdate *updates,
+                         size_t count);
+
+} // namespace lats::lob
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "lob/price_ladder.hpp"
+#include "lob/types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace lats::lob {
+
+/// L2 聚合最多維護的檔數
+inline constexpr size_t L2_MAX_DEPTH = 16;
+
+/// 單邊最優 N 檔的 L2 聚合，structure-of-arrays 排列，
+/// 依價格優先順序存放，size 之後的欄位固定為 0
+struct alignas(32) DepthLevels {
+  Price prices[L2_MAX_DEPTH] = {};
+  uint64_t quantities[L2_MAX_DEPTH] = {};
+  uint32_t orders[L2_MAX_DEPTH] = {};
+  uint32_t size = 0;
+};
+static_assert(sizeof(DepthLevels) % 32 == 0);
+
+/// 兩邊的 L2 快照，sequence 為 OrderBook 最優 N 檔的變動次數
+struct DepthSnapshot {
+  uint64_t sequence = 0;
+  DepthLevels bids;
+  DepthLevels asks;
+};
+
+/// 以 32 bytes 為單位整塊複製 (AVX2 aligned load/store)
+inline void copy_depth(DepthLevels &dst, const DepthLevels &src) {
+#ifdef __AVX2__
+  auto *d = reinterpret_cast<__m256i *>(&dst);
+  const auto *s = reinterpret_cast<const __m256i *>(&src);
+  for (size_t i = 0; i < sizeof(DepthLevels) / sizeof(__m256i); ++i) {
+    _mm256_store_si256(d + i, _mm256_load_si256(s + i));
+  }
+#else
+  std::memcpy(&dst, &src, sizeof(DepthLevels));
+#endif
+}
+
+namespace detail {
+
+/// 將 [from, from + count) 的檔位搬到 to 開始的位置 (可重疊)
+inline void move_levels(DepthLevels &levels, uint32_t to, uint32_t from,
+                        uint32_t count) {
+  std::memmove(levels.prices + to, levels.prices + from,
+               count * sizeof(Price));
+  std::memmove(levels.quantities + to, levels.quantities + from,
+               count * sizeof(uint64_t));
+  std::memmove(levels.orders + to, levels.orders + from,
+               count * sizeof(uint32_t));
+}
+
+} // namespace detail
+
+/// 單邊 L2 聚合 (book side)
+///
+/// OrderBook 在檔位的總量或掛單數改變時呼叫 update()，檔位被移除時呼叫
+/// erase()，只在最優 depth 檔內搬移陣列元素，不需要每次走訪 ladder。
+/// 不變式：陣列內恰好是此邊最優的 min(depth, 檔位數) 檔。
+/// depth 為 0 時不維護任何資料。
+template <Side S> class L2Depth {
+public:
+  explicit L2Depth(size_t depth) : depth_(static_cast<uint32_t>(depth)) {
+    if (depth > L2_MAX_DEPTH) {
+      throw std::invalid_argument("L2 depth must be at most 16");
+    }
+  }
+
+  size_t depth() const { return depth_; }
+  const DepthLevels &levels() const { return levels_; }
+
+  /// 檔位 price 的總量與掛單數改為 quantity / orders (orders > 0)。
+  /// 回傳最優 depth 檔是否改變
+  bool update(Price price, uint64_t quantity, uint32_t orders) {
+    if (depth_ == 0) {
+      return false;
+    }
+
+    const uint32_t n = levels_.size;
+    uint32_t i = 0;
+    for (; i < n; ++i) {
+      const int64_t k = PriceLadder<S>::key(levels_.prices[i]);
+      if (k >= PriceLadder<S>::key(price)) {
+        break;
+      }
+    }
+
+    if (i < n && levels_.prices[i] == price) {
+      levels_.quantities[i] = quantity;
+      levels_.orders[i] = orders;
+      return true;
+    }
+    // 比第 depth 檔差，不在最優 depth 檔內
+    if (i == depth_) {
+      return false;
+    }
+
+    // 其餘情況必為新檔位：插入並在陣列已滿時擠掉最後一檔
+    const uint32_t last = n < depth_ ? n : depth_ - 1;
+    detail::move_levels(levels_, i + 1, i, last - i);
+    levels_.prices[i] = price;
+    levels_.quantities[i] = quantity;
+    levels_.orders[i] = orders;
+    levels_.size = last + 1;
+    return true;
+  }
+
+  /// 檔位 price 已從 ladder 移除；陣列空出的最後一檔由 ladder 補上。
+  /// 回傳最優 depth 檔是否改變
+  bool erase(Price price, const PriceLadder<S> &ladder) {
+    uint32_t i = 0;
+    while (i < levels_.size && levels_.prices[i] != price) {
+      ++i;
+    }
+    if (i == levels_.size) {
+      return false;
+    }
+
+    const uint32_t last = levels_.size - 1;
+    detail::move_levels(levels_, i, i + 1, last - i);
+    levels_.prices[last] = 0;
+    levels_.quantities[last] = 0;
+    levels_.orders[last] = 0;
+    levels_.size = last;
+
+    // ladder 依序的前 last 檔就是陣列中剩下的檔位，下一檔即為要補上的
+    if (ladder.size() > last) {
+      uint32_t skip = last;
+      ladder.for_each([&](const PriceLevel &level) {
+        if (skip-- > 0) {
+          return true;
+        }
+        levels_.prices[last] = level.price;
+        levels_.quantities[last] = level.total_quantity;
+        levels_.orders[last] = static_cast<uint32_t>(level.orders.size());
+        levels_.size = last + 1;
+        return false;
+      });
+    }
+    return true;
+  }
+
+private:
+  uint32_t depth_;
+  DepthLevels levels_;
+};
+
+} // namespace lats::lob
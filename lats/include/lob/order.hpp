@@ -1,14 +1,32 @@
+#pragma once
+
 #include "lob/types.hpp"
-#include <boost/intrusive/list.hpp>
+
+#include <boost/intrusive/list_hook.hpp>
+#include <boost/intrusive/unordered_set_hook.hpp>
 
 namespace lats::lob {
 
+struct PriceLevel;
+
+// normal_link: unlink 時不清空 hook 指標，省去 hot path 上多餘的寫入
+using LinkMode =
+    boost::intrusive::link_mode<boost::intrusive::normal_link>;
+
 struct Order {
   OrderID order_id;
   Price price;
   Quantity quantity;
   Side side;
   TimeStamp timestamp;
+
+  // 所屬價格檔位，撤單時不需再查找檔位
+  PriceLevel *level = nullptr;
+
+  // 價格檔位內的 FIFO 鏈結
+  boost::intrusive::list_member_hook<LinkMode> level_hook;
+  // OrderID 索引
+  boost::intrusive::unordered_set_member_hook<LinkMode> id_hook;
 };
 
 } // namespace lats::lob
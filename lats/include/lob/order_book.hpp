@@ -0,0 +1,313 @@
+#pragma once
+
+#include "core/object_pool.hpp"
+#include "lob/l2_depth.hpp"
+#include "lob/order.hpp"
+#include "lob/price_ladder.hpp"
+#include "lob/types.hpp"
+
+#include <boost/intrusive/unordered_set.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+namespace lats::lob {
+
+namespace bi = boost::intrusive;
+
+/// 成交回報
+struct Trade {
+  OrderID maker_id;
+  OrderID taker_id;
+  Price price;
+  Quantity quantity;
+  Side taker_side;
+};
+
+struct BookConfig {
+  size_t max_orders = 1 << 20;
+  size_t max_levels = 1 << 16;
+  Price tick_size = 1;         // 最小跳動單位 (定點數)
+  size_t ladder_slots = 4096;  // 每邊 ladder 視窗的檔位數
+  size_t depth_levels = 0;     // 每邊維護的 L2 聚合檔數，0 代表不維護
+  core::PoolOptions pool_options = {};
+};
+
+/// Limit Order Book
+///
+/// Order 與 PriceLevel 由建構時預先配置的 ObjectPool 提供，add/cancel/execute
+/// 只在物件池與 intrusive 容器間搬移指標，hot path 上不做 heap 配置。
+/// 每邊的檔位以 PriceLadder 直接索引，價格必須是 tick_size 的整數倍。
+/// 設定 depth_levels 時另外隨每次變動增量維護最優 N 檔的 L2 聚合。
+class OrderBook {
+public:
+  explicit OrderBook(const BookConfig &config = BookConfig{});
+  OrderBook(size_t max_orders, size_t max_levels);
+  ~OrderBook();
+
+  OrderBook(const OrderBook &) = delete;
+  OrderBook &operator=(const OrderBook &) = delete;
+
+  /// 新增限價單，可成交的部分先撮合，剩餘數量掛入簿中
+  /// 重複的 OrderID、數量為 0、價格不在 tick 上或容量耗盡時回傳 false；
+  /// 回傳 false 時不會有任何成交 (容量在撮合前檢查)
+  template <typename TradeHandler>
+  bool add_order(OrderID id, Side side, Price price, Quantity quantity,
+                 TimeStamp ts, TradeHandler &&on_trade);
+
+  bool add_order(OrderID id, Side side, Price price, Quantity quantity,
+                 TimeStamp ts) {
+    return add_order(id, side, price, quantity, ts, [](const Trade &) {});
+  }
+
+  /// 撤銷整筆掛單，O(1)
+  bool cancel_order(OrderID id);
+
+  /// 外部成交 (例如行情中的 Execute 訊息)，數量歸零時移除掛單
+  bool execute_order(OrderID id, Quantity quantity);
+
+  /// 改單：價格不變且數量減少時保留時間優先，否則視為撤單重掛並重新撮合。
+  /// 價格不在 tick 上或容量不足時回傳 false，原掛單不受影響
+  template <typename TradeHandler>
+  bool modify_order(OrderID id, Price new_price, Quantity new_quantity,
+                    TimeStamp ts, TradeHandler &&on_trade);
+
+  bool modify_order(OrderID id, Price new_price, Quantity new_quantity,
+                    TimeStamp ts) {
+    return modify_order(id, new_price, new_quantity, ts,
+                        [](const Trade &) {});
+  }
+
+  std::optional<Price> best_bid() const;
+  std::optional<Price> best_ask() const;
+
+  /// 指定價格上的總掛單量
+  uint64_t volume_at(Side side, Price price) const;
+
+  const Order *find_order(OrderID id) const;
+
+  size_t order_count() const { return order_index_.size(); }
+  size_t level_count(Side side) const {
+    return side == Side::Buy ? bids_.size() : asks_.size();
+  }
+
+  const PriceLadder<Side::Buy> &bids() const { return bids_; }
+  const PriceLadder<Side::Sell> &asks() const { return asks_; }
+
+  /// 最優 depth_levels 檔的 L2 聚合 (價格、總量、掛單數)
+  const DepthLevels &depth(Side side) const {
+    return side == Side::Buy ? bid_depth_.levels() : ask_depth_.levels();
+  }
+
+  /// L2 聚合的變動次數，未變動時不必重新取快照
+  uint64_t depth_sequence() const { return depth_sequence_; }
+
+  /// 複製兩邊的 L2 聚合，不走訪 ladder
+  void depth_snapshot(DepthSnapshot &out) const {
+    out.sequence = depth_sequence_;
+    copy_depth(out.bids, bid_depth_.levels());
+    copy_depth(out.asks, ask_depth_.levels());
+  }
+
+private:
+  struct OrderKey {
+    using type = OrderID;
+    const type &operator()(const Order &order) const {
+      return order.order_id;
+    }
+  };
+
+  struct OrderIDHash {
+    size_t operator()(OrderID id) const {
+      // 混合高低位，避免連續 ID 只落在部分 bucket
+      id ^= id >> 33;
+      id *= 0xff51afd7ed558ccdULL;
+      id ^= id >> 33;
+      return static_cast<size_t>(id);
+    }
+  };
+
+  using OrderIndex = bi::unordered_set<
+      Order,
+      bi::member_hook<Order, bi::unordered_set_member_hook<LinkMode>,
+                      &Order::id_hook>,
+      bi::key_of_value<OrderKey>, bi::hash<OrderIDHash>,
+      bi::power_2_buckets<true>, bi::constant_time_size<true>>;
+
+  Price tick_size_;
+  core::ObjectPool<Order> order_pool_;
+  core::ObjectPool<PriceLevel> level_pool_;
+
+  std::unique_ptr<OrderIndex::bucket_type[]> order_buckets_;
+  OrderIndex order_index_;
+
+  PriceLadder<Side::Buy> bids_;
+  PriceLadder<Side::Sell> asks_;
+
+  L2Depth<Side::Buy> bid_depth_;
+  L2Depth<Side::Sell> ask_depth_;
+  uint64_t depth_sequence_ = 0;
+
+  Order *allocate_order();
+  void free_order(Order *order);
+  PriceLevel *allocate_level(Price price);
+  void free_level(PriceLevel *level);
+
+  // 掛單池與檔位池 (price 還沒有檔位時) 都還有空間
+  bool can_rest(Side side, Price price) const {
+    if (order_pool_.available() == 0) {
+      return false;
+    }
+    if (level_pool_.available() > 0) {
+      return true;
+    }
+    return side == Side::Buy ? bids_.find(price) != nullptr
+                             : asks_.find(price) != nullptr;
+  }
+
+  // 將剩餘數量掛入簿中
+  bool rest_order(OrderID id, Side side, Price price, Quantity quantity,
+                  TimeStamp ts);
+  // 將訂單從檔位與索引移除並歸還，檔位清空時一併移除
+  void remove_order(Order &order);
+
+  // 檔位的總量或掛單數改變後更新 L2 聚合
+  void depth_changed(Side side, const PriceLevel &level) {
+    const bool changed =
+        side == Side::Buy
+            ? bid_depth_.update(level.price, level.total_quantity,
+                                static_cast<uint32_t>(level.orders.size()))
+            : ask_depth_.update(level.price, level.total_quantity,
+                                static_cast<uint32_t>(level.orders.size()));
+    depth_sequence_ += changed;
+  }
+  // 檔位從 ladder 移除後更新 L2 聚合
+  void depth_removed(Side side, Price price) {
+    const bool changed = side == Side::Buy ? bid_depth_.erase(price, bids_)
+                                           : ask_depth_.erase(price, asks_);
+    depth_sequence_ += changed;
+  }
+
+  template <typename Levels, typename TradeHandler>
+  Quantity match(Levels &levels, OrderID taker_id, Side taker_side,
+                 Price limit, Quantity quantity, TradeHandler &on_trade);
+};
+
+template <typename TradeHandler>
+bool OrderBook::add_order(OrderID id, Side side, Price price,
+                          Quantity quantity, TimeStamp ts,
+                          TradeHandler &&on_trade) {
+  if (quantity == 0 || price % tick_size_ != 0 ||
+      order_index_.find(id) != order_index_.end()) {
+    return false;
+  }
+
+  // 撮合前先確認剩餘數量掛得進去，不會在送出成交回報之後才拒絕：
+  // 有成交又有剩餘時，穿價的掛單與檔位都已經吃完歸還，空間一定足夠，
+  // 所以只有完全不穿價、容量又耗盡時才需要拒絕
+  const bool crosses =
+      side == Side::Buy ? !asks_.empty() && asks_.best()->price <= price
+                        : !bids_.empty() && bids_.best()->price >= price;
+  if (!crosses && !can_rest(side, price)) {
+    return false;
+  }
+
+  if (side == Side::Buy) {
+    quantity = match(asks_, id, side, price, quantity, on_trade);
+  } else {
+    quantity = match(bids_, id, side, price, quantity, on_trade);
+  }
+
+  if (quantity == 0) {
+    return true;
+  }
+
+  // 依上面的檢查不會失敗
+  return rest_order(id, side, price, quantity, ts);
+}
+
+template <typename TradeHandler>
+bool OrderBook::modify_order(OrderID id, Price new_price,
+                             Quantity new_quantity, TimeStamp ts,
+                             TradeHandler &&on_trade) {
+  auto it = order_index_.find(id);
+  if (it == order_index_.end()) {
+    return false;
+  }
+
+  Order &order = *it;
+  if (new_quantity == 0) {
+    remove_order(order);
+    return true;
+  }
+
+  if (new_price == order.price && new_quantity <= order.quantity) {
+    order.level->total_quantity -= order.quantity - new_quantity;
+    order.quantity = new_quantity;
+    depth_changed(order.side, *order.level);
+    return true;
+  }
+
+  // 撤單前先做 add_order 會拒絕的檢查，失敗時原掛單保持不變
+  if (new_price % tick_size_ != 0) {
+    return false;
+  }
+  // 剩餘數量可能需要新檔位；原檔位不會因撤單而釋放時，檔位池必須有空間
+  const Side side = order.side;
+  const bool has_level = side == Side::Buy ? bids_.find(new_price) != nullptr
+                                           : asks_.find(new_price) != nullptr;
+  if (!has_level && level_pool_.available() == 0 &&
+      order.level->orders.size() > 1) {
+    return false;
+  }
+
+  remove_order(order);
+  return add_order(id, side, new_price, new_quantity, ts, on_trade);
+}
+
+template <typename Levels, typename TradeHandler>
+Quantity OrderBook::match(Levels &levels, OrderID taker_id, Side taker_side,
+                          Price limit, Quantity quantity,
+                          TradeHandler &on_trade) {
+  const Side maker_side = taker_side == Side::Buy ? Side::Sell : Side::Buy;
+  while (quantity > 0 && !levels.empty()) {
+    PriceLevel &level = *levels.best();
+    const bool crosses = taker_side == Side::Buy ? level.price <= limit
+                                                 : level.price >= limit;
+    if (!crosses) {
+      break;
+    }
+
+    while (quantity > 0 && !level.orders.empty()) {
+      Order &maker = level.orders.front();
+      const Quantity fill = std::min(quantity, maker.quantity);
+
+      maker.quantity -= fill;
+      level.total_quantity -= fill;
+      quantity -= fill;
+
+      on_trade(Trade{maker.order_id, taker_id, level.price, fill, taker_side});
+
+      if (maker.quantity == 0) {
+        level.orders.pop_front();
+        order_index_.erase(order_index_.iterator_to(maker));
+        free_order(&maker);
+      }
+    }
+
+    if (level.orders.empty()) {
+      levels.erase(&level);
+      depth_removed(maker_side, level.price);
+      free_level(&level);
+    } else {
+      depth_changed(maker_side, level);
+    }
+  }
+
+  return quantity;
+}
+
+} // namespace lats::lob
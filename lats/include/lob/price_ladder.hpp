@@ -0,0 +1,308 @@
+#pragma once
+
+#include "lob/order.hpp"
+#include "lob/types.hpp"
+
+#include <boost/intrusive/list.hpp>
+#include <boost/intrusive/set.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace lats::lob {
+
+namespace bi = boost::intrusive;
+
+/// 同一價格上的所有掛單，依時間優先排成 FIFO
+struct PriceLevel {
+  using OrderList =
+      bi::list<Order,
+               bi::member_hook<Order, bi::list_member_hook<LinkMode>,
+                               &Order::level_hook>,
+               bi::constant_time_size<true>>;
+
+  Price price = 0;
+  uint64_t total_quantity = 0;
+  OrderList orders;
+
+  // 只有落在 ladder 視窗外的檔位才會掛在 overflow tree 上
+  bi::set_member_hook<LinkMode> side_hook;
+};
+
+namespace detail {
+
+/// 從第 from 個 bit 開始找第一個為 1 的 bit，找不到回傳 num_words * 64
+inline size_t find_next_set(const uint64_t *words, size_t num_words,
+                            size_t from) {
+  size_t w = from / 64;
+  if (w >= num_words) {
+    return num_words * 64;
+  }
+
+  uint64_t bits = words[w] & (~uint64_t{0} << (from % 64));
+  if (bits != 0) {
+    return w * 64 + static_cast<size_t>(__builtin_ctzll(bits));
+  }
+  ++w;
+
+#ifdef __AVX2__
+  // 先對齊到 4 個 word，之後每次檢查 256 bits
+  for (; w < num_words && (w & 3) != 0; ++w) {
+    if (words[w] != 0) {
+      return w * 64 + static_cast<size_t>(__builtin_ctzll(words[w]));
+    }
+  }
+  for (; w + 4 <= num_words; w += 4) {
+    const __m256i v =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(words + w));
+    if (!_mm256_testz_si256(v, v)) {
+      break;
+    }
+  }
+#endif
+
+  for (; w < num_words; ++w) {
+    if (words[w] != 0) {
+      return w * 64 + static_cast<size_t>(__builtin_ctzll(words[w]));
+    }
+  }
+  return num_words * 64;
+}
+
+} // namespace detail
+
+/// 單邊價格階梯 (book side)
+///
+/// 以 (key - base) / tick 直接索引的 PriceLevel* 陣列，搭配非空檔位的 bitmap，
+/// 最優價耗盡後以 bitmap 掃描 (AVX2 + tzcnt) 找下一檔，不需走訪樹。
+/// 買方以 -price 當 key，因此兩邊都是 key 越小價格越優。
+///
+/// 不變式：只要此邊不為空，最優價必定在視窗內；視窗外的檔位都比視窗更差，
+/// 放在 overflow tree。新價格優於視窗或視窗被清空時重新定位 (recenter)。
+template <Side S> class PriceLadder {
+public:
+  using Compare = std::conditional_t<S == Side::Buy, std::greater<Price>,
+                                     std::less<Price>>;
+
+  PriceLadder(Price tick_size, size_t num_slots)
+      : tick_(tick_size), num_slots_(num_slots), best_idx_(num_slots),
+        slots_(num_slots, nullptr), bitmap_(num_slots / 64, 0) {
+    if (tick_size <= 0) {
+      throw std::invalid_argument("tick size must be positive");
+    }
+    if (num_slots < 256 || (num_slots & (num_slots - 1)) != 0) {
+      throw std::invalid_argument(
+          "ladder size must be a power of 2 and at least 256");
+    }
+  }
+
+  ~PriceLadder() { overflow_.clear(); }
+
+  PriceLadder(const PriceLadder &) = delete;
+  PriceLadder &operator=(const PriceLadder &) = delete;
+
+  static int64_t key(Price price) { return S == Side::Buy ? -price : price; }
+
+  bool empty() const { return best_idx_ == num_slots_; }
+  size_t size() const { return ladder_count_ + overflow_.size(); }
+
+  PriceLevel *best() const {
+    return best_idx_ == num_slots_ ? nullptr : slots_[best_idx_];
+  }
+
+  PriceLevel *find(Price price) const {
+    const size_t idx = index_of(key(price));
+    if (idx < num_slots_) {
+      return slots_[idx];
+    }
+    auto it = overflow_.find(price);
+    return it == overflow_.end() ? nullptr : const_cast<PriceLevel *>(&*it);
+  }
+
+  /// 加入一個此價格尚不存在的檔位
+  void insert(PriceLevel *level) {
+    const int64_t k = key(level->price);
+
+    if (empty() || k < base_) {
+      recenter(k);
+    }
+
+    const size_t idx = index_of(k);
+    if (idx < num_slots_) {
+      place(idx, level);
+      if (idx < best_idx_) {
+        best_idx_ = idx;
+      }
+    } else {
+      overflow_.insert(*level);
+    }
+  }
+
+  void erase(PriceLevel *level) {
+    const size_t idx = index_of(key(level->price));
+    if (idx >= num_slots_ || slots_[idx] != level) {
+      overflow_.erase(overflow_.iterator_to(*level));
+      return;
+    }
+
+    slots_[idx] = nullptr;
+    bitmap_[idx / 64] &= ~(uint64_t{1} << (idx % 64));
+    --ladder_count_;
+
+    if (idx == best_idx_) {
+      best_idx_ = next_set(idx);
+      if (best_idx_ == num_slots_ && !overflow_.empty()) {
+        refill_from_overflow();
+      }
+    }
+  }
+
+  /// 依價格優先順序走訪，f 回傳 false 時停止
+  template <typename F> void for_each(F &&f) const {
+    for (size_t idx = best_idx_; idx < num_slots_; idx = next_set(idx + 1)) {
+      if (!f(*slots_[idx])) {
+        return;
+      }
+    }
+    for (const PriceLevel &level : overflow_) {
+      if (!f(level)) {
+        return;
+      }
+    }
+  }
+
+  template <typename Disposer> void clear_and_dispose(Disposer &&dispose) {
+    for (size_t idx = 0; idx < num_slots_; ++idx) {
+      if (slots_[idx] != nullptr) {
+        dispose(slots_[idx]);
+        slots_[idx] = nullptr;
+      }
+    }
+    std::fill(bitmap_.begin(), bitmap_.end(), 0);
+    ladder_count_ = 0;
+    best_idx_ = num_slots_;
+    overflow_.clear_and_dispose(dispose);
+  }
+
+  size_t recenter_count() const { return recenter_count_; }
+
+private:
+  struct LevelPrice {
+    using type = Price;
+    const type &operator()(const PriceLevel &level) const {
+      return level.price;
+    }
+  };
+
+  using Overflow =
+      bi::set<PriceLevel,
+              bi::member_hook<PriceLevel, bi::set_member_hook<LinkMode>,
+                              &PriceLevel::side_hook>,
+              bi::key_of_value<LevelPrice>, bi::compare<Compare>>;
+
+  // 新的最優價前保留 1/4 視窗，價格小幅改善時不必再 recenter
+  static constexpr size_t HEADROOM_DIVISOR = 4;
+
+  Price tick_;
+  size_t num_slots_;
+  int64_t base_ = 0; // slot 0 對應的 key
+  size_t best_idx_;
+  size_t ladder_count_ = 0;
+  size_t recenter_count_ = 0;
+
+  std::vector<PriceLevel *> slots_;
+  std::vector<uint64_t> bitmap_;
+  Overflow overflow_;
+
+  // 視窗外 (含優於視窗) 回傳 num_slots_
+  size_t index_of(int64_t k) const {
+    if (k < base_) {
+      return num_slots_;
+    }
+    const uint64_t idx =
+        static_cast<uint64_t>(k - base_) / static_cast<uint64_t>(tick_);
+    return idx < num_slots_ ? static_cast<size_t>(idx) : num_slots_;
+  }
+
+  size_t next_set(size_t from) const {
+    return detail::find_next_set(bitmap_.data(), bitmap_.size(), from);
+  }
+
+  void place(size_t idx, PriceLevel *level) {
+    slots_[idx] = level;
+    bitmap_[idx / 64] |= uint64_t{1} << (idx % 64);
+    ++ladder_count_;
+  }
+
+  // 將視窗移到以 best_key 為最優價的位置，移出視窗的檔位轉入 overflow
+  void recenter(int64_t best_key) {
+    ++recenter_count_;
+    const int64_t new_base =
+        best_key - static_cast<int64_t>(num_slots_ / HEADROOM_DIVISOR) * tick_;
+
+    if (ladder_count_ == 0) {
+      base_ = new_base;
+      return;
+    }
+
+    // 新的 base 一定比舊的小 (價格更優)，從最差的一端往回搬可避免覆蓋
+    const uint64_t shift_ticks =
+        static_cast<uint64_t>(base_ - new_base) / static_cast<uint64_t>(tick_);
+    for (size_t i = num_slots_; i-- > 0;) {
+      PriceLevel *level = slots_[i];
+      if (level == nullptr) {
+        continue;
+      }
+      slots_[i] = nullptr;
+      if (shift_ticks < num_slots_ - i) {
+        slots_[i + shift_ticks] = level;
+      } else {
+        overflow_.insert(*level);
+        --ladder_count_;
+      }
+    }
+
+    base_ = new_base;
+    rebuild_bitmap();
+  }
+
+  // 視窗清空時從 overflow 取回最優的一段檔位
+  void refill_from_overflow() {
+    ++recenter_count_;
+    base_ = key(overflow_.begin()->price) -
+            static_cast<int64_t>(num_slots_ / HEADROOM_DIVISOR) * tick_;
+
+    while (!overflow_.empty()) {
+      PriceLevel &level = *overflow_.begin();
+      const size_t idx = index_of(key(level.price));
+      if (idx >= num_slots_) {
+        break;
+      }
+      overflow_.erase(overflow_.begin());
+      place(idx, &level);
+    }
+
+    best_idx_ = next_set(0);
+  }
+
+  void rebuild_bitmap() {
+    std::fill(bitmap_.begin(), bitmap_.end(), 0);
+    for (size_t i = 0; i < num_slots_; ++i) {
+      if (slots_[i] != nullptr) {
+        bitmap_[i / 64] |= uint64_t{1} << (i % 64);
+      }
+    }
+    best_idx_ = next_set(0);
+  }
+};
+
+} // namespace lats::lob
@@ -0,0 +1,234 @@
+#pragma once
+
+#include "core/shm_region.hpp"
+#include "lob/types.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace lats::lob {
+
+class OrderBook;
+
+/// 每邊最多可發布的檔數
+inline constexpr uint32_t TOB_MAX_DEPTH = 10;
+
+struct BookLevel {
+  Price price = 0;
+  uint64_t quantity = 0;
+};
+
+/// 讀取端取得的某個 symbol 的最優 N 檔
+struct TopOfBook {
+  uint64_t version = 0;    // 發布次數 * 2，0 代表尚未發布過
+  TimeStamp timestamp = 0; // publisher 給的時間戳
+  uint32_t bid_depth = 0;
+  uint32_t ask_depth = 0;
+  BookLevel bids[TOB_MAX_DEPTH];
+  BookLevel asks[TOB_MAX_DEPTH];
+};
+
+namespace detail {
+
+inline constexpr uint64_t TOB_MAGIC = 0x31424F545354414C; // "LATSTOB1"
+inline constexpr uint32_t TOB_LAYOUT_VERSION = 1;
+
+/// 共享記憶體開頭，magic 最後以 release 寫入，讀取端看到 magic 才算初始化完成
+struct alignas(64) TobShmHeader {
+  std::atomic<uint64_t> magic;
+  uint32_t layout_version;
+  uint32_t symbol_count;
+  uint32_t depth;
+  uint32_t entry_size;
+};
+
+/// 每個 symbol 一個 entry，以 64 bytes 對齊，depth = 1 時剛好一條 cache line。
+/// 欄位都是 lock-free atomic，seqlock 的讀寫在 C++ 記憶體模型下沒有 data race
+struct TobEntryHead {
+  std::atomic<uint64_t> version; // 奇數代表寫入中
+  std::atomic<uint64_t> timestamp;
+  std::atomic<uint32_t> bid_depth;
+  std::atomic<uint32_t> ask_depth;
+};
+
+/// entry head 之後依序為 depth 個買方檔位、depth 個賣方檔位
+struct TobShmLevel {
+  std::atomic<int64_t> price;
+  std::atomic<uint64_t> quantity;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free &&
+                  std::atomic<int64_t>::is_always_lock_free &&
+                  std::atomic<uint32_t>::is_always_lock_free,
+              "shared memory atomics must be lock-free");
+static_assert(sizeof(TobShmHeader) == 64);
+static_assert(sizeof(TobEntryHead) == 24 && sizeof(TobShmLevel) == 16);
+
+inline size_t tob_entry_size(uint32_t depth) {
+  const size_t raw = sizeof(TobEntryHead) + 2 * depth * sizeof(TobShmLevel);
+  return (raw + 63) / 64 * 64;
+}
+
+} // namespace detail
+
+/// 以 seqlock 保護、發布到 POSIX shared memory 的最優 N 檔報價
+///
+/// 同一台機器上的策略行程以 TopOfBookReader 直接讀取，不經過 TCP，
+/// 讀取端不加鎖、不做 syscall，也不會擋住發布端。每個 symbol 只能有一個
+/// 發布者 (通常是維護該 book 的線程)。解構時 shm_unlink，已開啟的讀取端
+/// 仍可讀到最後的內容。
+class TopOfBookPublisher {
+public:
+  /// depth 為每邊發布的檔數 (1 ~ TOB_MAX_DEPTH)，失敗時丟出例外
+  TopOfBookPublisher(const std::string &name, uint32_t symbol_count,
+                     uint32_t depth = 1);
+
+  TopOfBookPublisher(const TopOfBookPublisher &) = delete;
+  TopOfBookPublisher &operator=(const TopOfBookPublisher &) = delete;
+
+  /// 發布 symbol 的最優檔位，超過 depth 的部分忽略；symbol 超出範圍時回傳 false
+  bool publish(uint32_t symbol, const BookLevel *bids, uint32_t bid_count,
+               const BookLevel *asks, uint32_t ask_count, TimeStamp ts) {
+    if (symbol >= symbol_count_) {
+      return false;
+    }
+    bid_count = bid_count < depth_ ? bid_count : depth_;
+    ask_count = ask_count < depth_ ? ask_count : depth_;
+
+    detail::TobEntryHead &head = entry(symbol);
+    detail::TobShmLevel *levels = levels_of(head);
+
+    const uint64_t v = head.version.load(std::memory_order_relaxed);
+    head.version.store(v + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    head.timestamp.store(ts, std::memory_order_relaxed);
+    head.bid_depth.store(bid_count, std::memory_order_relaxed);
+    head.ask_depth.store(ask_count, std::memory_order_relaxed);
+    for (uint32_t i = 0; i < bid_count; ++i) {
+      levels[i].price.store(bids[i].price, std::memory_order_relaxed);
+      levels[i].quantity.store(bids[i].quantity, std::memory_order_relaxed);
+    }
+    for (uint32_t i = 0; i < ask_count; ++i) {
+      levels[depth_ + i].price.store(asks[i].price,
+                                     std::memory_order_relaxed);
+      levels[depth_ + i].quantity.store(asks[i].quantity,
+                                        std::memory_order_relaxed);
+    }
+
+    head.version.store(v + 2, std::memory_order_release);
+    return true;
+  }
+
+  /// 從 book 取出每邊最優 depth 檔後發布
+  bool publish(uint32_t symbol, const OrderBook &book, TimeStamp ts);
+
+  uint32_t symbol_count() const { return symbol_count_; }
+  uint32_t depth() const { return depth_; }
+  const std::string &name() const { return region_.name(); }
+
+private:
+  core::ShmRegion region_;
+  char *entries_;
+  uint32_t symbol_count_;
+  uint32_t depth_;
+  size_t entry_size_;
+
+  detail::TobEntryHead &entry(uint32_t symbol) const {
+    return *reinterpret_cast<detail::TobEntryHead *>(entries_ +
+                                                     symbol * entry_size_);
+  }
+  static detail::TobShmLevel *levels_of(detail::TobEntryHead &head) {
+    return reinterpret_cast<detail::TobShmLevel *>(&head + 1);
+  }
+};
+
+/// TopOfBookPublisher 的讀取端，以唯讀方式映射同一塊 shared memory
+class TopOfBookReader {
+public:
+  /// 區塊不存在、尚未初始化完成或格式不符時丟出 std::runtime_error
+  explicit TopOfBookReader(const std::string &name);
+
+  TopOfBookReader(const TopOfBookReader &) = delete;
+  TopOfBookReader &operator=(const TopOfBookReader &) = delete;
+
+  /// 只讀一次：發布端正在寫入、或讀到一半被覆寫時回傳 false
+  bool try_read(uint32_t symbol, TopOfBook &out) const {
+    if (symbol >= symbol_count_) {
+      return false;
+    }
+    const detail::TobEntryHead &head = entry(symbol);
+    const detail::TobShmLevel *levels = levels_of(head);
+
+    const uint64_t v1 = head.version.load(std::memory_order_acquire);
+    if (v1 & 1) {
+      return false;
+    }
+
+    out.timestamp = head.timestamp.load(std::memory_order_relaxed);
+    uint32_t bid_count = head.bid_depth.load(std::memory_order_relaxed);
+    uint32_t ask_count = head.ask_depth.load(std::memory_order_relaxed);
+    // 讀到一半的計數可能超出範圍，先夾住，之後版本檢查會判定失敗
+    bid_count = bid_count < depth_ ? bid_count : depth_;
+    ask_count = ask_count < depth_ ? ask_count : depth_;
+    for (uint32_t i = 0; i < bid_count; ++i) {
+      out.bids[i].price = levels[i].price.load(std::memory_order_relaxed);
+      out.bids[i].quantity =
+          levels[i].quantity.load(std::memory_order_relaxed);
+    }
+    for (uint32_t i = 0; i < ask_count; ++i) {
+      out.asks[i].price =
+          levels[depth_ + i].price.load(std::memory_order_relaxed);
+      out.asks[i].quantity =
+          levels[depth_ + i].quantity.load(std::memory_order_relaxed);
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (head.version.load(std::memory_order_relaxed) != v1) {
+      return false;
+    }
+    out.version = v1;
+    out.bid_depth = bid_count;
+    out.ask_depth = ask_count;
+    return true;
+  }
+
+  /// 重試直到讀到一致的內容，symbol 超出範圍時回傳 false
+  bool read(uint32_t symbol, TopOfBook &out) const {
+    if (symbol >= symbol_count_) {
+      return false;
+    }
+    while (!try_read(symbol, out)) {
+      __builtin_ia32_pause();
+    }
+    return true;
+  }
+
+  /// 目前的版本，輪詢時先比對版本，有變化才讀取整個 entry
+  uint64_t version(uint32_t symbol) const {
+    return entry(symbol).version.load(std::memory_order_acquire);
+  }
+
+  uint32_t symbol_count() const { return symbol_count_; }
+  uint32_t depth() const { return depth_; }
+
+private:
+  core::ShmRegion region_;
+  const char *entries_;
+  uint32_t symbol_count_;
+  uint32_t depth_;
+  size_t entry_size_;
+
+  const detail::TobEntryHead &entry(uint32_t symbol) const {
+    return *reinterpret_cast<const detail::TobEntryHead *>(
+        entries_ + symbol * entry_size_);
+  }
+  static const detail::TobShmLevel *
+  levels_of(const detail::TobEntryHead &head) {
+    return reinterpret_cast<const detail::TobShmLevel *>(&head + 1);
+  }
+};
+
+} // namespace lats::lob
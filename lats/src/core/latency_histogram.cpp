@@ -0,0 +1,86 @@
+#include <core/latency_histogram.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace lats::core {
+
+LatencyHistogram::LatencyHistogram() : counts_(BUCKET_COUNT, 0) {}
+
+void LatencyHistogram::merge(const LatencyHistogram &other) {
+  for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+    counts_[i] += other.counts_[i];
+  }
+  total_ += other.total_;
+  sum_ += other.sum_;
+  min_ = std::min(min_, other.min_);
+  max_ = std::max(max_, other.max_);
+}
+
+void LatencyHistogram::reset() {
+  std::fill(counts_.begin(), counts_.end(), 0);
+  total_ = 0;
+  sum_ = 0;
+  min_ = UINT64_MAX;
+  max_ = 0;
+}
+
+void LatencyHistogram::snapshot_and_reset(LatencyHistogram &out) {
+  std::swap(counts_, out.counts_);
+  std::swap(total_, out.total_);
+  std::swap(sum_, out.sum_);
+  std::swap(min_, out.min_);
+  std::swap(max_, out.max_);
+  reset();
+}
+
+double LatencyHistogram::mean() const {
+  if (total_ == 0) {
+    throw std::runtime_error("No samples available");
+  }
+  return static_cast<double>(sum_) / total_;
+}
+
+uint64_t LatencyHistogram::percentile(double p) const {
+  if (total_ == 0) {
+    throw std::runtime_error("No samples available");
+  }
+
+  if (p < 0.0 || p > 1.0) {
+    throw std::invalid_argument("Percentile must be between 0.0 and 1.0");
+  }
+
+  // 第 rank 個樣本 (1-based) 所在的 bucket
+  uint64_t rank = static_cast<uint64_t>(std::ceil(p * total_));
+  rank = std::max<uint64_t>(rank, 1);
+
+  uint64_t seen = 0;
+  for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+    seen += counts_[i];
+    if (seen >= rank) {
+      return std::clamp(bucket_highest(i), min_, max_);
+    }
+  }
+  return max_;
+}
+
+uint64_t LatencyHistogram::bucket_lowest(size_t index) {
+  if (index < SUB_BUCKET_COUNT) {
+    return index;
+  }
+  const size_t shift = index / SUB_BUCKET_COUNT - 1;
+  const uint64_t top = SUB_BUCKET_COUNT + index % SUB_BUCKET_COUNT;
+  return top << shift;
+}
+
+uint64_t LatencyHistogram::bucket_highest(size_t index) {
+  if (index < SUB_BUCKET_COUNT) {
+    return index;
+  }
+  const size_t shift = index / SUB_BUCKET_COUNT - 1;
+  return bucket_lowest(index) + ((uint64_t{1} << shift) - 1);
+}
+
+} // namespace lats::core
@@ -0,0 +1,87 @@
+#include "core/mapped_region.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <utility>
+
+namespace lats::core {
+
+namespace {
+
+size_t round_up(size_t n, size_t align) {
+  return (n + align - 1) / align * align;
+}
+
+size_t page_size() { return static_cast<size_t>(::sysconf(_SC_PAGESIZE)); }
+
+} // namespace
+
+MappedRegion::MappedRegion(size_t size, bool hugepages, bool prefault) {
+  const int populate = prefault ? MAP_POPULATE : 0;
+
+  if (hugepages) {
+    size_ = round_up(size, HUGE_PAGE_SIZE);
+    void *p = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | populate, -1,
+                     0);
+    if (p != MAP_FAILED) {
+      data_ = p;
+      hugepages_ = true;
+    }
+  }
+
+  if (data_ == nullptr) {
+    size_ = round_up(size, page_size());
+    void *p = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | populate, -1, 0);
+    if (p == MAP_FAILED) {
+      throw std::runtime_error("mmap() failed: " +
+                               std::string(strerror(errno)));
+    }
+    data_ = p;
+
+    if (hugepages) {
+      ::madvise(data_, size_, MADV_HUGEPAGE);
+    }
+  }
+
+  if (prefault) {
+    // MAP_POPULATE 只保證頁面存在，寫入一次確保不會再有 copy-on-write fault
+    const size_t page = hugepages_ ? HUGE_PAGE_SIZE : page_size();
+    auto *bytes = static_cast<volatile unsigned char *>(data_);
+    for (size_t off = 0; off < size_; off += page) {
+      bytes[off] = 0;
+    }
+  }
+}
+
+MappedRegion::~MappedRegion() { release(); }
+
+MappedRegion::MappedRegion(MappedRegion &&other) noexcept
+    : data_{std::exchange(other.data_, nullptr)},
+      size_{std::exchange(other.size_, 0)},
+      hugepages_{std::exchange(other.hugepages_, false)} {}
+
+MappedRegion &MappedRegion::operator=(MappedRegion &&other) noexcept {
+  if (this != &other) {
+    release();
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    hugepages_ = std::exchange(other.hugepages_, false);
+  }
+  return *this;
+}
+
+void MappedRegion::release() {
+  if (data_ != nullptr) {
+    ::munmap(data_, size_);
+    data_ = nullptr;
+    size_ = 0;
+  }
+}
+
+} // namespace lats::core
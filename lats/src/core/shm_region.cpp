@@ -0,0 +1,204 @@
+#include "core/shm_region.hpp"
+
+#include "core/mapped_region.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+namespace lats::core {
+
+namespace {
+
+// hugetlbfs 的掛載點，shm_open 所在的 tmpfs 不支援 MAP_HUGETLB
+constexpr const char *HUGETLBFS_DIR = "/dev/hugepages";
+
+[[noreturn]] void fail(const std::string &what, const std::string &name) {
+  throw std::runtime_error(what + "(" + name +
+                           ") failed: " + std::string(strerror(errno)));
+}
+
+void check_name(const std::string &name) {
+  if (name.size() < 2 || name[0] != '/' ||
+      name.find('/', 1) != std::string::npos) {
+    throw std::invalid_argument("shared memory name must look like /name: " +
+                                name);
+  }
+}
+
+size_t round_up(size_t n, size_t align) {
+  return (n + align - 1) / align * align;
+}
+
+int open_fd(const std::string &name, int flags, bool hugepages) {
+  if (hugepages) {
+    return ::open((HUGETLBFS_DIR + name).c_str(), flags, 0600);
+  }
+  return ::shm_open(name.c_str(), flags, 0600);
+}
+
+void unlink_name(const std::string &name, bool hugepages) {
+  if (hugepages) {
+    ::unlink((HUGETLBFS_DIR + name).c_str());
+  } else {
+    ::shm_unlink(name.c_str());
+  }
+}
+
+// 建立 (或重設) 指定大小的區塊並映射，失敗時回傳 MAP_FAILED 並保留 errno
+void *create_mapping(const std::string &name, size_t size, bool hugepages,
+                     bool prefault, const char **failed_call) {
+  const int fd = open_fd(name, O_CREAT | O_RDWR, hugepages);
+  if (fd < 0) {
+    *failed_call = "open";
+    return MAP_FAILED;
+  }
+  // 先截成 0 再設定大小，讓沿用舊名稱時內容一定是全 0
+  if (::ftruncate(fd, 0) < 0 ||
+      ::ftruncate(fd, static_cast<off_t>(size)) < 0) {
+    const int err = errno;
+    ::close(fd);
+    unlink_name(name, hugepages);
+    errno = err;
+    *failed_call = "ftruncate";
+    return MAP_FAILED;
+  }
+
+  const int populate = prefault ? MAP_POPULATE : 0;
+  void *p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | populate, fd, 0);
+  const int err = errno;
+  ::close(fd);
+  if (p == MAP_FAILED) {
+    unlink_name(name, hugepages);
+    errno = err;
+    *failed_call = "mmap";
+  }
+  return p;
+}
+
+} // namespace
+
+ShmRegion ShmRegion::create(const std::string &name, size_t size,
+                            bool hugepages, bool prefault) {
+  check_name(name);
+  if (size == 0) {
+    throw std::invalid_argument("shared memory size must be positive");
+  }
+
+  ShmRegion region;
+  region.name_ = name;
+  region.owner_ = true;
+
+  const char *failed_call = nullptr;
+  if (hugepages) {
+    const size_t huge_size = round_up(size, HUGE_PAGE_SIZE);
+    void *p = create_mapping(name, huge_size, true, prefault, &failed_call);
+    if (p != MAP_FAILED) {
+      region.data_ = p;
+      region.size_ = huge_size;
+      region.hugepages_ = true;
+      return region;
+    }
+  }
+
+  // 沒有掛載 hugetlbfs 或沒有預留 hugepage 時退回一般頁面，並提示 THP
+  void *p = create_mapping(name, size, false, prefault, &failed_call);
+  if (p == MAP_FAILED) {
+    region.owner_ = false;
+    fail(failed_call, name);
+  }
+  if (hugepages) {
+    ::madvise(p, size, MADV_HUGEPAGE);
+  }
+  region.data_ = p;
+  region.size_ = size;
+  return region;
+}
+
+ShmRegion ShmRegion::open(const std::string &name, bool writable) {
+  check_name(name);
+  const int flags = writable ? O_RDWR : O_RDONLY;
+  bool hugepages = false;
+  int fd = open_fd(name, flags, false);
+  if (fd < 0 && errno == ENOENT) {
+    // 也可能是建立在 hugetlbfs 上的區塊
+    fd = open_fd(name, flags, true);
+    hugepages = fd >= 0;
+    if (fd < 0) {
+      errno = ENOENT;
+    }
+  }
+  if (fd < 0) {
+    fail("shm_open", name);
+  }
+
+  struct stat st {};
+  if (::fstat(fd, &st) < 0) {
+    const int err = errno;
+    ::close(fd);
+    errno = err;
+    fail("fstat", name);
+  }
+  if (st.st_size <= 0) {
+    ::close(fd);
+    throw std::runtime_error("shared memory " + name + " is empty");
+  }
+
+  const size_t size = static_cast<size_t>(st.st_size);
+  const int prot = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+  void *p = ::mmap(nullptr, size, prot, MAP_SHARED, fd, 0);
+  const int err = errno;
+  ::close(fd);
+  if (p == MAP_FAILED) {
+    errno = err;
+    fail("mmap", name);
+  }
+
+  ShmRegion region;
+  region.data_ = p;
+  region.size_ = size;
+  region.name_ = name;
+  region.hugepages_ = hugepages;
+  return region;
+}
+
+ShmRegion::~ShmRegion() { release(); }
+
+ShmRegion::ShmRegion(ShmRegion &&other) noexcept
+    : data_{std::exchange(other.data_, nullptr)},
+      size_{std::exchange(other.size_, 0)}, name_{std::move(other.name_)},
+      hugepages_{std::exchange(other.hugepages_, false)},
+      owner_{std::exchange(other.owner_, false)} {}
+
+ShmRegion &ShmRegion::operator=(ShmRegion &&other) noexcept {
+  if (this != &other) {
+    release();
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    name_ = std::move(other.name_);
+    hugepages_ = std::exchange(other.hugepages_, false);
+    owner_ = std::exchange(other.owner_, false);
+  }
+  return *this;
+}
+
+void ShmRegion::release() {
+  if (data_ != nullptr) {
+    ::munmap(data_, size_);
+    data_ = nullptr;
+    size_ = 0;
+  }
+  if (owner_) {
+    unlink_name(name_, hugepages_);
+    owner_ = false;
+  }
+}
+
+} // namespace lats::core
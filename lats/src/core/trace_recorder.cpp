@@ -0,0 +1,211 @@
+#include "core/trace_recorder.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace lats::core {
+
+namespace {
+
+constexpr size_t DRAIN_BATCH = 4096;
+
+[[noreturn]] void throw_errno(const std::string &what) {
+  throw std::runtime_error(what + " failed: " + std::string(strerror(errno)));
+}
+
+} // namespace
+
+TraceRecorder::TraceRecorder(const std::string &path,
+                             std::vector<std::string> stage_names,
+                             std::chrono::milliseconds drain_interval) {
+  if (stage_names.empty() || stage_names.size() > TRACE_MAX_STAGES) {
+    throw std::invalid_argument("trace needs 1 to 16 stages");
+  }
+  if (drain_interval.count() <= 0) {
+    throw std::invalid_argument("drain interval must be positive");
+  }
+
+  header_.magic = TRACE_MAGIC;
+  header_.version = TRACE_FORMAT_VERSION;
+  header_.record_size = sizeof(TraceRecord);
+  header_.num_stages = static_cast<uint32_t>(stage_names.size());
+  for (size_t i = 0; i < stage_names.size(); ++i) {
+    if (stage_names[i].size() >= TRACE_STAGE_NAME_SIZE) {
+      throw std::invalid_argument("trace stage name too long: " +
+                                  stage_names[i]);
+    }
+    std::strncpy(header_.stage_names[i], stage_names[i].c_str(),
+                 TRACE_STAGE_NAME_SIZE - 1);
+  }
+  // dump 記錄 TSC 頻率，離線分析時換算 ns
+  if (!TscClock::calibrated()) {
+    TscClock::calibrate();
+  }
+  header_.tsc_ghz = TscClock::frequency_ghz();
+
+  file_ = std::fopen(path.c_str(), "wb");
+  if (file_ == nullptr) {
+    throw_errno("fopen(" + path + ")");
+  }
+  // 先寫入標頭佔位，stop() 時補上記錄數
+  if (std::fwrite(&header_, sizeof(header_), 1, file_) != 1) {
+    std::fclose(file_);
+    throw_errno("fwrite(trace header)");
+  }
+
+  batch_.reserve(DRAIN_BATCH);
+  drainer_ = std::thread(&TraceRecorder::drain_loop, this, drain_interval);
+}
+
+TraceRecorder::~TraceRecorder() { stop(); }
+
+void TraceRecorder::register_thread() {
+  auto ring = std::make_unique<detail::TraceRing>();
+  std::lock_guard<std::mutex> lock(rings_mutex_);
+  ring->thread = static_cast<uint32_t>(rings_.size());
+  detail::tls_trace_ring = ring.get();
+  rings_.push_back(std::move(ring));
+}
+
+uint64_t TraceRecorder::dropped() const {
+  std::lock_guard<std::mutex> lock(rings_mutex_);
+  uint64_t total = 0;
+  for (const auto &ring : rings_) {
+    total += ring->dropped.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+void TraceRecorder::stop() {
+  {
+    std::lock_guard<std::mutex> lock(stop_mutex_);
+    if (!running_) {
+      return;
+    }
+    running_ = false;
+  }
+  stop_cv_.notify_one();
+  drainer_.join();
+  drain_once();
+
+  header_.records = records_written();
+  header_.dropped = dropped();
+  {
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    header_.num_threads = static_cast<uint32_t>(rings_.size());
+  }
+  std::fseek(file_, 0, SEEK_SET);
+  std::fwrite(&header_, sizeof(header_), 1, file_);
+  std::fclose(file_);
+  file_ = nullptr;
+}
+
+void TraceRecorder::drain_loop(std::chrono::milliseconds interval) {
+  std::unique_lock<std::mutex> lock(stop_mutex_);
+  while (running_) {
+    lock.unlock();
+    const size_t drained = drain_once();
+    lock.lock();
+    // 還有資料時立刻再取，沒有資料才等待
+    if (drained == 0) {
+      stop_cv_.wait_for(lock, interval, [this] { return !running_; });
+    }
+  }
+}
+
+size_t TraceRecorder::drain_once() {
+  size_t drained = 0;
+  auto flush = [this] {
+    std::fwrite(batch_.data(), sizeof(TraceRecord), batch_.size(), file_);
+    records_written_.fetch_add(batch_.size(), std::memory_order_relaxed);
+    batch_.clear();
+  };
+
+  std::lock_guard<std::mutex> lock(rings_mutex_);
+  for (auto &ring : rings_) {
+    while (const TraceRecord *record = ring->queue.front()) {
+      batch_.push_back(*record);
+      ring->queue.pop();
+      ++drained;
+      if (batch_.size() == DRAIN_BATCH) {
+        flush();
+      }
+    }
+  }
+  flush();
+  return drained;
+}
+
+TraceReport load_trace(const std::string &path) {
+  std::FILE *file = std::fopen(path.c_str(), "rb");
+  if (file == nullptr) {
+    throw_errno("fopen(" + path + ")");
+  }
+  std::unique_ptr<std::FILE, int (*)(std::FILE *)> guard(file, std::fclose);
+
+  TraceFileHeader header;
+  if (std::fread(&header, sizeof(header), 1, file) != 1 ||
+      header.magic != TRACE_MAGIC) {
+    throw std::runtime_error(path + " is not a trace dump");
+  }
+  if (header.version != TRACE_FORMAT_VERSION ||
+      header.record_size != sizeof(TraceRecord) ||
+      header.num_stages == 0 || header.num_stages > TRACE_MAX_STAGES ||
+      !(header.tsc_ghz > 0.0)) {
+    throw std::runtime_error(path + " has an unsupported trace layout");
+  }
+
+  std::vector<TraceRecord> records(header.records);
+  if (std::fread(records.data(), sizeof(TraceRecord), records.size(), file) !=
+      records.size()) {
+    throw std::runtime_error(path + " is truncated");
+  }
+
+  TraceReport report;
+  report.records = header.records;
+  report.dropped = header.dropped;
+  report.threads = header.num_threads;
+  for (uint32_t i = 0; i < header.num_stages; ++i) {
+    report.stage_names.emplace_back(header.stage_names[i],
+                                    strnlen(header.stage_names[i],
+                                            TRACE_STAGE_NAME_SIZE));
+  }
+  report.stage_latency.resize(header.num_stages);
+
+  auto to_ns = [&](uint64_t cycles) {
+    return static_cast<uint64_t>(
+        std::llround(static_cast<double>(cycles) / header.tsc_ghz));
+  };
+
+  // 同一個 sequence 的記錄依時間排序後，相鄰兩筆之差即為後者 stage 的延遲
+  std::sort(records.begin(), records.end(),
+            [](const TraceRecord &a, const TraceRecord &b) {
+              return a.sequence != b.sequence ? a.sequence < b.sequence
+                                              : a.tsc < b.tsc;
+            });
+  size_t begin = 0;
+  while (begin < records.size()) {
+    size_t end = begin;
+    while (end < records.size() &&
+           records[end].sequence == records[begin].sequence) {
+      ++end;
+    }
+    for (size_t i = begin + 1; i < end; ++i) {
+      if (records[i].stage < header.num_stages) {
+        report.stage_latency[records[i].stage].add_sample(
+            to_ns(records[i].tsc - records[i - 1].tsc));
+      }
+    }
+    if (end - begin > 1) {
+      report.end_to_end.add_sample(
+          to_ns(records[end - 1].tsc - records[begin].tsc));
+    }
+    begin = end;
+  }
+  return report;
+}
+
+} // namespace lats::core
@@ -0,0 +1,50 @@
+#include "core/trace_recorder.hpp"
+
+#include <cinttypes>
+#include <cstdio>
+#include <exception>
+
+using namespace lats;
+
+namespace {
+
+void print_row(const char *name, const core::LatencyStats &stats) {
+  std::printf("%-24s %10" PRIu64 " %10" PRIu64 " %10" PRIu64 " %10" PRIu64
+              " %10" PRIu64 " %12.1f\n",
+              name, stats.count(), stats.p50(), stats.p99(), stats.p999(),
+              stats.max(), stats.mean());
+}
+
+} // namespace
+
+// 用法: trace_report <dump>
+// 將 TraceRecorder 的 dump 轉成各 stage 的延遲分佈 (ns)
+int main(int argc, char *argv[]) {
+  if (argc != 2) {
+    std::fprintf(stderr, "usage: %s <trace dump>\n", argv[0]);
+    return 2;
+  }
+
+  try {
+    const core::TraceReport report = core::load_trace(argv[1]);
+    std::printf("records=%" PRIu64 " dropped=%" PRIu64 " threads=%u\n\n",
+                report.records, report.dropped, report.threads);
+    std::printf("%-24s %10s %10s %10s %10s %10s %12s\n", "stage", "count",
+                "p50", "p99", "p999", "max", "mean");
+
+    // 第一個 stage 通常沒有前一個 stage，沒有樣本的不列出
+    for (size_t i = 0; i < report.stage_names.size(); ++i) {
+      if (report.stage_latency[i].count() > 0) {
+        print_row(report.stage_names[i].c_str(), report.stage_latency[i]);
+      }
+    }
+    // 只有單一 stage 的 dump 沒有 end-to-end 樣本
+    if (report.end_to_end.count() > 0) {
+      print_row("end-to-end", report.end_to_end);
+    }
+  } catch (const std::exception &e) {
+    std::fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,232 @@
+#include "core/tsc_clock.hpp"
+
+#include "core/cpu_affinity.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cpuid.h>
+#include <ctime>
+#include <limits>
+#include <stdexcept>
+
+namespace lats::core {
+
+TscClock::Params TscClock::params_;
+
+namespace {
+
+struct ClockSample {
+  uint64_t tsc = 0;
+  uint64_t ns = 0;
+};
+
+uint64_t clock_ns(clockid_t clock) {
+  timespec ts;
+  ::clock_gettime(clock, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000ULL +
+         static_cast<uint64_t>(ts.tv_nsec);
+}
+
+// 以兩次 TSC 夾住 clock_gettime，取窗口最小 (最少被打斷) 的一次，
+// 假設 clock 讀值落在窗口中點
+ClockSample sample_clock(clockid_t clock) {
+  constexpr int ATTEMPTS = 16;
+  ClockSample best;
+  uint64_t best_window = std::numeric_limits<uint64_t>::max();
+  for (int i = 0; i < ATTEMPTS; ++i) {
+    const uint64_t before = TscClock::now();
+    const uint64_t ns = clock_ns(clock);
+    const uint64_t after = TscClock::now();
+    if (after - before < best_window) {
+      best_window = after - before;
+      best.tsc = before + (after - before) / 2;
+      best.ns = ns;
+    }
+  }
+  return best;
+}
+
+double ghz_between(const ClockSample &from, const ClockSample &to) {
+  return static_cast<double>(to.tsc - from.tsc) /
+         static_cast<double>(to.ns - from.ns);
+}
+
+uint64_t mult_for(double ghz) {
+  return static_cast<uint64_t>(
+      std::llround(std::ldexp(1.0, TscClock::SHIFT) / ghz));
+}
+
+int64_t signed_cycles_to_ns(uint64_t from, uint64_t to) {
+  return to >= from ? static_cast<int64_t>(TscClock::cycles_to_ns(to - from))
+                    : -static_cast<int64_t>(TscClock::cycles_to_ns(from - to));
+}
+
+std::mutex calibration_mutex;
+// 第一次校準時的 CLOCK_MONOTONIC_RAW 取樣，resync() 以它為頻率的基準點
+ClockSample raw_reference;
+
+} // namespace
+
+TscFeatures detect_tsc_features() {
+  TscFeatures features;
+  unsigned int eax, ebx, ecx, edx;
+  if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+    features.tsc = (edx & (1u << 4)) != 0;
+  }
+  if (__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx)) {
+    const unsigned int max_extended = eax;
+    if (max_extended >= 0x80000001 &&
+        __get_cpuid(0x80000001, &eax, &ebx, &ecx, &edx)) {
+      features.rdtscp = (edx & (1u << 27)) != 0;
+    }
+    if (max_extended >= 0x80000007 &&
+        __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) {
+      features.invariant = (edx & (1u << 8)) != 0;
+    }
+  }
+  return features;
+}
+
+const TscFeatures &TscClock::features() {
+  static const TscFeatures features = detect_tsc_features();
+  return features;
+}
+
+void TscClock::publish(uint64_t mult, uint64_t anchor_tsc,
+                       uint64_t anchor_ns) {
+  const uint64_t v = params_.seq.load(std::memory_order_relaxed);
+  params_.seq.store(v + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  params_.mult.store(mult, std::memory_order_relaxed);
+  params_.anchor_tsc.store(anchor_tsc, std::memory_order_relaxed);
+  params_.anchor_ns.store(anchor_ns, std::memory_order_relaxed);
+  params_.seq.store(v + 2, std::memory_order_release);
+}
+
+void TscClock::calibrate(int samples, std::chrono::milliseconds interval,
+                         bool require_invariant) {
+  if (samples <= 0 || interval.count() <= 0) {
+    throw std::invalid_argument("calibration needs positive samples/interval");
+  }
+  if (!features().tsc || !features().rdtscp) {
+    throw std::runtime_error("CPU does not support TSC/RDTSCP");
+  }
+  // 頻率會變動時，校準出的倍率與錨點很快就失效；虛擬機常隱藏這個位元但
+  // 實際上是穩定的，所以預設只警告
+  if (!features().invariant) {
+    if (require_invariant) {
+      throw std::runtime_error("TSC is not invariant (constant/nonstop)");
+    }
+    spdlog::warn("TSC is not reported as invariant (constant/nonstop); "
+                 "TscClock conversions may drift with CPU frequency changes");
+  }
+
+  std::lock_guard<std::mutex> lock(calibration_mutex);
+
+  std::vector<double> ghz;
+  ghz.reserve(static_cast<size_t>(samples));
+  const ClockSample first = sample_clock(CLOCK_MONOTONIC_RAW);
+  ClockSample prev = first;
+  for (int i = 0; i < samples; ++i) {
+    std::this_thread::sleep_for(interval);
+    const ClockSample cur = sample_clock(CLOCK_MONOTONIC_RAW);
+    ghz.push_back(ghz_between(prev, cur));
+    prev = cur;
+  }
+  // 中位數：個別區間被搶占或遷移核心時不影響結果
+  std::nth_element(ghz.begin(), ghz.begin() + ghz.size() / 2, ghz.end());
+
+  raw_reference = first;
+  const ClockSample anchor = sample_clock(CLOCK_REALTIME);
+  publish(mult_for(ghz[ghz.size() / 2]), anchor.tsc, anchor.ns);
+}
+
+void TscClock::not_calibrated() {
+  throw std::logic_error("TscClock used before calibrate()");
+}
+
+int64_t TscClock::resync() {
+  if (!calibrated()) {
+    not_calibrated();
+  }
+
+  std::lock_guard<std::mutex> lock(calibration_mutex);
+  // 基準越長，取樣誤差佔的比例越小
+  const ClockSample raw = sample_clock(CLOCK_MONOTONIC_RAW);
+  const ClockSample real = sample_clock(CLOCK_REALTIME);
+  const int64_t error =
+      static_cast<int64_t>(real.ns - to_epoch_ns(real.tsc));
+
+  // NTP 調整 CLOCK_REALTIME 時錨點會隨之跳動，頻率則維持以硬體時脈為準
+  publish(mult_for(ghz_between(raw_reference, raw)), real.tsc, real.ns);
+  return error;
+}
+
+double TscClock::frequency_ghz() {
+  const uint64_t mult = params_.mult.load(std::memory_order_relaxed);
+  return mult == 0 ? 0.0 : std::ldexp(1.0, SHIFT) / static_cast<double>(mult);
+}
+
+std::vector<CoreSkew>
+TscClock::measure_core_skew(const std::vector<int> &cpus) {
+  if (!calibrated()) {
+    calibrate();
+  }
+
+  const ClockSample reference = sample_clock(CLOCK_MONOTONIC_RAW);
+  std::vector<CoreSkew> result;
+  result.reserve(cpus.size());
+  for (int cpu : cpus) {
+    CoreSkew skew;
+    skew.cpu = cpu;
+    ClockSample sample;
+    // 在新線程上綁核，不改變呼叫端線程的 affinity
+    std::thread probe([&] {
+      skew.pinned = cpu >= 0 && cpu < CPU_SETSIZE && pin_current_thread(cpu);
+      if (skew.pinned) {
+        sample = sample_clock(CLOCK_MONOTONIC_RAW);
+      }
+    });
+    probe.join();
+
+    if (skew.pinned) {
+      // 以 TSC 預測的經過時間減去實際經過時間
+      skew.offset_ns = signed_cycles_to_ns(reference.tsc, sample.tsc) -
+                       static_cast<int64_t>(sample.ns - reference.ns);
+    }
+    result.push_back(skew);
+  }
+  return result;
+}
+
+TscResyncThread::TscResyncThread(std::chrono::milliseconds interval, int cpu) {
+  if (interval.count() <= 0) {
+    throw std::invalid_argument("resync interval must be positive");
+  }
+  if (!TscClock::calibrated()) {
+    TscClock::calibrate();
+  }
+  thread_ = std::thread(&TscResyncThread::run, this, interval, cpu);
+}
+
+TscResyncThread::~TscResyncThread() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_one();
+  thread_.join();
+}
+
+void TscResyncThread::run(std::chrono::milliseconds interval, int cpu) {
+  pin_current_thread(cpu);
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!cv_.wait_for(lock, interval, [this] { return stop_; })) {
+    last_error_ns_.store(TscClock::resync(), std::memory_order_relaxed);
+    resyncs_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+} // namespace lats::core
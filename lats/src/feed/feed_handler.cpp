@@ -0,0 +1,262 @@
+#include "feed/feed_handler.hpp"
+
+#include "core/cpu_affinity.hpp"
+#include "core/timer.hpp"
+#include "feed/sequence_tracker.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <spdlog/spdlog.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace lats::feed {
+
+namespace {
+
+[[noreturn]] void throw_errno(const std::string &what) {
+  throw std::runtime_error(what + " failed: " + std::string(strerror(errno)));
+}
+
+in_addr parse_addr(const std::string &addr) {
+  in_addr out{};
+  if (::inet_pton(AF_INET, addr.c_str(), &out) != 1) {
+    throw std::invalid_argument("Invalid IPv4 address: " + addr);
+  }
+  return out;
+}
+
+} // namespace
+
+FeedHandler::FeedHandler(FeedConfig config)
+    : config_(std::move(config)), queue_(std::make_unique<PacketQueue>()) {
+  if (config_.batch_size == 0) {
+    throw std::invalid_argument("batch_size must be greater than 0");
+  }
+
+  const in_addr group = parse_addr(config_.group);
+  const in_addr iface = parse_addr(config_.interface);
+
+  fd_ = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+  if (fd_ < 0) {
+    throw_errno("socket()");
+  }
+
+  try {
+    int opt = 1;
+    if (::setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0) {
+      throw_errno("setsockopt(SO_REUSEADDR)");
+    }
+
+    // SO_RCVBUFFORCE 可超過 rmem_max，但需要 CAP_NET_ADMIN
+    int rcvbuf = config_.rcvbuf_bytes;
+    if (::setsockopt(fd_, SOL_SOCKET, SO_RCVBUFFORCE, &rcvbuf,
+                     sizeof(rcvbuf)) < 0) {
+      ::setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    }
+
+    // bind 到 group 位址，同一個 port 上其他 group 的流量不會進來
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(config_.port);
+    addr.sin_addr = group;
+    if (::bind(fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+      throw_errno("bind()");
+    }
+
+    ip_mreq mreq{};
+    mreq.imr_multiaddr = group;
+    mreq.imr_interface = iface;
+    if (::setsockopt(fd_, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq,
+                     sizeof(mreq)) < 0) {
+      throw_errno("setsockopt(IP_ADD_MEMBERSHIP)");
+    }
+  } catch (...) {
+    ::close(fd_);
+    fd_ = -1;
+    throw;
+  }
+
+  // 延遲統計在熱路徑上換算 cycles，校準必須在啟動時完成
+  if (!core::TscClock::calibrated()) {
+    core::TscClock::calibrate();
+  }
+
+  spdlog::info("FeedHandler joined {}:{} on {}", config_.group, config_.port,
+               config_.interface);
+}
+
+FeedHandler::~FeedHandler() {
+  stop();
+  if (fd_ >= 0) {
+    ::close(fd_);
+  }
+}
+
+void FeedHandler::start(PacketCallback on_packet) {
+  if (running_.exchange(true)) {
+    return;
+  }
+
+  on_packet_ = std::move(on_packet);
+  rx_done_.store(false, std::memory_order_relaxed);
+  parse_thread_ = std::thread(&FeedHandler::parse_loop, this);
+  rx_thread_ = std::thread(&FeedHandler::rx_loop, this);
+}
+
+void FeedHandler::stop() {
+  running_.store(false, std::memory_order_release);
+  if (rx_thread_.joinable()) {
+    rx_thread_.join();
+  }
+  if (parse_thread_.joinable()) {
+    parse_thread_.join();
+  }
+}
+
+void FeedHandler::rx_loop() {
+  if (!core::pin_current_thread(config_.rx_cpu)) {
+    spdlog::warn("Failed to pin rx thread to CPU {}", config_.rx_cpu);
+  }
+  if (config_.tracer != nullptr) {
+    config_.tracer->register_thread();
+  }
+
+  const size_t batch = config_.batch_size;
+  std::vector<RawPacket> buffers(batch);
+  std::vector<iovec> iovs(batch);
+  std::vector<mmsghdr> msgs(batch);
+  for (size_t i = 0; i < batch; ++i) {
+    iovs[i].iov_base = buffers[i].data;
+    iovs[i].iov_len = MAX_PACKET_SIZE;
+    msgs[i] = {};
+    msgs[i].msg_hdr.msg_iov = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+
+  pollfd pfd{fd_, POLLIN, 0};
+
+  while (running_.load(std::memory_order_acquire)) {
+    const int n = ::recvmmsg(fd_, msgs.data(), static_cast<unsigned>(batch),
+                             MSG_DONTWAIT, nullptr);
+    if (n <= 0) {
+      if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK &&
+          errno != EINTR) {
+        spdlog::error("recvmmsg() failed: {}", strerror(errno));
+        break;
+      }
+      if (!config_.busy_poll) {
+        ::poll(&pfd, 1, 1); // 最多等 1ms，讓 stop() 能及時生效
+      }
+      continue;
+    }
+
+    const uint64_t rx_tsc = core::Timer::now();
+    counters_.packets_received.fetch_add(n, std::memory_order_relaxed);
+
+    for (int i = 0; i < n; ++i) {
+      RawPacket *slot = queue_->alloc();
+      if (slot == nullptr) {
+        counters_.queue_full_drops.fetch_add(1, std::memory_order_relaxed);
+        continue;
+      }
+      // 只複製實際長度，不複製整個 MAX_PACKET_SIZE
+      slot->rx_tsc = rx_tsc;
+      slot->len = static_cast<uint16_t>(msgs[i].msg_len);
+      std::memcpy(slot->data, buffers[i].data, msgs[i].msg_len);
+      queue_->publish();
+
+      // 只有開啟 trace 時才多解一次標頭取得序號
+      MoldUDP64Header header;
+      if (core::tracing_enabled() &&
+          MoldUDP64Header::decode(buffers[i].data, msgs[i].msg_len, header)) {
+        core::trace(trace_stage::RECEIVE, header.sequence, rx_tsc);
+      }
+    }
+  }
+
+  rx_done_.store(true, std::memory_order_release);
+}
+
+void FeedHandler::parse_loop() {
+  if (!core::pin_current_thread(config_.parse_cpu)) {
+    spdlog::warn("Failed to pin parse thread to CPU {}", config_.parse_cpu);
+  }
+  if (config_.tracer != nullptr) {
+    config_.tracer->register_thread();
+  }
+
+  SequenceTracker tracker;
+  bool first = true;
+  MoldUDP64Header header;
+
+  // 接收線程結束後，先把 queue 中剩下的封包處理完
+  while (!rx_done_.load(std::memory_order_acquire) || !queue_->empty()) {
+    RawPacket *packet = queue_->front();
+    if (packet == nullptr) {
+      if (!config_.busy_poll) {
+        std::this_thread::yield();
+      }
+      continue;
+    }
+
+    if (!MoldUDP64Header::decode(packet->data, packet->len, header)) {
+      counters_.malformed.fetch_add(1, std::memory_order_relaxed);
+      queue_->pop();
+      continue;
+    }
+
+    // 中途加入的 session 以收到的第一個序號為起點
+    if (first) {
+      tracker = SequenceTracker(header.sequence);
+      first = false;
+    }
+
+    switch (tracker.on_packet(header.sequence, header.message_count)) {
+    case SequenceTracker::Result::InOrder:
+      break;
+    case SequenceTracker::Result::Gap:
+      counters_.gaps.store(tracker.gaps(), std::memory_order_relaxed);
+      counters_.missed_messages.store(tracker.missed(),
+                                      std::memory_order_relaxed);
+      break;
+    case SequenceTracker::Result::Overlap:
+      counters_.overlaps.store(tracker.overlaps(), std::memory_order_relaxed);
+      break;
+    case SequenceTracker::Result::Duplicate:
+      // 重複的封包不再交給下游
+      counters_.duplicates.store(tracker.duplicates(),
+                                 std::memory_order_relaxed);
+      queue_->pop();
+      continue;
+    case SequenceTracker::Result::EndOfSession:
+      // 不含訊息；結束前若有遺失的序號仍計入 gap
+      counters_.gaps.store(tracker.gaps(), std::memory_order_relaxed);
+      counters_.missed_messages.store(tracker.missed(),
+                                      std::memory_order_relaxed);
+      counters_.end_of_session.fetch_add(1, std::memory_order_relaxed);
+      queue_->pop();
+      continue;
+    }
+    packet->first_message = tracker.first_new();
+
+    if (on_packet_) {
+      on_packet_(*packet);
+    }
+    core::trace(trace_stage::PARSE, header.sequence);
+    latency_.add_sample(
+        core::Timer::cycles_to_ns(core::Timer::now() - packet->rx_tsc));
+    counters_.packets_parsed.fetch_add(1, std::memory_order_relaxed);
+    queue_->pop();
+  }
+}
+
+} // namespace lats::feed
@@ -0,0 +1,72 @@
+#include "feed/feed_handler.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <exception>
+#include <thread>
+
+using namespace lats;
+
+namespace {
+
+std::atomic<bool> g_running{true};
+
+void on_signal(int) { g_running.store(false); }
+
+} // namespace
+
+// 用法: feed_receiver [group] [port] [interface] [rx_cpu] [parse_cpu]
+int main(int argc, char *argv[]) {
+  feed::FeedConfig config;
+  if (argc > 1) {
+    config.group = argv[1];
+  }
+  if (argc > 2) {
+    config.port = static_cast<uint16_t>(std::atoi(argv[2]));
+  }
+  if (argc > 3) {
+    config.interface = argv[3];
+  }
+  if (argc > 4) {
+    config.rx_cpu = std::atoi(argv[4]);
+  }
+  if (argc > 5) {
+    config.parse_cpu = std::atoi(argv[5]);
+  }
+
+  std::signal(SIGINT, on_signal);
+  std::signal(SIGTERM, on_signal);
+
+  try {
+    feed::FeedHandler handler(config);
+    handler.start(nullptr);
+
+    const auto &c = handler.counters();
+    while (g_running.load()) {
+      std::this_thread::sleep_for(std::chrono::seconds(1));
+      spdlog::info("received={} parsed={} drops={} gaps={} missed={} dup={}",
+                   c.packets_received.load(), c.packets_parsed.load(),
+                   c.queue_full_drops.load(), c.gaps.load(),
+                   c.missed_messages.load(), c.duplicates.load());
+    }
+
+    handler.stop();
+
+    const auto &latency = handler.latency();
+    if (latency.count() > 0) {
+      spdlog::info("wire-to-parse latency P50={}ns P99={}ns P999={}ns "
+                   "max={}ns",
+                   latency.p50(), latency.p99(), latency.p999(),
+                   latency.max());
+    }
+  } catch (const std::exception &e) {
+    spdlog::error("{}", e.what());
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,86 @@
+#include "feed/multicast_sender.hpp"
+
+#include "feed/packet.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace lats::feed {
+
+MulticastSender::MulticastSender(const std::string &group, uint16_t port,
+                                 const std::string &interface, bool loopback,
+                                 int ttl)
+    : port_(port) {
+  in_addr group_addr{};
+  in_addr iface{};
+  if (::inet_pton(AF_INET, group.c_str(), &group_addr) != 1 ||
+      ::inet_pton(AF_INET, interface.c_str(), &iface) != 1) {
+    throw std::invalid_argument("Invalid IPv4 address");
+  }
+  group_addr_ = group_addr.s_addr;
+
+  fd_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+  if (fd_ < 0) {
+    throw std::runtime_error("socket() failed: " +
+                             std::string(strerror(errno)));
+  }
+
+  unsigned char loop = loopback ? 1 : 0;
+  unsigned char hops = static_cast<unsigned char>(ttl);
+  if (::setsockopt(fd_, IPPROTO_IP, IP_MULTICAST_IF, &iface, sizeof(iface)) <
+          0 ||
+      ::setsockopt(fd_, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop)) <
+          0 ||
+      ::setsockopt(fd_, IPPROTO_IP, IP_MULTICAST_TTL, &hops, sizeof(hops)) <
+          0) {
+    const int err = errno;
+    ::close(fd_);
+    throw std::runtime_error("setsockopt(IP_MULTICAST_*) failed: " +
+                             std::string(strerror(err)));
+  }
+}
+
+MulticastSender::~MulticastSender() {
+  if (fd_ >= 0) {
+    ::close(fd_);
+  }
+}
+
+bool MulticastSender::send(const void *data, size_t len) {
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port_);
+  addr.sin_addr.s_addr = group_addr_;
+
+  const ssize_t n = ::sendto(fd_, data, len, 0,
+                             reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+  return n == static_cast<ssize_t>(len);
+}
+
+bool MulticastSender::send_packet(uint64_t sequence, uint16_t message_count,
+                                  const void *payload, size_t payload_len) {
+  if (MoldUDP64Header::SIZE + payload_len > MAX_PACKET_SIZE) {
+    return false;
+  }
+
+  uint8_t buffer[MAX_PACKET_SIZE];
+  MoldUDP64Header header{};
+  std::memcpy(header.session, "LATS      ", MoldUDP64Header::SESSION_SIZE);
+  header.sequence = sequence;
+  header.message_count = message_count;
+  header.encode(buffer);
+
+  if (payload_len > 0) {
+    std::memcpy(buffer + MoldUDP64Header::SIZE, payload, payload_len);
+  }
+  return send(buffer, MoldUDP64Header::SIZE + payload_len);
+}
+
+} // namespace lats::feed
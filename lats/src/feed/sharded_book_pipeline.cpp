@@ -0,0 +1,186 @@
+#include "feed/sharded_book_pipeline.hpp"
+
+#include "core/cpu_affinity.hpp"
+#include "core/timer.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+namespace lats::feed {
+
+ShardedBookPipeline::ShardedBookPipeline(PipelineConfig config)
+    : config_(std::move(config)) {
+  if (config_.num_shards == 0) {
+    throw std::invalid_argument("num_shards must be greater than 0");
+  }
+  if (config_.max_symbols == 0 || config_.max_symbols > 65536) {
+    throw std::invalid_argument("max_symbols must be between 1 and 65536");
+  }
+  if (config_.books_per_shard == 0) {
+    throw std::invalid_argument("books_per_shard must be greater than 0");
+  }
+
+  for (size_t i = 0; i < config_.num_shards; ++i) {
+    auto shard = std::make_unique<Shard>();
+    shard->queue = std::make_unique<EventQueue>();
+    shard->cpu = i < config_.shard_cpus.size() ? config_.shard_cpus[i] : -1;
+    shard->books.resize(config_.max_symbols);
+    shards_.push_back(std::move(shard));
+  }
+
+  // 延遲統計在熱路徑上換算 cycles，校準必須在啟動時完成
+  if (!core::TscClock::calibrated()) {
+    core::TscClock::calibrate();
+  }
+}
+
+ShardedBookPipeline::~ShardedBookPipeline() { stop(); }
+
+void ShardedBookPipeline::start() {
+  if (running_.exchange(true)) {
+    return;
+  }
+  std::vector<std::promise<void>> ready(shards_.size());
+  std::vector<std::future<void>> built;
+  for (size_t i = 0; i < shards_.size(); ++i) {
+    built.push_back(ready[i].get_future());
+    shards_[i]->thread = std::thread(&ShardedBookPipeline::worker_loop, this,
+                                     std::ref(*shards_[i]), std::ref(ready[i]));
+  }
+
+  std::exception_ptr error;
+  for (auto &future : built) {
+    try {
+      future.get();
+    } catch (...) {
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+  if (error) {
+    stop();
+    std::rethrow_exception(error);
+  }
+}
+
+void ShardedBookPipeline::stop() {
+  running_.store(false, std::memory_order_release);
+  for (auto &shard : shards_) {
+    if (shard->thread.joinable()) {
+      shard->thread.join();
+    }
+  }
+}
+
+bool ShardedBookPipeline::dispatch(const BookEvent &event) {
+  if (event.symbol >= config_.max_symbols) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  EventQueue &queue = *shards_[shard_of(event.symbol)]->queue;
+  BookEvent *slot;
+  while ((slot = queue.alloc()) == nullptr) {
+    if (!config_.busy_poll) {
+      std::this_thread::yield();
+    }
+  }
+  *slot = event;
+  slot->dispatch_tsc = core::Timer::now();
+  queue.publish();
+  return true;
+}
+
+const lob::OrderBook *ShardedBookPipeline::book(uint16_t symbol) const {
+  if (symbol >= config_.max_symbols) {
+    return nullptr;
+  }
+  return shards_[shard_of(symbol)]->books[symbol];
+}
+
+void ShardedBookPipeline::worker_loop(Shard &shard,
+                                      std::promise<void> &ready) {
+  if (!core::pin_current_thread(shard.cpu)) {
+    spdlog::warn("Failed to pin book worker to CPU {}", shard.cpu);
+  }
+
+  // 綁核之後才建立，book 的記憶體落在 worker 所在的 NUMA node；
+  // 重新 start() 時沿用原本的 book
+  if (shard.storage.empty()) {
+    try {
+      const size_t count =
+          std::min(config_.books_per_shard, config_.max_symbols);
+      for (size_t i = 0; i < count; ++i) {
+        shard.storage.push_back(
+            std::make_unique<lob::OrderBook>(config_.book_config));
+      }
+    } catch (...) {
+      shard.storage.clear();
+      ready.set_exception(std::current_exception());
+      return;
+    }
+  }
+  ready.set_value();
+
+  EventQueue &queue = *shard.queue;
+  // stop() 之後先把 queue 中剩下的事件處理完
+  while (running_.load(std::memory_order_acquire) || !queue.empty()) {
+    const BookEvent *event = queue.front();
+    if (event == nullptr) {
+      if (!config_.busy_poll) {
+        std::this_thread::yield();
+      }
+      continue;
+    }
+
+    if (!apply(shard, *event)) {
+      shard.counters.rejected.fetch_add(1, std::memory_order_relaxed);
+    }
+    shard.latency.add_sample(
+        core::Timer::cycles_to_ns(core::Timer::now() - event->dispatch_tsc));
+    shard.counters.events.fetch_add(1, std::memory_order_relaxed);
+    queue.pop();
+  }
+}
+
+bool ShardedBookPipeline::apply(Shard &shard, const BookEvent &event) {
+  lob::OrderBook *&slot = shard.books[event.symbol];
+  if (slot == nullptr) {
+    if (shard.bound == shard.storage.size()) {
+      shard.counters.no_book.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    slot = shard.storage[shard.bound++].get();
+  }
+  lob::OrderBook &book = *slot;
+
+  switch (event.type) {
+  case BookEvent::Type::Add:
+    return book.add_order(event.order_id, event.side, event.price,
+                          event.quantity, event.timestamp);
+  // 部分撤單對簿的影響與成交相同：減少數量，歸零時移除
+  case BookEvent::Type::Execute:
+  case BookEvent::Type::Cancel:
+    return book.execute_order(event.order_id, event.quantity);
+  case BookEvent::Type::Delete:
+    return book.cancel_order(event.order_id);
+  case BookEvent::Type::Replace: {
+    const lob::Order *order = book.find_order(event.order_id);
+    if (order == nullptr) {
+      return false;
+    }
+    const lob::Side side = order->side;
+    book.cancel_order(event.order_id);
+    return book.add_order(event.new_order_id, side, event.price,
+                          event.quantity, event.timestamp);
+  }
+  }
+  return false;
+}
+
+} // namespace lats::feed
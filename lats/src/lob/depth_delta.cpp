@@ -0,0 +1,113 @@
+#include "lob/depth_delta.hpp"
+
+#include "lob/price_ladder.hpp"
+
+namespace lats::lob {
+
+namespace {
+
+// 兩邊的陣列都依價格優先排序，以 key 合併走訪
+
+template <Side S>
+size_t emit_removals(const DepthLevels &prev, const DepthLevels &cur,
+                     DepthUpdate *out) {
+  size_t n = 0;
+  uint32_t j = 0;
+  for (uint32_t i = 0; i < prev.size; ++i) {
+    const int64_t k = PriceLadder<S>::key(prev.prices[i]);
+    while (j < cur.size && PriceLadder<S>::key(cur.prices[j]) < k) {
+      ++j;
+    }
+    if (j == cur.size || cur.prices[j] != prev.prices[i]) {
+      out[n++] = DepthUpdate{prev.prices[i], 0, 0, S};
+    }
+  }
+  return n;
+}
+
+template <Side S>
+size_t emit_changes(const DepthLevels &prev, const DepthLevels &cur,
+                    DepthUpdate *out) {
+  size_t n = 0;
+  uint32_t i = 0;
+  for (uint32_t j = 0; j < cur.size; ++j) {
+    const int64_t k = PriceLadder<S>::key(cur.prices[j]);
+    while (i < prev.size && PriceLadder<S>::key(prev.prices[i]) < k) {
+      ++i;
+    }
+    const bool unchanged = i < prev.size &&
+                           prev.prices[i] == cur.prices[j] &&
+                           prev.quantities[i] == cur.quantities[j] &&
+                           prev.orders[i] == cur.orders[j];
+    if (!unchanged) {
+      out[n++] = DepthUpdate{cur.prices[j], cur.quantities[j], cur.orders[j],
+                             S};
+    }
+  }
+  return n;
+}
+
+template <Side S> void apply_update(DepthLevels &levels, const DepthUpdate &u) {
+  const int64_t k = PriceLadder<S>::key(u.price);
+  uint32_t i = 0;
+  while (i < levels.size && PriceLadder<S>::key(levels.prices[i]) < k) {
+    ++i;
+  }
+  const bool found = i < levels.size && levels.prices[i] == u.price;
+
+  if (u.quantity == 0) {
+    if (found) {
+      const uint32_t last = levels.size - 1;
+      detail::move_levels(levels, i, i + 1, last - i);
+      levels.prices[last] = 0;
+      levels.quantities[last] = 0;
+      levels.orders[last] = 0;
+      levels.size = last;
+    }
+    return;
+  }
+
+  if (!found) {
+    // 移除都先於新增套用，正常情況下不會超出容量
+    if (i == L2_MAX_DEPTH) {
+      return;
+    }
+    const uint32_t last =
+        levels.size < L2_MAX_DEPTH ? levels.size : L2_MAX_DEPTH - 1;
+    detail::move_levels(levels, i + 1, i, last - i);
+    levels.prices[i] = u.price;
+    levels.size = last + 1;
+  }
+  levels.quantities[i] = u.quantity;
+  levels.orders[i] = u.orders;
+}
+
+} // namespace
+
+size_t DepthDeltaEncoder::encode(const DepthSnapshot &snapshot) {
+  DepthUpdate *out = updates_.data();
+  size_t n = 0;
+  n += emit_removals<Side::Buy>(last_.bids, snapshot.bids, out + n);
+  n += emit_removals<Side::Sell>(last_.asks, snapshot.asks, out + n);
+  n += emit_changes<Side::Buy>(last_.bids, snapshot.bids, out + n);
+  n += emit_changes<Side::Sell>(last_.asks, snapshot.asks, out + n);
+  size_ = n;
+
+  last_.sequence = snapshot.sequence;
+  copy_depth(last_.bids, snapshot.bids);
+  copy_depth(last_.asks, snapshot.asks);
+  return n;
+}
+
+void apply_depth_updates(DepthSnapshot &snapshot, const DepthUpdate *updates,
+                         size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    if (updates[i].side == Side::Buy) {
+      apply_update<Side::Buy>(snapshot.bids, updates[i]);
+    } else {
+      apply_update<Side::Sell>(snapshot.asks, updates[i]);
+    }
+  }
+}
+
+} // namespace lats::lob
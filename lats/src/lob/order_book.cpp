@@ -0,0 +1,174 @@
+#include "lob/order_book.hpp"
+
+namespace lats::lob {
+
+namespace {
+
+size_t next_power_of_two(size_t n) {
+  size_t p = 1;
+  while (p < n) {
+    p <<= 1;
+  }
+  return p;
+}
+
+} // namespace
+
+OrderBook::OrderBook(const BookConfig &config)
+    : tick_size_(config.tick_size),
+      order_pool_(config.max_orders, config.pool_options),
+      level_pool_(config.max_levels, config.pool_options),
+      order_buckets_(new OrderIndex::bucket_type[next_power_of_two(
+          config.max_orders)]),
+      order_index_(OrderIndex::bucket_traits(
+          order_buckets_.get(), next_power_of_two(config.max_orders))),
+      bids_(config.tick_size, config.ladder_slots),
+      asks_(config.tick_size, config.ladder_slots),
+      bid_depth_(config.depth_levels), ask_depth_(config.depth_levels) {}
+
+OrderBook::OrderBook(size_t max_orders, size_t max_levels)
+    : OrderBook([&] {
+        BookConfig config;
+        config.max_orders = max_orders;
+        config.max_levels = max_levels;
+        return config;
+      }()) {}
+
+OrderBook::~OrderBook() {
+  // 先解除 intrusive 容器的鏈結，再把仍存活的物件歸還物件池
+  order_index_.clear();
+
+  auto release_level = [this](PriceLevel *level) {
+    level->orders.clear_and_dispose(
+        [this](Order *order) { order_pool_.destroy(order); });
+    level_pool_.destroy(level);
+  };
+  bids_.clear_and_dispose(release_level);
+  asks_.clear_and_dispose(release_level);
+}
+
+bool OrderBook::cancel_order(OrderID id) {
+  auto it = order_index_.find(id);
+  if (it == order_index_.end()) {
+    return false;
+  }
+
+  remove_order(*it);
+  return true;
+}
+
+bool OrderBook::execute_order(OrderID id, Quantity quantity) {
+  auto it = order_index_.find(id);
+  if (it == order_index_.end() || quantity == 0) {
+    return false;
+  }
+
+  Order &order = *it;
+  if (quantity >= order.quantity) {
+    remove_order(order);
+    return true;
+  }
+
+  order.quantity -= quantity;
+  order.level->total_quantity -= quantity;
+  depth_changed(order.side, *order.level);
+  return true;
+}
+
+std::optional<Price> OrderBook::best_bid() const {
+  if (bids_.empty()) {
+    return std::nullopt;
+  }
+  return bids_.best()->price;
+}
+
+std::optional<Price> OrderBook::best_ask() const {
+  if (asks_.empty()) {
+    return std::nullopt;
+  }
+  return asks_.best()->price;
+}
+
+uint64_t OrderBook::volume_at(Side side, Price price) const {
+  const PriceLevel *level =
+      side == Side::Buy ? bids_.find(price) : asks_.find(price);
+  return level == nullptr ? 0 : level->total_quantity;
+}
+
+const Order *OrderBook::find_order(OrderID id) const {
+  auto it = order_index_.find(id);
+  return it == order_index_.end() ? nullptr : &*it;
+}
+
+Order *OrderBook::allocate_order() { return order_pool_.construct(); }
+
+void OrderBook::free_order(Order *order) { order_pool_.destroy(order); }
+
+PriceLevel *OrderBook::allocate_level(Price price) {
+  PriceLevel *level = level_pool_.construct();
+  if (level != nullptr) {
+    level->price = price;
+  }
+  return level;
+}
+
+void OrderBook::free_level(PriceLevel *level) { level_pool_.destroy(level); }
+
+bool OrderBook::rest_order(OrderID id, Side side, Price price,
+                           Quantity quantity, TimeStamp ts) {
+  Order *order = allocate_order();
+  if (order == nullptr) {
+    return false;
+  }
+
+  PriceLevel *level = side == Side::Buy ? bids_.find(price) : asks_.find(price);
+  if (level == nullptr && (level = allocate_level(price)) != nullptr) {
+    if (side == Side::Buy) {
+      bids_.insert(level);
+    } else {
+      asks_.insert(level);
+    }
+  }
+
+  if (level == nullptr) {
+    free_order(order);
+    return false;
+  }
+
+  order->order_id = id;
+  order->price = price;
+  order->quantity = quantity;
+  order->side = side;
+  order->timestamp = ts;
+  order->level = level;
+
+  level->orders.push_back(*order);
+  level->total_quantity += quantity;
+  order_index_.insert(*order);
+  depth_changed(side, *level);
+  return true;
+}
+
+void OrderBook::remove_order(Order &order) {
+  PriceLevel *level = order.level;
+
+  level->orders.erase(level->orders.iterator_to(order));
+  level->total_quantity -= order.quantity;
+  order_index_.erase(order_index_.iterator_to(order));
+
+  if (level->orders.empty()) {
+    if (order.side == Side::Buy) {
+      bids_.erase(level);
+    } else {
+      asks_.erase(level);
+    }
+    depth_removed(order.side, level->price);
+    free_level(level);
+  } else {
+    depth_changed(order.side, *level);
+  }
+
+  free_order(&order);
+}
+
+} // namespace lats::lob
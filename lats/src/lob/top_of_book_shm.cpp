@@ -0,0 +1,84 @@
+#include "lob/top_of_book_shm.hpp"
+
+#include "lob/order_book.hpp"
+
+#include <stdexcept>
+
+namespace lats::lob {
+
+TopOfBookPublisher::TopOfBookPublisher(const std::string &name,
+                                       uint32_t symbol_count, uint32_t depth)
+    : symbol_count_(symbol_count), depth_(depth),
+      entry_size_(detail::tob_entry_size(depth)) {
+  if (symbol_count == 0) {
+    throw std::invalid_argument("symbol count must be positive");
+  }
+  if (depth == 0 || depth > TOB_MAX_DEPTH) {
+    throw std::invalid_argument("depth must be between 1 and " +
+                                std::to_string(TOB_MAX_DEPTH));
+  }
+
+  region_ = core::ShmRegion::create(
+      name, sizeof(detail::TobShmHeader) + symbol_count * entry_size_);
+  auto *base = static_cast<char *>(region_.data());
+  entries_ = base + sizeof(detail::TobShmHeader);
+
+  // create() 保證內容為 0，所有 entry 的版本都是 0 (尚未發布)
+  auto *header = reinterpret_cast<detail::TobShmHeader *>(base);
+  header->layout_version = detail::TOB_LAYOUT_VERSION;
+  header->symbol_count = symbol_count;
+  header->depth = depth;
+  header->entry_size = static_cast<uint32_t>(entry_size_);
+  header->magic.store(detail::TOB_MAGIC, std::memory_order_release);
+}
+
+bool TopOfBookPublisher::publish(uint32_t symbol, const OrderBook &book,
+                                 TimeStamp ts) {
+  BookLevel bids[TOB_MAX_DEPTH];
+  BookLevel asks[TOB_MAX_DEPTH];
+  uint32_t bid_count = 0;
+  uint32_t ask_count = 0;
+
+  book.bids().for_each([&](const PriceLevel &level) {
+    bids[bid_count++] = {level.price, level.total_quantity};
+    return bid_count < depth_;
+  });
+  book.asks().for_each([&](const PriceLevel &level) {
+    asks[ask_count++] = {level.price, level.total_quantity};
+    return ask_count < depth_;
+  });
+
+  return publish(symbol, bids, bid_count, asks, ask_count, ts);
+}
+
+TopOfBookReader::TopOfBookReader(const std::string &name)
+    : region_(core::ShmRegion::open(name)) {
+  if (region_.size() < sizeof(detail::TobShmHeader)) {
+    throw std::runtime_error("shared memory " + name + " is too small");
+  }
+
+  const auto *base = static_cast<const char *>(region_.data());
+  const auto *header = reinterpret_cast<const detail::TobShmHeader *>(base);
+  if (header->magic.load(std::memory_order_acquire) != detail::TOB_MAGIC) {
+    throw std::runtime_error("shared memory " + name +
+                             " is not an initialized top-of-book segment");
+  }
+  if (header->layout_version != detail::TOB_LAYOUT_VERSION) {
+    throw std::runtime_error("unsupported top-of-book layout version " +
+                             std::to_string(header->layout_version));
+  }
+
+  symbol_count_ = header->symbol_count;
+  depth_ = header->depth;
+  entry_size_ = header->entry_size;
+  if (depth_ == 0 || depth_ > TOB_MAX_DEPTH ||
+      entry_size_ != detail::tob_entry_size(depth_) ||
+      region_.size() <
+          sizeof(detail::TobShmHeader) + symbol_count_ * entry_size_) {
+    throw std::runtime_error("shared memory " + name +
+                             " has an inconsistent top-of-book header");
+  }
+  entries_ = base + sizeof(detail::TobShmHeader);
+}
+
+} // namespace lats::lob
@@ -0,0 +1,160 @@
+#include "core/disruptor.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace lats::core::test {
+using namespace lats::core;
+
+TEST(DisruptorTest, EveryConsumerSeesEveryMessage) {
+  Disruptor<int, 8> ring;
+  const auto a = ring.add_consumer();
+  const auto b = ring.add_consumer();
+
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_TRUE(ring.try_publish(i));
+  }
+
+  std::vector<int> seen_a;
+  std::vector<int> seen_b;
+  EXPECT_EQ(ring.poll(a, [&](const int &v, uint64_t) { seen_a.push_back(v); }),
+            5u);
+  EXPECT_EQ(ring.poll(b, [&](const int &v, uint64_t) { seen_b.push_back(v); },
+                      2),
+            2u);
+  EXPECT_EQ(ring.poll(b, [&](const int &v, uint64_t) { seen_b.push_back(v); }),
+            3u);
+  EXPECT_EQ(ring.poll(a, [](const int &, uint64_t) {}), 0u);
+
+  const std::vector<int> expected{0, 1, 2, 3, 4};
+  EXPECT_EQ(seen_a, expected);
+  EXPECT_EQ(seen_b, expected);
+  EXPECT_EQ(ring.cursor(), 5u);
+  EXPECT_EQ(ring.consumer_cursor(a), 5u);
+}
+
+TEST(DisruptorTest, SlowestConsumerGatesProducer) {
+  Disruptor<int, 4> ring;
+  const auto fast = ring.add_consumer();
+  const auto slow = ring.add_consumer();
+
+  // 與 SPSCQueue 不同，Capacity 個位置全部可用
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_TRUE(ring.try_publish(i));
+  }
+  ring.poll(fast, [](const int &, uint64_t) {});
+  EXPECT_FALSE(ring.try_publish(4));
+  EXPECT_EQ(ring.try_claim(), nullptr);
+
+  ring.poll(slow, [](const int &, uint64_t) {}, 1);
+  EXPECT_TRUE(ring.try_publish(4));
+  EXPECT_FALSE(ring.try_publish(5));
+}
+
+TEST(DisruptorTest, DependentConsumerWaitsForUpstream) {
+  Disruptor<int, 8> ring;
+  const auto builder = ring.add_consumer();
+  const auto logger = ring.add_consumer({builder});
+
+  ring.try_publish(1);
+  ring.try_publish(2);
+  EXPECT_EQ(ring.poll(logger, [](const int &, uint64_t) {}), 0u);
+
+  ring.poll(builder, [](const int &, uint64_t) {}, 1);
+  std::vector<uint64_t> sequences;
+  ring.poll(logger,
+            [&](const int &, uint64_t seq) { sequences.push_back(seq); });
+  EXPECT_EQ(sequences, std::vector<uint64_t>{0});
+}
+
+TEST(DisruptorTest, InvalidConsumers) {
+  Disruptor<int, 8, 2> ring;
+  EXPECT_THROW(ring.add_consumer({0}), std::invalid_argument);
+  ring.add_consumer();
+  ring.add_consumer({0});
+  EXPECT_THROW(ring.add_consumer(), std::invalid_argument);
+}
+
+// 依賴清單不合法時整份拒絕，不影響下一次註冊
+TEST(DisruptorTest, InvalidDependenciesLeaveNoState) {
+  Disruptor<int, 8, 3> ring;
+  const auto builder = ring.add_consumer();
+  EXPECT_THROW(ring.add_consumer({0, 0, 0, 0, 0, 0, 0, 0, 0}),
+               std::invalid_argument);
+  EXPECT_THROW(ring.add_consumer({builder, 5}), std::invalid_argument);
+  EXPECT_EQ(ring.consumer_count(), 1u);
+
+  // 沒有依賴：不必等 builder
+  const auto strategy = ring.add_consumer();
+  ring.try_publish(1);
+  EXPECT_EQ(ring.poll(strategy, [](const int &, uint64_t) {}), 1u);
+}
+
+TEST(DisruptorTest, NoConsumersNeverBlocks) {
+  Disruptor<int, 4> ring;
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_TRUE(ring.try_publish(i));
+  }
+}
+
+// book builder -> logger 依賴鏈，加上一個獨立的策略消費者
+TEST(DisruptorTest, ConcurrentPipeline) {
+  constexpr uint64_t NUM_ITEMS = 200000;
+  Disruptor<uint64_t, 256> ring;
+  const auto builder = ring.add_consumer();
+  const auto logger = ring.add_consumer({builder});
+  const auto strategy = ring.add_consumer();
+
+  std::atomic<uint64_t> builder_done{0};
+  std::atomic<bool> ordered{true};
+  std::atomic<bool> overtook{false};
+
+  auto run = [&](Disruptor<uint64_t, 256>::ConsumerId id) {
+    uint64_t expected = 0;
+    while (expected < NUM_ITEMS) {
+      const size_t n = ring.poll(id, [&](const uint64_t &value,
+                                         uint64_t seq) {
+        if (value != expected || seq != expected) {
+          ordered = false;
+        }
+        if (id == logger &&
+            seq >= builder_done.load(std::memory_order_acquire)) {
+          overtook = true;
+        }
+        ++expected;
+        if (id == builder) {
+          builder_done.store(expected, std::memory_order_release);
+        }
+      });
+      if (n == 0) {
+        std::this_thread::yield();
+      }
+    }
+  };
+
+  std::vector<std::thread> consumers;
+  consumers.emplace_back(run, builder);
+  consumers.emplace_back(run, logger);
+  consumers.emplace_back(run, strategy);
+
+  for (uint64_t i = 0; i < NUM_ITEMS;) {
+    if (ring.try_publish(i)) {
+      ++i;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  for (auto &t : consumers) {
+    t.join();
+  }
+
+  EXPECT_TRUE(ordered);
+  EXPECT_FALSE(overtook);
+  EXPECT_EQ(ring.consumer_cursor(logger), NUM_ITEMS);
+}
+
+} // namespace lats::core::test
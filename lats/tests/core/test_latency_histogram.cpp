@@ -0,0 +1,136 @@
+#include "core/latency_histogram.hpp"
+#include "core/latency_stats.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace lats::core::test {
+using namespace lats::core;
+
+// 小於 2 * SUB_BUCKET_COUNT 的值各自獨佔一個 bucket
+TEST(LatencyHistogramTest, SmallValuesAreExact) {
+  for (uint64_t v = 0; v < 2 * LatencyHistogram::SUB_BUCKET_COUNT; ++v) {
+    size_t index = LatencyHistogram::bucket_index(v);
+    EXPECT_EQ(LatencyHistogram::bucket_lowest(index), v);
+    EXPECT_EQ(LatencyHistogram::bucket_highest(index), v);
+  }
+}
+
+// 每個值都落在自己 bucket 的範圍內，且 bucket 寬度不超過相對誤差上限
+TEST(LatencyHistogramTest, BucketBoundsCoverValue) {
+  std::mt19937_64 rng(7);
+  for (int i = 0; i < 100000; ++i) {
+    uint64_t v = rng() >> (rng() % 64);
+    size_t index = LatencyHistogram::bucket_index(v);
+    ASSERT_LT(index, LatencyHistogram::BUCKET_COUNT);
+
+    uint64_t low = LatencyHistogram::bucket_lowest(index);
+    uint64_t high = LatencyHistogram::bucket_highest(index);
+    ASSERT_LE(low, v);
+    ASSERT_GE(high, v);
+    ASSERT_LE(high - low, low / LatencyHistogram::SUB_BUCKET_COUNT);
+  }
+
+  EXPECT_LT(LatencyHistogram::bucket_index(UINT64_MAX),
+            LatencyHistogram::BUCKET_COUNT);
+}
+
+TEST(LatencyHistogramTest, Empty) {
+  LatencyHistogram hist;
+
+  EXPECT_TRUE(hist.empty());
+  EXPECT_EQ(hist.count(), 0u);
+  EXPECT_THROW(hist.percentile(0.5), std::runtime_error);
+  EXPECT_THROW(hist.mean(), std::runtime_error);
+}
+
+TEST(LatencyHistogramTest, PercentileWithinRelativeError) {
+  LatencyHistogram hist;
+  std::vector<uint64_t> samples;
+  std::mt19937_64 rng(42);
+  std::lognormal_distribution<double> dist(6.0, 1.0); // 集中在數百 ns
+
+  for (int i = 0; i < 200000; ++i) {
+    uint64_t v = static_cast<uint64_t>(dist(rng));
+    hist.record(v);
+    samples.push_back(v);
+  }
+  std::sort(samples.begin(), samples.end());
+
+  EXPECT_EQ(hist.count(), samples.size());
+  EXPECT_EQ(hist.min(), samples.front());
+  EXPECT_EQ(hist.max(), samples.back());
+
+  for (double p : {0.5, 0.9, 0.99, 0.999}) {
+    uint64_t exact = samples[static_cast<size_t>(p * samples.size()) - 1];
+    uint64_t approx = hist.percentile(p);
+    EXPECT_GE(approx, exact) << "p=" << p;
+    EXPECT_LE(approx - exact, exact / LatencyHistogram::SUB_BUCKET_COUNT + 1)
+        << "p=" << p;
+  }
+  EXPECT_EQ(hist.percentile(1.0), samples.back());
+  EXPECT_THROW(hist.percentile(1.5), std::invalid_argument);
+}
+
+// 分別記錄再 merge 應與全部記錄在同一個直方圖相同
+TEST(LatencyHistogramTest, Merge) {
+  LatencyHistogram a, b, all;
+  for (uint64_t v = 1; v <= 10000; ++v) {
+    (v % 3 == 0 ? a : b).record(v * 7);
+    all.record(v * 7);
+  }
+
+  a.merge(b);
+  EXPECT_EQ(a.count(), all.count());
+  EXPECT_EQ(a.min(), all.min());
+  EXPECT_EQ(a.max(), all.max());
+  EXPECT_DOUBLE_EQ(a.mean(), all.mean());
+  for (double p : {0.0, 0.5, 0.99, 0.999, 1.0}) {
+    EXPECT_EQ(a.percentile(p), all.percentile(p));
+  }
+}
+
+TEST(LatencyHistogramTest, SnapshotAndReset) {
+  LatencyHistogram hist, interval;
+  interval.record(999999); // 會被覆蓋
+
+  for (uint64_t v = 100; v < 200; ++v) {
+    hist.record(v);
+  }
+  hist.snapshot_and_reset(interval);
+
+  EXPECT_TRUE(hist.empty());
+  EXPECT_EQ(interval.count(), 100u);
+  EXPECT_EQ(interval.min(), 100u);
+  EXPECT_EQ(interval.max(), 199u);
+
+  // 下一個區間從零開始
+  hist.record(5000);
+  EXPECT_EQ(hist.count(), 1u);
+  EXPECT_EQ(hist.min(), hist.percentile(0.5));
+}
+
+TEST(LatencyStatsTest, AccessorsUseHistogram) {
+  LatencyStats stats;
+  EXPECT_THROW(stats.min(), std::runtime_error);
+
+  for (uint64_t v = 1; v <= 1000; ++v) {
+    stats.add_sample(v);
+  }
+  stats.compute();
+
+  EXPECT_EQ(stats.count(), 1000u);
+  EXPECT_EQ(stats.min(), 1u);
+  EXPECT_EQ(stats.max(), 1000u);
+  EXPECT_DOUBLE_EQ(stats.mean(), 500.5);
+  EXPECT_NEAR(stats.p50(), 500, 4);
+  EXPECT_NEAR(stats.p99(), 990, 8);
+  EXPECT_NEAR(stats.p999(), 999, 8);
+}
+
+} // namespace lats::core::test
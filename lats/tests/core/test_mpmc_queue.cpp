@@ -0,0 +1,145 @@
+#include "core/mpmc_queue.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace lats::core::test {
+using namespace lats::core;
+
+TEST(MPMCQueueTest, BasicPushPop) {
+  MPMCQueue<int, 8> queue;
+
+  EXPECT_TRUE(queue.empty());
+  EXPECT_TRUE(queue.try_push(42));
+  EXPECT_FALSE(queue.empty());
+
+  auto result = queue.try_pop();
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(result.value(), 42);
+  EXPECT_TRUE(queue.empty());
+}
+
+// 與 SPSCQueue 不同，Capacity 個位置全部可用
+TEST(MPMCQueueTest, QueueFull) {
+  MPMCQueue<int, 4> queue;
+
+  EXPECT_TRUE(queue.try_push(1));
+  EXPECT_TRUE(queue.try_push(2));
+  EXPECT_TRUE(queue.try_push(3));
+  EXPECT_TRUE(queue.try_push(4));
+  EXPECT_FALSE(queue.try_push(5));
+
+  auto result = queue.try_pop();
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(result.value(), 1);
+  EXPECT_TRUE(queue.try_push(5));
+}
+
+TEST(MPMCQueueTest, QueueEmpty) {
+  MPMCQueue<int, 8> queue;
+
+  EXPECT_FALSE(queue.try_pop().has_value());
+}
+
+// 多輪繞圈後 sequence 仍正確
+TEST(MPMCQueueTest, FIFOOrderWrapAround) {
+  MPMCQueue<int, 8> queue;
+
+  for (int round = 0; round < 100; ++round) {
+    for (int i = 0; i < 5; ++i) {
+      EXPECT_TRUE(queue.try_push(round * 10 + i));
+    }
+    for (int i = 0; i < 5; ++i) {
+      auto result = queue.try_pop();
+      ASSERT_TRUE(result.has_value());
+      EXPECT_EQ(result.value(), round * 10 + i);
+    }
+  }
+}
+
+TEST(MPMCQueueTest, MoveSemantics) {
+  struct NonCopyable {
+    int value = 0;
+    NonCopyable() = default;
+    NonCopyable(int v) : value(v) {}
+    NonCopyable(const NonCopyable &) = delete;
+    NonCopyable &operator=(const NonCopyable &) = delete;
+    NonCopyable(NonCopyable &&) = default;
+    NonCopyable &operator=(NonCopyable &&) = default;
+  };
+
+  MPMCQueue<NonCopyable, 8> queue;
+
+  NonCopyable obj(42);
+  EXPECT_TRUE(queue.try_push(std::move(obj)));
+
+  auto result = queue.try_pop();
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(result.value().value, 42);
+}
+
+// 多生產者多消費者：每個元素恰好被消費一次，且同一生產者的元素保持順序
+TEST(MPMCQueueTest, ConcurrentProducersConsumers) {
+  constexpr int NUM_PRODUCERS = 4;
+  constexpr int NUM_CONSUMERS = 4;
+  constexpr uint64_t ITEMS_PER_PRODUCER = 100000;
+  constexpr uint64_t TOTAL = NUM_PRODUCERS * ITEMS_PER_PRODUCER;
+
+  MPMCQueue<uint64_t, 1024> queue;
+  std::atomic<uint64_t> consumed{0};
+  std::vector<std::atomic<uint32_t>> seen(TOTAL);
+  std::atomic<bool> order_ok{true};
+
+  std::vector<std::thread> consumers;
+  for (int c = 0; c < NUM_CONSUMERS; ++c) {
+    consumers.emplace_back([&]() {
+      // 高 16 bits 為生產者編號，低位為該生產者的序號
+      std::vector<int64_t> last(NUM_PRODUCERS, -1);
+      while (consumed.load(std::memory_order_relaxed) < TOTAL) {
+        auto result = queue.try_pop();
+        if (!result.has_value()) {
+          std::this_thread::yield();
+          continue;
+        }
+        const uint64_t producer = *result >> 48;
+        const uint64_t seq = *result & ((uint64_t{1} << 48) - 1);
+        if (static_cast<int64_t>(seq) <= last[producer]) {
+          order_ok = false;
+        }
+        last[producer] = static_cast<int64_t>(seq);
+        seen[producer * ITEMS_PER_PRODUCER + seq].fetch_add(1);
+        consumed.fetch_add(1, std::memory_order_relaxed);
+      }
+    });
+  }
+
+  std::vector<std::thread> producers;
+  for (uint64_t p = 0; p < NUM_PRODUCERS; ++p) {
+    producers.emplace_back([&, p]() {
+      for (uint64_t i = 0; i < ITEMS_PER_PRODUCER; ++i) {
+        while (!queue.try_push((p << 48) | i)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  for (auto &t : producers) {
+    t.join();
+  }
+  for (auto &t : consumers) {
+    t.join();
+  }
+
+  EXPECT_EQ(consumed.load(), TOTAL);
+  EXPECT_TRUE(order_ok.load());
+  for (uint64_t i = 0; i < TOTAL; ++i) {
+    ASSERT_EQ(seen[i].load(), 1u) << "item " << i;
+  }
+  EXPECT_TRUE(queue.empty());
+}
+
+} // namespace lats::core::test
@@ -0,0 +1,124 @@
+#include "core/object_pool.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <set>
+#include <vector>
+
+namespace lats::core::test {
+using namespace lats::core;
+
+namespace {
+
+struct Tracked {
+  static inline int alive = 0;
+  uint64_t value;
+
+  explicit Tracked(uint64_t v) : value(v) { ++alive; }
+  ~Tracked() { --alive; }
+};
+
+} // namespace
+
+TEST(ObjectPoolTest, ConstructDestroy) {
+  ObjectPool<Tracked> pool(4);
+
+  Tracked *obj = pool.construct(42);
+  ASSERT_NE(obj, nullptr);
+  EXPECT_EQ(obj->value, 42u);
+  EXPECT_EQ(Tracked::alive, 1);
+  EXPECT_EQ(pool.in_use(), 1u);
+  EXPECT_TRUE(pool.owns(obj));
+
+  pool.destroy(obj);
+  EXPECT_EQ(Tracked::alive, 0);
+  EXPECT_EQ(pool.in_use(), 0u);
+  EXPECT_EQ(pool.available(), 4u);
+}
+
+// 容量耗盡時回傳 nullptr，不會擴充
+TEST(ObjectPoolTest, Exhaustion) {
+  ObjectPool<uint64_t> pool(3);
+
+  std::vector<uint64_t *> objs;
+  for (int i = 0; i < 3; ++i) {
+    uint64_t *p = pool.construct(i);
+    ASSERT_NE(p, nullptr);
+    objs.push_back(p);
+  }
+  EXPECT_EQ(pool.construct(3), nullptr);
+  EXPECT_EQ(pool.available(), 0u);
+
+  pool.destroy(objs.back());
+  EXPECT_NE(pool.construct(4), nullptr);
+}
+
+// 釋放的 slot 以 LIFO 順序重用 (cache 中最熱的先用)
+TEST(ObjectPoolTest, ReusesFreedSlots) {
+  ObjectPool<uint64_t> pool(8);
+
+  uint64_t *a = pool.construct(1);
+  uint64_t *b = pool.construct(2);
+  pool.destroy(a);
+  pool.destroy(b);
+
+  EXPECT_EQ(pool.construct(3), b);
+  EXPECT_EQ(pool.construct(4), a);
+}
+
+TEST(ObjectPoolTest, DistinctAlignedSlots) {
+  struct alignas(64) CacheLine {
+    uint8_t bytes[64];
+  };
+  ObjectPool<CacheLine> pool(128);
+
+  std::set<CacheLine *> seen;
+  for (int i = 0; i < 128; ++i) {
+    CacheLine *p = pool.construct();
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % alignof(CacheLine), 0u);
+    EXPECT_TRUE(seen.insert(p).second);
+  }
+}
+
+TEST(ObjectPoolTest, OwnsRejectsForeignPointer) {
+  ObjectPool<uint64_t> pool(4);
+  uint64_t outside = 0;
+
+  EXPECT_FALSE(pool.owns(&outside));
+}
+
+// 系統沒有預留 hugepage 時應退回一般頁面而不是失敗
+TEST(ObjectPoolTest, HugepageFallback) {
+  ObjectPool<uint64_t> pool(1024, PoolOptions{true, true});
+
+  uint64_t *p = pool.construct(7);
+  ASSERT_NE(p, nullptr);
+  EXPECT_EQ(*p, 7u);
+}
+
+TEST(ObjectPoolTest, ChurnKeepsAccounting) {
+  constexpr size_t CAPACITY = 1024;
+  ObjectPool<uint64_t> pool(CAPACITY, PoolOptions{false, false});
+  std::vector<uint64_t *> live;
+
+  for (int round = 0; round < 100; ++round) {
+    while (uint64_t *p = pool.construct(round)) {
+      live.push_back(p);
+    }
+    EXPECT_EQ(live.size(), CAPACITY);
+
+    for (size_t i = 0; i < live.size(); i += 2) {
+      pool.destroy(live[i]);
+    }
+    std::vector<uint64_t *> kept;
+    for (size_t i = 1; i < live.size(); i += 2) {
+      kept.push_back(live[i]);
+    }
+    live.swap(kept);
+    EXPECT_EQ(pool.in_use(), live.size());
+  }
+}
+
+} // namespace lats::core::test
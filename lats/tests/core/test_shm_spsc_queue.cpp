@@ -0,0 +1,184 @@
+#include "core/shm_spsc_queue.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace lats::core::test {
+using namespace lats::core;
+
+namespace {
+
+struct Message {
+  uint64_t sequence;
+  uint64_t payload;
+};
+
+std::string shm_name(const char *tag) {
+  return "/lats_test_q_" + std::string(tag) + "_" + std::to_string(::getpid());
+}
+
+} // namespace
+
+TEST(ShmSPSCQueueTest, PushPopWithinProcess) {
+  auto producer = ShmSPSCQueue<Message, 8>::create(shm_name("basic"),
+                                                   ShmRole::Producer);
+  auto consumer = ShmSPSCQueue<Message, 8>::attach(shm_name("basic"),
+                                                   ShmRole::Consumer);
+
+  EXPECT_TRUE(consumer.empty());
+  EXPECT_FALSE(consumer.try_pop().has_value());
+
+  // 繞過 ring 尾端數次，順序不變
+  uint64_t next_pop = 0;
+  for (uint64_t i = 0; i < 100; ++i) {
+    ASSERT_TRUE(producer.try_push(Message{i, i * 2}));
+    if (i % 3 == 2) {
+      while (auto msg = consumer.try_pop()) {
+        ASSERT_EQ(msg->sequence, next_pop);
+        ASSERT_EQ(msg->payload, next_pop * 2);
+        ++next_pop;
+      }
+    }
+  }
+  while (auto msg = consumer.try_pop()) {
+    ASSERT_EQ(msg->sequence, next_pop++);
+  }
+  EXPECT_EQ(next_pop, 100u);
+}
+
+TEST(ShmSPSCQueueTest, FullQueue) {
+  auto producer = ShmSPSCQueue<Message, 4>::create(shm_name("full"),
+                                                   ShmRole::Producer);
+  auto consumer = ShmSPSCQueue<Message, 4>::attach(shm_name("full"),
+                                                   ShmRole::Consumer);
+
+  // 與 SPSCQueue 相同，保留一個空 slot 區分滿與空
+  EXPECT_TRUE(producer.try_push(Message{1, 0}));
+  EXPECT_TRUE(producer.try_push(Message{2, 0}));
+  EXPECT_TRUE(producer.try_push(Message{3, 0}));
+  EXPECT_FALSE(producer.try_push(Message{4, 0}));
+
+  Message *front = consumer.front();
+  ASSERT_NE(front, nullptr);
+  EXPECT_EQ(front->sequence, 1u);
+  consumer.pop();
+  EXPECT_TRUE(producer.try_push(Message{4, 0}));
+}
+
+TEST(ShmSPSCQueueTest, AttachChecksLayout) {
+  auto producer = ShmSPSCQueue<Message, 8>::create(shm_name("layout"),
+                                                   ShmRole::Producer);
+
+  EXPECT_THROW((ShmSPSCQueue<Message, 16>::attach(shm_name("layout"),
+                                                  ShmRole::Consumer)),
+               std::runtime_error);
+  EXPECT_THROW((ShmSPSCQueue<uint64_t, 8>::attach(shm_name("layout"),
+                                                  ShmRole::Consumer)),
+               std::runtime_error);
+  EXPECT_THROW((ShmSPSCQueue<Message, 8>::attach(shm_name("missing"),
+                                                 ShmRole::Consumer)),
+               std::runtime_error);
+}
+
+TEST(ShmSPSCQueueTest, RoleIsExclusive) {
+  auto producer = ShmSPSCQueue<Message, 8>::create(shm_name("role"),
+                                                   ShmRole::Producer);
+  EXPECT_THROW((ShmSPSCQueue<Message, 8>::attach(shm_name("role"),
+                                                 ShmRole::Producer)),
+               std::runtime_error);
+
+  {
+    auto consumer = ShmSPSCQueue<Message, 8>::attach(shm_name("role"),
+                                                     ShmRole::Consumer);
+    EXPECT_EQ(producer.peer_state(), PeerState::Alive);
+    EXPECT_EQ(consumer.peer_state(), PeerState::Alive);
+  }
+  // 解構時 detach，角色可以重新附加
+  EXPECT_EQ(producer.peer_state(), PeerState::NotAttached);
+  auto consumer = ShmSPSCQueue<Message, 8>::attach(shm_name("role"),
+                                                   ShmRole::Consumer);
+  EXPECT_EQ(producer.peer_state(), PeerState::Alive);
+}
+
+TEST(ShmSPSCQueueTest, DetectsDeadPeer) {
+  const std::string name = shm_name("dead");
+  auto producer = ShmSPSCQueue<Message, 8>::create(name, ShmRole::Producer);
+
+  const pid_t child = ::fork();
+  ASSERT_GE(child, 0);
+  if (child == 0) {
+    // 附加後不 detach 直接結束，模擬 crash
+    try {
+      auto consumer = ShmSPSCQueue<Message, 8>::attach(name, ShmRole::Consumer);
+      ::_exit(0);
+    } catch (...) {
+      ::_exit(1);
+    }
+  }
+  int status = 0;
+  ASSERT_EQ(::waitpid(child, &status, 0), child);
+  ASSERT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+  EXPECT_EQ(producer.peer_state(), PeerState::Dead);
+  // 新的 consumer 可以接手
+  auto consumer = ShmSPSCQueue<Message, 8>::attach(name, ShmRole::Consumer);
+  EXPECT_EQ(producer.peer_state(), PeerState::Alive);
+}
+
+TEST(ShmSPSCQueueTest, CrossProcessTransfer) {
+  constexpr uint64_t NUM_ITEMS = 100000;
+  const std::string name = shm_name("xproc");
+  auto consumer = ShmSPSCQueue<Message, 1024>::create(name, ShmRole::Consumer);
+
+  const pid_t child = ::fork();
+  ASSERT_GE(child, 0);
+  if (child == 0) {
+    try {
+      auto producer =
+          ShmSPSCQueue<Message, 1024>::attach(name, ShmRole::Producer);
+      for (uint64_t i = 0; i < NUM_ITEMS;) {
+        if (producer.try_push(Message{i, ~i})) {
+          ++i;
+        } else {
+          ::sched_yield();
+        }
+      }
+      producer.detach();
+      ::_exit(0);
+    } catch (...) {
+      ::_exit(1);
+    }
+  }
+
+  uint64_t expected = 0;
+  bool in_order = true;
+  int status = 0;
+  bool reaped = false;
+  while (expected < NUM_ITEMS) {
+    if (auto msg = consumer.try_pop()) {
+      in_order &= msg->sequence == expected && msg->payload == ~expected;
+      ++expected;
+    } else if (reaped) {
+      break; // 子行程已結束且 ring 已空
+    } else {
+      // 還沒被回收的子行程是 zombie，kill(pid, 0) 仍會成功，所以直接 waitpid
+      reaped = ::waitpid(child, &status, WNOHANG) == child;
+      ::sched_yield();
+    }
+  }
+
+  if (!reaped) {
+    ASSERT_EQ(::waitpid(child, &status, 0), child);
+  }
+  EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+  EXPECT_EQ(expected, NUM_ITEMS);
+  EXPECT_TRUE(in_order);
+  EXPECT_TRUE(consumer.empty());
+}
+
+} // namespace lats::core::test
@@ -152,6 +152,129 @@ TEST(SPSCQueueTest, DifferentCapacities) {
   EXPECT_TRUE(q4.empty());
   EXPECT_TRUE(q1024.empty());
 }
+TEST(SPSCQueueTest, Emplace) {
+  struct Point {
+    int x = 0;
+    int y = 0;
+    Point() = default;
+    Point(int a, int b) noexcept : x(a), y(b) {}
+  };
+
+  SPSCQueue<Point, 4> queue;
+  EXPECT_TRUE(queue.emplace(1, 2));
+  EXPECT_TRUE(queue.emplace(3, 4));
+  EXPECT_TRUE(queue.emplace(5, 6));
+  EXPECT_FALSE(queue.emplace(7, 8));
+
+  auto result = queue.try_pop();
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(result->x, 1);
+  EXPECT_EQ(result->y, 2);
+}
+
+// 批次寫入/讀出：空間不足時只處理部分
+TEST(SPSCQueueTest, BatchPushPop) {
+  SPSCQueue<int, 8> queue;
+  int input[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+
+  EXPECT_EQ(queue.try_push_n(input, 10), 7u); // 可用 7 個位置
+
+  int output[10] = {};
+  EXPECT_EQ(queue.try_pop_n(output, 3), 3u);
+  EXPECT_EQ(output[0], 0);
+  EXPECT_EQ(output[2], 2);
+
+  // 繞圈寫入
+  EXPECT_EQ(queue.try_push_n(input + 7, 3), 3u);
+  EXPECT_EQ(queue.try_pop_n(output, 10), 7u);
+  for (int i = 0; i < 7; ++i) {
+    EXPECT_EQ(output[i], i + 3);
+  }
+  EXPECT_EQ(queue.try_pop_n(output, 10), 0u);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(SPSCQueueTest, FrontPop) {
+  SPSCQueue<int, 4> queue;
+
+  EXPECT_EQ(queue.front(), nullptr);
+  queue.try_push(1);
+  queue.try_push(2);
+
+  int *front = queue.front();
+  ASSERT_NE(front, nullptr);
+  EXPECT_EQ(*front, 1);
+  EXPECT_EQ(queue.front(), front); // 未 pop 前重複取得同一個元素
+  queue.pop();
+
+  ASSERT_NE(queue.front(), nullptr);
+  EXPECT_EQ(*queue.front(), 2);
+  queue.pop();
+  EXPECT_EQ(queue.front(), nullptr);
+}
+
+TEST(SPSCQueueTest, AllocPublish) {
+  SPSCQueue<int, 4> queue;
+
+  for (int i = 0; i < 3; ++i) {
+    int *slot = queue.alloc();
+    ASSERT_NE(slot, nullptr);
+    *slot = i * 10;
+    queue.publish();
+  }
+  EXPECT_EQ(queue.alloc(), nullptr);
+
+  for (int i = 0; i < 3; ++i) {
+    auto result = queue.try_pop();
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result.value(), i * 10);
+  }
+}
+
+// 批次 API 與 claim/commit API 的併發正確性
+TEST(SPSCQueueTest, ConcurrentBatchAndInPlace) {
+  constexpr uint64_t NUM_ITEMS = 1000000;
+  SPSCQueue<uint64_t, 1024> queue;
+
+  std::thread consumer([&]() {
+    uint64_t expected = 0;
+    uint64_t buffer[64];
+    while (expected < NUM_ITEMS) {
+      // 交替使用批次讀出與原地讀取
+      if (expected % 2 == 0) {
+        size_t n = queue.try_pop_n(buffer, 64);
+        for (size_t i = 0; i < n; ++i) {
+          ASSERT_EQ(buffer[i], expected++);
+        }
+      } else if (uint64_t *item = queue.front()) {
+        ASSERT_EQ(*item, expected++);
+        queue.pop();
+      }
+    }
+  });
+
+  std::thread producer([&]() {
+    uint64_t next = 0;
+    uint64_t buffer[32];
+    while (next < NUM_ITEMS) {
+      if (next % 3 == 0) {
+        size_t n = 0;
+        for (; n < 32 && next + n < NUM_ITEMS; ++n) {
+          buffer[n] = next + n;
+        }
+        next += queue.try_push_n(buffer, n);
+      } else if (uint64_t *slot = queue.alloc()) {
+        *slot = next++;
+        queue.publish();
+      }
+    }
+  });
+
+  producer.join();
+  consumer.join();
+  EXPECT_TRUE(queue.empty());
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,126 @@
+#include "core/trace_recorder.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+namespace lats::core::test {
+using namespace lats::core;
+
+namespace {
+
+std::string dump_path(const char *tag) {
+  return "/tmp/lats_test_trace_" + std::string(tag) + "_" +
+         std::to_string(::getpid()) + ".bin";
+}
+
+uint64_t ns_to_cycles(uint64_t ns) {
+  return static_cast<uint64_t>(static_cast<double>(ns) *
+                               TscClock::frequency_ghz());
+}
+
+} // namespace
+
+TEST(TraceRecorderTest, InvalidConfig) {
+  EXPECT_THROW(TraceRecorder(dump_path("bad"), {}), std::invalid_argument);
+  EXPECT_THROW(TraceRecorder(dump_path("bad"),
+                             {std::string(TRACE_STAGE_NAME_SIZE, 'x')}),
+               std::invalid_argument);
+  EXPECT_THROW(TraceRecorder("/nonexistent/dir/trace.bin", {"a"}),
+               std::runtime_error);
+}
+
+TEST(TraceRecorderTest, UnregisteredThreadIsNoop) {
+  EXPECT_FALSE(tracing_enabled());
+  trace(0, 1); // 不應 crash
+  trace(0, 1, 100);
+}
+
+// 兩個線程各記錄一段 stage，離線分析要依 sequence 串起來
+TEST(TraceRecorderTest, PerStageLatencyAcrossThreads) {
+  // 每個 ring 容得下全部記錄，不受 drainer 排程影響
+  constexpr uint64_t NUM_SEQUENCES = detail::TraceRing::CAPACITY / 2 - 1;
+  const std::string path = dump_path("stages");
+  {
+    TraceRecorder recorder(path, {"recv", "parse", "book"});
+
+    std::thread rx([&] {
+      recorder.register_thread();
+      EXPECT_TRUE(tracing_enabled());
+      for (uint64_t seq = 0; seq < NUM_SEQUENCES; ++seq) {
+        const uint64_t base = 1'000'000'000 + seq * ns_to_cycles(10'000);
+        trace(0, seq, base);
+      }
+    });
+    std::thread worker([&] {
+      recorder.register_thread();
+      for (uint64_t seq = 0; seq < NUM_SEQUENCES; ++seq) {
+        const uint64_t base = 1'000'000'000 + seq * ns_to_cycles(10'000);
+        trace(1, seq, base + ns_to_cycles(1'000));
+        trace(2, seq, base + ns_to_cycles(3'000));
+      }
+    });
+    rx.join();
+    worker.join();
+    recorder.stop();
+    EXPECT_EQ(recorder.dropped(), 0u);
+    EXPECT_EQ(recorder.records_written(), 3 * NUM_SEQUENCES);
+  }
+
+  const TraceReport report = load_trace(path);
+  std::remove(path.c_str());
+
+  EXPECT_EQ(report.records, 3 * NUM_SEQUENCES);
+  EXPECT_EQ(report.dropped, 0u);
+  EXPECT_EQ(report.threads, 2u);
+  ASSERT_EQ(report.stage_names.size(), 3u);
+  EXPECT_EQ(report.stage_names[1], "parse");
+
+  EXPECT_EQ(report.stage_latency[0].count(), 0u); // 第一個 stage 沒有前一段
+  ASSERT_EQ(report.stage_latency[1].count(), NUM_SEQUENCES);
+  ASSERT_EQ(report.stage_latency[2].count(), NUM_SEQUENCES);
+  EXPECT_NEAR(static_cast<double>(report.stage_latency[1].p50()), 1000.0, 20.0);
+  EXPECT_NEAR(static_cast<double>(report.stage_latency[2].p50()), 2000.0, 30.0);
+  EXPECT_NEAR(static_cast<double>(report.end_to_end.p99()), 3000.0, 40.0);
+}
+
+TEST(TraceRecorderTest, FullRingDropsInsteadOfBlocking) {
+  constexpr uint64_t NUM_RECORDS = detail::TraceRing::CAPACITY * 4;
+  const std::string path = dump_path("full");
+  {
+    // drainer 很少醒來，ring 一定會滿
+    TraceRecorder recorder(path, {"a"}, std::chrono::milliseconds(10000));
+    std::thread t([&] {
+      recorder.register_thread();
+      for (uint64_t i = 0; i < NUM_RECORDS; ++i) {
+        trace(0, i);
+      }
+    });
+    t.join();
+    recorder.stop();
+    EXPECT_GT(recorder.dropped(), 0u);
+    EXPECT_EQ(recorder.records_written() + recorder.dropped(), NUM_RECORDS);
+  }
+  const TraceReport report = load_trace(path);
+  std::remove(path.c_str());
+  EXPECT_EQ(report.records + report.dropped, NUM_RECORDS);
+}
+
+TEST(TraceRecorderTest, RejectsForeignFile) {
+  const std::string path = dump_path("foreign");
+  std::FILE *file = std::fopen(path.c_str(), "wb");
+  ASSERT_NE(file, nullptr);
+  std::fputs("not a trace", file);
+  std::fclose(file);
+  EXPECT_THROW(load_trace(path), std::runtime_error);
+  std::remove(path.c_str());
+  EXPECT_THROW(load_trace(path), std::runtime_error);
+}
+
+} // namespace lats::core::test
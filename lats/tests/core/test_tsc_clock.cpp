@@ -0,0 +1,153 @@
+#include "core/tsc_clock.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <cstdlib>
+#include <sched.h>
+#include <stdexcept>
+#include <thread>
+
+namespace lats::core::test {
+using namespace lats::core;
+
+namespace {
+
+uint64_t clock_ns(clockid_t clock) {
+  timespec ts;
+  ::clock_gettime(clock, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000ULL +
+         static_cast<uint64_t>(ts.tv_nsec);
+}
+
+int64_t abs_diff(uint64_t a, uint64_t b) {
+  return a > b ? static_cast<int64_t>(a - b) : static_cast<int64_t>(b - a);
+}
+
+class TscClockTest : public ::testing::Test {
+protected:
+  static void SetUpTestSuite() { TscClock::calibrate(); }
+};
+
+// 換算函式丟出 std::logic_error 時以 exit code 3 結束
+template <typename F> void exit_on_logic_error(F &&f) {
+  try {
+    f();
+  } catch (const std::logic_error &) {
+    std::exit(3);
+  }
+  std::exit(0);
+}
+
+} // namespace
+
+// 換算函式不會自行校準：未校準時直接失敗。
+// threadsafe 模式在新的 process 中重新執行，不受其他測試已校準的影響
+TEST(TscClockUncalibratedTest, ConversionsFailFast) {
+  ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+  EXPECT_EXIT(exit_on_logic_error([] { TscClock::cycles_to_ns(1); }),
+              ::testing::ExitedWithCode(3), "");
+  EXPECT_EXIT(exit_on_logic_error([] { TscClock::to_epoch_ns(1); }),
+              ::testing::ExitedWithCode(3), "");
+  EXPECT_EXIT(exit_on_logic_error([] { TscClock::resync(); }),
+              ::testing::ExitedWithCode(3), "");
+}
+
+TEST_F(TscClockTest, Features) {
+  const TscFeatures &features = TscClock::features();
+  EXPECT_TRUE(features.tsc);
+  EXPECT_TRUE(features.rdtscp);
+  // invariant 取決於硬體/虛擬機，只確認兩次偵測一致
+  EXPECT_EQ(features.invariant, detect_tsc_features().invariant);
+}
+
+// 沒有 invariant 位元時預設照常校準，要求 invariant 時才拒絕
+TEST_F(TscClockTest, RequireInvariantIsOptIn) {
+  // 與預設相同的取樣，不影響後面測試的精度
+  const auto interval = std::chrono::milliseconds(20);
+  if (TscClock::features().invariant) {
+    EXPECT_NO_THROW(TscClock::calibrate(5, interval, true));
+  } else {
+    EXPECT_THROW(TscClock::calibrate(5, interval, true), std::runtime_error);
+    EXPECT_NO_THROW(TscClock::calibrate(5, interval));
+  }
+  EXPECT_TRUE(TscClock::calibrated());
+}
+
+TEST_F(TscClockTest, FixedPointConversion) {
+  ASSERT_TRUE(TscClock::calibrated());
+  const double ghz = TscClock::frequency_ghz();
+  ASSERT_GT(ghz, 0.1);
+  ASSERT_LT(ghz, 10.0);
+
+  EXPECT_EQ(TscClock::cycles_to_ns(0), 0u);
+  // 一秒的 cycles 換算回來誤差在 1ns 以內
+  const auto one_second = static_cast<uint64_t>(ghz * 1e9);
+  EXPECT_LE(abs_diff(TscClock::cycles_to_ns(one_second), 1'000'000'000ULL),
+            1);
+  // 大數值不溢位 (約一天)
+  const uint64_t day = one_second * 86400;
+  EXPECT_LE(abs_diff(TscClock::cycles_to_ns(day), 86400'000'000'000ULL),
+            86400);
+}
+
+TEST_F(TscClockTest, ElapsedMatchesMonotonicRaw) {
+  const uint64_t raw_start = clock_ns(CLOCK_MONOTONIC_RAW);
+  const uint64_t tsc_start = TscClock::now();
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  const uint64_t tsc_end = TscClock::now();
+  const uint64_t raw_end = clock_ns(CLOCK_MONOTONIC_RAW);
+
+  const uint64_t tsc_ns = TscClock::cycles_to_ns(tsc_end - tsc_start);
+  const uint64_t raw_ns = raw_end - raw_start;
+  // 虛擬機上 clock_gettime 與排程會帶來一些誤差
+  EXPECT_LE(abs_diff(tsc_ns, raw_ns), static_cast<int64_t>(raw_ns / 100));
+}
+
+TEST_F(TscClockTest, EpochTracksRealtime) {
+  const uint64_t before = clock_ns(CLOCK_REALTIME);
+  const uint64_t epoch = TscClock::now_epoch_ns();
+  const uint64_t after = clock_ns(CLOCK_REALTIME);
+  EXPECT_LE(abs_diff(epoch, before + (after - before) / 2), 1'000'000);
+
+  // 錨點之前與之後的讀值都能換算，且保持順序
+  const uint64_t tsc = TscClock::now();
+  EXPECT_LT(TscClock::to_epoch_ns(tsc - 1000), TscClock::to_epoch_ns(tsc));
+  EXPECT_LT(TscClock::to_epoch_ns(tsc), TscClock::to_epoch_ns(tsc + 1000));
+}
+
+TEST_F(TscClockTest, ResyncKeepsEpochClose) {
+  const uint64_t tsc = TscClock::now();
+  const uint64_t epoch_before = TscClock::to_epoch_ns(tsc);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+  const int64_t error = TscClock::resync();
+  EXPECT_LE(std::llabs(error), 1'000'000);
+  // 同一個讀值在 resync 前後的換算結果只差修正量
+  EXPECT_LE(abs_diff(TscClock::to_epoch_ns(tsc), epoch_before), 1'000'000);
+  EXPECT_LE(abs_diff(TscClock::now_epoch_ns(), clock_ns(CLOCK_REALTIME)),
+            1'000'000);
+}
+
+TEST_F(TscClockTest, CoreSkew) {
+  const auto skews = TscClock::measure_core_skew({::sched_getcpu(), -1});
+  ASSERT_EQ(skews.size(), 2u);
+  EXPECT_TRUE(skews[0].pinned);
+  EXPECT_LE(std::llabs(skews[0].offset_ns), 1'000'000);
+  EXPECT_FALSE(skews[1].pinned);
+}
+
+TEST_F(TscClockTest, ResyncThread) {
+  TscResyncThread resync(std::chrono::milliseconds(5));
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (resync.resyncs() < 2 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_GE(resync.resyncs(), 2u);
+  EXPECT_LE(std::llabs(resync.last_error_ns()), 1'000'000);
+}
+
+} // namespace lats::core::test
@@ -0,0 +1,183 @@
+#include "feed/feed_handler.hpp"
+#include "feed/multicast_sender.hpp"
+#include "feed/packet.hpp"
+#include "feed/sequence_tracker.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+namespace lats::feed::test {
+using namespace lats::feed;
+
+TEST(SequenceTrackerTest, InOrder) {
+  SequenceTracker tracker;
+
+  EXPECT_EQ(tracker.on_packet(1, 3), SequenceTracker::Result::InOrder);
+  EXPECT_EQ(tracker.on_packet(4, 1), SequenceTracker::Result::InOrder);
+  EXPECT_EQ(tracker.expected(), 5u);
+  EXPECT_EQ(tracker.gaps(), 0u);
+}
+
+// heartbeat 的 message_count 為 0，不推進序號
+TEST(SequenceTrackerTest, Heartbeat) {
+  SequenceTracker tracker(10);
+
+  EXPECT_EQ(tracker.on_packet(10, 0), SequenceTracker::Result::InOrder);
+  EXPECT_EQ(tracker.on_packet(10, 2), SequenceTracker::Result::InOrder);
+  EXPECT_EQ(tracker.expected(), 12u);
+}
+
+TEST(SequenceTrackerTest, GapAndDuplicate) {
+  SequenceTracker tracker;
+
+  EXPECT_EQ(tracker.on_packet(1, 2), SequenceTracker::Result::InOrder);
+  EXPECT_EQ(tracker.on_packet(6, 1), SequenceTracker::Result::Gap);
+  EXPECT_EQ(tracker.gaps(), 1u);
+  EXPECT_EQ(tracker.missed(), 3u); // 3, 4, 5
+  EXPECT_EQ(tracker.expected(), 7u);
+
+  // 遲到的封包不會讓序號倒退
+  EXPECT_EQ(tracker.on_packet(3, 3), SequenceTracker::Result::Duplicate);
+  EXPECT_EQ(tracker.on_packet(6, 1), SequenceTracker::Result::Duplicate);
+  EXPECT_EQ(tracker.duplicates(), 2u);
+  EXPECT_EQ(tracker.expected(), 7u);
+
+  EXPECT_EQ(tracker.on_packet(7, 1), SequenceTracker::Result::InOrder);
+}
+
+// 重送封包與已處理的部分重疊時，只交出新的訊息
+TEST(SequenceTrackerTest, PartialOverlap) {
+  SequenceTracker tracker;
+
+  EXPECT_EQ(tracker.on_packet(1, 4), SequenceTracker::Result::InOrder);
+  EXPECT_EQ(tracker.first_new(), 0u);
+
+  // 3..8：3, 4 已處理，5..8 是新的
+  EXPECT_EQ(tracker.on_packet(3, 6), SequenceTracker::Result::Overlap);
+  EXPECT_EQ(tracker.first_new(), 2u);
+  EXPECT_EQ(tracker.expected(), 9u);
+  EXPECT_EQ(tracker.overlaps(), 1u);
+  EXPECT_EQ(tracker.duplicates(), 0u);
+
+  EXPECT_EQ(tracker.on_packet(9, 1), SequenceTracker::Result::InOrder);
+  EXPECT_EQ(tracker.first_new(), 0u);
+  // 結束位置剛好等於 expected 時仍是完整的重複
+  EXPECT_EQ(tracker.on_packet(7, 3), SequenceTracker::Result::Duplicate);
+  EXPECT_EQ(tracker.expected(), 10u);
+}
+
+// end-of-session 的 message_count 為 0xFFFF，不能當成訊息數推進序號
+TEST(SequenceTrackerTest, EndOfSession) {
+  SequenceTracker tracker;
+
+  EXPECT_EQ(tracker.on_packet(1, 3), SequenceTracker::Result::InOrder);
+  EXPECT_EQ(tracker.on_packet(4, MoldUDP64Header::END_OF_SESSION),
+            SequenceTracker::Result::EndOfSession);
+  EXPECT_TRUE(tracker.ended());
+  EXPECT_EQ(tracker.expected(), 4u);
+  EXPECT_EQ(tracker.gaps(), 0u);
+
+  // 結束前漏掉的訊息仍算遺失
+  SequenceTracker late;
+  EXPECT_EQ(late.on_packet(1, 1), SequenceTracker::Result::InOrder);
+  EXPECT_EQ(late.on_packet(5, MoldUDP64Header::END_OF_SESSION),
+            SequenceTracker::Result::EndOfSession);
+  EXPECT_EQ(late.gaps(), 1u);
+  EXPECT_EQ(late.missed(), 3u);
+  EXPECT_EQ(late.expected(), 5u);
+}
+
+TEST(MoldUDP64HeaderTest, EncodeDecode) {
+  MoldUDP64Header header{};
+  std::memcpy(header.session, "SESSION001", MoldUDP64Header::SESSION_SIZE);
+  header.sequence = 0x0102030405060708ULL;
+  header.message_count = 0x0A0B;
+
+  uint8_t buffer[MoldUDP64Header::SIZE];
+  header.encode(buffer);
+  EXPECT_EQ(buffer[10], 0x01); // big-endian
+  EXPECT_EQ(buffer[17], 0x08);
+  EXPECT_EQ(buffer[18], 0x0A);
+
+  MoldUDP64Header decoded;
+  ASSERT_TRUE(MoldUDP64Header::decode(buffer, sizeof(buffer), decoded));
+  EXPECT_EQ(std::memcmp(decoded.session, "SESSION001", 10), 0);
+  EXPECT_EQ(decoded.sequence, header.sequence);
+  EXPECT_EQ(decoded.message_count, header.message_count);
+
+  EXPECT_FALSE(MoldUDP64Header::decode(buffer, sizeof(buffer) - 1, decoded));
+}
+
+TEST(FeedHandlerTest, InvalidConfig) {
+  FeedConfig config;
+  config.group = "not-an-address";
+  EXPECT_THROW(FeedHandler handler(config), std::invalid_argument);
+}
+
+// 經由 loopback multicast 的端到端測試：掉包與重送都要被偵測到
+TEST(FeedHandlerTest, LoopbackGapDetection) {
+  FeedConfig config;
+  config.group = "239.255.0.1";
+  config.port = 40001;
+  config.interface = "127.0.0.1";
+  config.busy_poll = false;
+
+  std::unique_ptr<FeedHandler> handler;
+  std::unique_ptr<MulticastSender> sender;
+  try {
+    handler = std::make_unique<FeedHandler>(config);
+    sender = std::make_unique<MulticastSender>(config.group, config.port,
+                                               config.interface);
+  } catch (const std::runtime_error &e) {
+    GTEST_SKIP() << "multicast unavailable: " << e.what();
+  }
+
+  std::atomic<uint64_t> delivered{0};
+  handler->start([&](const RawPacket &packet) {
+    EXPECT_GE(packet.len, MoldUDP64Header::SIZE + 4);
+    delivered.fetch_add(1, std::memory_order_relaxed);
+  });
+
+  // 每個封包 2 則訊息，跳過第 50 個封包 (序號 99, 100)
+  constexpr uint64_t NUM_PACKETS = 200;
+  const uint32_t payload = 0xDEADBEEF;
+  uint64_t sent = 0;
+  for (uint64_t i = 0; i < NUM_PACKETS; ++i) {
+    if (i == 49) {
+      continue;
+    }
+    ASSERT_TRUE(sender->send_packet(1 + i * 2, 2, &payload, sizeof(payload)));
+    ++sent;
+    if (i % 20 == 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  ASSERT_TRUE(sender->send_packet(1, 2, &payload, sizeof(payload))); // 重送
+
+  const auto &counters = handler->counters();
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (counters.packets_parsed.load() + counters.duplicates.load() <
+             sent + 1 &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  handler->stop();
+
+  EXPECT_EQ(counters.packets_received.load(), sent + 1);
+  EXPECT_EQ(counters.packets_parsed.load(), sent);
+  EXPECT_EQ(delivered.load(), sent);
+  EXPECT_EQ(counters.gaps.load(), 1u);
+  EXPECT_EQ(counters.missed_messages.load(), 2u);
+  EXPECT_EQ(counters.duplicates.load(), 1u);
+  EXPECT_EQ(counters.queue_full_drops.load(), 0u);
+  EXPECT_EQ(handler->latency().count(), sent);
+}
+
+} // namespace lats::feed::test
@@ -0,0 +1,242 @@
+#include "feed/itch_book_builder.hpp"
+#include "feed/itch_parser.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace lats::feed::test {
+using namespace lats::feed;
+using namespace lats::feed::itch;
+using lob::Side;
+
+namespace {
+
+void fill_header(MessageHeader &header, char type, uint16_t locate = 1,
+                 uint64_t ts = 0) {
+  header.type = type;
+  header.stock_locate.set(locate);
+  header.tracking_number.set(0);
+  header.timestamp.set(ts);
+}
+
+AddOrder make_add(uint64_t ref, char side, uint32_t shares, uint32_t price,
+                  uint16_t locate = 1) {
+  AddOrder msg{};
+  fill_header(msg.header, AddOrder::TYPE, locate, 34200000000000ULL);
+  msg.order_ref.set(ref);
+  msg.side_indicator = side;
+  msg.shares.set(shares);
+  std::memcpy(msg.stock, "AAPL    ", 8);
+  msg.price_raw.set(price);
+  return msg;
+}
+
+// 收集所有事件，驗證 dispatch 與欄位解碼
+struct RecordingHandler : NullHandler {
+  std::vector<char> events;
+  lob::OrderID last_id = 0;
+  lob::Quantity last_qty = 0;
+  lob::Price last_price = 0;
+  Side last_side = Side::Buy;
+
+  void on_add(const AddOrder &msg) {
+    events.push_back('A');
+    last_id = msg.order_id();
+    last_side = msg.side();
+    last_qty = msg.quantity();
+    last_price = msg.price();
+  }
+  void on_executed(const OrderExecuted &msg) {
+    events.push_back('E');
+    last_id = msg.order_id();
+    last_qty = msg.quantity();
+  }
+  void on_delete(const OrderDelete &msg) {
+    events.push_back('D');
+    last_id = msg.order_id();
+  }
+  void on_trade(const Trade &msg) {
+    events.push_back('P');
+    last_price = msg.price();
+  }
+};
+
+// 以 MoldUDP64 格式串接多個訊息
+class PacketBuilder {
+public:
+  explicit PacketBuilder(uint64_t sequence) {
+    buffer_.resize(MoldUDP64Header::SIZE);
+    header_ = MoldUDP64Header{};
+    std::memcpy(header_.session, "TEST      ", MoldUDP64Header::SESSION_SIZE);
+    header_.sequence = sequence;
+  }
+
+  template <typename Msg> PacketBuilder &add(const Msg &msg) {
+    BE16 len;
+    len.set(sizeof(Msg));
+    buffer_.insert(buffer_.end(), len.bytes, len.bytes + sizeof(len));
+    const auto *bytes = reinterpret_cast<const uint8_t *>(&msg);
+    buffer_.insert(buffer_.end(), bytes, bytes + sizeof(Msg));
+    ++header_.message_count;
+    return *this;
+  }
+
+  const std::vector<uint8_t> &build() {
+    header_.encode(buffer_.data());
+    return buffer_;
+  }
+
+private:
+  MoldUDP64Header header_;
+  std::vector<uint8_t> buffer_;
+};
+
+} // namespace
+
+TEST(ItchMessagesTest, BigEndianFields) {
+  const uint8_t raw[] = {0x12, 0x34, 0x56, 0x78, 0x9A, 0xBC, 0xDE, 0xF0};
+
+  EXPECT_EQ(reinterpret_cast<const BE16 *>(raw)->value(), 0x1234);
+  EXPECT_EQ(reinterpret_cast<const BE32 *>(raw)->value(), 0x12345678u);
+  EXPECT_EQ(reinterpret_cast<const BE64 *>(raw)->value(),
+            0x123456789ABCDEF0ULL);
+  EXPECT_EQ(reinterpret_cast<const BigEndian48 *>(raw)->value(),
+            0x123456789ABCULL);
+
+  BigEndian48 ts;
+  ts.set(0x0000A1B2C3D4E5F6ULL);
+  EXPECT_EQ(ts.bytes[0], 0xA1);
+  EXPECT_EQ(ts.value(), 0xA1B2C3D4E5F6ULL);
+}
+
+// view 的欄位直接對應 lob 型別，ITCH 價格與 PRICE_SCALE 同為 4 位小數
+TEST(ItchParserTest, AddOrderMapsToLobTypes) {
+  RecordingHandler handler;
+  Parser<RecordingHandler> parser(handler);
+
+  AddOrder msg = make_add(42, 'S', 300, 1234500); // 123.45
+  ASSERT_TRUE(parser.parse_message(reinterpret_cast<const uint8_t *>(&msg),
+                                   sizeof(msg)));
+
+  ASSERT_EQ(handler.events.size(), 1u);
+  EXPECT_EQ(handler.last_id, 42u);
+  EXPECT_EQ(handler.last_side, Side::Sell);
+  EXPECT_EQ(handler.last_qty, 300u);
+  EXPECT_EQ(handler.last_price, lob::to_fixed_price(123.45));
+  EXPECT_EQ(msg.header.ts(), 34200000000000ULL);
+}
+
+// 'F' 以內含的 AddOrder 呼叫 on_add；沒有宣告的 callback 落到 NullHandler
+TEST(ItchParserTest, DispatchAndDefaults) {
+  RecordingHandler handler;
+  Parser<RecordingHandler> parser(handler);
+
+  AddOrderMPID add_mpid{};
+  add_mpid.add = make_add(7, 'B', 10, 10000);
+  add_mpid.add.header.type = AddOrderMPID::TYPE;
+  OrderCancel cancel{};
+  fill_header(cancel.header, OrderCancel::TYPE);
+  cancel.order_ref.set(7);
+  cancel.cancelled_shares.set(5);
+  OrderDelete del{};
+  fill_header(del.header, OrderDelete::TYPE);
+  del.order_ref.set(7);
+
+  PacketBuilder builder(1);
+  builder.add(add_mpid).add(cancel).add(del);
+  const auto &packet = builder.build();
+
+  EXPECT_EQ(parser.parse_packet(packet.data(), packet.size()), 3u);
+  EXPECT_EQ(handler.events, (std::vector<char>{'A', 'D'}));
+  EXPECT_EQ(parser.malformed(), 0u);
+
+  // 部分重疊的重送封包：前兩則已處理過，只分派第三則
+  handler.events.clear();
+  RawPacket raw;
+  raw.len = static_cast<uint16_t>(packet.size());
+  std::memcpy(raw.data, packet.data(), packet.size());
+  raw.first_message = 2;
+  EXPECT_EQ(parser.parse_packet(raw), 1u);
+  EXPECT_EQ(handler.events, (std::vector<char>{'D'}));
+}
+
+TEST(ItchParserTest, MalformedAndUnknown) {
+  RecordingHandler handler;
+  Parser<RecordingHandler> parser(handler);
+
+  AddOrder msg = make_add(1, 'B', 100, 10000);
+  EXPECT_FALSE(parser.parse_message(reinterpret_cast<const uint8_t *>(&msg),
+                                    sizeof(msg) - 1));
+  EXPECT_EQ(parser.malformed(), 1u);
+
+  const uint8_t system_event[12] = {'S'};
+  EXPECT_TRUE(parser.parse_message(system_event, sizeof(system_event)));
+  EXPECT_EQ(parser.skipped(), 1u);
+
+  // 封包宣稱的訊息數多於實際內容
+  PacketBuilder builder(1);
+  builder.add(msg);
+  std::vector<uint8_t> packet = builder.build();
+  packet[19] = 2;
+  EXPECT_EQ(parser.parse_packet(packet.data(), packet.size()), 1u);
+  EXPECT_EQ(parser.malformed(), 2u);
+  EXPECT_TRUE(handler.events.size() == 1u && handler.events[0] == 'A');
+}
+
+TEST(ItchBookBuilderTest, RebuildsBook) {
+  lob::OrderBook book;
+  BookBuilder builder(book, 1);
+  Parser<BookBuilder> parser(builder);
+
+  auto parse = [&parser](const auto &msg) {
+    return parser.parse_message(reinterpret_cast<const uint8_t *>(&msg),
+                                sizeof(msg));
+  };
+
+  parse(make_add(1, 'B', 100, 1000000));
+  parse(make_add(2, 'B', 200, 1000000));
+  parse(make_add(3, 'S', 50, 1010000));
+  parse(make_add(4, 'S', 50, 1010000, 2)); // 其他商品，忽略
+  EXPECT_EQ(book.order_count(), 3u);
+  EXPECT_EQ(book.best_bid(), 1000000);
+  EXPECT_EQ(book.volume_at(Side::Buy, 1000000), 300u);
+
+  OrderExecuted exec{};
+  fill_header(exec.header, OrderExecuted::TYPE);
+  exec.order_ref.set(1);
+  exec.executed_shares.set(40);
+  parse(exec);
+  EXPECT_EQ(book.find_order(1)->quantity, 60u);
+
+  OrderCancel cancel{};
+  fill_header(cancel.header, OrderCancel::TYPE);
+  cancel.order_ref.set(1);
+  cancel.cancelled_shares.set(60);
+  parse(cancel);
+  EXPECT_EQ(book.find_order(1), nullptr);
+
+  // Replace 保留方向、換新 id 與價格
+  OrderReplace replace{};
+  fill_header(replace.header, OrderReplace::TYPE);
+  replace.original_order_ref.set(2);
+  replace.new_order_ref.set(5);
+  replace.shares.set(150);
+  replace.price_raw.set(1005000);
+  parse(replace);
+  EXPECT_EQ(book.find_order(2), nullptr);
+  ASSERT_NE(book.find_order(5), nullptr);
+  EXPECT_EQ(book.find_order(5)->side, Side::Buy);
+  EXPECT_EQ(book.best_bid(), 1005000);
+
+  OrderDelete del{};
+  fill_header(del.header, OrderDelete::TYPE);
+  del.order_ref.set(3);
+  parse(del);
+  EXPECT_FALSE(book.best_ask().has_value());
+  EXPECT_EQ(book.order_count(), 1u);
+}
+
+} // namespace lats::feed::test
@@ -0,0 +1,243 @@
+#include "feed/sharded_book_pipeline.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace lats::feed::test {
+using namespace lats::feed;
+using lob::Side;
+
+namespace {
+
+// 測試用的小簿，避免每個 symbol 預先配置太多記憶體
+PipelineConfig small_config(size_t num_shards) {
+  PipelineConfig config;
+  config.num_shards = num_shards;
+  config.max_symbols = 64;
+  config.books_per_shard = 16;
+  config.book_config = {1 << 12, 1 << 8, 1, 256, {}};
+  config.busy_poll = false; // 測試機可能只有一顆核心
+  return config;
+}
+
+BookEvent make_event(BookEvent::Type type, uint16_t symbol, lob::OrderID id,
+                     lob::Quantity qty = 0, lob::Price price = 0,
+                     Side side = Side::Buy) {
+  BookEvent event;
+  event.type = type;
+  event.symbol = symbol;
+  event.order_id = id;
+  event.quantity = qty;
+  event.price = price;
+  event.side = side;
+  return event;
+}
+
+void fill_header(itch::MessageHeader &header, char type, uint16_t locate) {
+  header.type = type;
+  header.stock_locate.set(locate);
+  header.tracking_number.set(0);
+  header.timestamp.set(34200000000000ULL);
+}
+
+} // namespace
+
+TEST(ShardedBookPipelineTest, InvalidConfig) {
+  PipelineConfig config = small_config(0);
+  EXPECT_THROW(ShardedBookPipeline{config}, std::invalid_argument);
+  config = small_config(2);
+  config.max_symbols = 0;
+  EXPECT_THROW(ShardedBookPipeline{config}, std::invalid_argument);
+  config = small_config(2);
+  config.books_per_shard = 0;
+  EXPECT_THROW(ShardedBookPipeline{config}, std::invalid_argument);
+}
+
+TEST(ShardedBookPipelineTest, ShardOfIsStableAndSpread) {
+  PipelineConfig config = small_config(4);
+  config.max_symbols = 4096;
+  ShardedBookPipeline pipeline(config);
+
+  std::vector<size_t> per_shard(4, 0);
+  for (uint16_t symbol = 0; symbol < 4096; ++symbol) {
+    const size_t shard = pipeline.shard_of(symbol);
+    ASSERT_LT(shard, 4u);
+    ASSERT_EQ(shard, pipeline.shard_of(symbol));
+    ++per_shard[shard];
+  }
+  // 連續的 symbol id 應大致平均分散
+  for (size_t count : per_shard) {
+    EXPECT_GT(count, 4096u / 4 / 2);
+  }
+}
+
+TEST(ShardedBookPipelineTest, MatchesSingleThreadedBooks) {
+  constexpr uint16_t NUM_SYMBOLS = 16;
+  constexpr size_t NUM_EVENTS = 50000;
+  const PipelineConfig config = small_config(4);
+
+  // 以單線程的參考簿驗證各 shard 套用順序正確
+  std::vector<std::unique_ptr<lob::OrderBook>> reference(NUM_SYMBOLS);
+  for (auto &book : reference) {
+    book = std::make_unique<lob::OrderBook>(config.book_config);
+  }
+
+  ShardedBookPipeline pipeline(config);
+  pipeline.start();
+
+  std::mt19937_64 rng(7);
+  std::vector<std::vector<lob::OrderID>> live(NUM_SYMBOLS);
+  lob::OrderID next_id = 1;
+  for (size_t i = 0; i < NUM_EVENTS; ++i) {
+    const auto symbol = static_cast<uint16_t>(rng() % NUM_SYMBOLS);
+    auto &orders = live[symbol];
+    BookEvent event;
+    if (orders.size() < 8 || rng() % 2 == 0) {
+      const Side side = rng() % 2 == 0 ? Side::Buy : Side::Sell;
+      const lob::Price price = side == Side::Buy ? 1000 - rng() % 50
+                                                 : 1001 + rng() % 50;
+      event = make_event(BookEvent::Type::Add, symbol, next_id++,
+                         1 + rng() % 100, price, side);
+      orders.push_back(event.order_id);
+    } else {
+      const size_t pos = rng() % orders.size();
+      event = make_event(BookEvent::Type::Delete, symbol, orders[pos]);
+      orders[pos] = orders.back();
+      orders.pop_back();
+    }
+
+    lob::OrderBook &book = *reference[symbol];
+    if (event.type == BookEvent::Type::Add) {
+      book.add_order(event.order_id, event.side, event.price, event.quantity,
+                     0);
+    } else {
+      book.cancel_order(event.order_id);
+    }
+    ASSERT_TRUE(pipeline.dispatch(event));
+  }
+  pipeline.stop();
+
+  uint64_t total = 0;
+  for (size_t shard = 0; shard < pipeline.num_shards(); ++shard) {
+    total += pipeline.counters(shard).events.load();
+    EXPECT_EQ(pipeline.counters(shard).rejected.load(), 0u);
+    EXPECT_EQ(pipeline.latency(shard).count(),
+              pipeline.counters(shard).events.load());
+  }
+  EXPECT_EQ(total, NUM_EVENTS);
+
+  for (uint16_t symbol = 0; symbol < NUM_SYMBOLS; ++symbol) {
+    const lob::OrderBook *book = pipeline.book(symbol);
+    ASSERT_NE(book, nullptr);
+    EXPECT_EQ(book->order_count(), reference[symbol]->order_count());
+    EXPECT_EQ(book->best_bid(), reference[symbol]->best_bid());
+    EXPECT_EQ(book->best_ask(), reference[symbol]->best_ask());
+  }
+}
+
+TEST(ShardedBookPipelineTest, DropsOutOfRangeSymbols) {
+  ShardedBookPipeline pipeline(small_config(2));
+  EXPECT_FALSE(pipeline.dispatch(
+      make_event(BookEvent::Type::Add, 64, 1, 10, 100)));
+  EXPECT_FALSE(pipeline.try_dispatch(
+      make_event(BookEvent::Type::Add, 1000, 1, 10, 100)));
+  EXPECT_EQ(pipeline.dropped(), 2u);
+  EXPECT_EQ(pipeline.book(64), nullptr);
+}
+
+// book 用完之後新 symbol 的事件被拒絕，已綁定的 symbol 不受影響
+TEST(ShardedBookPipelineTest, RejectsSymbolsBeyondBookCapacity) {
+  PipelineConfig config = small_config(1);
+  config.books_per_shard = 2;
+  ShardedBookPipeline pipeline(config);
+  pipeline.start();
+
+  for (uint16_t symbol = 1; symbol <= 3; ++symbol) {
+    ASSERT_TRUE(pipeline.dispatch(
+        make_event(BookEvent::Type::Add, symbol, symbol, 10, 100)));
+  }
+  ASSERT_TRUE(
+      pipeline.dispatch(make_event(BookEvent::Type::Add, 1, 4, 10, 101)));
+  pipeline.stop();
+
+  EXPECT_EQ(pipeline.counters(0).events.load(), 4u);
+  EXPECT_EQ(pipeline.counters(0).rejected.load(), 1u);
+  EXPECT_EQ(pipeline.counters(0).no_book.load(), 1u);
+  ASSERT_NE(pipeline.book(1), nullptr);
+  EXPECT_EQ(pipeline.book(1)->order_count(), 2u);
+  ASSERT_NE(pipeline.book(2), nullptr);
+  EXPECT_EQ(pipeline.book(3), nullptr);
+}
+
+// worker 建立 book 失敗時 start() 收尾後丟出同一個例外
+TEST(ShardedBookPipelineTest, StartReportsBookFailure) {
+  PipelineConfig config = small_config(2);
+  config.book_config.tick_size = 0;
+  ShardedBookPipeline pipeline(config);
+  EXPECT_THROW(pipeline.start(), std::invalid_argument);
+  EXPECT_EQ(pipeline.book(1), nullptr);
+}
+
+TEST(ShardedBookPipelineTest, TryDispatchReportsFullQueue) {
+  ShardedBookPipeline pipeline(small_config(1));
+  // 沒有 start()，queue 不會被消化
+  const BookEvent event = make_event(BookEvent::Type::Add, 3, 1, 10, 100);
+  size_t accepted = 0;
+  while (pipeline.try_dispatch(event)) {
+    ++accepted;
+  }
+  EXPECT_EQ(accepted, ShardedBookPipeline::QUEUE_CAPACITY - 1);
+  EXPECT_EQ(pipeline.counters(0).queue_full.load(), 1u);
+}
+
+TEST(ShardedBookPipelineTest, ItchDispatcher) {
+  ShardedBookPipeline pipeline(small_config(3));
+  ShardedBookDispatcher dispatcher(pipeline);
+  pipeline.start();
+
+  for (uint16_t locate = 1; locate <= 3; ++locate) {
+    itch::AddOrder add{};
+    fill_header(add.header, itch::AddOrder::TYPE, locate);
+    add.order_ref.set(locate * 10);
+    add.side_indicator = 'B';
+    add.shares.set(100);
+    std::memcpy(add.stock, "TEST    ", 8);
+    add.price_raw.set(1000 + locate);
+    dispatcher.on_add(add);
+  }
+
+  itch::OrderExecuted exec{};
+  fill_header(exec.header, itch::OrderExecuted::TYPE, 1);
+  exec.order_ref.set(10);
+  exec.executed_shares.set(40);
+  dispatcher.on_executed(exec);
+
+  itch::OrderReplace replace{};
+  fill_header(replace.header, itch::OrderReplace::TYPE, 2);
+  replace.original_order_ref.set(20);
+  replace.new_order_ref.set(21);
+  replace.shares.set(50);
+  replace.price_raw.set(990);
+  dispatcher.on_replace(replace);
+
+  itch::OrderDelete del{};
+  fill_header(del.header, itch::OrderDelete::TYPE, 3);
+  del.order_ref.set(30);
+  dispatcher.on_delete(del);
+  pipeline.stop();
+
+  ASSERT_NE(pipeline.book(1), nullptr);
+  EXPECT_EQ(pipeline.book(1)->volume_at(Side::Buy, 1001), 60u);
+  ASSERT_NE(pipeline.book(2), nullptr);
+  EXPECT_EQ(pipeline.book(2)->find_order(20), nullptr);
+  EXPECT_EQ(pipeline.book(2)->best_bid(), 990);
+  ASSERT_NE(pipeline.book(3), nullptr);
+  EXPECT_EQ(pipeline.book(3)->order_count(), 0u);
+}
+
+} // namespace lats::feed::test
@@ -0,0 +1,271 @@
+#include "lob/depth_delta.hpp"
+#include "lob/l2_depth.hpp"
+#include "lob/order_book.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace lats::lob::test {
+using namespace lats::lob;
+
+namespace {
+
+constexpr size_t DEPTH = 5;
+
+BookConfig depth_config(size_t depth) {
+  BookConfig config;
+  config.max_orders = 4096;
+  config.max_levels = 1024;
+  config.ladder_slots = 256;
+  config.depth_levels = depth;
+  return config;
+}
+
+// 從 ladder 直接算出的最優 depth 檔，作為對照
+template <Side S>
+DepthLevels reference(const PriceLadder<S> &ladder, size_t depth) {
+  DepthLevels out;
+  ladder.for_each([&](const PriceLevel &level) {
+    if (out.size == depth) {
+      return false;
+    }
+    out.prices[out.size] = level.price;
+    out.quantities[out.size] = level.total_quantity;
+    out.orders[out.size] = static_cast<uint32_t>(level.orders.size());
+    ++out.size;
+    return true;
+  });
+  return out;
+}
+
+// 比較有效檔位，並確認 size 之後的欄位維持為 0
+void expect_levels_eq(const DepthLevels &actual, const DepthLevels &expected) {
+  ASSERT_EQ(actual.size, expected.size);
+  for (size_t i = 0; i < L2_MAX_DEPTH; ++i) {
+    EXPECT_EQ(actual.prices[i], expected.prices[i]) << "level " << i;
+    EXPECT_EQ(actual.quantities[i], expected.quantities[i]) << "level " << i;
+    EXPECT_EQ(actual.orders[i], expected.orders[i]) << "level " << i;
+  }
+}
+
+} // namespace
+
+TEST(L2DepthTest, RejectsTooDeep) {
+  EXPECT_THROW(L2Depth<Side::Buy>(L2_MAX_DEPTH + 1), std::invalid_argument);
+  EXPECT_THROW(OrderBook(depth_config(L2_MAX_DEPTH + 1)),
+               std::invalid_argument);
+}
+
+TEST(L2DepthTest, DisabledByDefault) {
+  OrderBook book(16, 16);
+  EXPECT_TRUE(book.add_order(1, Side::Buy, 100, 10, 0));
+  EXPECT_EQ(book.depth(Side::Buy).size, 0u);
+  EXPECT_EQ(book.depth_sequence(), 0u);
+}
+
+TEST(L2DepthTest, AggregatesQuantityAndOrders) {
+  OrderBook book(depth_config(DEPTH));
+  book.add_order(1, Side::Buy, 100, 10, 0);
+  book.add_order(2, Side::Buy, 100, 5, 0);
+  book.add_order(3, Side::Buy, 101, 7, 0);
+  book.add_order(4, Side::Sell, 103, 8, 0);
+
+  const DepthLevels &bids = book.depth(Side::Buy);
+  ASSERT_EQ(bids.size, 2u);
+  EXPECT_EQ(bids.prices[0], 101);
+  EXPECT_EQ(bids.quantities[0], 7u);
+  EXPECT_EQ(bids.orders[0], 1u);
+  EXPECT_EQ(bids.prices[1], 100);
+  EXPECT_EQ(bids.quantities[1], 15u);
+  EXPECT_EQ(bids.orders[1], 2u);
+
+  const DepthLevels &asks = book.depth(Side::Sell);
+  ASSERT_EQ(asks.size, 1u);
+  EXPECT_EQ(asks.prices[0], 103);
+
+  // 成交後檔位數量與掛單數同步減少
+  book.add_order(5, Side::Sell, 100, 12, 0);
+  ASSERT_EQ(bids.size, 1u);
+  EXPECT_EQ(bids.prices[0], 100);
+  EXPECT_EQ(bids.quantities[0], 10u);
+  EXPECT_EQ(bids.orders[0], 2u);
+}
+
+TEST(L2DepthTest, RefillsFromLadderBeyondDepth) {
+  OrderBook book(depth_config(DEPTH));
+  for (OrderID id = 1; id <= 8; ++id) {
+    book.add_order(id, Side::Sell, 100 + static_cast<Price>(id), 10, 0);
+  }
+  ASSERT_EQ(book.depth(Side::Sell).size, DEPTH);
+  EXPECT_EQ(book.depth(Side::Sell).prices[DEPTH - 1], 105);
+
+  const uint64_t sequence = book.depth_sequence();
+  // 第 depth 檔之外的變動不影響聚合
+  book.cancel_order(7);
+  EXPECT_EQ(book.depth_sequence(), sequence);
+
+  book.cancel_order(2);
+  expect_levels_eq(book.depth(Side::Sell), reference(book.asks(), DEPTH));
+  EXPECT_EQ(book.depth(Side::Sell).prices[DEPTH - 1], 106);
+  EXPECT_GT(book.depth_sequence(), sequence);
+}
+
+TEST(L2DepthTest, MatchesLadderUnderRandomFlow) {
+  OrderBook book(depth_config(DEPTH));
+  std::mt19937_64 rng(7);
+  std::vector<OrderID> live;
+  OrderID next_id = 1;
+
+  for (int step = 0; step < 20000; ++step) {
+    const int action = static_cast<int>(rng() % 10);
+    if (action < 5 || live.empty()) {
+      const Side side = rng() % 2 == 0 ? Side::Buy : Side::Sell;
+      // 兩邊價格重疊，會觸發撮合
+      const Price price = side == Side::Buy
+                              ? 100 - static_cast<Price>(rng() % 20)
+                              : 95 + static_cast<Price>(rng() % 20);
+      const auto quantity = static_cast<Quantity>(1 + rng() % 50);
+      if (book.add_order(next_id, side, price, quantity, 0)) {
+        live.push_back(next_id);
+      }
+      ++next_id;
+    } else {
+      const size_t idx = static_cast<size_t>(rng() % live.size());
+      const OrderID id = live[idx];
+      if (action < 7) {
+        book.cancel_order(id);
+      } else if (action < 9) {
+        book.execute_order(id, static_cast<Quantity>(1 + rng() % 20));
+      } else if (const Order *order = book.find_order(id)) {
+        book.modify_order(id, order->price, order->quantity / 2 + 1, 0);
+      }
+      if (book.find_order(id) == nullptr) {
+        live[idx] = live.back();
+        live.pop_back();
+      }
+    }
+
+    expect_levels_eq(book.depth(Side::Buy), reference(book.bids(), DEPTH));
+    expect_levels_eq(book.depth(Side::Sell), reference(book.asks(), DEPTH));
+    if (HasFailure()) {
+      FAIL() << "mismatch at step " << step;
+    }
+  }
+}
+
+TEST(L2DepthTest, SnapshotCopiesBothSides) {
+  OrderBook book(depth_config(DEPTH));
+  book.add_order(1, Side::Buy, 99, 10, 0);
+  book.add_order(2, Side::Sell, 101, 20, 0);
+
+  DepthSnapshot snapshot;
+  book.depth_snapshot(snapshot);
+  EXPECT_EQ(snapshot.sequence, book.depth_sequence());
+  expect_levels_eq(snapshot.bids, book.depth(Side::Buy));
+  expect_levels_eq(snapshot.asks, book.depth(Side::Sell));
+}
+
+TEST(DepthDeltaTest, FirstEncodeIsFullSnapshot) {
+  OrderBook book(depth_config(DEPTH));
+  book.add_order(1, Side::Buy, 99, 10, 0);
+  book.add_order(2, Side::Buy, 98, 10, 0);
+  book.add_order(3, Side::Sell, 101, 20, 0);
+
+  DepthSnapshot snapshot;
+  book.depth_snapshot(snapshot);
+  DepthDeltaEncoder encoder;
+  ASSERT_EQ(encoder.encode(snapshot), 3u);
+  EXPECT_EQ(encoder.updates()[0].price, 99);
+  EXPECT_EQ(encoder.updates()[0].side, Side::Buy);
+  EXPECT_EQ(encoder.updates()[2].price, 101);
+  EXPECT_EQ(encoder.updates()[2].quantity, 20u);
+
+  // 沒有變動時不輸出
+  EXPECT_EQ(encoder.encode(snapshot), 0u);
+
+  encoder.reset();
+  EXPECT_EQ(encoder.encode(snapshot), 3u);
+}
+
+TEST(DepthDeltaTest, EmitsOnlyChangedLevels) {
+  OrderBook book(depth_config(DEPTH));
+  book.add_order(1, Side::Buy, 99, 10, 0);
+  book.add_order(2, Side::Buy, 98, 10, 0);
+  book.add_order(3, Side::Sell, 101, 20, 0);
+
+  DepthSnapshot snapshot;
+  DepthDeltaEncoder encoder;
+  book.depth_snapshot(snapshot);
+  encoder.encode(snapshot);
+
+  book.execute_order(2, 4);
+  book.cancel_order(1);
+  book.depth_snapshot(snapshot);
+  ASSERT_EQ(encoder.encode(snapshot), 2u);
+
+  // 移除排在修改之前
+  const DepthUpdate &removed = encoder.updates()[0];
+  EXPECT_EQ(removed.side, Side::Buy);
+  EXPECT_EQ(removed.price, 99);
+  EXPECT_EQ(removed.quantity, 0u);
+
+  const DepthUpdate &changed = encoder.updates()[1];
+  EXPECT_EQ(changed.side, Side::Buy);
+  EXPECT_EQ(changed.price, 98);
+  EXPECT_EQ(changed.quantity, 6u);
+  EXPECT_EQ(changed.orders, 1u);
+}
+
+TEST(DepthDeltaTest, ReceiverReconstructsSnapshots) {
+  OrderBook book(depth_config(L2_MAX_DEPTH));
+  std::mt19937_64 rng(11);
+  std::vector<OrderID> live;
+  OrderID next_id = 1;
+
+  DepthDeltaEncoder encoder;
+  DepthSnapshot snapshot;
+  DepthSnapshot receiver;
+
+  for (int step = 0; step < 5000; ++step) {
+    // 每次快照之間累積數筆變動
+    for (int i = 0; i < 4; ++i) {
+      if (rng() % 3 != 0 || live.empty()) {
+        const Side side = rng() % 2 == 0 ? Side::Buy : Side::Sell;
+        const Price price = side == Side::Buy
+                                ? 100 - static_cast<Price>(rng() % 40)
+                                : 90 + static_cast<Price>(rng() % 40);
+        if (book.add_order(next_id, side, price,
+                           static_cast<Quantity>(1 + rng() % 30), 0)) {
+          live.push_back(next_id);
+        }
+        ++next_id;
+      } else {
+        const size_t idx = static_cast<size_t>(rng() % live.size());
+        book.cancel_order(live[idx]);
+        live[idx] = live.back();
+        live.pop_back();
+      }
+      live.erase(std::remove_if(live.begin(), live.end(),
+                                [&](OrderID id) {
+                                  return book.find_order(id) == nullptr;
+                                }),
+                 live.end());
+    }
+
+    book.depth_snapshot(snapshot);
+    const size_t count = encoder.encode(snapshot);
+    ASSERT_LE(count, DEPTH_MAX_UPDATES);
+    apply_depth_updates(receiver, encoder.updates(), count);
+
+    expect_levels_eq(receiver.bids, snapshot.bids);
+    expect_levels_eq(receiver.asks, snapshot.asks);
+    if (HasFailure()) {
+      FAIL() << "mismatch at step " << step;
+    }
+  }
+}
+
+} // namespace lats::lob::test
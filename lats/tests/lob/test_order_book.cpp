@@ -0,0 +1,275 @@
+#include "lob/order_book.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace lats::lob::test {
+using namespace lats::lob;
+
+namespace {
+constexpr Price px(double price) {
+  return static_cast<Price>(price * PRICE_SCALE);
+}
+} // namespace
+
+TEST(OrderBookTest, EmptyBook) {
+  OrderBook book(16, 16);
+
+  EXPECT_FALSE(book.best_bid().has_value());
+  EXPECT_FALSE(book.best_ask().has_value());
+  EXPECT_EQ(book.order_count(), 0u);
+}
+
+TEST(OrderBookTest, AddRestingOrders) {
+  OrderBook book(16, 16);
+
+  EXPECT_TRUE(book.add_order(1, Side::Buy, px(100.0), 10, 0));
+  EXPECT_TRUE(book.add_order(2, Side::Buy, px(101.0), 5, 0));
+  EXPECT_TRUE(book.add_order(3, Side::Sell, px(103.0), 7, 0));
+  EXPECT_TRUE(book.add_order(4, Side::Sell, px(102.0), 8, 0));
+
+  EXPECT_EQ(book.best_bid(), px(101.0));
+  EXPECT_EQ(book.best_ask(), px(102.0));
+  EXPECT_EQ(book.order_count(), 4u);
+  EXPECT_EQ(book.level_count(Side::Buy), 2u);
+  EXPECT_EQ(book.level_count(Side::Sell), 2u);
+}
+
+TEST(OrderBookTest, AggregatesVolumePerLevel) {
+  OrderBook book(16, 16);
+
+  book.add_order(1, Side::Buy, px(100.0), 10, 0);
+  book.add_order(2, Side::Buy, px(100.0), 20, 0);
+
+  EXPECT_EQ(book.level_count(Side::Buy), 1u);
+  EXPECT_EQ(book.volume_at(Side::Buy, px(100.0)), 30u);
+  EXPECT_EQ(book.volume_at(Side::Buy, px(99.0)), 0u);
+}
+
+TEST(OrderBookTest, RejectsDuplicateAndZeroQuantity) {
+  OrderBook book(16, 16);
+
+  EXPECT_TRUE(book.add_order(1, Side::Buy, px(100.0), 10, 0));
+  EXPECT_FALSE(book.add_order(1, Side::Buy, px(99.0), 10, 0));
+  EXPECT_FALSE(book.add_order(2, Side::Buy, px(99.0), 0, 0));
+  EXPECT_EQ(book.order_count(), 1u);
+}
+
+TEST(OrderBookTest, CancelOrder) {
+  OrderBook book(16, 16);
+
+  book.add_order(1, Side::Buy, px(100.0), 10, 0);
+  book.add_order(2, Side::Buy, px(100.0), 20, 0);
+
+  EXPECT_TRUE(book.cancel_order(1));
+  EXPECT_EQ(book.volume_at(Side::Buy, px(100.0)), 20u);
+  EXPECT_EQ(book.find_order(1), nullptr);
+
+  // 檔位清空後應移除
+  EXPECT_TRUE(book.cancel_order(2));
+  EXPECT_FALSE(book.best_bid().has_value());
+  EXPECT_EQ(book.level_count(Side::Buy), 0u);
+}
+
+// 撤銷不存在的訂單
+TEST(OrderBookTest, CancelUnknownOrder) {
+  OrderBook book(16, 16);
+
+  EXPECT_FALSE(book.cancel_order(42));
+  book.add_order(1, Side::Sell, px(100.0), 10, 0);
+  EXPECT_TRUE(book.cancel_order(1));
+  EXPECT_FALSE(book.cancel_order(1));
+}
+
+TEST(OrderBookTest, FullMatch) {
+  OrderBook book(16, 16);
+  std::vector<Trade> trades;
+  auto on_trade = [&](const Trade &t) { trades.push_back(t); };
+
+  book.add_order(1, Side::Sell, px(100.0), 10, 0);
+  EXPECT_TRUE(book.add_order(2, Side::Buy, px(100.0), 10, 0, on_trade));
+
+  ASSERT_EQ(trades.size(), 1u);
+  EXPECT_EQ(trades[0].maker_id, 1u);
+  EXPECT_EQ(trades[0].taker_id, 2u);
+  EXPECT_EQ(trades[0].price, px(100.0));
+  EXPECT_EQ(trades[0].quantity, 10u);
+  EXPECT_EQ(trades[0].taker_side, Side::Buy);
+
+  EXPECT_EQ(book.order_count(), 0u);
+  EXPECT_FALSE(book.best_ask().has_value());
+  EXPECT_FALSE(book.best_bid().has_value());
+}
+
+TEST(OrderBookTest, PartialMatchRestsRemainder) {
+  OrderBook book(16, 16);
+  std::vector<Trade> trades;
+  auto on_trade = [&](const Trade &t) { trades.push_back(t); };
+
+  book.add_order(1, Side::Sell, px(100.0), 5, 0);
+  book.add_order(2, Side::Sell, px(101.0), 5, 0);
+  EXPECT_TRUE(book.add_order(3, Side::Buy, px(100.5), 8, 0, on_trade));
+
+  ASSERT_EQ(trades.size(), 1u);
+  EXPECT_EQ(trades[0].quantity, 5u);
+
+  // 剩餘 3 掛在 100.5，不得穿越 101.0
+  EXPECT_EQ(book.best_bid(), px(100.5));
+  EXPECT_EQ(book.volume_at(Side::Buy, px(100.5)), 3u);
+  EXPECT_EQ(book.best_ask(), px(101.0));
+}
+
+TEST(OrderBookTest, SweepsMultipleLevels) {
+  OrderBook book(16, 16);
+  std::vector<Trade> trades;
+  auto on_trade = [&](const Trade &t) { trades.push_back(t); };
+
+  book.add_order(1, Side::Buy, px(100.0), 5, 0);
+  book.add_order(2, Side::Buy, px(99.0), 5, 0);
+  book.add_order(3, Side::Buy, px(98.0), 5, 0);
+  EXPECT_TRUE(book.add_order(4, Side::Sell, px(99.0), 12, 0, on_trade));
+
+  ASSERT_EQ(trades.size(), 2u);
+  EXPECT_EQ(trades[0].price, px(100.0));
+  EXPECT_EQ(trades[1].price, px(99.0));
+  EXPECT_EQ(book.best_bid(), px(98.0));
+  EXPECT_EQ(book.best_ask(), px(99.0));
+  EXPECT_EQ(book.volume_at(Side::Sell, px(99.0)), 2u);
+}
+
+// 同價位依時間優先成交
+TEST(OrderBookTest, PriceTimePriority) {
+  OrderBook book(16, 16);
+  std::vector<Trade> trades;
+  auto on_trade = [&](const Trade &t) { trades.push_back(t); };
+
+  book.add_order(1, Side::Sell, px(100.0), 5, 1);
+  book.add_order(2, Side::Sell, px(100.0), 5, 2);
+  book.add_order(3, Side::Sell, px(100.0), 5, 3);
+  book.add_order(4, Side::Buy, px(100.0), 7, 4, on_trade);
+
+  ASSERT_EQ(trades.size(), 2u);
+  EXPECT_EQ(trades[0].maker_id, 1u);
+  EXPECT_EQ(trades[1].maker_id, 2u);
+  EXPECT_EQ(trades[1].quantity, 2u);
+  EXPECT_EQ(book.find_order(2)->quantity, 3u);
+}
+
+TEST(OrderBookTest, ExecuteOrder) {
+  OrderBook book(16, 16);
+
+  book.add_order(1, Side::Buy, px(100.0), 10, 0);
+  EXPECT_TRUE(book.execute_order(1, 4));
+  EXPECT_EQ(book.find_order(1)->quantity, 6u);
+  EXPECT_EQ(book.volume_at(Side::Buy, px(100.0)), 6u);
+
+  EXPECT_TRUE(book.execute_order(1, 6));
+  EXPECT_EQ(book.find_order(1), nullptr);
+  EXPECT_FALSE(book.best_bid().has_value());
+  EXPECT_FALSE(book.execute_order(1, 1));
+}
+
+// 減量保留時間優先
+TEST(OrderBookTest, ModifyReduceKeepsPriority) {
+  OrderBook book(16, 16);
+  std::vector<Trade> trades;
+  auto on_trade = [&](const Trade &t) { trades.push_back(t); };
+
+  book.add_order(1, Side::Sell, px(100.0), 10, 1);
+  book.add_order(2, Side::Sell, px(100.0), 10, 2);
+  EXPECT_TRUE(book.modify_order(1, px(100.0), 4, 3));
+  EXPECT_EQ(book.volume_at(Side::Sell, px(100.0)), 14u);
+
+  book.add_order(3, Side::Buy, px(100.0), 1, 4, on_trade);
+  ASSERT_EQ(trades.size(), 1u);
+  EXPECT_EQ(trades[0].maker_id, 1u);
+}
+
+// 加量或改價失去時間優先
+TEST(OrderBookTest, ModifyIncreaseLosesPriority) {
+  OrderBook book(16, 16);
+  std::vector<Trade> trades;
+  auto on_trade = [&](const Trade &t) { trades.push_back(t); };
+
+  book.add_order(1, Side::Sell, px(100.0), 10, 1);
+  book.add_order(2, Side::Sell, px(100.0), 10, 2);
+  EXPECT_TRUE(book.modify_order(1, px(100.0), 15, 3));
+
+  book.add_order(3, Side::Buy, px(100.0), 1, 4, on_trade);
+  ASSERT_EQ(trades.size(), 1u);
+  EXPECT_EQ(trades[0].maker_id, 2u);
+}
+
+TEST(OrderBookTest, ModifyPriceCanCross) {
+  OrderBook book(16, 16);
+  std::vector<Trade> trades;
+  auto on_trade = [&](const Trade &t) { trades.push_back(t); };
+
+  book.add_order(1, Side::Sell, px(101.0), 10, 0);
+  book.add_order(2, Side::Buy, px(100.0), 4, 0);
+  EXPECT_TRUE(book.modify_order(2, px(101.0), 4, 1, on_trade));
+
+  ASSERT_EQ(trades.size(), 1u);
+  EXPECT_EQ(trades[0].maker_id, 1u);
+  EXPECT_EQ(book.volume_at(Side::Sell, px(101.0)), 6u);
+  EXPECT_FALSE(book.best_bid().has_value());
+  EXPECT_FALSE(book.modify_order(99, px(100.0), 1, 0));
+}
+
+// 預配置容量耗盡時拒單，撤單後空間可重用
+TEST(OrderBookTest, CapacityExhausted) {
+  OrderBook book(2, 16);
+
+  EXPECT_TRUE(book.add_order(1, Side::Buy, px(100.0), 1, 0));
+  EXPECT_TRUE(book.add_order(2, Side::Buy, px(99.0), 1, 0));
+  EXPECT_FALSE(book.add_order(3, Side::Buy, px(98.0), 1, 0));
+
+  EXPECT_TRUE(book.cancel_order(1));
+  EXPECT_TRUE(book.add_order(3, Side::Buy, px(98.0), 1, 0));
+  EXPECT_EQ(book.order_count(), 2u);
+}
+
+// 容量耗盡時，不穿價的單在撮合前就被拒絕 (沒有成交回報)，
+// 穿價的單照常撮合，剩餘數量用撮合歸還的空間掛入
+TEST(OrderBookTest, CapacityExhaustedRejectsBeforeMatching) {
+  OrderBook book(2, 2);
+  ASSERT_TRUE(book.add_order(1, Side::Sell, px(101.0), 5, 0));
+  ASSERT_TRUE(book.add_order(2, Side::Buy, px(99.0), 5, 0));
+
+  std::vector<Trade> trades;
+  auto on_trade = [&trades](const Trade &t) { trades.push_back(t); };
+  EXPECT_FALSE(book.add_order(3, Side::Buy, px(100.0), 5, 0, on_trade));
+  EXPECT_TRUE(trades.empty());
+
+  EXPECT_TRUE(book.add_order(4, Side::Buy, px(102.0), 8, 0, on_trade));
+  ASSERT_EQ(trades.size(), 1u);
+  EXPECT_EQ(trades[0].quantity, 5u);
+  EXPECT_EQ(book.volume_at(Side::Buy, px(102.0)), 3u);
+  EXPECT_FALSE(book.best_ask().has_value());
+  EXPECT_EQ(book.order_count(), 2u);
+}
+
+TEST(OrderBookTest, StressAddCancel) {
+  constexpr size_t N = 10000;
+  OrderBook book(N, 1024);
+
+  for (OrderID id = 0; id < N; ++id) {
+    Side side = id % 2 == 0 ? Side::Buy : Side::Sell;
+    Price offset = static_cast<Price>((id / 2) % 500);
+    Price price = side == Side::Buy ? px(100.0) - offset : px(101.0) + offset;
+    ASSERT_TRUE(book.add_order(id, side, price, 1, 0));
+  }
+  EXPECT_EQ(book.order_count(), N);
+  EXPECT_EQ(book.best_bid(), px(100.0));
+  EXPECT_EQ(book.best_ask(), px(101.0));
+
+  for (OrderID id = 0; id < N; ++id) {
+    ASSERT_TRUE(book.cancel_order(id));
+  }
+  EXPECT_EQ(book.order_count(), 0u);
+  EXPECT_EQ(book.level_count(Side::Buy), 0u);
+  EXPECT_EQ(book.level_count(Side::Sell), 0u);
+}
+
+} // namespace lats::lob::test
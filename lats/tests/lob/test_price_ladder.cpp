@@ -0,0 +1,265 @@
+#include "lob/order_book.hpp"
+#include "lob/price_ladder.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+namespace lats::lob::test {
+using namespace lats::lob;
+
+namespace {
+
+constexpr size_t SLOTS = 256;
+
+// 測試用的檔位儲存，deque 保證指標穩定
+struct Levels {
+  std::deque<PriceLevel> storage;
+
+  PriceLevel *make(Price price) {
+    storage.emplace_back();
+    storage.back().price = price;
+    return &storage.back();
+  }
+};
+
+template <Side S> std::vector<Price> prices(const PriceLadder<S> &ladder) {
+  std::vector<Price> out;
+  ladder.for_each([&](const PriceLevel &level) {
+    out.push_back(level.price);
+    return true;
+  });
+  return out;
+}
+
+} // namespace
+
+TEST(BitmapScanTest, FindNextSet) {
+  std::vector<uint64_t> words(16, 0);
+  EXPECT_EQ(detail::find_next_set(words.data(), words.size(), 0), 16u * 64);
+
+  words[0] = uint64_t{1} << 5;
+  words[9] = uint64_t{1} << 63;
+  words[15] = 1;
+
+  EXPECT_EQ(detail::find_next_set(words.data(), words.size(), 0), 5u);
+  EXPECT_EQ(detail::find_next_set(words.data(), words.size(), 5), 5u);
+  EXPECT_EQ(detail::find_next_set(words.data(), words.size(), 6), 9u * 64 + 63);
+  EXPECT_EQ(detail::find_next_set(words.data(), words.size(), 9 * 64 + 63),
+            9u * 64 + 63);
+  EXPECT_EQ(detail::find_next_set(words.data(), words.size(), 10 * 64),
+            15u * 64);
+  EXPECT_EQ(detail::find_next_set(words.data(), words.size(), 15 * 64 + 1),
+            16u * 64);
+}
+
+TEST(PriceLadderTest, RejectsInvalidGeometry) {
+  EXPECT_THROW((PriceLadder<Side::Buy>(0, SLOTS)), std::invalid_argument);
+  EXPECT_THROW((PriceLadder<Side::Buy>(1, 100)), std::invalid_argument);
+  EXPECT_THROW((PriceLadder<Side::Buy>(1, 64)), std::invalid_argument);
+}
+
+TEST(PriceLadderTest, BestAfterDepletion) {
+  Levels levels;
+  PriceLadder<Side::Sell> asks(1, SLOTS);
+
+  PriceLevel *a = levels.make(100);
+  PriceLevel *b = levels.make(105);
+  PriceLevel *c = levels.make(180);
+  asks.insert(b);
+  asks.insert(a);
+  asks.insert(c);
+
+  EXPECT_EQ(asks.best(), a);
+  asks.erase(a);
+  EXPECT_EQ(asks.best(), b);
+  asks.erase(b);
+  EXPECT_EQ(asks.best(), c);
+  asks.erase(c);
+  EXPECT_TRUE(asks.empty());
+  EXPECT_EQ(asks.best(), nullptr);
+}
+
+// 買方價格越高越優
+TEST(PriceLadderTest, BidOrdering) {
+  Levels levels;
+  PriceLadder<Side::Buy> bids(1, SLOTS);
+
+  bids.insert(levels.make(100));
+  bids.insert(levels.make(102));
+  bids.insert(levels.make(99));
+
+  EXPECT_EQ(bids.best()->price, 102);
+  EXPECT_EQ(prices(bids), (std::vector<Price>{102, 100, 99}));
+}
+
+TEST(PriceLadderTest, TickSizeIndexing) {
+  Levels levels;
+  PriceLadder<Side::Sell> asks(100, SLOTS);
+
+  PriceLevel *a = levels.make(10'000);
+  PriceLevel *b = levels.make(10'100);
+  asks.insert(a);
+  asks.insert(b);
+
+  EXPECT_EQ(asks.find(10'000), a);
+  EXPECT_EQ(asks.find(10'100), b);
+  EXPECT_EQ(asks.find(10'200), nullptr);
+}
+
+// 遠離最優價的檔位放在 overflow，仍可查找與走訪
+TEST(PriceLadderTest, FarLevelsGoToOverflow) {
+  Levels levels;
+  PriceLadder<Side::Sell> asks(1, SLOTS);
+
+  PriceLevel *near = levels.make(100);
+  PriceLevel *far = levels.make(100 + 10 * SLOTS);
+  asks.insert(near);
+  asks.insert(far);
+
+  EXPECT_EQ(asks.size(), 2u);
+  EXPECT_EQ(asks.find(100 + 10 * SLOTS), far);
+  EXPECT_EQ(prices(asks), (std::vector<Price>{100, 100 + 10 * SLOTS}));
+
+  // 視窗清空後由 overflow 補回最優價
+  asks.erase(near);
+  EXPECT_EQ(asks.best(), far);
+  EXPECT_EQ(asks.size(), 1u);
+}
+
+// 更優的價格超出視窗時重新定位，被擠出視窗的檔位轉入 overflow
+TEST(PriceLadderTest, RecenterOnBetterPrice) {
+  Levels levels;
+  PriceLadder<Side::Buy> bids(1, SLOTS);
+
+  std::vector<PriceLevel *> inserted;
+  for (Price p = 1000; p > 1000 - 100; p -= 10) {
+    inserted.push_back(levels.make(p));
+    bids.insert(inserted.back());
+  }
+  const size_t recenters = bids.recenter_count();
+
+  PriceLevel *jump = levels.make(1000 + 2 * SLOTS);
+  bids.insert(jump);
+  EXPECT_GT(bids.recenter_count(), recenters);
+  EXPECT_EQ(bids.best(), jump);
+  EXPECT_EQ(bids.size(), inserted.size() + 1);
+
+  for (PriceLevel *level : inserted) {
+    EXPECT_EQ(bids.find(level->price), level);
+  }
+
+  bids.erase(jump);
+  EXPECT_EQ(bids.best()->price, 1000);
+
+  std::vector<Price> expected;
+  for (Price p = 1000; p > 1000 - 100; p -= 10) {
+    expected.push_back(p);
+  }
+  EXPECT_EQ(prices(bids), expected);
+}
+
+TEST(PriceLadderTest, ForEachStopsEarly) {
+  Levels levels;
+  PriceLadder<Side::Sell> asks(1, SLOTS);
+  for (Price p = 100; p < 110; ++p) {
+    asks.insert(levels.make(p));
+  }
+
+  int visited = 0;
+  asks.for_each([&](const PriceLevel &) { return ++visited < 3; });
+  EXPECT_EQ(visited, 3);
+}
+
+// 價格在大範圍內漂移時，OrderBook 的最優價與檔位量應維持正確
+TEST(PriceLadderTest, OrderBookDrift) {
+  BookConfig config;
+  config.max_orders = 4096;
+  config.max_levels = 4096;
+  config.ladder_slots = SLOTS;
+  OrderBook book(config);
+
+  OrderID id = 1;
+  Price mid = 100'000;
+  Price highest = 0;
+  for (int step = 0; step < 50; ++step) {
+    mid += (step % 2 == 0) ? 3 * SLOTS : -static_cast<Price>(SLOTS);
+    for (int i = 1; i <= 5; ++i) {
+      ASSERT_TRUE(book.add_order(id++, Side::Buy, mid - i, 1, 0));
+    }
+    highest = std::max(highest, mid - 1);
+    EXPECT_EQ(book.best_bid(), highest);
+  }
+
+  // 以賣單逐檔吃掉最優價，最優價應依序遞減
+  std::optional<Price> prev = book.best_bid();
+  while (book.best_bid()) {
+    Price best = *book.best_bid();
+    EXPECT_LE(best, *prev);
+    prev = best;
+    book.add_order(id, Side::Sell, best, book.volume_at(Side::Buy, best), 0);
+    ++id;
+    EXPECT_EQ(book.volume_at(Side::Buy, best), 0u);
+  }
+  EXPECT_EQ(book.order_count(), 0u);
+}
+
+TEST(PriceLadderTest, OrderBookRejectsOffTickPrice) {
+  BookConfig config;
+  config.max_orders = 16;
+  config.max_levels = 16;
+  config.tick_size = 100;
+  OrderBook book(config);
+
+  EXPECT_FALSE(book.add_order(1, Side::Buy, 10'050, 1, 0));
+  EXPECT_TRUE(book.add_order(2, Side::Buy, 10'000, 1, 0));
+}
+
+// 改到不在 tick 上的價格時拒絕，原掛單不能被撤掉
+TEST(PriceLadderTest, OrderBookModifyToOffTickKeepsOrder) {
+  BookConfig config;
+  config.max_orders = 16;
+  config.max_levels = 16;
+  config.tick_size = 100;
+  OrderBook book(config);
+
+  ASSERT_TRUE(book.add_order(1, Side::Buy, 10'000, 5, 0));
+  EXPECT_FALSE(book.modify_order(1, 10'050, 5, 1));
+
+  const Order *order = book.find_order(1);
+  ASSERT_NE(order, nullptr);
+  EXPECT_EQ(order->price, 10'000);
+  EXPECT_EQ(order->quantity, 5u);
+  EXPECT_EQ(book.order_count(), 1u);
+  EXPECT_EQ(book.volume_at(Side::Buy, 10'000), 5u);
+
+  EXPECT_TRUE(book.modify_order(1, 10'100, 5, 2));
+  EXPECT_EQ(book.best_bid(), 10'100);
+}
+
+// 檔位池耗盡、改價需要新檔位時拒絕，原掛單保持不變
+TEST(PriceLadderTest, OrderBookModifyWithoutLevelCapacityKeepsOrder) {
+  BookConfig config;
+  config.max_orders = 16;
+  config.max_levels = 2;
+  OrderBook book(config);
+
+  ASSERT_TRUE(book.add_order(1, Side::Buy, 100, 5, 0));
+  ASSERT_TRUE(book.add_order(2, Side::Buy, 100, 5, 0));
+  ASSERT_TRUE(book.add_order(3, Side::Buy, 99, 5, 0));
+
+  EXPECT_FALSE(book.modify_order(1, 98, 5, 1));
+  EXPECT_NE(book.find_order(1), nullptr);
+  EXPECT_EQ(book.volume_at(Side::Buy, 100), 10u);
+
+  // 移到已存在的檔位不需要新檔位
+  EXPECT_TRUE(book.modify_order(1, 99, 5, 2));
+  EXPECT_EQ(book.volume_at(Side::Buy, 99), 10u);
+  // 單獨佔一檔的掛單改價時會先釋放原檔位
+  EXPECT_TRUE(book.modify_order(2, 97, 5, 3));
+  EXPECT_EQ(book.best_bid(), 99);
+}
+
+} // namespace lats::lob::test
@@ -0,0 +1,151 @@
+#include "lob/order_book.hpp"
+#include "lob/top_of_book_shm.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+namespace lats::lob::test {
+using namespace lats::lob;
+
+namespace {
+std::string shm_name(const char *tag) {
+  return "/lats_test_" + std::string(tag) + "_" + std::to_string(::getpid());
+}
+} // namespace
+
+TEST(TopOfBookShmTest, ReadBeforePublish) {
+  TopOfBookPublisher publisher(shm_name("empty"), 4);
+  TopOfBookReader reader(publisher.name());
+
+  EXPECT_EQ(reader.symbol_count(), 4u);
+  EXPECT_EQ(reader.depth(), 1u);
+
+  TopOfBook tob;
+  ASSERT_TRUE(reader.try_read(0, tob));
+  EXPECT_EQ(tob.version, 0u);
+  EXPECT_EQ(tob.bid_depth, 0u);
+  EXPECT_EQ(tob.ask_depth, 0u);
+  EXPECT_FALSE(reader.try_read(4, tob));
+}
+
+TEST(TopOfBookShmTest, PublishAndRead) {
+  TopOfBookPublisher publisher(shm_name("rw"), 2, 3);
+  TopOfBookReader reader(publisher.name());
+
+  const BookLevel bids[] = {{100, 10}, {99, 20}, {98, 30}, {97, 40}};
+  const BookLevel asks[] = {{101, 5}};
+  ASSERT_TRUE(publisher.publish(1, bids, 4, asks, 1, 12345));
+  EXPECT_FALSE(publisher.publish(2, bids, 1, asks, 1, 0));
+
+  TopOfBook tob;
+  ASSERT_TRUE(reader.read(1, tob));
+  EXPECT_EQ(tob.version, 2u);
+  EXPECT_EQ(tob.timestamp, 12345u);
+  ASSERT_EQ(tob.bid_depth, 3u); // 超過 depth 的檔位不發布
+  ASSERT_EQ(tob.ask_depth, 1u);
+  EXPECT_EQ(tob.bids[0].price, 100);
+  EXPECT_EQ(tob.bids[2].quantity, 30u);
+  EXPECT_EQ(tob.asks[0].price, 101);
+  EXPECT_EQ(tob.asks[0].quantity, 5u);
+
+  // 其他 symbol 不受影響
+  ASSERT_TRUE(reader.read(0, tob));
+  EXPECT_EQ(tob.version, 0u);
+  EXPECT_EQ(reader.version(1), 2u);
+}
+
+TEST(TopOfBookShmTest, PublishFromOrderBook) {
+  TopOfBookPublisher publisher(shm_name("book"), 1, 2);
+  TopOfBookReader reader(publisher.name());
+
+  OrderBook book(64, 64);
+  book.add_order(1, Side::Buy, 100, 10, 0);
+  book.add_order(2, Side::Buy, 100, 5, 0);
+  book.add_order(3, Side::Buy, 98, 7, 0);
+  book.add_order(4, Side::Buy, 97, 1, 0);
+  book.add_order(5, Side::Sell, 103, 4, 0);
+  ASSERT_TRUE(publisher.publish(0, book, 1));
+
+  TopOfBook tob;
+  ASSERT_TRUE(reader.read(0, tob));
+  ASSERT_EQ(tob.bid_depth, 2u);
+  EXPECT_EQ(tob.bids[0].price, 100);
+  EXPECT_EQ(tob.bids[0].quantity, 15u);
+  EXPECT_EQ(tob.bids[1].price, 98);
+  ASSERT_EQ(tob.ask_depth, 1u);
+  EXPECT_EQ(tob.asks[0].price, 103);
+}
+
+TEST(TopOfBookShmTest, InvalidSegment) {
+  EXPECT_THROW(TopOfBookReader(shm_name("missing")), std::runtime_error);
+  EXPECT_THROW(TopOfBookPublisher(shm_name("depth"), 1, 0),
+               std::invalid_argument);
+  EXPECT_THROW(TopOfBookPublisher(shm_name("depth"), 1, TOB_MAX_DEPTH + 1),
+               std::invalid_argument);
+}
+
+TEST(TopOfBookShmTest, UnlinkedOnDestruction) {
+  const std::string name = shm_name("unlink");
+  {
+    TopOfBookPublisher publisher(name, 1);
+  }
+  EXPECT_THROW(TopOfBookReader{name}, std::runtime_error);
+}
+
+// 每次發布的所有欄位都由同一個 i 推導，讀到混合兩次發布的內容就是撕裂
+TEST(TopOfBookShmTest, ConcurrentReadsAreConsistent) {
+  constexpr uint64_t NUM_UPDATES = 200000;
+  TopOfBookPublisher publisher(shm_name("torn"), 1, 4);
+  TopOfBookReader reader(publisher.name());
+  std::atomic<bool> done{false};
+
+  std::thread writer([&] {
+    BookLevel bids[4];
+    BookLevel asks[4];
+    for (uint64_t i = 1; i <= NUM_UPDATES; ++i) {
+      for (int k = 0; k < 4; ++k) {
+        bids[k] = {static_cast<Price>(i * 10 - k), i + k};
+        asks[k] = {static_cast<Price>(i * 10 + k + 1), i + k};
+      }
+      publisher.publish(0, bids, 4, asks, 4, i);
+    }
+    done.store(true, std::memory_order_release);
+  });
+
+  uint64_t reads = 0;
+  uint64_t torn = 0;
+  uint64_t last_version = 0;
+  TopOfBook tob;
+  while (!done.load(std::memory_order_acquire)) {
+    reader.read(0, tob);
+    if (tob.version < last_version) {
+      ++torn;
+    }
+    last_version = tob.version;
+    if (tob.version == 0) {
+      continue;
+    }
+    const uint64_t i = tob.timestamp;
+    bool ok = tob.version == i * 2 && tob.bid_depth == 4 && tob.ask_depth == 4;
+    for (uint64_t k = 0; ok && k < 4; ++k) {
+      ok = tob.bids[k].price == static_cast<Price>(i * 10 - k) &&
+           tob.bids[k].quantity == i + k &&
+           tob.asks[k].price == static_cast<Price>(i * 10 + k + 1) &&
+           tob.asks[k].quantity == i + k;
+    }
+    torn += ok ? 0 : 1;
+    ++reads;
+  }
+  writer.join();
+
+  EXPECT_EQ(torn, 0u) << "after " << reads << " reads";
+  ASSERT_TRUE(reader.read(0, tob));
+  EXPECT_EQ(tob.timestamp, NUM_UPDATES);
+}
+
+} // namespace lats::lob::test